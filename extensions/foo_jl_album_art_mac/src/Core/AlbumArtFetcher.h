@@ -59,12 +59,19 @@ private:
 + (NSImage*)fetchArtworkForTrack:(metadb_handle_ptr)track
                             type:(albumart_config::ArtworkType)type;
 
+// Same, decoded to at most maxPixelSize on the longest side (0 = full size)
++ (NSImage*)fetchArtworkForTrack:(metadb_handle_ptr)track
+                            type:(albumart_config::ArtworkType)type
+                    maxPixelSize:(NSInteger)maxPixelSize;
+
 // Check which artwork types are available for a track
 // Returns array of NSNumber containing available ArtworkType values
 + (NSArray<NSNumber*>*)availableTypesForTrack:(metadb_handle_ptr)track;
 
 // Convert album_art_data to NSImage
 + (NSImage*)imageFromAlbumArtData:(const album_art_data_ptr&)data;
++ (NSImage*)imageFromAlbumArtData:(const album_art_data_ptr&)data
+                     maxPixelSize:(NSInteger)maxPixelSize;
 
 @end
 
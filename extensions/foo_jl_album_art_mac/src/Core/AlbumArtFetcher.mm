@@ -7,6 +7,7 @@
 
 #import "AlbumArtFetcher.h"
 #import "../UI/AlbumArtController.h"
+#import "../../../../shared/ImagePipeline.h"
 
 // Registered controllers
 static std::vector<__weak AlbumArtController*> g_controllers;
@@ -143,6 +144,12 @@ metadb_handle_ptr AlbumArtCallbackManager::getCurrentTrack() const {
 
 + (NSImage*)fetchArtworkForTrack:(metadb_handle_ptr)track
                             type:(albumart_config::ArtworkType)type {
+    return [self fetchArtworkForTrack:track type:type maxPixelSize:0];
+}
+
++ (NSImage*)fetchArtworkForTrack:(metadb_handle_ptr)track
+                            type:(albumart_config::ArtworkType)type
+                    maxPixelSize:(NSInteger)maxPixelSize {
     if (!track.is_valid()) {
         return nil;
     }
@@ -178,7 +185,7 @@ metadb_handle_ptr AlbumArtCallbackManager::getCurrentTrack() const {
                 return nil;
             }
 
-            return [self imageFromAlbumArtData:data];
+            return [self imageFromAlbumArtData:data maxPixelSize:maxPixelSize];
 
         } catch (const exception_album_art_not_found&) {
             // Art not found - this is expected for some types
@@ -249,16 +256,22 @@ metadb_handle_ptr AlbumArtCallbackManager::getCurrentTrack() const {
 }
 
 + (NSImage*)imageFromAlbumArtData:(const album_art_data_ptr&)data {
+    return [self imageFromAlbumArtData:data maxPixelSize:0];
+}
+
++ (NSImage*)imageFromAlbumArtData:(const album_art_data_ptr&)data
+                     maxPixelSize:(NSInteger)maxPixelSize {
     if (!data.is_valid() || data->size() == 0) {
         return nil;
     }
 
+    // Copied: the NSImage fallback decodes lazily, after the caller's ptr is gone
     NSData* imageData = [NSData dataWithBytes:data->data() length:data->size()];
-    if (!imageData) {
-        return nil;
+    NSImage* image = jl_image::decodeImage(imageData, maxPixelSize);
+    if (!image) {
+        // Formats ImageIO can't read directly
+        image = [[NSImage alloc] initWithData:imageData];
     }
-
-    NSImage* image = [[NSImage alloc] initWithData:imageData];
     return image;
 }
 
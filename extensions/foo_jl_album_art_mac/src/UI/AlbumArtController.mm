@@ -8,6 +8,7 @@
 #import "AlbumArtController.h"
 #import "../Core/AlbumArtFetcher.h"
 #import "../Core/AlbumArtConfig.h"
+#import "../../../../shared/ImagePipeline.h"
 
 using namespace albumart_config;
 
@@ -20,8 +21,13 @@ using namespace albumart_config;
 @property (nonatomic, assign) BOOL isZoomable;
 @property (nonatomic, strong) NSArray<NSNumber*> *availableTypes;
 @property (nonatomic, assign) metadb_handle_ptr currentTrack;
+@property (nonatomic, assign) NSInteger loadedPixelSize;  // Decode size of the shown image (0 = full)
+@property (nonatomic, assign) NSUInteger loadGeneration;  // Drops results of superseded loads
 @end
 
+// Decode sizes are rounded up to this step so small resizes don't re-decode
+static const NSInteger kDecodeSizeStep = 128;
+
 @implementation AlbumArtController
 
 - (instancetype)init {
@@ -103,23 +109,30 @@ using namespace albumart_config;
 - (void)handleNewTrack:(metadb_handle_ptr)track {
     self.currentTrack = track;
 
-    // Fetch available types on background thread
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    NSUInteger generation = ++self.loadGeneration;
+    NSInteger pixelSize = [self decodePixelSize];
+    ArtworkType type = self.currentType;
+
+    // Fetch available types and decode on the shared decode queue
+    [jl_image::decodeQueue() addOperationWithBlock:^{
         NSArray<NSNumber*>* available = [AlbumArtFetcher availableTypesForTrack:track];
 
         // Fetch artwork for current type
-        NSImage* image = [AlbumArtFetcher fetchArtworkForTrack:track type:self.currentType];
+        NSImage* image = [AlbumArtFetcher fetchArtworkForTrack:track type:type maxPixelSize:pixelSize];
 
         dispatch_async(dispatch_get_main_queue(), ^{
+            if (generation != self.loadGeneration) return;
             self.availableTypes = available;
             [self updateNavigationArrows];
             self.artView.image = image;
+            self.loadedPixelSize = pixelSize;
             self.artView.artworkTypeName = [NSString stringWithUTF8String:artworkTypeName(self.currentType)];
         });
-    });
+    }];
 }
 
 - (void)handlePlaybackStop {
+    self.loadGeneration++;
     self.currentTrack.release();
     self.availableTypes = @[];
     self.artView.image = nil;
@@ -227,14 +240,39 @@ using namespace albumart_config;
 
     metadb_handle_ptr track = self.currentTrack;
     ArtworkType type = self.currentType;
+    NSUInteger generation = ++self.loadGeneration;
+    NSInteger pixelSize = [self decodePixelSize];
 
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-        NSImage* image = [AlbumArtFetcher fetchArtworkForTrack:track type:type];
+    [jl_image::decodeQueue() addOperationWithBlock:^{
+        NSImage* image = [AlbumArtFetcher fetchArtworkForTrack:track type:type maxPixelSize:pixelSize];
 
         dispatch_async(dispatch_get_main_queue(), ^{
+            if (generation != self.loadGeneration) return;
             self.artView.image = image;
+            self.loadedPixelSize = pixelSize;
         });
-    });
+    }];
+}
+
+#pragma mark - Decode Size
+
+// Pixel size to decode artwork at for the current view size.
+// Zoomable views can magnify the image, so they keep full resolution.
+- (NSInteger)decodePixelSize {
+    if (self.isZoomable) return 0;
+    NSSize size = self.view.bounds.size;
+    NSInteger pixelSize = jl_image::pixelSizeForPoints(MAX(size.width, size.height));
+    return MAX(kDecodeSizeStep, ((pixelSize + kDecodeSizeStep - 1) / kDecodeSizeStep) * kDecodeSizeStep);
+}
+
+- (void)viewDidLayout {
+    [super viewDidLayout];
+
+    // Re-decode when the view grew past the resolution the image was decoded at
+    if (self.artView.image && self.loadedPixelSize > 0 &&
+        [self decodePixelSize] > self.loadedPixelSize) {
+        [self refreshArtwork];
+    }
 }
 
 #pragma mark - AlbumArtViewDelegate
@@ -31,6 +31,9 @@ public:
     // Maximum age for cached thumbnails (30 days)
     static constexpr int kMaxAgeDays = 30;
 
+    // Downloaded images larger than this (longest side, pixels) are stored downsampled
+    static constexpr int kMaxThumbnailPixelSize = 1024;
+
     // Cache operations (all thread-safe)
 
     // Get cached thumbnail path for URL (synchronous, returns immediately)
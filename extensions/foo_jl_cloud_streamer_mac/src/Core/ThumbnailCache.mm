@@ -1,5 +1,6 @@
 #import "ThumbnailCache.h"
 #import "CloudConfig.h"
+#import "../../../../shared/ImagePipeline.h"
 #import <CommonCrypto/CommonDigest.h>
 
 namespace cloud_streamer {
@@ -221,7 +222,11 @@ void ThumbnailCache::downloadThumbnail(const std::string& url,
         }
 
         NSURLSessionDataTask* task = [m_session dataTaskWithURL:nsurl
-            completionHandler:^(NSData* data, NSURLResponse* response, NSError* error) {
+            completionHandler:^(NSData* downloaded, NSURLResponse* response, NSError* error) {
+                // Full-size artwork is common - shrink it here, off the serial cache queue
+                NSData* data = jl_image::downsampledImageData(downloaded, kMaxThumbnailPixelSize, 0.85);
+                bool reencoded = data != downloaded;
+
                 dispatch_async(m_queue, ^{
                     NSMutableArray* callbacks = m_pendingCallbacks[urlKey];
                     [m_pendingCallbacks removeObjectForKey:urlKey];
@@ -244,7 +249,9 @@ void ThumbnailCache::downloadThumbnail(const std::string& url,
                                 result.success = true;
                                 result.filePath = std::string([cachePath UTF8String]);
                                 result.imageData = data;
-                                if (contentType) {
+                                if (reencoded) {
+                                    result.mimeType = "image/jpeg";
+                                } else if (contentType) {
                                     result.mimeType = std::string([contentType UTF8String]);
                                 }
                                 logDebug("Thumbnail cached: " + url);
@@ -0,0 +1,207 @@
+//
+//  QueueModel.cpp
+//  foo_jl_queue_manager
+//
+
+#include "QueueModel.h"
+#include "QueueOperations.h"
+#include <algorithm>
+
+namespace queue_ops {
+
+namespace {
+
+// Myers diff of a[0, n) -> b[0, m) with at most maxEdits edits. Appends
+// removals (a indices + base) and insertions (b indices + base) in
+// descending order. Returns false if the distance is larger.
+bool myersDiff(const t_playback_queue_item* a, size_t n, const t_playback_queue_item* b, size_t m,
+               size_t base, size_t maxEdits, QueueDiff& out) {
+    long N = (long)n;
+    long M = (long)m;
+    long maxD = std::min<long>(N + M, (long)maxEdits);
+    long offset = maxD + 1;
+    std::vector<long> v(2 * maxD + 3, 0);
+    std::vector<std::vector<long>> trace;  // trace[d][k + d] = furthest x on diagonal k before step d
+
+    for (long d = 0; d <= maxD; d++) {
+        trace.emplace_back(v.begin() + (offset - d), v.begin() + (offset + d + 1));
+        for (long k = -d; k <= d; k += 2) {
+            long x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]))
+                ? v[offset + k + 1]          // Down: insertion
+                : v[offset + k - 1] + 1;     // Right: removal
+            long y = x - k;
+            while (x < N && y < M && sameQueueItem(a[x], b[y])) {
+                x++;
+                y++;
+            }
+            v[offset + k] = x;
+            if (x < N || y < M) continue;
+
+            // Walk the trace back from (N, M)
+            for (long step = d; step > 0; step--) {
+                const std::vector<long>& prev = trace[step];
+                long pk = x - y;
+                auto at = [&prev, step](long diagonal) { return prev[diagonal + step]; };
+                bool down = (pk == -step || (pk != step && at(pk - 1) < at(pk + 1)));
+                long prevK = down ? pk + 1 : pk - 1;
+                long prevX = at(prevK);
+                long prevY = prevX - prevK;
+                if (down) {
+                    out.inserted.push_back(base + (size_t)prevY);
+                } else {
+                    out.removed.push_back(base + (size_t)prevX);
+                }
+                x = prevX;
+                y = prevY;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool sameQueueItem(const t_playback_queue_item& a, const t_playback_queue_item& b) {
+    return a.m_handle == b.m_handle && a.m_playlist == b.m_playlist && a.m_item == b.m_item;
+}
+
+QueueDiff diffQueueContents(const std::vector<t_playback_queue_item>& oldItems,
+                            const std::vector<t_playback_queue_item>& newItems,
+                            size_t maxEdits) {
+    QueueDiff diff;
+
+    // Bulk adds append and single removals leave most of the queue in place
+    size_t head = 0;
+    size_t limit = std::min(oldItems.size(), newItems.size());
+    while (head < limit && sameQueueItem(oldItems[head], newItems[head])) head++;
+    size_t tail = 0;
+    while (tail < limit - head &&
+           sameQueueItem(oldItems[oldItems.size() - 1 - tail], newItems[newItems.size() - 1 - tail])) {
+        tail++;
+    }
+
+    size_t oldCount = oldItems.size() - head - tail;
+    size_t newCount = newItems.size() - head - tail;
+    if (oldCount == 0 || newCount == 0 ||
+        !myersDiff(oldItems.data() + head, oldCount, newItems.data() + head, newCount, head, maxEdits, diff)) {
+        // Pure insert/remove, or too different to be worth an exact diff
+        diff.removed.clear();
+        diff.inserted.clear();
+        for (size_t i = 0; i < oldCount; i++) diff.removed.push_back(head + i);
+        for (size_t i = 0; i < newCount; i++) diff.inserted.push_back(head + i);
+        return diff;
+    }
+
+    std::reverse(diff.removed.begin(), diff.removed.end());
+    std::reverse(diff.inserted.begin(), diff.inserted.end());
+    return diff;
+}
+
+QueueDiff QueueModel::update(std::vector<t_playback_queue_item> contents) {
+    QueueDiff diff = diffQueueContents(m_contents, contents, kMaxDiffEdits);
+    m_contents = std::move(contents);
+    applyDiff(diff);
+    return diff;
+}
+
+QueueModel::ItemStats QueueModel::measure(const t_playback_queue_item& item) const {
+    ItemStats stats;
+    stats.length = item.m_handle.is_valid() ? item.m_handle->get_length() : 0;
+    stats.orphan = isOrphanItem(item);
+    stats.invalid = !isItemValid(item);
+    return stats;
+}
+
+void QueueModel::tally(const ItemStats& stats, bool add) {
+    auto apply = [add](size_t& counter) { add ? counter++ : counter--; };
+    if (stats.length <= 0) apply(m_totals.unknownLength);
+    if (stats.orphan) apply(m_totals.orphans);
+    if (stats.invalid) apply(m_totals.invalid);
+}
+
+void QueueModel::applyDiff(const QueueDiff& diff) {
+    if (m_starts.empty()) m_starts.push_back(0);
+    if (diff.empty()) return;
+
+    // Rows played off the front: nothing after them moves relative to each other
+    if (diff.inserted.empty() && diff.removed.back() == diff.removed.size() - 1) {
+        dropHead(diff.removed.size());
+        return;
+    }
+
+    // Rows before the first change keep their stats and offsets
+    size_t first = std::min(diff.removed.empty() ? SIZE_MAX : diff.removed.front(),
+                            diff.inserted.empty() ? SIZE_MAX : diff.inserted.front());
+
+    // Merge kept and inserted rows from first on; only inserted rows are measured
+    std::vector<ItemStats> tail;
+    tail.reserve(m_contents.size() - first);
+    size_t oldIndex = first;
+    size_t nextRemoved = 0;
+    size_t nextInserted = 0;
+    for (size_t i = first; i < m_contents.size(); i++) {
+        if (nextInserted < diff.inserted.size() && diff.inserted[nextInserted] == i) {
+            tail.push_back(measure(m_contents[i]));
+            tally(tail.back(), true);
+            nextInserted++;
+            continue;
+        }
+        while (nextRemoved < diff.removed.size() && diff.removed[nextRemoved] == oldIndex) {
+            tally(m_items[oldIndex++], false);
+            nextRemoved++;
+        }
+        tail.push_back(m_items[oldIndex++]);
+    }
+    for (; nextRemoved < diff.removed.size(); nextRemoved++) {
+        tally(m_items[diff.removed[nextRemoved]], false);
+    }
+
+    m_items.resize(first);
+    m_items.insert(m_items.end(), tail.begin(), tail.end());
+    sumStartsFrom(first);
+}
+
+void QueueModel::remeasure(const std::vector<size_t>& indices) {
+    size_t first = SIZE_MAX;
+    for (size_t index : indices) {
+        if (index >= m_items.size()) continue;
+        tally(m_items[index], false);
+        m_items[index] = measure(m_contents[index]);
+        tally(m_items[index], true);
+        first = std::min(first, index);
+    }
+    if (first != SIZE_MAX) sumStartsFrom(first);
+}
+
+bool QueueModel::revalidate() {
+    size_t invalid = m_totals.invalid;
+    for (size_t i = 0; i < m_items.size(); i++) {
+        bool now = !isItemValid(m_contents[i]);
+        if (now == m_items[i].invalid) continue;
+        now ? m_totals.invalid++ : m_totals.invalid--;
+        m_items[i].invalid = now;
+    }
+    return m_totals.invalid != invalid;
+}
+
+// The remaining offsets keep their sums; the new first one becomes the base
+void QueueModel::dropHead(size_t count) {
+    for (size_t i = 0; i < count; i++) tally(m_items[i], false);
+    m_items.erase(m_items.begin(), m_items.begin() + (std::ptrdiff_t)count);
+    m_starts.erase(m_starts.begin(), m_starts.begin() + (std::ptrdiff_t)count);
+    if (m_items.empty()) m_starts.front() = 0;
+    m_totals.length = m_starts.back() - m_starts.front();
+}
+
+// Offsets before first are unchanged (a re-sum from 0 also resets the base)
+void QueueModel::sumStartsFrom(size_t first) {
+    m_starts.resize(first + 1);
+    if (first == 0) m_starts.front() = 0;
+    for (size_t i = first; i < m_items.size(); i++) {
+        m_starts.push_back(m_starts[i] + std::max(m_items[i].length, 0.0));
+    }
+    m_totals.length = m_starts.back() - m_starts.front();
+}
+
+} // namespace queue_ops
@@ -0,0 +1,92 @@
+//
+//  QueueModel.h
+//  foo_jl_queue_manager
+//
+//  C++ copy of the playback queue as last shown, and the minimal row diff
+//  to a new snapshot. Queue callbacks do not say what changed, so each one
+//  is diffed against the model: the common head and tail are skipped and the
+//  rest goes through a Myers LCS diff over item identity (track + source
+//  playlist position), giving removals and insertions for the table view.
+//
+//  The same diff keeps the queue totals current: per-item lengths and flags
+//  are measured only for inserted items, and start offsets are re-summed
+//  only from the first changed row, so reading a row's offset is O(1).
+//  Offsets are running sums relative to the first row's, so removing rows
+//  from the head (playback draining the queue) re-sums nothing.
+//
+
+#pragma once
+
+#include <foobar2000/SDK/foobar2000.h>
+#include <deque>
+#include <vector>
+
+namespace queue_ops {
+
+// Same queue entry: track and (for playlist items) its source position
+bool sameQueueItem(const t_playback_queue_item& a, const t_playback_queue_item& b);
+
+struct QueueDiff {
+    std::vector<size_t> removed;   // Old indices, ascending
+    std::vector<size_t> inserted;  // New indices, ascending (applied after the removals)
+
+    bool empty() const { return removed.empty() && inserted.empty(); }
+};
+
+struct QueueTotals {
+    double length = 0;         // Seconds, items of known length only
+    size_t unknownLength = 0;  // Streams / unreadable tracks (not in length)
+    size_t orphans = 0;        // Queued without a source playlist
+    size_t invalid = 0;        // Source playlist entry gone when queued
+};
+
+class QueueModel {
+public:
+    // Edit distance above which the changed middle is replaced wholesale
+    static const size_t kMaxDiffEdits = 1024;
+
+    const std::vector<t_playback_queue_item>& contents() const { return m_contents; }
+    size_t count() const { return m_contents.size(); }
+
+    // Replace the contents, returning the diff from the previous ones
+    QueueDiff update(std::vector<t_playback_queue_item> contents);
+
+    const QueueTotals& totals() const { return m_totals; }
+
+    // Measure rows again after their tracks changed (ascending indices)
+    void remeasure(const std::vector<size_t>& indices);
+
+    // Check every row's source playlist entry again after playlists changed
+    // (queue callbacks don't fire for that). Returns true if totals changed.
+    bool revalidate();
+
+    // Known length of the items before index (index == count: whole queue)
+    double startOffset(size_t index) const {
+        return index < m_starts.size() ? m_starts[index] - m_starts.front() : m_totals.length;
+    }
+
+private:
+    struct ItemStats {
+        double length;  // <= 0 if unknown
+        bool orphan;
+        bool invalid;
+    };
+
+    ItemStats measure(const t_playback_queue_item& item) const;
+    void tally(const ItemStats& stats, bool add);
+    void applyDiff(const QueueDiff& diff);
+    void dropHead(size_t count);
+    void sumStartsFrom(size_t first);
+
+    std::vector<t_playback_queue_item> m_contents;
+    std::deque<ItemStats> m_items;  // Parallel to m_contents
+    std::deque<double> m_starts;    // Running sums of known lengths (count + 1), from any base
+    QueueTotals m_totals;
+};
+
+// Minimal diff of old -> new (exposed for QueueModel and its callers)
+QueueDiff diffQueueContents(const std::vector<t_playback_queue_item>& oldItems,
+                            const std::vector<t_playback_queue_item>& newItems,
+                            size_t maxEdits);
+
+} // namespace queue_ops
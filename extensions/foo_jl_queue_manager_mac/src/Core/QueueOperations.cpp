@@ -6,9 +6,55 @@
 //
 
 #include "QueueOperations.h"
+#include "QueueModel.h"
+#include "../../../../shared/FormattedStringCache.h"
+#include <algorithm>
 
 namespace queue_ops {
 
+#pragma mark - QueueTransaction
+
+namespace {
+
+int g_transactionDepth = 0;
+bool g_transactionChanged = false;
+QueueTransaction::CommitHandler g_commitHandler = nullptr;
+
+// Append one item without opening a transaction
+void addItem(playlist_manager::ptr& pm, const t_playback_queue_item& item) {
+    if (isOrphanItem(item)) {
+        pm->queue_add_item(item.m_handle);
+    } else {
+        pm->queue_add_item_playlist(item.m_playlist, item.m_item);
+    }
+}
+
+} // namespace
+
+QueueTransaction::QueueTransaction() {
+    g_transactionDepth++;
+}
+
+QueueTransaction::~QueueTransaction() {
+    if (--g_transactionDepth > 0 || !g_transactionChanged) return;
+    g_transactionChanged = false;
+    if (g_commitHandler) g_commitHandler();
+}
+
+bool QueueTransaction::active() {
+    return g_transactionDepth > 0;
+}
+
+void QueueTransaction::noteChange() {
+    g_transactionChanged = true;
+}
+
+void QueueTransaction::setCommitHandler(CommitHandler handler) {
+    g_commitHandler = handler;
+}
+
+#pragma mark - Queue operations
+
 size_t getCount() {
     auto pm = playlist_manager::get();
     return pm->queue_get_count();
@@ -34,8 +80,7 @@ std::vector<t_playback_queue_item> getContentsVector() {
 void removeItems(const std::vector<size_t>& indices) {
     if (indices.empty()) return;
 
-    auto pm = playlist_manager::get();
-    size_t count = pm->queue_get_count();
+    size_t count = getCount();
 
     // Create bit_array mask
     pfc::bit_array_bittable mask(count);
@@ -45,7 +90,11 @@ void removeItems(const std::vector<size_t>& indices) {
         }
     }
 
-    pm->queue_remove_mask(mask);
+    removeItems(mask);
+}
+
+void removeItems(const bit_array& mask) {
+    playlist_manager::get()->queue_remove_mask(mask);
 }
 
 void removeItem(size_t index) {
@@ -67,6 +116,64 @@ void addOrphanItem(metadb_handle_ptr handle) {
     pm->queue_add_item(handle);
 }
 
+void addItems(const std::vector<t_playback_queue_item>& items) {
+    if (items.empty()) return;
+    QueueTransaction transaction;
+    auto pm = playlist_manager::get();
+    for (const auto& item : items) addItem(pm, item);
+}
+
+void addItemsFromPlaylist(size_t playlist, const std::vector<size_t>& items) {
+    if (items.empty()) return;
+    QueueTransaction transaction;
+    auto pm = playlist_manager::get();
+    size_t itemCount = pm->playlist_get_item_count(playlist);
+    for (size_t item : items) {
+        if (item < itemCount) pm->queue_add_item_playlist(playlist, item);
+    }
+}
+
+void moveItems(const std::vector<size_t>& indices, size_t dest) {
+    if (indices.empty()) return;
+
+    auto contents = getContentsVector();
+    dest = std::min(dest, contents.size());
+
+    // One pass: unmoved items before dest, the moved block, unmoved items after
+    std::vector<bool> moving(contents.size(), false);
+    for (size_t index : indices) {
+        if (index < contents.size()) moving[index] = true;
+    }
+
+    std::vector<t_playback_queue_item> block;
+    std::vector<t_playback_queue_item> reordered;
+    block.reserve(indices.size());
+    reordered.reserve(contents.size());
+    for (size_t i = 0; i <= contents.size(); i++) {
+        if (i == dest) {
+            for (size_t j = 0; j < contents.size(); j++) {
+                if (moving[j]) block.push_back(contents[j]);
+            }
+            reordered.insert(reordered.end(), block.begin(), block.end());
+        }
+        if (i < contents.size() && !moving[i]) reordered.push_back(contents[i]);
+    }
+
+    // Unchanged order (block dropped onto itself) - skip the rebuild
+    bool unchanged = true;
+    for (size_t i = 0; i < contents.size() && unchanged; i++) {
+        unchanged = sameQueueItem(reordered[i], contents[i]);
+    }
+    if (!unchanged) replaceAll(reordered);
+}
+
+void replaceAll(const std::vector<t_playback_queue_item>& items) {
+    QueueTransaction transaction;
+    auto pm = playlist_manager::get();
+    pm->queue_flush();
+    for (const auto& item : items) addItem(pm, item);
+}
+
 bool isItemValid(const t_playback_queue_item& item) {
     // Orphan items are always "valid" (no playlist reference to check)
     if (isOrphanItem(item)) {
@@ -122,9 +229,8 @@ pfc::string8 formatItem(const t_playback_queue_item& item, const char* formatStr
     }
 
     try {
-        titleformat_object::ptr script;
-        titleformat_compiler::get()->compile_safe(script, formatString);
-        item.m_handle->format_title(nullptr, result, script, nullptr);
+        // Cached per track and pattern until the track changes
+        jl_format::formatWithPattern(item.m_handle, formatString, result);
     } catch (...) {
         result = "[Error]";
     }
@@ -146,7 +252,13 @@ pfc::string8 formatDuration(const t_playback_queue_item& item) {
         return result;
     }
 
-    int seconds = static_cast<int>(length);
+    return formatLength(length);
+}
+
+pfc::string8 formatLength(double length) {
+    pfc::string8 result;
+
+    int seconds = static_cast<int>(std::max(length, 0.0));
     int minutes = seconds / 60;
     seconds = seconds % 60;
 
@@ -13,6 +13,28 @@
 
 namespace queue_ops {
 
+// Groups queue edits: queue callbacks raised while a transaction is open are
+// collapsed into one notification when the outermost one ends, so a batch of
+// N SDK calls refreshes the UI once. Main thread only (like the queue API).
+class QueueTransaction {
+public:
+    using CommitHandler = void (*)();
+
+    QueueTransaction();
+    ~QueueTransaction();
+
+    QueueTransaction(const QueueTransaction&) = delete;
+    QueueTransaction& operator=(const QueueTransaction&) = delete;
+
+    static bool active();
+
+    // Record a queue change seen inside a transaction
+    static void noteChange();
+
+    // Called once after the outermost transaction if anything changed
+    static void setCommitHandler(CommitHandler handler);
+};
+
 // Get number of items in queue
 size_t getCount();
 
@@ -25,6 +47,9 @@ std::vector<t_playback_queue_item> getContentsVector();
 // Remove items at specified indices (indices must be sorted ascending)
 void removeItems(const std::vector<size_t>& indices);
 
+// Remove every item whose bit is set - one SDK call
+void removeItems(const bit_array& mask);
+
 // Remove item at single index
 void removeItem(size_t index);
 
@@ -37,6 +62,23 @@ void addItemFromPlaylist(size_t playlist, size_t item);
 // Add orphan item (not associated with any playlist)
 void addOrphanItem(metadb_handle_ptr handle);
 
+// Batch operations. Each runs in a QueueTransaction, so however many SDK
+// calls it takes the UI refreshes once.
+
+// Append items (playlist items keep their source, orphans are added by handle)
+void addItems(const std::vector<t_playback_queue_item>& items);
+
+// Append items of one playlist
+void addItemsFromPlaylist(size_t playlist, const std::vector<size_t>& items);
+
+// Move the items at indices (sorted ascending) so they sit, in their current
+// order, before the item now at dest (dest == count appends)
+void moveItems(const std::vector<size_t>& indices, size_t dest);
+
+// Replace the whole queue. The SDK has no queue reorder, so this is one flush
+// plus one add per item.
+void replaceAll(const std::vector<t_playback_queue_item>& items);
+
 // Check if a queue item is still valid (playlist/item references are current)
 bool isItemValid(const t_playback_queue_item& item);
 
@@ -53,4 +95,7 @@ pfc::string8 formatItem(const t_playback_queue_item& item, const char* formatStr
 // Format queue item duration as string (e.g., "3:45")
 pfc::string8 formatDuration(const t_playback_queue_item& item);
 
+// Format a length in seconds as "3:45" / "1:02:03"
+pfc::string8 formatLength(double length);
+
 } // namespace queue_ops
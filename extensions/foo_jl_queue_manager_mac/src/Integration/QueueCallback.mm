@@ -21,6 +21,50 @@ public:
 
 FB2K_SERVICE_FACTORY(queue_callback_impl);
 
+// Tag edits and other track changes - queued rows show formatted tag text
+class queue_metadb_callback_impl : public metadb_io_callback {
+public:
+    void on_changed_sorted(metadb_handle_list_cref items, bool /*fromHook*/) override {
+        QueueCallbackManager::instance().onTracksChanged(items);
+    }
+};
+
+FB2K_SERVICE_FACTORY(queue_metadb_callback_impl);
+
+// Playlist edits can leave queued entries pointing at a moved or missing item
+class queue_playlist_callback_impl : public playlist_callback_static {
+public:
+    unsigned get_flags() override {
+        return flag_on_items_added | flag_on_items_reordered | flag_on_items_removed |
+               flag_on_items_replaced | flag_on_playlists_reorder | flag_on_playlists_removed;
+    }
+
+    void on_items_added(t_size p_playlist, t_size p_start, const pfc::list_base_const_t<metadb_handle_ptr>& p_data, const bit_array& p_selection) override { changed(); }
+    void on_items_reordered(t_size p_playlist, const t_size* p_order, t_size p_count) override { changed(); }
+    void on_items_removing(t_size p_playlist, const bit_array& p_mask, t_size p_old_count, t_size p_new_count) override {}
+    void on_items_removed(t_size p_playlist, const bit_array& p_mask, t_size p_old_count, t_size p_new_count) override { changed(); }
+    void on_items_selection_change(t_size p_playlist, const bit_array& p_affected, const bit_array& p_state) override {}
+    void on_item_focus_change(t_size p_playlist, t_size p_from, t_size p_to) override {}
+    void on_items_modified(t_size p_playlist, const bit_array& p_mask) override {}
+    void on_items_modified_fromplayback(t_size p_playlist, const bit_array& p_mask, play_control::t_display_level p_level) override {}
+    void on_items_replaced(t_size p_playlist, const bit_array& p_mask, const pfc::list_base_const_t<t_on_items_replaced_entry>& p_data) override { changed(); }
+    void on_item_ensure_visible(t_size p_playlist, t_size p_idx) override {}
+    void on_playlist_activate(t_size p_old, t_size p_new) override {}
+    void on_playlist_created(t_size p_index, const char* p_name, t_size p_name_len) override {}
+    void on_playlists_reorder(const t_size* p_order, t_size p_count) override { changed(); }
+    void on_playlists_removing(const bit_array& p_mask, t_size p_old_count, t_size p_new_count) override {}
+    void on_playlists_removed(const bit_array& p_mask, t_size p_old_count, t_size p_new_count) override { changed(); }
+    void on_playlist_renamed(t_size p_index, const char* p_new_name, t_size p_new_name_len) override {}
+    void on_default_format_changed() override {}
+    void on_playback_order_changed(t_size p_new_index) override {}
+    void on_playlist_locked(t_size p_playlist, bool p_locked) override {}
+
+private:
+    static void changed() { QueueCallbackManager::instance().onPlaylistsChanged(); }
+};
+
+FB2K_SERVICE_FACTORY(queue_playlist_callback_impl);
+
 // Initialization/shutdown
 class queue_manager_init : public initquit {
 public:
@@ -29,18 +29,38 @@ public:
     // Unregister a controller (call from dealloc)
     void unregisterController(QueueManagerController* controller);
 
-    // Called by playback_queue_callback service when queue changes
+    // Called by playback_queue_callback service when queue changes.
+    // Inside a queue_ops::QueueTransaction the change is deferred to its end;
+    // otherwise changes until the main queue next runs share one refresh.
     void onQueueChanged(playback_queue_callback::t_change_origin origin);
 
+    // Called by metadb_io_callback when tracks change. Controllers re-format
+    // the affected rows once the main queue next runs, after every metadb
+    // callback (including the shared format cache's invalidation) is done.
+    void onTracksChanged(metadb_handle_list_cref tracks);
+
+    // Called by playlist_callback when playlist items or playlists were added,
+    // removed or reordered. Controllers re-check which queued entries still
+    // point at their source item; edits until the main queue runs share one check.
+    void onPlaylistsChanged();
+
 private:
-    QueueCallbackManager() = default;
+    QueueCallbackManager();
     ~QueueCallbackManager() = default;
 
+    // Schedule one reload of every controller (no-op if already scheduled)
+    void requestRefresh();
+
+    // Registered controllers still alive (drops released ones). Main thread.
+    std::vector<QueueManagerController*> liveControllers();
+
     // Non-copyable
     QueueCallbackManager(const QueueCallbackManager&) = delete;
     QueueCallbackManager& operator=(const QueueCallbackManager&) = delete;
 
     std::mutex m_mutex;
+    bool m_refreshPending = false;
+    bool m_revalidatePending = false;
 
     // Using void* to store __weak references in C++
     // The actual weak reference handling is done in the .mm file
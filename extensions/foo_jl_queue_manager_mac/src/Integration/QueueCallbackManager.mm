@@ -7,13 +7,22 @@
 
 #import "QueueCallbackManager.h"
 #import "../UI/QueueManagerController.h"
+#include "../Core/QueueOperations.h"
 #import <Foundation/Foundation.h>
+#include <memory>
 
 QueueCallbackManager& QueueCallbackManager::instance() {
     static QueueCallbackManager instance;
     return instance;
 }
 
+QueueCallbackManager::QueueCallbackManager() {
+    // A finished batch refreshes like a single change
+    queue_ops::QueueTransaction::setCommitHandler([] {
+        QueueCallbackManager::instance().requestRefresh();
+    });
+}
+
 void QueueCallbackManager::registerController(QueueManagerController* controller) {
     std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -32,32 +41,75 @@ void QueueCallbackManager::unregisterController(QueueManagerController* controll
 }
 
 void QueueCallbackManager::onQueueChanged(playback_queue_callback::t_change_origin origin) {
-    // Capture controllers to notify (under lock)
-    std::vector<QueueManagerController*> controllersToNotify;
+    // Batch in progress - its transaction refreshes once when it ends
+    if (queue_ops::QueueTransaction::active()) {
+        queue_ops::QueueTransaction::noteChange();
+        return;
+    }
+    requestRefresh();
+}
 
+void QueueCallbackManager::requestRefresh() {
     {
         std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_refreshPending) return;
+        m_refreshPending = true;
+    }
 
-        // Clean up nil references and collect valid controllers
-        std::vector<void*> validControllers;
-        for (void* ptr : m_controllers) {
-            QueueManagerController* controller = (__bridge QueueManagerController*)ptr;
-            if (controller != nil) {
-                validControllers.push_back(ptr);
-                controllersToNotify.push_back(controller);
-            }
+    // Dispatch to main thread; controllers are collected when the refresh runs
+    dispatch_async(dispatch_get_main_queue(), ^{
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_refreshPending = false;
+        }
+
+        for (QueueManagerController* controller : liveControllers()) {
+            [controller reloadQueueContents];
+        }
+    });
+}
+
+void QueueCallbackManager::onTracksChanged(metadb_handle_list_cref tracks) {
+    auto changed = std::make_shared<metadb_handle_list>(tracks);
+    dispatch_async(dispatch_get_main_queue(), ^{
+        for (QueueManagerController* controller : liveControllers()) {
+            [controller refreshTracks:*changed];
         }
-        m_controllers = validControllers;
+    });
+}
+
+void QueueCallbackManager::onPlaylistsChanged() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_revalidatePending) return;
+        m_revalidatePending = true;
     }
 
-    // Dispatch to main thread
     dispatch_async(dispatch_get_main_queue(), ^{
-        for (QueueManagerController* controller : controllersToNotify) {
-            // Skip if controller is in the middle of reordering (debounce)
-            if (controller.isReorderingInProgress) {
-                continue;
-            }
-            [controller reloadQueueContents];
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_revalidatePending = false;
+        }
+
+        for (QueueManagerController* controller : liveControllers()) {
+            [controller revalidateQueueItems];
         }
     });
 }
+
+std::vector<QueueManagerController*> QueueCallbackManager::liveControllers() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Clean up nil references and collect valid controllers
+    std::vector<QueueManagerController*> controllers;
+    std::vector<void*> validControllers;
+    for (void* ptr : m_controllers) {
+        QueueManagerController* controller = (__bridge QueueManagerController*)ptr;
+        if (controller != nil) {
+            validControllers.push_back(ptr);
+            controllers.push_back(controller);
+        }
+    }
+    m_controllers = validControllers;
+    return controllers;
+}
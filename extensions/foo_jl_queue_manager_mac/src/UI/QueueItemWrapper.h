@@ -18,7 +18,7 @@
 }
 
 // Queue position (0-based index in queue)
-@property (nonatomic, readonly) NSUInteger queueIndex;
+@property (nonatomic) NSUInteger queueIndex;
 
 // Source playlist index (or NSNotFound for orphan items)
 @property (nonatomic, readonly) NSUInteger sourcePlaylist;
@@ -26,7 +26,10 @@
 // Source item index within playlist (or NSNotFound for orphan items)
 @property (nonatomic, readonly) NSUInteger sourceItem;
 
-// Cached display text for Artist - Title column
+// Display text for the Artist - Title column. Not a second cache of the
+// formatted string: the UTF-8 text lives in the shared formatted-metadata
+// cache; this is the row's NSString of it, so drawing a cell neither takes
+// the cache lock nor converts from UTF-8. Refreshed by updateCachedValues.
 @property (nonatomic, strong) NSString* cachedArtistTitle;
 
 // Cached duration string
@@ -36,6 +39,14 @@
 - (instancetype)initWithQueueItem:(const t_playback_queue_item&)item
                        queueIndex:(NSUInteger)index;
 
+// Point a wrapper of the same track at another queue entry (keeps the
+// cached display values - they depend on the track only)
+- (void)updateWithQueueItem:(const t_playback_queue_item&)item
+                 queueIndex:(NSUInteger)index;
+
+// Format the cached display values again (the track's tags changed)
+- (void)updateCachedValues;
+
 // Get the underlying handle (for SDK operations)
 - (metadb_handle_ptr)handle;
 
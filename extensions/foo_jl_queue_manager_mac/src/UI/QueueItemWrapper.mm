@@ -7,6 +7,7 @@
 
 #import "QueueItemWrapper.h"
 #include "../Core/QueueOperations.h"
+#include "../../../../shared/FormattedStringCache.h"
 
 @implementation QueueItemWrapper
 
@@ -15,16 +16,7 @@
     self = [super init];
     if (self) {
         _handle = item.m_handle;
-        _queueIndex = index;
-
-        // Handle orphan items (m_playlist == ~0)
-        if (item.m_playlist == ~(size_t)0) {
-            _sourcePlaylist = NSNotFound;
-            _sourceItem = NSNotFound;
-        } else {
-            _sourcePlaylist = item.m_playlist;
-            _sourceItem = item.m_item;
-        }
+        [self updateWithQueueItem:item queueIndex:index];
 
         // Cache display values
         [self updateCachedValues];
@@ -32,6 +24,20 @@
     return self;
 }
 
+- (void)updateWithQueueItem:(const t_playback_queue_item&)item
+                 queueIndex:(NSUInteger)index {
+    _queueIndex = index;
+
+    // Handle orphan items (m_playlist == ~0)
+    if (item.m_playlist == ~(size_t)0) {
+        _sourcePlaylist = NSNotFound;
+        _sourceItem = NSNotFound;
+    } else {
+        _sourcePlaylist = item.m_playlist;
+        _sourceItem = item.m_item;
+    }
+}
+
 - (void)dealloc {
     // metadb_handle_ptr destructor will handle release automatically
     // because it's a C++ member, its destructor is called when the ObjC object is deallocated
@@ -74,11 +80,8 @@
     }
 
     try {
-        titleformat_object::ptr script;
-        titleformat_compiler::get()->compile_safe(script, [pattern UTF8String]);
-
         pfc::string8 result;
-        _handle->format_title(nullptr, result, script, nullptr);
+        jl_format::formatWithPattern(_handle, [pattern UTF8String], result);
 
         return [NSString stringWithUTF8String:result.c_str()];
     } catch (...) {
@@ -87,32 +90,13 @@
 }
 
 - (void)updateCachedValues {
-    // Cache Artist - Title
+    // Artist - Title comes from the shared cache; keep only the NSString of it
     _cachedArtistTitle = [self formatWithPattern:@"[%artist% - ]%title%"];
 
-    // Cache duration
-    if (_handle.is_valid()) {
-        double length = _handle->get_length();
-        if (length > 0) {
-            int seconds = static_cast<int>(length);
-            int minutes = seconds / 60;
-            seconds = seconds % 60;
-
-            if (minutes >= 60) {
-                int hours = minutes / 60;
-                minutes = minutes % 60;
-                _cachedDuration = [NSString stringWithFormat:@"%d:%02d:%02d",
-                                   hours, minutes, seconds];
-            } else {
-                _cachedDuration = [NSString stringWithFormat:@"%d:%02d",
-                                   minutes, seconds];
-            }
-        } else {
-            _cachedDuration = @"--:--";
-        }
-    } else {
-        _cachedDuration = @"--:--";
-    }
+    // Duration is derived from the length, not titleformat - nothing to share
+    double length = _handle.is_valid() ? _handle->get_length() : 0;
+    _cachedDuration = length > 0 ? [NSString stringWithUTF8String:queue_ops::formatLength(length).c_str()]
+                                 : @"--:--";
 }
 
 @end
@@ -8,6 +8,7 @@
 #pragma once
 
 #import <Cocoa/Cocoa.h>
+#include <foobar2000/SDK/foobar2000.h>
 
 @class QueueItemWrapper;
 
@@ -22,12 +23,17 @@
 @property (nonatomic, strong) NSMutableArray<QueueItemWrapper*>* queueItems;
 
 // State flags
-@property (nonatomic) BOOL isReorderingInProgress;
 @property (nonatomic) BOOL transparentBackground;
 
 // Reload queue contents from SDK
 - (void)reloadQueueContents;
 
+// Re-format the rows of changed tracks (tag edits, length updates)
+- (void)refreshTracks:(metadb_handle_list_cref)tracks;
+
+// Re-count unavailable entries after source playlists changed
+- (void)revalidateQueueItems;
+
 // Remove selected items from queue
 - (void)removeSelectedItems;
 
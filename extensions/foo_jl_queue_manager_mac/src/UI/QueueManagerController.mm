@@ -11,10 +11,14 @@
 #import "QueueHeaderCell.h"
 #import "../Integration/QueueCallbackManager.h"
 #import "../Core/QueueOperations.h"
+#include "../Core/QueueModel.h"
 #import "../Core/QueueConfig.h"
 #import "../Core/ConfigHelper.h"
 #import "../../../../shared/UIStyles.h"
 
+#include <unordered_set>
+#include <vector>
+
 // Column identifiers
 static NSString* const kColumnIdQueueIndex = @"queue_index";
 static NSString* const kColumnIdArtistTitle = @"artist_title";
@@ -26,7 +30,10 @@ static NSPasteboardType const QueueItemPasteboardType = @"com.foobar2000.queue-m
 // External pasteboard types we accept
 static NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.rows";
 
-@implementation QueueManagerController
+@implementation QueueManagerController {
+    // Queue contents as currently shown - callbacks are diffed against it
+    queue_ops::QueueModel _model;
+}
 
 #pragma mark - Lifecycle
 
@@ -34,7 +41,6 @@ static NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simpl
     self = [super initWithNibName:nil bundle:nil];
     if (self) {
         _queueItems = [NSMutableArray array];
-        _isReorderingInProgress = NO;
         _transparentBackground = queue_config::getConfigBool(
             queue_config::kKeyTransparentBackground,
             queue_config::kDefaultTransparentBackground);
@@ -210,36 +216,120 @@ static NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simpl
 #pragma mark - Data Loading
 
 - (void)reloadQueueContents {
-    // Fetch current queue from SDK
-    auto contents = queue_ops::getContentsVector();
-
-    // Clear and rebuild wrappers
-    [_queueItems removeAllObjects];
+    // Fetch current queue from SDK and diff it against what is shown
+    queue_ops::QueueDiff diff = _model.update(queue_ops::getContentsVector());
+    if (diff.empty()) return;
+
+    const std::vector<t_playback_queue_item>& contents = _model.contents();
+    NSMutableIndexSet* removedRows = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet* insertedRows = [NSMutableIndexSet indexSet];
+    for (size_t index : diff.removed) [removedRows addIndex:index];
+    for (size_t index : diff.inserted) [insertedRows addIndex:index];
+
+    // Removed wrappers are reused for re-inserted tracks (moves), so only
+    // tracks new to the queue are formatted
+    NSMutableDictionary<NSValue*, NSMutableArray<QueueItemWrapper*>*>* reusable = [NSMutableDictionary dictionary];
+    for (QueueItemWrapper* wrapper in [_queueItems objectsAtIndexes:removedRows]) {
+        NSValue* key = [NSValue valueWithPointer:[wrapper handle].get_ptr()];
+        if (!reusable[key]) reusable[key] = [NSMutableArray array];
+        [reusable[key] addObject:wrapper];
+    }
 
-    for (size_t i = 0; i < contents.size(); i++) {
-        QueueItemWrapper* wrapper = [[QueueItemWrapper alloc]
-                                     initWithQueueItem:contents[i]
-                                     queueIndex:i];
-        [_queueItems addObject:wrapper];
+    NSMutableArray<QueueItemWrapper*>* inserted = [NSMutableArray arrayWithCapacity:diff.inserted.size()];
+    for (size_t index : diff.inserted) {
+        const t_playback_queue_item& item = contents[index];
+        NSMutableArray<QueueItemWrapper*>* candidates = reusable[[NSValue valueWithPointer:item.m_handle.get_ptr()]];
+        QueueItemWrapper* wrapper = candidates.lastObject;
+        if (wrapper) {
+            [candidates removeLastObject];
+            [wrapper updateWithQueueItem:item queueIndex:index];
+        } else {
+            wrapper = [[QueueItemWrapper alloc] initWithQueueItem:item queueIndex:index];
+        }
+        [inserted addObject:wrapper];
     }
 
-    // Reload table
-    [_tableView reloadData];
+    [_queueItems removeObjectsAtIndexes:removedRows];
+    [_queueItems insertObjects:inserted atIndexes:insertedRows];
+
+    [_tableView beginUpdates];
+    [_tableView removeRowsAtIndexes:removedRows withAnimation:NSTableViewAnimationEffectNone];
+    [_tableView insertRowsAtIndexes:insertedRows withAnimation:NSTableViewAnimationEffectNone];
+    [_tableView endUpdates];
+
+    // Rows after the first change moved and start at a new offset - renumber
+    // them and refresh their cells (only visible cells redraw)
+    NSUInteger firstChanged = MIN(removedRows.count ? removedRows.firstIndex : NSNotFound,
+                                  insertedRows.count ? insertedRows.firstIndex : NSNotFound);
+    NSUInteger count = _queueItems.count;
+    if (firstChanged < count) {
+        for (NSUInteger row = firstChanged; row < count; row++) {
+            _queueItems[row].queueIndex = row;
+        }
+        [_tableView reloadDataForRowIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(firstChanged, count - firstChanged)]
+                              columnIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, _tableView.numberOfColumns)]];
+    }
 
     // Update status bar
     [self updateStatusBar];
 }
 
+- (void)refreshTracks:(metadb_handle_list_cref)tracks {
+    if (_queueItems.count == 0) return;
+    std::unordered_set<const metadb_handle*> changed;
+    for (t_size i = 0; i < tracks.get_count(); i++) changed.insert(tracks[i].get_ptr());
+
+    // Wrappers keep their text across queue changes, so edited tracks are re-formatted here
+    NSMutableIndexSet* rows = [NSMutableIndexSet indexSet];
+    std::vector<size_t> indices;
+    NSUInteger count = _queueItems.count;
+    for (NSUInteger row = 0; row < count; row++) {
+        QueueItemWrapper* wrapper = _queueItems[row];
+        if (!changed.count([wrapper handle].get_ptr())) continue;
+        [wrapper updateCachedValues];
+        [rows addIndex:row];
+        indices.push_back(row);
+    }
+    if (indices.empty()) return;
+
+    _model.remeasure(indices);
+    [_tableView reloadDataForRowIndexes:rows
+                          columnIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, _tableView.numberOfColumns)]];
+    [self updateStatusBar];
+}
+
+- (void)revalidateQueueItems {
+    if (_model.revalidate()) [self updateStatusBar];
+}
+
 - (void)updateStatusBar {
     NSUInteger count = _queueItems.count;
     if (count == 0) {
         _statusBar.stringValue = @"";
-    } else if (count == 1) {
-        _statusBar.stringValue = @"1 item in queue";
-    } else {
-        _statusBar.stringValue = [NSString stringWithFormat:@"%lu items in queue",
-                                  (unsigned long)count];
+        return;
+    }
+
+    // Totals are maintained by the model - nothing here walks the queue
+    const queue_ops::QueueTotals& totals = _model.totals();
+    NSMutableString* status = [NSMutableString stringWithFormat:@"%lu %@ in queue, %@%@",
+                               (unsigned long)count, count == 1 ? @"item" : @"items",
+                               [self lengthString:totals.length],
+                               totals.unknownLength > 0 ? @"+" : @""];
+    if (totals.invalid > 0) {
+        [status appendFormat:@", %lu unavailable", (unsigned long)totals.invalid];
     }
+
+    NSIndexSet* selection = _tableView.selectedRowIndexes;
+    if (selection.count == 1 && selection.firstIndex < count) {
+        NSUInteger row = selection.firstIndex;
+        [status appendFormat:@" - #%lu starts after %@", (unsigned long)(row + 1),
+                             [self lengthString:_model.startOffset(row)]];
+    }
+    _statusBar.stringValue = status;
+}
+
+- (NSString*)lengthString:(double)seconds {
+    return [NSString stringWithUTF8String:queue_ops::formatLength(seconds).c_str()];
 }
 
 #pragma mark - Actions
@@ -248,14 +338,14 @@ static NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simpl
     NSIndexSet* selection = _tableView.selectedRowIndexes;
     if (selection.count == 0) return;
 
-    // Build list of indices to remove (in ascending order)
-    __block std::vector<size_t> indices;
+    // Selection as a mask - one SDK call however many rows are selected
+    pfc::bit_array_bittable mask(_queueItems.count);
     [selection enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL* stop) {
-        indices.push_back(idx);
+        if (idx < self->_queueItems.count) mask.set(idx, true);
     }];
 
     // Remove from queue via SDK
-    queue_ops::removeItems(indices);
+    queue_ops::removeItems(mask);
 
     // Table will be reloaded by callback
 }
@@ -352,84 +442,36 @@ static NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simpl
     return NO;
 }
 
-// Handle internal queue reordering
+// Handle internal queue reordering (every dragged row moves as one block)
 - (BOOL)handleInternalDropAtRow:(NSInteger)targetRow fromPasteboard:(NSPasteboard*)pasteboard {
-    NSString* rowString = [pasteboard stringForType:QueueItemPasteboardType];
-    if (!rowString) return NO;
-
-    NSInteger sourceRow = [rowString integerValue];
-    if (sourceRow < 0 || sourceRow >= (NSInteger)_queueItems.count) return NO;
+    NSMutableIndexSet* sourceRows = [NSMutableIndexSet indexSet];
+    for (NSPasteboardItem* item in pasteboard.pasteboardItems) {
+        NSString* rowString = [item stringForType:QueueItemPasteboardType];
+        if (!rowString) continue;
+        NSInteger sourceRow = [rowString integerValue];
+        if (sourceRow >= 0 && sourceRow < (NSInteger)_queueItems.count) {
+            [sourceRows addIndex:sourceRow];
+        }
+    }
+    if (sourceRows.count == 0) return NO;
     if (targetRow < 0) targetRow = 0;
     if (targetRow > (NSInteger)_queueItems.count) targetRow = _queueItems.count;
 
-    // If dropping at the same position or the position right after, no change needed
-    if (sourceRow == targetRow || sourceRow + 1 == targetRow) return NO;
-
-    // Set flag to prevent callback storm
-    _isReorderingInProgress = YES;
-
-    // Get current queue contents
-    auto contents = queue_ops::getContentsVector();
-    if (sourceRow >= (NSInteger)contents.size()) {
-        _isReorderingInProgress = NO;
+    // Dropping a contiguous block onto itself changes nothing
+    NSRange block = NSMakeRange(sourceRows.firstIndex, sourceRows.lastIndex - sourceRows.firstIndex + 1);
+    if (sourceRows.count == block.length &&
+        targetRow >= (NSInteger)block.location && targetRow <= (NSInteger)NSMaxRange(block)) {
         return NO;
     }
 
-    // Capture the item being moved
-    t_playback_queue_item movingItem = contents[sourceRow];
-
-    // Clear the queue
-    queue_ops::clear();
-
-    // Rebuild in new order
-    // Adjust target if source was before target
-    NSInteger adjustedTarget = targetRow;
-    if (sourceRow < targetRow) {
-        adjustedTarget--;
-    }
-
-    for (NSInteger i = 0; i < (NSInteger)contents.size(); i++) {
-        if (i == sourceRow) continue; // Skip source position
-
-        // Insert the moved item at target position
-        if (i == adjustedTarget || (i == 0 && adjustedTarget == 0 && sourceRow != 0)) {
-            // Actually we need a different approach - rebuild properly
-        }
-    }
-
-    // Simpler approach: build new order array
-    std::vector<t_playback_queue_item> newOrder;
-    newOrder.reserve(contents.size());
-
-    for (NSInteger i = 0; i < (NSInteger)contents.size(); i++) {
-        if (i == sourceRow) continue;
-
-        // Insert moved item at correct position
-        if ((NSInteger)newOrder.size() == adjustedTarget) {
-            newOrder.push_back(movingItem);
-        }
-        newOrder.push_back(contents[i]);
-    }
-
-    // If target is at the end
-    if (adjustedTarget >= (NSInteger)newOrder.size()) {
-        newOrder.push_back(movingItem);
-    }
-
-    // Add all items back to queue
-    for (const auto& item : newOrder) {
-        if (item.m_playlist != ~(size_t)0) {
-            queue_ops::addItemFromPlaylist(item.m_playlist, item.m_item);
-        } else {
-            queue_ops::addOrphanItem(item.m_handle);
-        }
-    }
-
-    _isReorderingInProgress = NO;
-
-    // Manually reload since we suppressed callbacks
-    [self reloadQueueContents];
+    std::vector<size_t> indices;
+    indices.reserve(sourceRows.count);
+    [sourceRows enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL* stop) {
+        indices.push_back(idx);
+    }];
 
+    // Flush + re-add inside one transaction - the table refreshes once
+    queue_ops::moveItems(indices, (size_t)targetRow);
     return YES;
 }
 
@@ -455,15 +497,13 @@ static NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simpl
         return NO;
     }
 
-    size_t playlistItemCount = pm->playlist_get_item_count(activePlaylist);
-
-    // Add each item to the queue
+    // Add all items as one batch (invalid rows are skipped)
+    std::vector<size_t> rows;
+    rows.reserve(rowNumbers.count);
     for (NSNumber* rowNum in rowNumbers) {
-        size_t row = [rowNum unsignedLongValue];
-        if (row < playlistItemCount) {
-            queue_ops::addItemFromPlaylist(activePlaylist, row);
-        }
+        rows.push_back([rowNum unsignedLongValue]);
     }
+    queue_ops::addItemsFromPlaylist(activePlaylist, rows);
 
     return YES;
 }
@@ -535,6 +575,10 @@ static NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simpl
 
     NSTextField* cell = cellView.textField;
 
+    // Queue time before this row (precomputed by the model)
+    cellView.toolTip = [NSString stringWithFormat:@"Starts after %@ of queue",
+                        [self lengthString:_model.startOffset(row)]];
+
     // Set cell content based on column
     if ([identifier isEqualToString:kColumnIdQueueIndex]) {
         cell.stringValue = [NSString stringWithFormat:@"%lu", (unsigned long)(row + 1)];
@@ -557,6 +601,8 @@ static NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simpl
 }
 
 - (void)tableViewSelectionDidChange:(NSNotification*)notification {
+    [self updateStatusBar];
+
     // Update text colors for all visible rows based on selection state
     NSIndexSet* selectedRows = _tableView.selectedRowIndexes;
 
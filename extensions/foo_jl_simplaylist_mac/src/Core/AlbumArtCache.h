@@ -10,6 +10,13 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+// Load counters since launch
+typedef struct {
+    uint64_t decodes;        // Loads that ran (thumbnail store read or full decode)
+    uint64_t wastedDecodes;  // Ran, but the group had left every viewport by completion
+    uint64_t cancelled;      // Dropped before running (scrolled out of range)
+} AlbumArtLoadStats;
+
 @interface AlbumArtCache : NSObject
 
 + (instancetype)sharedCache;
@@ -22,6 +29,21 @@ NS_ASSUME_NONNULL_BEGIN
                  handle:(metadb_handle_ptr)handle
              completion:(void (^)(NSImage * _Nullable image))completion;
 
+// Same, for a group shown by owner (a playlist view) at playlist index position.
+// The load is prioritized and cancelled according to the owner's viewport.
+- (void)loadImageForKey:(NSString *)key
+                 handle:(metadb_handle_ptr)handle
+                  owner:(nullable id)owner
+               position:(NSInteger)position
+             completion:(void (^)(NSImage * _Nullable image))completion;
+
+// Playlist index ranges owner currently shows and keeps loads for (visible plus overscan).
+// Pending loads of visible groups run first; loads outside keepRange for every owner
+// are cancelled before they start. Owners are held weakly.
+- (void)updateViewportForOwner:(id)owner visibleRange:(NSRange)visibleRange keepRange:(NSRange)keepRange;
+
++ (AlbumArtLoadStats)loadStats;
+
 // Get cached image (returns nil if not cached)
 - (nullable NSImage *)cachedImageForKey:(NSString *)key;
 
@@ -40,6 +62,14 @@ NS_ASSUME_NONNULL_BEGIN
 // Set maximum cache size in bytes (default 50MB)
 @property (nonatomic, assign) NSUInteger maxCacheSize;
 
+// Pixel size images are loaded at (longest side, default 512).
+// Thumbnails at this size are also kept on disk across restarts.
+@property (nonatomic, assign, readonly) NSInteger thumbnailPixelSize;
+
+// Load images for drawing at pointSize (scaled for the sharpest attached screen).
+// Drops in-memory images when the resulting pixel size changes.
+- (void)setThumbnailDisplaySize:(CGFloat)pointSize;
+
 // Get placeholder image for missing art
 + (NSImage *)placeholderImage;
 
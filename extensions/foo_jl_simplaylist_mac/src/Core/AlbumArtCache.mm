@@ -4,19 +4,90 @@
 //
 
 #import "AlbumArtCache.h"
+#import "../../../../shared/ImagePipeline.h"
+#include "ArtThumbnailStore.h"
+#include "CoverProbeCache.h"
+#include "LruCache.h"
+#include <atomic>
 
-// Maximum entries in key tracking sets (prevents unbounded memory growth)
-static const NSUInteger kMaxKeySetSize = 10000;
+// Maximum keys with known art state (prevents unbounded memory growth)
+static const size_t kMaxKnownKeys = 20000;
 
-@interface AlbumArtCache ()
+// On-disk thumbnail store limit, enforced once per session
+static const size_t kThumbnailStoreMaxSizeMB = 256;
+
+// Pixel sizes are rounded up to this step so small size changes reuse thumbnails
+static const NSInteger kThumbnailSizeStep = 16;
+
+// Stored thumbnail for source, decoded here so drawing doesn't decode lazily
+static NSImage *storedThumbnail(const std::string& sourceKey, int64_t sourceMtime, NSInteger pixelSize) {
+    auto encoded = getArtThumbnailStore().getThumbnail(sourceKey, sourceMtime, (int)pixelSize);
+    if (!encoded) return nil;
+
+    NSData *data = [NSData dataWithBytes:encoded->data() length:encoded->size()];
+    return jl_image::decodeImage(data, 0);
+}
+
+// Decode source art straight to pixelSize and remember the result on disk
+// (sourceKey empty = no stable modification time, don't store)
+static NSImage *thumbnailFromSource(CGImageSourceRef source, NSInteger pixelSize,
+                                    const std::string& sourceKey, int64_t sourceMtime) {
+    CGImageRef cgImage = jl_image::createDecodedImage(source, pixelSize);
+    if (!cgImage) return nil;
+
+    if (!sourceKey.empty()) {
+        NSData *encoded = jl_image::encodeJPEG(cgImage, 0.85);
+        if (encoded.length > 0) {
+            getArtThumbnailStore().storeThumbnail(sourceKey, sourceMtime, (int)pixelSize,
+                                                  (const uint8_t *)encoded.bytes, encoded.length);
+        }
+    }
+
+    NSImage *image = jl_image::imageFromCGImage(cgImage);
+    CGImageRelease(cgImage);
+    return image;
+}
+
+// Counters for +loadStats (readable without creating the cache)
+static std::atomic<uint64_t> g_decodes{0};
+static std::atomic<uint64_t> g_wastedDecodes{0};
+static std::atomic<uint64_t> g_cancelledLoads{0};
+
+// Visible and retained playlist index ranges of one owner
+@interface AlbumArtViewport : NSObject
+@property (nonatomic, assign) NSRange visibleRange;
+@property (nonatomic, assign) NSRange keepRange;
+@end
+
+@implementation AlbumArtViewport
+@end
+
+// One in-flight key: its operation, waiting completions and requesting owners
+@interface AlbumArtPendingLoad : NSObject
+@property (nonatomic, weak) NSOperation *operation;  // Retained by the queue while pending
+@property (nonatomic, strong) NSMutableArray *completions;
+@property (nonatomic, strong) NSMapTable<id, NSNumber *> *positions;  // Owner -> playlist index
+@end
+
+@implementation AlbumArtPendingLoad
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _completions = [NSMutableArray array];
+        _positions = [NSMapTable weakToStrongObjectsMapTable];
+    }
+    return self;
+}
+@end
+
+@interface AlbumArtCache () {
+    // Load outcome per key (true = has art, false = tried and found none).
+    // Survives image eviction; guarded by pendingLock.
+    simplaylist::LruCache<std::string, bool> _knownKeys;
+}
 @property (nonatomic, strong) NSCache<NSString *, NSImage *> *imageCache;
-@property (nonatomic, strong) NSMutableSet<NSString *> *noImageKeys;  // Keys where we tried and found no art
-@property (nonatomic, strong) NSMutableSet<NSString *> *hasImageKeys;  // Keys that have album art
-@property (nonatomic, strong) NSMutableArray<NSString *> *noImageKeyOrder;   // LRU order for eviction
-@property (nonatomic, strong) NSMutableArray<NSString *> *hasImageKeyOrder;  // LRU order for eviction
-@property (nonatomic, strong) NSOperationQueue *loadQueue;
-@property (nonatomic, strong) NSMutableSet<NSString *> *pendingLoads;
-@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray *> *pendingCompletions;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AlbumArtPendingLoad *> *pendingLoads;
+@property (nonatomic, strong) NSMapTable<id, AlbumArtViewport *> *viewports;
 @property (nonatomic, strong) NSLock *pendingLock;
 @end
 
@@ -36,22 +107,26 @@ static NSImage *_placeholderImage = nil;
 - (instancetype)init {
     self = [super init];
     if (self) {
+        _knownKeys.setCapacity(kMaxKnownKeys);
+
         _imageCache = [[NSCache alloc] init];
         _imageCache.countLimit = 500;  // Max 500 images (increased to reduce eviction during scroll)
 
-        _noImageKeys = [NSMutableSet set];     // Track keys with no album art
-        _hasImageKeys = [NSMutableSet set];    // Track keys that have album art
-        _noImageKeyOrder = [NSMutableArray array];   // LRU eviction order
-        _hasImageKeyOrder = [NSMutableArray array];  // LRU eviction order
-
-        _loadQueue = [[NSOperationQueue alloc] init];
-        _loadQueue.maxConcurrentOperationCount = 4;
-        _loadQueue.qualityOfService = NSQualityOfServiceUserInitiated;
-
-        _pendingLoads = [NSMutableSet set];
-        _pendingCompletions = [NSMutableDictionary dictionary];
+        _pendingLoads = [NSMutableDictionary dictionary];
+        _viewports = [NSMapTable weakToStrongObjectsMapTable];
         _pendingLock = [[NSLock alloc] init];
         _maxCacheSize = 50 * 1024 * 1024;  // 50MB default
+        _thumbnailPixelSize = 512;
+
+        // Read the cover name list on the main thread
+        simplaylist::CoverProbeCache::instance();
+
+        // Open the thumbnail store now (cheap); trimming can wait
+        if (getArtThumbnailStore().initialize()) {
+            dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+                getArtThumbnailStore().enforceSizeLimit(kThumbnailStoreMaxSizeMB);
+            });
+        }
     }
     return self;
 }
@@ -84,34 +159,54 @@ static NSImage *_placeholderImage = nil;
     return _placeholderImage;
 }
 
+- (void)setThumbnailDisplaySize:(CGFloat)pointSize {
+    NSInteger pixelSize = jl_image::pixelSizeForPoints(pointSize);
+    pixelSize = ((pixelSize + kThumbnailSizeStep - 1) / kThumbnailSizeStep) * kThumbnailSizeStep;
+    pixelSize = MAX(pixelSize, kThumbnailSizeStep);
+
+    if (pixelSize == _thumbnailPixelSize) return;
+    _thumbnailPixelSize = pixelSize;
+    [_imageCache removeAllObjects];  // Loaded at the old size
+}
+
 - (nullable NSImage *)cachedImageForKey:(NSString *)key {
     return [_imageCache objectForKey:key];
 }
 
 - (BOOL)isLoadingKey:(NSString *)key {
     [_pendingLock lock];
-    BOOL loading = [_pendingLoads containsObject:key];
+    BOOL loading = _pendingLoads[key] != nil;
     [_pendingLock unlock];
     return loading;
 }
 
 - (BOOL)hasNoImageForKey:(NSString *)key {
     [_pendingLock lock];
-    BOOL noImage = [_noImageKeys containsObject:key];
+    const bool *hasImage = _knownKeys.get(key.UTF8String ?: "");
+    BOOL noImage = hasImage && !*hasImage;
     [_pendingLock unlock];
     return noImage;
 }
 
 - (BOOL)hasKnownImageForKey:(NSString *)key {
     [_pendingLock lock];
-    BOOL hasImage = [_hasImageKeys containsObject:key];
+    const bool *hasImage = _knownKeys.get(key.UTF8String ?: "");
+    BOOL known = hasImage && *hasImage;
     [_pendingLock unlock];
-    return hasImage;
+    return known;
 }
 
 - (void)loadImageForKey:(NSString *)key
                  handle:(metadb_handle_ptr)handle
              completion:(void (^)(NSImage * _Nullable image))completion {
+    [self loadImageForKey:key handle:handle owner:nil position:NSNotFound completion:completion];
+}
+
+- (void)loadImageForKey:(NSString *)key
+                 handle:(metadb_handle_ptr)handle
+                  owner:(nullable id)owner
+               position:(NSInteger)position
+             completion:(void (^)(NSImage * _Nullable image))completion {
 
     // Check cache first
     NSImage *cached = [_imageCache objectForKey:key];
@@ -124,7 +219,8 @@ static NSImage *_placeholderImage = nil;
 
     // Check if we already know there's no image for this key
     [_pendingLock lock];
-    if ([_noImageKeys containsObject:key]) {
+    const bool *hasImage = _knownKeys.get(key.UTF8String ?: "");
+    if (hasImage && !*hasImage) {
         [_pendingLock unlock];
         if (completion) {
             completion(nil);
@@ -133,34 +229,53 @@ static NSImage *_placeholderImage = nil;
     }
 
     // Check if already loading
-    if ([_pendingLoads containsObject:key]) {
-        // Add completion to pending list
+    AlbumArtPendingLoad *load = _pendingLoads[key];
+    if (load) {
+        // Add completion to pending list; a visible requester moves the load up
         if (completion) {
-            NSMutableArray *completions = _pendingCompletions[key];
-            if (!completions) {
-                completions = [NSMutableArray array];
-                _pendingCompletions[key] = completions;
+            [load.completions addObject:[completion copy]];
+        }
+        if (owner && position >= 0 && position != NSNotFound) {
+            [load.positions setObject:@(position) forKey:owner];
+            NSOperation *operation = load.operation;
+            BOOL wanted = YES;
+            NSOperationQueuePriority priority = [self priorityForLoad:load wanted:&wanted];
+            if (operation && operation.queuePriority != priority) {
+                operation.queuePriority = priority;
             }
-            [completions addObject:[completion copy]];
         }
         [_pendingLock unlock];
         return;
     }
 
     // Mark as loading
-    [_pendingLoads addObject:key];
+    load = [[AlbumArtPendingLoad alloc] init];
     if (completion) {
-        _pendingCompletions[key] = [NSMutableArray arrayWithObject:[completion copy]];
+        [load.completions addObject:[completion copy]];
     }
+    if (owner && position >= 0 && position != NSNotFound) {
+        [load.positions setObject:@(position) forKey:owner];
+    }
+    _pendingLoads[key] = load;
+
+    NSBlockOperation *operation = [[NSBlockOperation alloc] init];
+    __weak NSBlockOperation *weakOperation = operation;
+    load.operation = operation;
+    BOOL wanted = YES;
+    operation.queuePriority = [self priorityForLoad:load wanted:&wanted];
 
     [_pendingLock unlock];
 
     // Copy handle for use in block
     metadb_handle_ptr handleCopy = handle;
     NSString *keyCopy = [key copy];
+    NSInteger pixelSize = _thumbnailPixelSize;
 
     // Add to load queue - process entirely on background thread
-    [_loadQueue addOperationWithBlock:^{
+    [operation addExecutionBlock:^{
+        // Scrolled out of every viewport before starting
+        if (weakOperation.isCancelled) return;
+
         NSImage *image = nil;
 
         // First try: look for cover image files in the same directory (fast, no SDK needed)
@@ -176,22 +291,20 @@ static NSImage *_placeholderImage = nil;
                     }
 
                     NSString *directory = [filePath stringByDeletingLastPathComponent];
-                    NSFileManager *fm = [NSFileManager defaultManager];
-
-                    // Common cover image filenames
-                    NSArray *coverNames = @[@"cover.jpg", @"cover.png", @"folder.jpg", @"folder.png",
-                                           @"front.jpg", @"front.png", @"album.jpg", @"album.png",
-                                           @"Cover.jpg", @"Cover.png", @"Folder.jpg", @"Folder.png"];
-
-                    for (NSString *name in coverNames) {
-                        NSString *coverPath = [directory stringByAppendingPathComponent:name];
-                        if ([fm fileExistsAtPath:coverPath]) {
-                            image = [[NSImage alloc] initWithContentsOfFile:coverPath];
-                            if (image) {
-                                if (image.size.width > 512 || image.size.height > 512) {
-                                    image = [self resizeImage:image toMaxSize:512];
-                                }
-                                break;
+
+                    // One listing per directory (cached across sessions) instead of a stat per name
+                    simplaylist::CoverProbeResult cover =
+                        simplaylist::CoverProbeCache::instance().probe(directory.fileSystemRepresentation);
+                    if (cover.found()) {
+                        image = storedThumbnail(cover.coverPath, cover.coverMtime, pixelSize);
+                        if (!image) {
+                            NSURL *coverURL = [NSURL fileURLWithFileSystemRepresentation:cover.coverPath.c_str()
+                                                                             isDirectory:NO
+                                                                           relativeToURL:nil];
+                            CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)coverURL, NULL);
+                            if (source) {
+                                image = thumbnailFromSource(source, pixelSize, cover.coverPath, cover.coverMtime);
+                                CFRelease(source);
                             }
                         }
                     }
@@ -202,10 +315,22 @@ static NSImage *_placeholderImage = nil;
         }
 
         // Second try: use SDK (may not work well on background thread)
-        if (!image) {
+        if (!image && !weakOperation.isCancelled) {
             @try {
+                // Embedded art is keyed by the track file and its timestamp
+                std::string sourceKey;
+                int64_t sourceMtime = 0;
+                if (handleCopy.is_valid()) {
+                    t_filestats stats = handleCopy->get_filestats();
+                    if (stats.m_timestamp != filetimestamp_invalid) {
+                        sourceKey = handleCopy->get_path();
+                        sourceMtime = (int64_t)stats.m_timestamp;
+                        image = storedThumbnail(sourceKey, sourceMtime, pixelSize);
+                    }
+                }
+
                 auto art_mgr = album_art_manager_v2::tryGet();
-                if (art_mgr.is_valid() && handleCopy.is_valid()) {
+                if (!image && art_mgr.is_valid() && handleCopy.is_valid()) {
                     try {
                         metadb_handle_list items;
                         items.add_item(handleCopy);
@@ -221,11 +346,10 @@ static NSImage *_placeholderImage = nil;
                                 if (data.is_valid() && data->size() > 0) {
                                     NSData *imageData = [NSData dataWithBytes:data->data()
                                                                        length:data->size()];
-                                    if (imageData) {
-                                        image = [[NSImage alloc] initWithData:imageData];
-                                        if (image && (image.size.width > 512 || image.size.height > 512)) {
-                                            image = [self resizeImage:image toMaxSize:512];
-                                        }
+                                    CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)imageData, NULL);
+                                    if (source) {
+                                        image = thumbnailFromSource(source, pixelSize, sourceKey, sourceMtime);
+                                        CFRelease(source);
                                     }
                                 }
                             }
@@ -239,42 +363,36 @@ static NSImage *_placeholderImage = nil;
             }
         }
 
+        // Cancelled before the embedded art step - "no image" isn't known yet
+        BOOL abandoned = !image && weakOperation.isCancelled;
+
         // Update cache and call completions on main thread
         dispatch_async(dispatch_get_main_queue(), ^{
             [self->_pendingLock lock];
-            [self->_pendingLoads removeObject:keyCopy];
-            NSArray *completions = [self->_pendingCompletions[keyCopy] copy];
-            [self->_pendingCompletions removeObjectForKey:keyCopy];
+            NSArray *completions = nil;
+            // A cancelled-then-rerequested key has a newer pending load - leave it alone
+            if (self->_pendingLoads[keyCopy] == load) {
+                [self->_pendingLoads removeObjectForKey:keyCopy];
+                completions = [load.completions copy];
+            }
+
+            g_decodes++;
+            BOOL wanted = YES;
+            [self priorityForLoad:load wanted:&wanted];
+            if (!wanted || pixelSize != self->_thumbnailPixelSize) {
+                g_wastedDecodes++;
+            }
 
             if (image) {
-                [self->_imageCache setObject:image forKey:keyCopy];
-                // Bounded LRU insertion - evict oldest if at capacity
-                if (![self->_hasImageKeys containsObject:keyCopy]) {
-                    if (self->_hasImageKeys.count >= kMaxKeySetSize) {
-                        NSString *oldest = self->_hasImageKeyOrder.firstObject;
-                        if (oldest) {
-                            [self->_hasImageKeys removeObject:oldest];
-                            [self->_hasImageKeyOrder removeObjectAtIndex:0];
-                        }
-                    }
-                    [self->_hasImageKeys addObject:keyCopy];
-                    [self->_hasImageKeyOrder addObject:keyCopy];
-                }
-            } else {
-                // Mark this key as having no image to prevent repeated load attempts
-                // Bounded LRU insertion - evict oldest if at capacity
-                if (![self->_noImageKeys containsObject:keyCopy]) {
-                    if (self->_noImageKeys.count >= kMaxKeySetSize) {
-                        NSString *oldest = self->_noImageKeyOrder.firstObject;
-                        if (oldest) {
-                            [self->_noImageKeys removeObject:oldest];
-                            [self->_noImageKeyOrder removeObjectAtIndex:0];
-                        }
-                    }
-                    [self->_noImageKeys addObject:keyCopy];
-                    [self->_noImageKeyOrder addObject:keyCopy];
+                // Size changed while loading - drawing will request it again
+                if (pixelSize == self->_thumbnailPixelSize) {
+                    [self->_imageCache setObject:image forKey:keyCopy];
                 }
             }
+            // Remember the outcome (a key without image isn't retried)
+            if (!abandoned) {
+                self->_knownKeys.put(keyCopy.UTF8String ?: "", image != nil);
+            }
             [self->_pendingLock unlock];
 
             for (void (^block)(NSImage *) in completions) {
@@ -282,41 +400,98 @@ static NSImage *_placeholderImage = nil;
             }
         });
     }];
-}
 
-- (NSImage *)resizeImage:(NSImage *)sourceImage toMaxSize:(CGFloat)maxSize {
-    NSSize originalSize = sourceImage.size;
-    CGFloat scale = MIN(maxSize / originalSize.width, maxSize / originalSize.height);
+    // Shared queue: one concurrency cap for every image decode in the component
+    [jl_image::decodeQueue() addOperation:operation];
+}
 
-    if (scale >= 1.0) {
-        return sourceImage;  // Already small enough
+// Queue priority of a pending load from its owners' viewports (call with pendingLock held).
+// wanted = NO when every owner has scrolled the load's group out of its keep range.
+- (NSOperationQueuePriority)priorityForLoad:(AlbumArtPendingLoad *)load wanted:(BOOL *)wanted {
+    *wanted = YES;
+    if (load.positions.count == 0) return NSOperationQueuePriorityNormal;  // Not viewport-tracked
+
+    BOOL visible = NO;
+    BOOL kept = NO;
+    for (id owner in load.positions) {
+        if (!owner) continue;
+        NSUInteger position = [[load.positions objectForKey:owner] unsignedIntegerValue];
+        AlbumArtViewport *viewport = [_viewports objectForKey:owner];
+        if (!viewport) {
+            kept = YES;  // Owner hasn't published a viewport yet
+            continue;
+        }
+        if (NSLocationInRange(position, viewport.visibleRange)) visible = YES;
+        if (NSLocationInRange(position, viewport.keepRange)) kept = YES;
     }
 
-    NSSize newSize = NSMakeSize(originalSize.width * scale, originalSize.height * scale);
-    NSImage *resizedImage = [[NSImage alloc] initWithSize:newSize];
+    *wanted = kept;
+    if (visible) return NSOperationQueuePriorityVeryHigh;
+    return kept ? NSOperationQueuePriorityNormal : NSOperationQueuePriorityVeryLow;
+}
+
+- (void)updateViewportForOwner:(id)owner visibleRange:(NSRange)visibleRange keepRange:(NSRange)keepRange {
+    if (!owner) return;
 
-    [resizedImage lockFocus];
-    [[NSGraphicsContext currentContext] setImageInterpolation:NSImageInterpolationHigh];
-    [sourceImage drawInRect:NSMakeRect(0, 0, newSize.width, newSize.height)
-                   fromRect:NSZeroRect
-                  operation:NSCompositingOperationSourceOver
-                   fraction:1.0];
-    [resizedImage unlockFocus];
+    [_pendingLock lock];
+    AlbumArtViewport *viewport = [_viewports objectForKey:owner];
+    if (viewport && NSEqualRanges(viewport.visibleRange, visibleRange) &&
+        NSEqualRanges(viewport.keepRange, keepRange)) {
+        [_pendingLock unlock];
+        return;
+    }
+    if (!viewport) {
+        viewport = [[AlbumArtViewport alloc] init];
+        [_viewports setObject:viewport forKey:owner];
+    }
+    viewport.visibleRange = visibleRange;
+    viewport.keepRange = keepRange;
+
+    // Re-rank loads that haven't started; drop the ones nobody will see
+    NSMutableArray<NSString *> *dropped = nil;
+    for (NSString *key in _pendingLoads) {
+        AlbumArtPendingLoad *load = _pendingLoads[key];
+        if ([load.positions objectForKey:owner] == nil) continue;
+
+        NSOperation *operation = load.operation;
+        if (!operation || operation.isExecuting || operation.isFinished) continue;
+
+        BOOL wanted = YES;
+        NSOperationQueuePriority priority = [self priorityForLoad:load wanted:&wanted];
+        if (!wanted) {
+            [operation cancel];
+            if (!dropped) dropped = [NSMutableArray array];
+            [dropped addObject:key];
+        } else if (operation.queuePriority != priority) {
+            operation.queuePriority = priority;
+        }
+    }
+    if (dropped) {
+        // Completions are dropped too - drawing requests the key again if it comes back
+        [_pendingLoads removeObjectsForKeys:dropped];
+        g_cancelledLoads += dropped.count;
+    }
+    [_pendingLock unlock];
+}
 
-    return resizedImage;
++ (AlbumArtLoadStats)loadStats {
+    AlbumArtLoadStats stats;
+    stats.decodes = g_decodes.load();
+    stats.wastedDecodes = g_wastedDecodes.load();
+    stats.cancelled = g_cancelledLoads.load();
+    return stats;
 }
 
 - (void)clearCache {
     [_imageCache removeAllObjects];
 
     [_pendingLock lock];
-    [_loadQueue cancelAllOperations];
+    // The decode queue is shared: cancel only this cache's loads
+    for (AlbumArtPendingLoad *load in _pendingLoads.allValues) {
+        [load.operation cancel];
+    }
     [_pendingLoads removeAllObjects];
-    [_pendingCompletions removeAllObjects];
-    [_noImageKeys removeAllObjects];       // Also clear "no image" markers
-    [_noImageKeyOrder removeAllObjects];   // Clear LRU order
-    [_hasImageKeys removeAllObjects];      // Clear "has image" markers too
-    [_hasImageKeyOrder removeAllObjects];  // Clear LRU order
+    _knownKeys.clear();  // Also clear "no image" / "has image" markers
     [_pendingLock unlock];
 }
 
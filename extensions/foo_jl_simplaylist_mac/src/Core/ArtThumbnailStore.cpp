@@ -0,0 +1,412 @@
+//
+//  ArtThumbnailStore.cpp
+//  foo_simplaylist_mac
+//
+//  SQLite-based persistent store for pre-scaled album art thumbnails
+//
+
+#include "ArtThumbnailStore.h"
+#include <sys/stat.h>
+#include <ctime>
+
+static const sqlite3_int64 kTouchIntervalSeconds = 24 * 60 * 60;
+
+// Cover probe rows are ~100 bytes; past this many the least recently used go
+static const sqlite3_int64 kMaxCoverProbes = 50000;
+
+// Singleton instance
+static ArtThumbnailStore g_store;
+
+ArtThumbnailStore& getArtThumbnailStore() {
+    return g_store;
+}
+
+ArtThumbnailStore::ArtThumbnailStore() = default;
+
+ArtThumbnailStore::~ArtThumbnailStore() {
+    close();
+}
+
+std::string ArtThumbnailStore::getDatabasePath() const {
+    // Use foobar2000's profile directory
+    pfc::string8 profilePath;
+    try {
+        profilePath = core_api::get_profile_path();
+    } catch (...) {
+        // Fallback to temp directory
+        return "/tmp/foo_simplaylist_thumbnails.db";
+    }
+
+    // Convert file:// URL to path if needed
+    std::string path(profilePath.c_str());
+    if (path.find("file://") == 0) {
+        path = path.substr(7);
+    }
+
+    // Create cache directory if needed
+    std::string cacheDir = path + "/simplaylist_cache";
+    mkdir(cacheDir.c_str(), 0755);
+
+    return cacheDir + "/thumbnails.db";
+}
+
+bool ArtThumbnailStore::initialize() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_initialized) {
+        return true;
+    }
+
+    std::string dbPath = getDatabasePath();
+
+    int rc = sqlite3_open_v2(dbPath.c_str(), &m_db,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX,
+                             nullptr);
+
+    if (rc != SQLITE_OK) {
+        console::error("[SimPlaylist] Failed to open thumbnail database");
+        if (m_db) sqlite3_close(m_db);
+        m_db = nullptr;
+        return false;
+    }
+
+    // WAL for concurrent readers; memory-mapped reads so thumbnail blobs are
+    // served from the page cache without copying through SQLite's buffer pool
+    sqlite3_exec(m_db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+    sqlite3_exec(m_db, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+    sqlite3_exec(m_db, "PRAGMA mmap_size=268435456;", nullptr, nullptr, nullptr);  // 256MB
+    sqlite3_exec(m_db, "PRAGMA cache_size=-2000;", nullptr, nullptr, nullptr);     // 2MB cache
+
+    if (!createTables()) {
+        sqlite3_close(m_db);
+        m_db = nullptr;
+        return false;
+    }
+
+    m_initialized = true;
+    return true;
+}
+
+bool ArtThumbnailStore::createTables() {
+    const char* sql = R"(
+        CREATE TABLE IF NOT EXISTS thumbnails (
+            source_key TEXT NOT NULL,
+            pixel_size INTEGER NOT NULL,
+            source_mtime INTEGER NOT NULL,
+            data BLOB NOT NULL,
+            size_bytes INTEGER NOT NULL,
+            accessed_at INTEGER NOT NULL,
+            PRIMARY KEY (source_key, pixel_size)
+        );
+
+        CREATE INDEX IF NOT EXISTS idx_thumbnails_accessed ON thumbnails(accessed_at);
+
+        CREATE TABLE IF NOT EXISTS cover_probes (
+            directory TEXT PRIMARY KEY,
+            directory_mtime INTEGER NOT NULL,
+            names_hash INTEGER NOT NULL,
+            cover_name TEXT NOT NULL,
+            cover_mtime INTEGER NOT NULL,
+            accessed_at INTEGER NOT NULL
+        );
+
+        CREATE INDEX IF NOT EXISTS idx_cover_probes_accessed ON cover_probes(accessed_at);
+    )";
+
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(m_db, sql, nullptr, nullptr, &errMsg);
+
+    if (rc != SQLITE_OK) {
+        pfc::string_formatter msg;
+        msg << "[SimPlaylist] Failed to create thumbnail tables: " << (errMsg ? errMsg : "unknown error");
+        console::error(msg.c_str());
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    return true;
+}
+
+void ArtThumbnailStore::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_db) {
+        sqlite3_close(m_db);
+        m_db = nullptr;
+    }
+    m_initialized = false;
+}
+
+std::optional<std::vector<uint8_t>> ArtThumbnailStore::getThumbnail(const std::string& sourceKey,
+                                                                    int64_t sourceMtime,
+                                                                    int pixelSize) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_db || sourceKey.empty()) {
+        return std::nullopt;
+    }
+
+    const char* sql = "SELECT data, source_mtime, accessed_at FROM thumbnails "
+                      "WHERE source_key = ? AND pixel_size = ?";
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return std::nullopt;
+    }
+
+    sqlite3_bind_text(stmt, 1, sourceKey.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, pixelSize);
+
+    std::optional<std::vector<uint8_t>> result;
+    bool needsTouch = false;
+
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        // Outdated entries are left for storeThumbnail to replace
+        if (sqlite3_column_int64(stmt, 1) == sourceMtime) {
+            const uint8_t* blob = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 0));
+            int blobSize = sqlite3_column_bytes(stmt, 0);
+            if (blob && blobSize > 0) {
+                result.emplace(blob, blob + blobSize);
+                sqlite3_int64 now = static_cast<sqlite3_int64>(std::time(nullptr));
+                needsTouch = (now - sqlite3_column_int64(stmt, 2)) > kTouchIntervalSeconds;
+            }
+        }
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (needsTouch) {
+        touchEntry(sourceKey, pixelSize);
+    }
+    return result;
+}
+
+void ArtThumbnailStore::touchEntry(const std::string& sourceKey, int pixelSize) const {
+    const char* sql = "UPDATE thumbnails SET accessed_at = ? WHERE source_key = ? AND pixel_size = ?";
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(std::time(nullptr)));
+        sqlite3_bind_text(stmt, 2, sourceKey.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 3, pixelSize);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+}
+
+bool ArtThumbnailStore::storeThumbnail(const std::string& sourceKey, int64_t sourceMtime, int pixelSize,
+                                       const uint8_t* data, size_t size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_db || sourceKey.empty() || !data || size == 0) {
+        return false;
+    }
+
+    const char* sql = R"(
+        INSERT OR REPLACE INTO thumbnails
+        (source_key, pixel_size, source_mtime, data, size_bytes, accessed_at)
+        VALUES (?, ?, ?, ?, ?, ?)
+    )";
+
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, sourceKey.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, pixelSize);
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(sourceMtime));
+    sqlite3_bind_blob(stmt, 4, data, static_cast<int>(size), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(size));
+    sqlite3_bind_int64(stmt, 6, static_cast<sqlite3_int64>(std::time(nullptr)));
+
+    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+    sqlite3_finalize(stmt);
+
+    return success;
+}
+
+bool ArtThumbnailStore::getCoverProbe(const std::string& directory, int64_t directoryMtime, uint64_t namesHash,
+                                      std::string& coverName, int64_t& coverMtime) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_db || directory.empty()) {
+        return false;
+    }
+
+    const char* sql = "SELECT directory_mtime, names_hash, cover_name, cover_mtime, accessed_at FROM cover_probes "
+                      "WHERE directory = ?";
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, directory.c_str(), -1, SQLITE_STATIC);
+
+    bool found = false;
+    bool needsTouch = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW &&
+        sqlite3_column_int64(stmt, 0) == directoryMtime &&
+        static_cast<uint64_t>(sqlite3_column_int64(stmt, 1)) == namesHash) {
+        const unsigned char* name = sqlite3_column_text(stmt, 2);
+        coverName = name ? reinterpret_cast<const char*>(name) : "";
+        coverMtime = sqlite3_column_int64(stmt, 3);
+        found = true;
+        sqlite3_int64 now = static_cast<sqlite3_int64>(std::time(nullptr));
+        needsTouch = (now - sqlite3_column_int64(stmt, 4)) > kTouchIntervalSeconds;
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (needsTouch) {
+        touchCoverProbe(directory);
+    }
+    return found;
+}
+
+void ArtThumbnailStore::touchCoverProbe(const std::string& directory) const {
+    const char* sql = "UPDATE cover_probes SET accessed_at = ? WHERE directory = ?";
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(std::time(nullptr)));
+        sqlite3_bind_text(stmt, 2, directory.c_str(), -1, SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+}
+
+bool ArtThumbnailStore::storeCoverProbe(const std::string& directory, int64_t directoryMtime, uint64_t namesHash,
+                                        const std::string& coverName, int64_t coverMtime) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_db || directory.empty()) {
+        return false;
+    }
+
+    const char* sql = R"(
+        INSERT OR REPLACE INTO cover_probes
+        (directory, directory_mtime, names_hash, cover_name, cover_mtime, accessed_at)
+        VALUES (?, ?, ?, ?, ?, ?)
+    )";
+
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, directory.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(directoryMtime));
+    sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(namesHash));
+    sqlite3_bind_text(stmt, 4, coverName.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(coverMtime));
+    sqlite3_bind_int64(stmt, 6, static_cast<sqlite3_int64>(std::time(nullptr)));
+
+    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+    sqlite3_finalize(stmt);
+
+    return success;
+}
+
+bool ArtThumbnailStore::clearStore() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_db) {
+        return false;
+    }
+
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(m_db, "DELETE FROM thumbnails; DELETE FROM cover_probes;", nullptr, nullptr, &errMsg);
+
+    if (rc != SQLITE_OK) {
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    // Vacuum to reclaim space
+    sqlite3_exec(m_db, "VACUUM", nullptr, nullptr, nullptr);
+
+    return true;
+}
+
+size_t ArtThumbnailStore::trimCoverProbes() {
+    const char* sql = R"(
+        DELETE FROM cover_probes WHERE rowid IN (
+            SELECT rowid FROM cover_probes ORDER BY accessed_at DESC LIMIT -1 OFFSET ?
+        )
+    )";
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return 0;
+    }
+
+    sqlite3_bind_int64(stmt, 1, kMaxCoverProbes);
+    size_t deleted = 0;
+    if (sqlite3_step(stmt) == SQLITE_DONE) {
+        deleted = static_cast<size_t>(sqlite3_changes(m_db));
+    }
+    sqlite3_finalize(stmt);
+    return deleted;
+}
+
+size_t ArtThumbnailStore::enforceSizeLimit(size_t maxSizeMB) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_db) {
+        return 0;
+    }
+
+    // Probes are tiny but one per directory ever seen - cap their count
+    size_t deleted = trimCoverProbes();
+    if (maxSizeMB == 0) {
+        return deleted;
+    }
+
+    const char* sizeSql = "SELECT COALESCE(SUM(size_bytes), 0) FROM thumbnails";
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_int64 currentSize = 0;
+
+    if (sqlite3_prepare_v2(m_db, sizeSql, -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            currentSize = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    sqlite3_int64 maxSizeBytes = static_cast<sqlite3_int64>(maxSizeMB) * 1024 * 1024;
+    if (currentSize <= maxSizeBytes) {
+        return deleted;
+    }
+
+    // Delete least recently used entries until under limit
+    while (currentSize > maxSizeBytes) {
+        const char* deleteSql = R"(
+            DELETE FROM thumbnails WHERE rowid IN (
+                SELECT rowid FROM thumbnails ORDER BY accessed_at ASC LIMIT 100
+            )
+        )";
+
+        if (sqlite3_exec(m_db, deleteSql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+            break;
+        }
+
+        int changes = sqlite3_changes(m_db);
+        if (changes <= 0) break;
+
+        deleted += static_cast<size_t>(changes);
+
+        // Re-check size
+        if (sqlite3_prepare_v2(m_db, sizeSql, -1, &stmt, nullptr) == SQLITE_OK) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                currentSize = sqlite3_column_int64(stmt, 0);
+            }
+            sqlite3_finalize(stmt);
+        }
+    }
+
+    return deleted;
+}
@@ -0,0 +1,76 @@
+//
+//  ArtThumbnailStore.h
+//  foo_simplaylist_mac
+//
+//  SQLite-based persistent store for pre-scaled album art thumbnails
+//
+
+#pragma once
+
+#include "../fb2k_sdk.h"
+#include <sqlite3.h>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Thumbnails are encoded images at the pixel size they are drawn at, keyed by
+// art source (cover file directory or track path) + size. An entry is only
+// valid while the source modification time matches.
+class ArtThumbnailStore {
+public:
+    ArtThumbnailStore();
+    ~ArtThumbnailStore();
+
+    // Initialize store (creates database if needed)
+    bool initialize();
+
+    // Close database connection
+    void close();
+
+    // Encoded thumbnail for source at pixelSize (nullopt if missing or outdated)
+    std::optional<std::vector<uint8_t>> getThumbnail(const std::string& sourceKey,
+                                                     int64_t sourceMtime,
+                                                     int pixelSize) const;
+
+    // Store encoded thumbnail (replaces any older entry for source + size)
+    bool storeThumbnail(const std::string& sourceKey, int64_t sourceMtime, int pixelSize,
+                        const uint8_t* data, size_t size);
+
+    // Cover file found in a directory (coverName empty = directory has none).
+    // Returns false if unknown or recorded for another directory mtime / name list.
+    bool getCoverProbe(const std::string& directory, int64_t directoryMtime, uint64_t namesHash,
+                       std::string& coverName, int64_t& coverMtime) const;
+
+    bool storeCoverProbe(const std::string& directory, int64_t directoryMtime, uint64_t namesHash,
+                         const std::string& coverName, int64_t coverMtime);
+
+    // Clear entire store
+    bool clearStore();
+
+    // Enforce size limit (removes least recently used entries first) and cap
+    // the cover probe rows. Returns the number of rows removed.
+    size_t enforceSizeLimit(size_t maxSizeMB);
+
+private:
+    // Database path
+    std::string getDatabasePath() const;
+
+    // Create tables if needed
+    bool createTables();
+
+    // Update access time for entry (at most once a day per entry)
+    void touchEntry(const std::string& sourceKey, int pixelSize) const;
+    void touchCoverProbe(const std::string& directory) const;
+
+    // Drop least recently used cover probes past kMaxCoverProbes
+    size_t trimCoverProbes();
+
+    sqlite3* m_db = nullptr;
+    mutable std::mutex m_mutex;
+    bool m_initialized = false;
+};
+
+// Singleton accessor
+ArtThumbnailStore& getArtThumbnailStore();
@@ -0,0 +1,73 @@
+//
+//  ColumnFormatEngine.cpp
+//  foo_simplaylist_mac
+//
+
+#include "ColumnFormatEngine.h"
+
+namespace simplaylist {
+
+ColumnFormatEngine::ColumnFormatEngine() {
+    m_ring.configure(kRingCapacity, 0);
+}
+
+void ColumnFormatEngine::setColumns(const ColumnSet& columns) {
+    if (columns.generation() == m_columnsGeneration) return;
+
+    m_scripts = columns.scripts();
+    m_columnsGeneration = columns.generation();
+    m_ring.configure(kRingCapacity, m_scripts.size());
+}
+
+void ColumnFormatEngine::invalidate() {
+    m_ring.clear();
+}
+
+size_t ColumnFormatEngine::prepareRange(t_size playlist, int64_t first, int64_t last,
+                                        const std::vector<t_size>* rowMap) {
+    if (playlist == SIZE_MAX || first < 0 || last < first) return 0;
+
+    if (playlist != m_playlist) {
+        m_ring.clear();
+        m_playlist = playlist;
+    }
+
+    // Fast path: whole range already resident (steady state while idle or redrawing)
+    bool allResident = true;
+    for (int64_t row = first; row <= last; row++) {
+        if (!m_ring.contains(row)) { allResident = false; break; }
+    }
+    if (allResident) return 0;
+
+    auto pm = playlist_manager::get();
+    t_size itemCount = rowMap ? rowMap->size() : pm->playlist_get_item_count(playlist);
+    if (itemCount == 0 || (t_size)first >= itemCount) return 0;
+    if ((t_size)last >= itemCount) last = (int64_t)itemCount - 1;
+
+    // A range wider than the ring would evict its own head - keep the leading rows
+    if ((size_t)(last - first + 1) > m_ring.capacity()) {
+        last = first + (int64_t)m_ring.capacity() - 1;
+    }
+
+    size_t formatted = 0;
+    for (int64_t row = first; row <= last; row++) {
+        if (m_ring.contains(row)) continue;
+
+        t_size item = rowMap ? (*rowMap)[(size_t)row] : (t_size)row;
+        m_ring.beginRow(row);
+        for (const auto& script : m_scripts) {
+            m_scratch.reset();
+            if (script.is_valid()) {
+                // Playlist context keeps %list_index%, %queue_index% etc. working
+                pm->playlist_item_format_title(playlist, item, nullptr, m_scratch, script,
+                                               nullptr, playback_control::display_level_all);
+            }
+            m_ring.appendCell(m_scratch.get_ptr(), m_scratch.get_length());
+        }
+        m_ring.commitRow();
+        formatted++;
+    }
+    return formatted;
+}
+
+} // namespace simplaylist
@@ -0,0 +1,60 @@
+//
+//  ColumnFormatEngine.h
+//  foo_simplaylist_mac
+//
+//  Batch column formatting for visible playlist rows.
+//  Scripts come precompiled from a ColumnSet; a contiguous row range is formatted
+//  in one pass into a FormattedRowRing, and the view reads UTF-8 spans
+//  back without creating per-row Objective-C objects.
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include "ColumnSet.h"
+#include "FormattedRowRing.h"
+#include <vector>
+
+namespace simplaylist {
+
+class ColumnFormatEngine {
+public:
+    // Rows kept resident - comfortably more than visible rows + overscan
+    static constexpr size_t kRingCapacity = 512;
+
+    ColumnFormatEngine();
+
+    // Take the scripts of a (changed) column set, drops formatted rows
+    void setColumns(const ColumnSet& columns);
+    size_t columnCount() const { return m_scripts.size(); }
+
+    // Drop all formatted rows (playlist content changed)
+    void invalidate();
+
+    // Drop a single row (item metadata changed)
+    void invalidateRow(int64_t playlistIndex) { m_ring.invalidateRow(playlistIndex); }
+
+    // Format every row in [first, last] that is not already resident.
+    // The range is clamped to the playlist size and ring capacity.
+    // Returns number of rows formatted (0 when everything was cached).
+    // rowMap (filter view): row r shows playlist item (*rowMap)[r]; rows stay
+    // keyed by r, so invalidate() whenever the map changes.
+    size_t prepareRange(t_size playlist, int64_t first, int64_t last,
+                        const std::vector<t_size>* rowMap = nullptr);
+
+    // Zero-copy access to a formatted cell (NUL-terminated UTF-8)
+    bool cell(int64_t playlistIndex, size_t column, const char*& outData, size_t& outLength) const {
+        return m_ring.cell(playlistIndex, column, outData, outLength);
+    }
+
+    bool hasRow(int64_t playlistIndex) const { return m_ring.contains(playlistIndex); }
+
+private:
+    std::vector<titleformat_object::ptr> m_scripts;
+    uint64_t m_columnsGeneration = 0;
+
+    FormattedRowRing m_ring;
+    t_size m_playlist = SIZE_MAX;
+    pfc::string8 m_scratch;  // Reused formatting buffer
+};
+
+} // namespace simplaylist
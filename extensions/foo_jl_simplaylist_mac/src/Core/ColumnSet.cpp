@@ -0,0 +1,24 @@
+//
+//  ColumnSet.cpp
+//  foo_simplaylist_mac
+//
+
+#include "ColumnSet.h"
+#include "TitleFormatHelper.h"
+
+namespace simplaylist {
+
+bool ColumnSet::setPatterns(const std::vector<std::string>& patterns) {
+    if (patterns == m_patterns && m_generation != 0) return false;
+
+    m_patterns = patterns;
+    m_scripts.clear();
+    m_scripts.reserve(m_patterns.size());
+    for (const std::string& pattern : m_patterns) {
+        m_scripts.push_back(TitleFormatHelper::compileWithCache(pattern));
+    }
+    m_generation++;
+    return true;
+}
+
+} // namespace simplaylist
@@ -0,0 +1,39 @@
+//
+//  ColumnSet.h
+//  foo_simplaylist_mac
+//
+//  Compiled scripts of the current column list. Rebuilt only when the columns
+//  change (add / remove / reorder / edit); everything that formats columns
+//  per row - batch formatting, search, sort, the legacy per-row delegate -
+//  reads the scripts from here instead of converting and looking up each
+//  pattern in the shared compile cache (mutex + hash) per cell.
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simplaylist {
+
+class ColumnSet {
+public:
+    // Recompile if the patterns differ. Returns true when anything changed.
+    bool setPatterns(const std::vector<std::string>& patterns);
+
+    size_t count() const { return m_scripts.size(); }
+    const std::vector<std::string>& patterns() const { return m_patterns; }
+    const std::vector<titleformat_object::ptr>& scripts() const { return m_scripts; }
+    const titleformat_object::ptr& script(size_t column) const { return m_scripts[column]; }
+
+    // Bumped on every change - lets holders of copied scripts detect staleness
+    uint64_t generation() const { return m_generation; }
+
+private:
+    std::vector<std::string> m_patterns;
+    std::vector<titleformat_object::ptr> m_scripts;
+    uint64_t m_generation = 0;
+};
+
+} // namespace simplaylist
@@ -49,6 +49,16 @@ static const char* const kHideSingleSubgroup = "hide_single_subgroup";
 // Display size: 0 = compact (smaller), 1 = normal (default), 2 = large
 static const char* const kDisplaySize = "display_size";
 
+// Album art file names searched in the track's directory, in priority order
+// (';'-separated, matched case-insensitively)
+static const char* const kCoverFileNames = "cover_file_names";
+
+// Search field shows only matching tracks (filter view) instead of selecting them
+static const char* const kSearchFilterMode = "search_filter_mode";
+
+// Last scroll position per playlist (see ScrollAnchorStore)
+static const char* const kScrollAnchors = "scroll_anchors";
+
 // Default values - row heights sized for 13pt font
 static const int64_t kDefaultRowHeight = 22;
 static const int64_t kDefaultHeaderHeight = 28;
@@ -63,6 +73,9 @@ static const bool kDefaultShowFirstSubgroupHeader = true;  // Show "Disc 1" etc.
 static const bool kDefaultDimParentheses = true;  // Dim text in () and []
 static const bool kDefaultHideSingleSubgroup = false;  // Don't hide single subgroups by default
 static const int64_t kDefaultDisplaySize = 1;  // 0=compact, 1=normal, 2=large
+static const bool kDefaultSearchFilterMode = false;
+static const char* const kDefaultCoverFileNames =
+    "cover.jpg;cover.png;folder.jpg;folder.png;front.jpg;front.png;album.jpg;album.png";
 
 // Helper functions
 inline std::string getFullKey(const char* key) {
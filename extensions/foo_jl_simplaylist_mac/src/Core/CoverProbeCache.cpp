@@ -0,0 +1,190 @@
+//
+//  CoverProbeCache.cpp
+//  foo_simplaylist_mac
+//
+
+#include "CoverProbeCache.h"
+#include "ArtThumbnailStore.h"
+#include "ConfigHelper.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <cctype>
+
+namespace simplaylist {
+
+static int64_t mtimeNanoseconds(const struct stat& st) {
+    return (int64_t)st.st_mtimespec.tv_sec * 1000000000LL + (int64_t)st.st_mtimespec.tv_nsec;
+}
+
+static std::string lowercased(const std::string& str) {
+    std::string result(str);
+    for (char& c : result) c = (char)std::tolower((unsigned char)c);
+    return result;
+}
+
+static int indexOfName(const std::vector<std::string>& names, const std::string& lowerName) {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == lowerName) return (int)i;
+    }
+    return -1;
+}
+
+CoverProbeCache& CoverProbeCache::instance() {
+    static CoverProbeCache cache;
+    return cache;
+}
+
+CoverProbeCache::CoverProbeCache() : m_entries(kMaxEntries) {
+    setNamePriority(simplaylist_config::getConfigString(
+        simplaylist_config::kCoverFileNames,
+        simplaylist_config::kDefaultCoverFileNames));
+}
+
+void CoverProbeCache::setNamePriority(const std::string& names) {
+    std::vector<std::string> parsed;
+    size_t start = 0;
+    while (start <= names.size()) {
+        size_t end = names.find(';', start);
+        if (end == std::string::npos) end = names.size();
+
+        // Trim surrounding spaces
+        size_t first = names.find_first_not_of(' ', start);
+        size_t last = names.find_last_not_of(' ', end - 1);
+        if (first != std::string::npos && first < end && last >= first) {
+            std::string name = lowercased(names.substr(first, last - first + 1));
+            if (indexOfName(parsed, name) < 0) parsed.push_back(std::move(name));
+        }
+        start = end + 1;
+    }
+
+    // FNV-1a over the normalized list - persisted results are tied to it
+    uint64_t hash = 14695981039346656037ULL;
+    for (const std::string& name : parsed) {
+        for (char c : name) {
+            hash ^= (uint8_t)c;
+            hash *= 1099511628211ULL;
+        }
+        hash ^= (uint8_t)';';
+        hash *= 1099511628211ULL;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (hash == m_namesHash && parsed == m_names) return;
+    m_names = std::move(parsed);
+    m_namesHash = hash;
+    m_entries.clear();
+}
+
+// Best candidate in the directory listing (-1 = none); outName keeps the file's case
+static int findCover(const std::string& directory, const std::vector<std::string>& names,
+                     std::string& outName) {
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) return -1;
+
+    int best = -1;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_type != DT_REG && entry->d_type != DT_LNK && entry->d_type != DT_UNKNOWN) continue;
+        int index = indexOfName(names, lowercased(entry->d_name));
+        if (index >= 0 && (best < 0 || index < best)) {
+            best = index;
+            outName = entry->d_name;
+            if (best == 0) break;
+        }
+    }
+    closedir(dir);
+    return best;
+}
+
+// Stats a sequential probe of the name list needs to reach coverName
+static int legacyCost(const std::vector<std::string>& names, const std::string& coverName) {
+    int index = coverName.empty() ? -1 : indexOfName(names, lowercased(coverName));
+    return index >= 0 ? index + 1 : (int)names.size();
+}
+
+static bool statFile(const std::string& path, int64_t& outMtime) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+    outMtime = mtimeNanoseconds(st);
+    return true;
+}
+
+CoverProbeResult CoverProbeCache::probe(const std::string& directory) {
+    std::string prefix = directory;
+    if (prefix.empty() || prefix.back() != '/') prefix += '/';
+
+    std::vector<std::string> names;
+    uint64_t namesHash = 0;
+    Entry entry;
+    bool cached = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (Entry* existing = m_entries.get(directory)) {
+            entry = *existing;
+            cached = true;
+            m_hits++;
+            m_syscallsSaved += entry.legacyCost;
+        } else {
+            names = m_names;
+            namesHash = m_namesHash;
+        }
+    }
+
+    if (!cached && !names.empty()) {
+        // One stat validates a persisted result; list only when the directory changed
+        int syscalls = 1;
+        struct stat st;
+        if (stat(directory.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+            int64_t directoryMtime = mtimeNanoseconds(st);
+            bool known = getArtThumbnailStore().getCoverProbe(directory, directoryMtime, namesHash,
+                                                              entry.coverName, entry.coverMtime);
+            if (known && !entry.coverName.empty()) {
+                // A cover rewritten in place keeps the directory mtime - refresh its own
+                syscalls++;
+                known = statFile(prefix + entry.coverName, entry.coverMtime);
+            }
+
+            if (known) {
+                m_hits++;
+            } else {
+                m_misses++;
+                entry.coverName.clear();
+                entry.coverMtime = 0;
+                syscalls++;
+                if (findCover(directory, names, entry.coverName) >= 0) {
+                    syscalls++;
+                    if (!statFile(prefix + entry.coverName, entry.coverMtime)) entry.coverName.clear();
+                }
+                getArtThumbnailStore().storeCoverProbe(directory, directoryMtime, namesHash,
+                                                       entry.coverName, entry.coverMtime);
+            }
+        } else {
+            m_misses++;
+        }
+
+        entry.legacyCost = legacyCost(names, entry.coverName);
+        m_syscallsSaved += entry.legacyCost - syscalls;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (namesHash == m_namesHash) m_entries.put(directory, entry);
+    }
+
+    CoverProbeResult result;
+    if (!entry.coverName.empty()) result.coverPath = prefix + entry.coverName;
+    result.coverMtime = entry.coverMtime;
+    return result;
+}
+
+CoverProbeCache::Stats CoverProbeCache::stats() const {
+    Stats stats;
+    stats.hits = m_hits.load();
+    stats.misses = m_misses.load();
+    stats.syscallsSaved = m_syscallsSaved.load();
+    return stats;
+}
+
+void CoverProbeCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+} // namespace simplaylist
@@ -0,0 +1,70 @@
+//
+//  CoverProbeCache.h
+//  foo_simplaylist_mac
+//
+//  Finds the cover image file of a track directory with one directory listing
+//  instead of a stat per candidate name. Results (including "no cover") are
+//  kept per directory in memory and in the thumbnail database, invalidated by
+//  the directory modification time.
+//
+
+#pragma once
+#include "LruCache.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace simplaylist {
+
+struct CoverProbeResult {
+    std::string coverPath;   // Empty = no cover file in the directory
+    int64_t coverMtime = 0;  // Nanoseconds, for thumbnail validation
+
+    bool found() const { return !coverPath.empty(); }
+};
+
+class CoverProbeCache {
+public:
+    // Directories remembered in memory
+    static constexpr size_t kMaxEntries = 10000;
+
+    struct Stats {
+        uint64_t hits = 0;           // Answered without listing the directory
+        uint64_t misses = 0;         // Directory listed
+        int64_t syscallsSaved = 0;   // vs. a stat per candidate name up to the match
+    };
+
+    static CoverProbeCache& instance();
+
+    // Candidate file names, highest priority first, separated by ';'.
+    // Matching is case-insensitive. Changing the list drops cached results.
+    void setNamePriority(const std::string& names);
+
+    // Cover file for directory (POSIX path). Thread-safe.
+    CoverProbeResult probe(const std::string& directory);
+
+    Stats stats() const;
+    void clear();
+
+private:
+    CoverProbeCache();
+
+    struct Entry {
+        std::string coverName;
+        int64_t coverMtime = 0;
+        int legacyCost = 0;  // Stats a sequential probe of the name list needs
+    };
+
+    LruCache<std::string, Entry> m_entries;
+    std::vector<std::string> m_names;  // Lowercase, priority order
+    uint64_t m_namesHash = 0;
+    mutable std::mutex m_mutex;
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<int64_t> m_syscallsSaved{0};
+};
+
+} // namespace simplaylist
@@ -0,0 +1,115 @@
+//
+//  FormattedRowRing.h
+//  foo_simplaylist_mac
+//
+//  Flat, index-addressed ring buffer of formatted column values.
+//  Each slot owns a reusable UTF-8 arena plus one span per column, so
+//  refilling a slot after the first pass never allocates.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simplaylist {
+
+class FormattedRowRing {
+public:
+    struct Span {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    // Resize for capacity rows x columnCount cells (drops all content)
+    void configure(size_t capacity, size_t columnCount) {
+        m_capacity = capacity > 0 ? capacity : 1;
+        m_columnCount = columnCount;
+        m_tags.assign(m_capacity, -1);
+        m_arenas.resize(m_capacity);
+        m_spans.assign(m_capacity * m_columnCount, Span());
+        m_filled.assign(m_capacity, 0);
+    }
+
+    // Invalidate all slots (keeps arena capacity for reuse)
+    void clear() {
+        std::fill(m_tags.begin(), m_tags.end(), -1);
+    }
+
+    // Invalidate a single row if it is resident
+    void invalidateRow(int64_t row) {
+        if (row < 0 || m_tags.empty()) return;
+        size_t slot = slotForRow(row);
+        if (m_tags[slot] == row) m_tags[slot] = -1;
+    }
+
+    size_t capacity() const { return m_capacity; }
+    size_t columnCount() const { return m_columnCount; }
+
+    bool contains(int64_t row) const {
+        if (row < 0 || m_tags.empty()) return false;
+        return m_tags[slotForRow(row)] == row;
+    }
+
+    // Start writing a row - evicts whatever row previously mapped to the slot
+    void beginRow(int64_t row) {
+        m_writeSlot = slotForRow(row);
+        m_tags[m_writeSlot] = -1;  // Not readable until commitRow()
+        m_writeRow = row;
+        m_arenas[m_writeSlot].clear();
+        m_filled[m_writeSlot] = 0;
+    }
+
+    // Append the next column's value to the row being written.
+    // Values are stored NUL-terminated so callers can hand them to C APIs directly.
+    void appendCell(const char* data, size_t length) {
+        size_t column = m_filled[m_writeSlot];
+        if (column >= m_columnCount) return;
+
+        std::string& arena = m_arenas[m_writeSlot];
+        Span& span = m_spans[m_writeSlot * m_columnCount + column];
+        span.offset = (uint32_t)arena.size();
+        span.length = (uint32_t)length;
+        arena.append(data, length);
+        arena.push_back('\0');
+        m_filled[m_writeSlot] = column + 1;
+    }
+
+    void commitRow() {
+        // Columns not written (e.g. empty pattern list) read back as empty
+        std::string& arena = m_arenas[m_writeSlot];
+        for (size_t c = m_filled[m_writeSlot]; c < m_columnCount; c++) {
+            Span& span = m_spans[m_writeSlot * m_columnCount + c];
+            span.offset = (uint32_t)arena.size();
+            span.length = 0;
+            arena.push_back('\0');
+        }
+        m_tags[m_writeSlot] = m_writeRow;
+    }
+
+    // Zero-copy access. Pointer is valid until the slot is rewritten.
+    bool cell(int64_t row, size_t column, const char*& outData, size_t& outLength) const {
+        if (!contains(row) || column >= m_columnCount) return false;
+        size_t slot = slotForRow(row);
+        const Span& span = m_spans[slot * m_columnCount + column];
+        outData = m_arenas[slot].data() + span.offset;
+        outLength = span.length;
+        return true;
+    }
+
+private:
+    size_t slotForRow(int64_t row) const { return (size_t)row % m_capacity; }
+
+    size_t m_capacity = 1;
+    size_t m_columnCount = 0;
+    std::vector<int64_t> m_tags;        // Playlist index resident in each slot (-1 = empty)
+    std::vector<std::string> m_arenas;  // Per-slot UTF-8 storage, reused across refills
+    std::vector<Span> m_spans;          // capacity * columnCount spans into the arenas
+    std::vector<size_t> m_filled;       // Columns written so far per slot
+    size_t m_writeSlot = 0;
+    int64_t m_writeRow = -1;
+};
+
+} // namespace simplaylist
@@ -0,0 +1,569 @@
+//
+//  GroupDetection.cpp
+//  foo_simplaylist_mac
+//
+
+#include "GroupDetection.h"
+#include <dispatch/dispatch.h>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <thread>
+
+namespace simplaylist {
+
+// Below this many items the dispatch overhead outweighs the parallel win
+static const t_size kParallelMinItems = 8192;
+// Items per chunk lower bound (keeps per-chunk event bookkeeping negligible)
+static const t_size kMinChunkItems = 4096;
+// How often workers poll the cancel check
+static const t_size kCancelCheckInterval = 1024;
+
+#pragma mark - SubgroupDetector
+
+SubgroupDetector::SubgroupDetector(bool showFirst, bool enableDebug)
+    : m_showFirstSubgroup(showFirst) {
+    if (enableDebug) {
+        m_debugFile = fopen("/tmp/simplaylist_subgroup_debug.txt", "a");
+        if (m_debugFile) {
+            fprintf(m_debugFile, "\n=== New SubgroupDetector created (showFirst=%d) ===\n", showFirst);
+            fflush(m_debugFile);
+        }
+    }
+}
+
+SubgroupDetector::~SubgroupDetector() {
+    if (m_debugFile) {
+        fclose(m_debugFile);
+    }
+}
+
+void SubgroupDetector::initFromState(const char* existingSubgroup) {
+    m_currentSubgroup = existingSubgroup ? existingSubgroup : "";
+    if (m_debugFile) {
+        fprintf(m_debugFile, "initFromState: '%s'\n", m_currentSubgroup.c_str());
+        fflush(m_debugFile);
+    }
+}
+
+void SubgroupDetector::enterNewGroup() {
+    m_currentSubgroup.clear();
+    if (m_debugFile) {
+        fprintf(m_debugFile, "enterNewGroup: cleared currentSubgroup\n");
+        fflush(m_debugFile);
+    }
+}
+
+bool SubgroupDetector::shouldAddSubgroup(const char* formattedSubgroup, bool isNewGroup,
+                                         t_size playlistIndex, GroupDetectionResult& out) {
+    // Only consider non-empty subgroup values (ignore tracks with missing disc tags)
+    if (!formattedSubgroup || formattedSubgroup[0] == 0) {
+        if (m_debugFile) {
+            fprintf(m_debugFile, "[%zu]: empty subgroup, skipped\n", playlistIndex);
+            fflush(m_debugFile);
+        }
+        return false;
+    }
+
+    bool isFirstSubgroupInGroup = m_currentSubgroup.empty();
+    bool isDifferentSubgroup = (strcmp(formattedSubgroup, m_currentSubgroup.c_str()) != 0);
+
+    bool shouldAdd = false;
+    const char* reason = "";
+
+    if (isFirstSubgroupInGroup) {
+        // First non-empty subgroup in this group
+        // Only add if: (1) this is the start of a new group, AND (2) showFirstSubgroup is enabled
+        if (isNewGroup && m_showFirstSubgroup) {
+            shouldAdd = true;
+            reason = "first subgroup at group start (showFirst=ON)";
+        } else {
+            reason = isNewGroup ? "first subgroup but showFirst=OFF" : "first subgroup but NOT at group start";
+        }
+    } else if (isDifferentSubgroup) {
+        // Real disc change (e.g., Disc 1 -> Disc 2) - always show
+        shouldAdd = true;
+        reason = "disc change";
+    } else {
+        reason = "same subgroup";
+    }
+
+    if (m_debugFile) {
+        fprintf(m_debugFile, "[%zu]: subgroup='%s', current='%s', isNew=%d, isFirst=%d, isDiff=%d -> %s: %s\n",
+                playlistIndex, formattedSubgroup, m_currentSubgroup.c_str(),
+                isNewGroup, isFirstSubgroupInGroup, isDifferentSubgroup,
+                shouldAdd ? "ADD" : "SKIP", reason);
+        fflush(m_debugFile);
+    }
+
+    if (shouldAdd) {
+        out.subgroupStarts.push_back(playlistIndex);
+        out.subgroupHeaders.emplace_back(formattedSubgroup);
+    }
+
+    // Always update currentSubgroup when formatted value is non-empty
+    m_currentSubgroup = formattedSubgroup;
+
+    return shouldAdd;
+}
+
+#pragma mark - Sequential detection
+
+bool detectGroupsSequential(const metadb_handle_list& handles, t_size begin, t_size end,
+                            const GroupDetectionParams& params, GroupDetectionState& state,
+                            GroupDetectionResult& out, const DetectionCancelCheck& cancelled) {
+    end = std::min(end, handles.get_count());
+    bool hasSubgroups = params.subgroupScript.is_valid();
+
+    SubgroupDetector subgroupDetector(params.showFirstSubgroup, params.debug);
+    subgroupDetector.initFromState(state.currentSubgroup.c_str());
+
+    pfc::string8 formattedHeader;
+    pfc::string8 formattedSubgroup;
+
+    for (t_size i = begin; i < end; i++) {
+        if (cancelled && (i - begin) % kCancelCheckInterval == 0 && cancelled()) return false;
+
+        // format_title with metadb_handle is thread-safe for reading
+        handles[i]->format_title(nullptr, formattedHeader, params.headerScript, nullptr);
+
+        bool isNewGroup = state.atPlaylistStart ||
+                          strcmp(formattedHeader.c_str(), state.currentHeader.c_str()) != 0;
+        state.atPlaylistStart = false;
+
+        if (isNewGroup) {
+            out.groupStarts.push_back(i);
+            out.groupHeaders.emplace_back(formattedHeader.c_str());
+            out.groupArtKeys.emplace_back(handles[i]->get_path());
+            state.currentHeader = formattedHeader.c_str();
+            subgroupDetector.enterNewGroup();  // Clear subgroup state for new group
+        }
+
+        // Check for subgroup change using shared detector
+        if (hasSubgroups) {
+            handles[i]->format_title(nullptr, formattedSubgroup, params.subgroupScript, nullptr);
+            subgroupDetector.shouldAddSubgroup(formattedSubgroup.c_str(), isNewGroup, i, out);
+        }
+    }
+
+    state.currentSubgroup = subgroupDetector.getCurrentSubgroup();
+    return true;
+}
+
+#pragma mark - Parallel detection
+
+namespace {
+
+// A track whose header or subgroup could change detector state.
+// Tracks in between repeat the previous header and either have an empty
+// subgroup or repeat the last non-empty one, so they are no-ops when replayed.
+struct ChunkEvent {
+    t_size index;
+    bool hasHeader;         // First track of chunk or header differs from previous track
+    std::string header;     // Valid when hasHeader
+    std::string subgroup;   // Empty = no subgroup value
+};
+
+struct ChunkScan {
+    t_size begin = 0;
+    t_size end = 0;
+    std::vector<ChunkEvent> events;
+    bool cancelled = false;
+};
+
+struct ParallelContext {
+    const metadb_handle_list* handles;
+    const GroupDetectionParams* params;
+    const DetectionCancelCheck* cancelled;
+    std::vector<ChunkScan>* chunks;
+};
+
+void scanChunk(void* context, size_t chunkIndex) {
+    ParallelContext* ctx = static_cast<ParallelContext*>(context);
+    ChunkScan& chunk = (*ctx->chunks)[chunkIndex];
+    const metadb_handle_list& handles = *ctx->handles;
+    const GroupDetectionParams& params = *ctx->params;
+    bool hasSubgroups = params.subgroupScript.is_valid();
+
+    pfc::string8 header, previousHeader, subgroup;
+    std::string segmentSubgroup;  // Last non-empty subgroup since the last header change
+
+    for (t_size i = chunk.begin; i < chunk.end; i++) {
+        if (*ctx->cancelled && (i - chunk.begin) % kCancelCheckInterval == 0 && (*ctx->cancelled)()) {
+            chunk.cancelled = true;
+            return;
+        }
+
+        handles[i]->format_title(nullptr, header, params.headerScript, nullptr);
+        bool headerEvent = (i == chunk.begin) || strcmp(header.c_str(), previousHeader.c_str()) != 0;
+        if (headerEvent) {
+            segmentSubgroup.clear();
+        }
+
+        bool subgroupEvent = false;
+        if (hasSubgroups) {
+            handles[i]->format_title(nullptr, subgroup, params.subgroupScript, nullptr);
+            if (subgroup.get_length() > 0) {
+                subgroupEvent = segmentSubgroup.empty() || strcmp(subgroup.c_str(), segmentSubgroup.c_str()) != 0;
+                if (subgroupEvent) {
+                    segmentSubgroup = subgroup.c_str();
+                }
+            }
+        }
+
+        if (headerEvent || subgroupEvent) {
+            ChunkEvent event;
+            event.index = i;
+            event.hasHeader = headerEvent;
+            if (headerEvent) event.header = header.c_str();
+            if (hasSubgroups && subgroup.get_length() > 0) event.subgroup = subgroup.c_str();
+            chunk.events.push_back(std::move(event));
+        }
+
+        previousHeader = header;
+    }
+}
+
+} // namespace
+
+bool detectGroupsParallel(const metadb_handle_list& handles, t_size begin, t_size end,
+                          const GroupDetectionParams& params, GroupDetectionState& state,
+                          GroupDetectionResult& out, const DetectionCancelCheck& cancelled) {
+    end = std::min(end, handles.get_count());
+    if (begin >= end) return true;
+
+    t_size count = end - begin;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    if (count < kParallelMinItems || cores == 1) {
+        return detectGroupsSequential(handles, begin, end, params, state, out, cancelled);
+    }
+
+    // A few chunks per core so uneven formatting cost still balances
+    t_size chunkCount = std::min<t_size>((t_size)cores * 4, count / kMinChunkItems);
+    chunkCount = std::max<t_size>(chunkCount, 1);
+    return detectGroupsChunked(handles, begin, end, params, state, out, cancelled, chunkCount);
+}
+
+bool detectGroupsChunked(const metadb_handle_list& handles, t_size begin, t_size end,
+                         const GroupDetectionParams& params, GroupDetectionState& state,
+                         GroupDetectionResult& out, const DetectionCancelCheck& cancelled,
+                         t_size chunkCount) {
+    end = std::min(end, handles.get_count());
+    if (begin >= end) return true;
+
+    t_size count = end - begin;
+    chunkCount = std::max<t_size>(1, std::min(chunkCount, count));
+    t_size chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    std::vector<ChunkScan> chunks(chunkCount);
+    for (t_size c = 0; c < chunkCount; c++) {
+        chunks[c].begin = begin + c * chunkSize;
+        chunks[c].end = std::min(end, chunks[c].begin + chunkSize);
+    }
+
+    ParallelContext ctx{&handles, &params, &cancelled, &chunks};
+    dispatch_apply_f(chunkCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), &ctx, scanChunk);
+
+    for (const ChunkScan& chunk : chunks) {
+        if (chunk.cancelled) return false;
+    }
+
+    // Stitch: replay chunk events in order through the same detector logic.
+    // A group spanning a chunk edge merges because the edge event's header
+    // compares equal to the carried state.
+    bool hasSubgroups = params.subgroupScript.is_valid();
+    SubgroupDetector subgroupDetector(params.showFirstSubgroup, params.debug);
+    subgroupDetector.initFromState(state.currentSubgroup.c_str());
+
+    for (ChunkScan& chunk : chunks) {
+        for (ChunkEvent& event : chunk.events) {
+            bool isNewGroup = event.hasHeader &&
+                              (state.atPlaylistStart || event.header != state.currentHeader);
+            state.atPlaylistStart = false;
+
+            if (isNewGroup) {
+                out.groupStarts.push_back(event.index);
+                out.groupHeaders.push_back(event.header);
+                out.groupArtKeys.emplace_back(handles[event.index]->get_path());
+                state.currentHeader = std::move(event.header);
+                subgroupDetector.enterNewGroup();
+            }
+
+            if (hasSubgroups) {
+                subgroupDetector.shouldAddSubgroup(event.subgroup.c_str(), isNewGroup, event.index, out);
+            }
+        }
+    }
+    state.currentSubgroup = subgroupDetector.getCurrentSubgroup();
+    return true;
+}
+
+t_size findGroupStart(const metadb_handle_list& handles, t_size index, const GroupDetectionParams& params) {
+    t_size count = handles.get_count();
+    if (index == 0 || index >= count) return std::min(index, count);
+
+    pfc::string8 header;
+    pfc::string8 previous;
+    handles[index]->format_title(nullptr, header, params.headerScript, nullptr);
+    while (index > 0) {
+        handles[index - 1]->format_title(nullptr, previous, params.headerScript, nullptr);
+        if (strcmp(previous.c_str(), header.c_str()) != 0) break;
+        index--;
+    }
+    return index;
+}
+
+#pragma mark - Incremental re-detection
+
+IndexRuns indexRunsFromMask(const bit_array& mask, t_size count) {
+    IndexRuns runs;
+    t_size i = mask.find_first(true, 0, count);
+    while (i < count) {
+        t_size end = mask.find_first(false, i, count);
+        runs.push_back({i, end - i});
+        if (end >= count) break;
+        i = mask.find_first(true, end, count);
+    }
+    return runs;
+}
+
+t_size remapIndexForRemove(const IndexRuns& removed, t_size index) {
+    t_size removedBefore = 0;
+    for (const IndexRun& run : removed) {
+        if (run.start > index) break;
+        if (index < run.start + run.count) {
+            // Removed item - lands on the next survivor
+            return run.start - removedBefore;
+        }
+        removedBefore += run.count;
+    }
+    return index - removedBefore;
+}
+
+void remapModelForInsert(GroupDetectionResult& model, t_size base, t_size count, IndexRuns& dirty) {
+    auto shift = [base, count](std::vector<t_size>& starts) {
+        for (auto it = std::lower_bound(starts.begin(), starts.end(), base); it != starts.end(); ++it) {
+            *it += count;
+        }
+    };
+    shift(model.groupStarts);
+    shift(model.subgroupStarts);
+    dirty.push_back({base, count});
+}
+
+bool DeferredInserts::add(t_size insertBase, t_size insertCount, uint64_t serial) {
+    if (!open) return false;
+    if (count == 0) {
+        base = insertBase;
+    } else if (insertBase < base || insertBase > base + count) {
+        return false;
+    }
+    count += insertCount;
+    lastSerial = serial;
+    return true;
+}
+
+namespace {
+
+// Compact one start list (and its parallel string lists) after removal
+void removeFromStartList(std::vector<t_size>& starts,
+                         std::vector<std::string>* stringsA,
+                         std::vector<std::string>* stringsB,
+                         const IndexRuns& removed,
+                         std::vector<SpliceOp>& ops) {
+    size_t write = 0;
+    size_t runIndex = 0;
+    t_size removedBefore = 0;
+
+    for (size_t read = 0; read < starts.size(); read++) {
+        t_size index = starts[read];
+        while (runIndex < removed.size() && removed[runIndex].start + removed[runIndex].count <= index) {
+            removedBefore += removed[runIndex].count;
+            runIndex++;
+        }
+
+        if (runIndex < removed.size() && index >= removed[runIndex].start) {
+            // Boundary item was removed - drop the entry (coalesce adjacent drops)
+            if (!ops.empty() && ops.back().at == write && ops.back().insertCount == 0) {
+                ops.back().removeCount++;
+            } else {
+                ops.push_back({write, 1, 0});
+            }
+            continue;
+        }
+
+        starts[write] = index - removedBefore;
+        if (write != read) {
+            if (stringsA) (*stringsA)[write] = std::move((*stringsA)[read]);
+            if (stringsB) (*stringsB)[write] = std::move((*stringsB)[read]);
+        }
+        write++;
+    }
+
+    starts.resize(write);
+    if (stringsA) stringsA->resize(write);
+    if (stringsB) stringsB->resize(write);
+}
+
+// Splice fresh entries over [from, to) of a start list
+void spliceStartList(std::vector<t_size>& starts, std::vector<std::string>& stringsA,
+                     std::vector<std::string>* stringsB,
+                     size_t from, size_t to,
+                     std::vector<t_size>& freshStarts, std::vector<std::string>& freshA,
+                     std::vector<std::string>* freshB,
+                     std::vector<SpliceOp>& ops) {
+    if (from == to && freshStarts.empty()) return;
+
+    starts.erase(starts.begin() + from, starts.begin() + to);
+    starts.insert(starts.begin() + from, freshStarts.begin(), freshStarts.end());
+    stringsA.erase(stringsA.begin() + from, stringsA.begin() + to);
+    stringsA.insert(stringsA.begin() + from,
+                    std::make_move_iterator(freshA.begin()), std::make_move_iterator(freshA.end()));
+    if (stringsB && freshB) {
+        stringsB->erase(stringsB->begin() + from, stringsB->begin() + to);
+        stringsB->insert(stringsB->begin() + from,
+                         std::make_move_iterator(freshB->begin()), std::make_move_iterator(freshB->end()));
+    }
+    ops.push_back({from, to - from, freshStarts.size()});
+}
+
+// Sequential detection from group start s until the detector is back in sync
+// with the model: the first item at or after dirtyEnd where a fresh group
+// begins on an existing model group start. Returns that index (or itemCount).
+// If item s no longer starts a group (it now matches the previous header),
+// sets mergedIntoPrevious and returns s - the caller widens the window, since
+// the previous group's subgroup state is not part of the model.
+t_size detectWindow(const HandleAccessor& handleAt, t_size s, t_size dirtyEnd, t_size itemCount,
+                    const GroupDetectionParams& params, GroupDetectionState& state,
+                    const std::vector<t_size>& modelStarts, size_t startCursor,
+                    GroupDetectionResult& out, bool& mergedIntoPrevious) {
+    mergedIntoPrevious = false;
+    bool hasSubgroups = params.subgroupScript.is_valid();
+    SubgroupDetector subgroupDetector(params.showFirstSubgroup, params.debug);
+    subgroupDetector.initFromState(state.currentSubgroup.c_str());
+
+    pfc::string8 formattedHeader;
+    pfc::string8 formattedSubgroup;
+    size_t cursor = startCursor;
+
+    for (t_size i = s; i < itemCount; i++) {
+        metadb_handle_ptr handle = handleAt(i);
+        if (handle.is_valid()) {
+            handle->format_title(nullptr, formattedHeader, params.headerScript, nullptr);
+        } else {
+            formattedHeader.reset();
+        }
+
+        bool isNewGroup = state.atPlaylistStart ||
+                          strcmp(formattedHeader.c_str(), state.currentHeader.c_str()) != 0;
+        state.atPlaylistStart = false;
+
+        if (i == s && !isNewGroup && s > 0) {
+            mergedIntoPrevious = true;
+            return s;
+        }
+
+        if (isNewGroup && i >= dirtyEnd) {
+            while (cursor < modelStarts.size() && modelStarts[cursor] < i) cursor++;
+            if (cursor < modelStarts.size() && modelStarts[cursor] == i) {
+                return i;  // Model is valid again from here on
+            }
+        }
+
+        if (isNewGroup) {
+            out.groupStarts.push_back(i);
+            out.groupHeaders.emplace_back(formattedHeader.c_str());
+            out.groupArtKeys.emplace_back(handle.is_valid() ? handle->get_path() : "");
+            state.currentHeader = formattedHeader.c_str();
+            subgroupDetector.enterNewGroup();
+        }
+
+        if (hasSubgroups) {
+            if (handle.is_valid()) {
+                handle->format_title(nullptr, formattedSubgroup, params.subgroupScript, nullptr);
+            } else {
+                formattedSubgroup.reset();
+            }
+            subgroupDetector.shouldAddSubgroup(formattedSubgroup.c_str(), isNewGroup, i, out);
+        }
+    }
+    return itemCount;
+}
+
+} // namespace
+
+void remapModelForRemove(GroupDetectionResult& model, const IndexRuns& removed,
+                         IndexRuns& dirty, GroupSpliceLog& log) {
+    removeFromStartList(model.groupStarts, &model.groupHeaders, &model.groupArtKeys, removed, log.groups);
+    removeFromStartList(model.subgroupStarts, &model.subgroupHeaders, nullptr, removed, log.subgroups);
+
+    t_size removedBefore = 0;
+    for (const IndexRun& run : removed) {
+        dirty.push_back({run.start - removedBefore, 0});
+        removedBefore += run.count;
+    }
+}
+
+t_size redetectDirtyRanges(GroupDetectionResult& model, t_size itemCount, const IndexRuns& dirty,
+                           const GroupDetectionParams& params, const HandleAccessor& handleAt,
+                           GroupSpliceLog& log) {
+    t_size formatted = 0;
+    t_size coveredUpTo = 0;
+    bool covered = false;
+
+    for (const IndexRun& run : dirty) {
+        t_size d0 = run.start;
+        if (d0 >= itemCount) continue;  // Tail removal - nothing after it to recheck
+        t_size d1 = std::min(run.start + run.count, itemCount);
+
+        // Already re-detected by the previous window
+        if (covered && d1 <= coveredUpTo) continue;
+        if (covered && d0 < coveredUpTo) d0 = coveredUpTo;
+
+        // Window starts at the group containing d0 - 1: everything before it is unchanged
+        auto& starts = model.groupStarts;
+        t_size s = 0;
+        if (d0 > 0) {
+            auto it = std::upper_bound(starts.begin(), starts.end(), d0 - 1);
+            if (it != starts.begin()) s = *(it - 1);
+        }
+        size_t groupFrom = std::lower_bound(starts.begin(), starts.end(), s) - starts.begin();
+
+        GroupDetectionResult fresh;
+        t_size resync = s;
+        for (;;) {
+            GroupDetectionState state;
+            state.atPlaylistStart = (s == 0);
+            if (groupFrom > 0) state.currentHeader = model.groupHeaders[groupFrom - 1];
+
+            bool merged = false;
+            fresh = GroupDetectionResult();
+            resync = detectWindow(handleAt, s, d1, itemCount, params, state, starts, groupFrom,
+                                  fresh, merged);
+            formatted += resync - s + (merged ? 1 : 0);
+            if (!merged || groupFrom == 0) break;
+
+            // Edit joined two groups - restart from the previous group's start
+            groupFrom--;
+            s = starts[groupFrom];
+        }
+
+        size_t groupTo = std::lower_bound(starts.begin(), starts.end(), resync) - starts.begin();
+        spliceStartList(model.groupStarts, model.groupHeaders, &model.groupArtKeys,
+                        groupFrom, groupTo,
+                        fresh.groupStarts, fresh.groupHeaders, &fresh.groupArtKeys, log.groups);
+
+        auto& subStarts = model.subgroupStarts;
+        size_t subFrom = std::lower_bound(subStarts.begin(), subStarts.end(), s) - subStarts.begin();
+        size_t subTo = std::lower_bound(subStarts.begin(), subStarts.end(), resync) - subStarts.begin();
+        spliceStartList(model.subgroupStarts, model.subgroupHeaders, nullptr,
+                        subFrom, subTo,
+                        fresh.subgroupStarts, fresh.subgroupHeaders, nullptr, log.subgroups);
+
+        covered = true;
+        coveredUpTo = resync;
+    }
+    return formatted;
+}
+
+} // namespace simplaylist
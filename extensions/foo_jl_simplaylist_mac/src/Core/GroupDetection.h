@@ -0,0 +1,192 @@
+//
+//  GroupDetection.h
+//  foo_simplaylist_mac
+//
+//  Group / subgroup boundary detection over a handle list.
+//  The sequential detector is the reference; the parallel detector formats
+//  chunks concurrently and replays the chunk edge events through the same
+//  SubgroupDetector, so its output is identical.
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace simplaylist {
+
+// Raw detection output (before single-subgroup filtering and padding)
+struct GroupDetectionResult {
+    std::vector<t_size> groupStarts;
+    std::vector<std::string> groupHeaders;
+    std::vector<std::string> groupArtKeys;  // Path of first track in group
+    std::vector<t_size> subgroupStarts;
+    std::vector<std::string> subgroupHeaders;
+
+    bool operator==(const GroupDetectionResult& other) const {
+        return groupStarts == other.groupStarts && groupHeaders == other.groupHeaders &&
+               groupArtKeys == other.groupArtKeys && subgroupStarts == other.subgroupStarts &&
+               subgroupHeaders == other.subgroupHeaders;
+    }
+};
+
+// Detector state carried across partial runs (sync prefix -> background continuation)
+struct GroupDetectionState {
+    std::string currentHeader;
+    std::string currentSubgroup;
+    bool atPlaylistStart = true;  // First item always starts a group
+};
+
+struct GroupDetectionParams {
+    titleformat_object::ptr headerScript;
+    titleformat_object::ptr subgroupScript;  // Empty = no subgroups
+    bool showFirstSubgroup = true;
+    bool debug = false;  // Log subgroup decisions to /tmp/simplaylist_subgroup_debug.txt
+};
+
+// Returns true when detection should stop (stale generation)
+using DetectionCancelCheck = std::function<bool()>;
+
+// =============================================================================
+// SUBGROUP DETECTION HELPER
+// =============================================================================
+// Encapsulates subgroup detection logic to ensure all code paths use IDENTICAL logic.
+// This eliminates bugs where one path is fixed but another isn't.
+
+class SubgroupDetector {
+public:
+    explicit SubgroupDetector(bool showFirst, bool enableDebug = false);
+    ~SubgroupDetector();
+
+    SubgroupDetector(const SubgroupDetector&) = delete;
+    SubgroupDetector& operator=(const SubgroupDetector&) = delete;
+
+    // Initialize from existing state (for continuation from partial detection)
+    void initFromState(const char* existingSubgroup);
+
+    // Call when entering a new group - clears subgroup tracking
+    void enterNewGroup();
+
+    // Check if a subgroup header should be added for this track
+    // Returns: true if subgroup header was added to out
+    // Updates: currentSubgroup tracking state
+    bool shouldAddSubgroup(const char* formattedSubgroup, bool isNewGroup,
+                           t_size playlistIndex, GroupDetectionResult& out);
+
+    // Get current subgroup value (for passing to continuation)
+    const std::string& getCurrentSubgroup() const { return m_currentSubgroup; }
+
+private:
+    std::string m_currentSubgroup;  // Tracks the current subgroup value
+    bool m_showFirstSubgroup;       // Config setting
+    FILE* m_debugFile = nullptr;
+};
+
+// Sequential reference: detect [begin, end), continuing from state.
+// Appends to out and updates state. Returns false if cancelled.
+bool detectGroupsSequential(const metadb_handle_list& handles, t_size begin, t_size end,
+                            const GroupDetectionParams& params, GroupDetectionState& state,
+                            GroupDetectionResult& out, const DetectionCancelCheck& cancelled);
+
+// Parallel: formats chunks of [begin, end) across cores, then stitches chunk
+// edges sequentially. Same contract and identical output as the sequential version.
+bool detectGroupsParallel(const metadb_handle_list& handles, t_size begin, t_size end,
+                          const GroupDetectionParams& params, GroupDetectionState& state,
+                          GroupDetectionResult& out, const DetectionCancelCheck& cancelled);
+
+// The parallel detector with an explicit chunk count: [begin, end) is split
+// into chunkCount chunks of ceil(count / chunkCount) items (the last may be
+// shorter). detectGroupsParallel picks the count from the core count.
+bool detectGroupsChunked(const metadb_handle_list& handles, t_size begin, t_size end,
+                         const GroupDetectionParams& params, GroupDetectionState& state,
+                         GroupDetectionResult& out, const DetectionCancelCheck& cancelled,
+                         t_size chunkCount);
+
+// First item of the group containing index (headers only, scanning backward).
+// Detecting from there with a fresh state gives the same groups as a detection
+// from 0, so a window can be detected without its prefix.
+t_size findGroupStart(const metadb_handle_list& handles, t_size index, const GroupDetectionParams& params);
+
+// =============================================================================
+// INCREMENTAL RE-DETECTION
+// =============================================================================
+// A complete detection result is kept as the model. An edit first remaps the
+// model's indices into the post-edit index space, then only the items between
+// the group containing each dirty range and the next surviving group boundary
+// are re-formatted and spliced back in.
+
+struct IndexRun {
+    t_size start;
+    t_size count;
+};
+using IndexRuns = std::vector<IndexRun>;
+
+// Contiguous runs of set bits in mask over [0, count)
+IndexRuns indexRunsFromMask(const bit_array& mask, t_size count);
+
+// New index of an item after removing runs (removed items map to the next survivor)
+t_size remapIndexForRemove(const IndexRuns& removed, t_size index);
+
+// Splice operations applied to the model, in order - lets callers mirror the
+// change into their own per-group arrays without rebuilding them.
+struct SpliceOp {
+    size_t at;           // Position in the group (or subgroup) list
+    size_t removeCount;
+    size_t insertCount;  // Inserted entries are model[at, at + insertCount) after all ops
+};
+
+struct GroupSpliceLog {
+    std::vector<SpliceOp> groups;
+    std::vector<SpliceOp> subgroups;
+};
+
+// Shift indices for count items inserted at base. Appends the dirty range.
+void remapModelForInsert(GroupDetectionResult& model, t_size base, t_size count, IndexRuns& dirty);
+
+// Inserts that arrive while background detection is still building the model,
+// replayed with remapModelForInsert once it completes. Streaming import
+// batches land inside or right after the ones before, so they merge into one
+// block; an insert anywhere else can't be replayed and the caller rebuilds.
+struct DeferredInserts {
+    bool open = false;  // Detection pending - inserts are collected
+    t_size base = 0;
+    t_size count = 0;   // 0 = nothing collected yet
+    uint64_t lastSerial = 0;
+
+    // Merge count items inserted at base; false when closed or outside the block
+    bool add(t_size insertBase, t_size insertCount, uint64_t serial);
+    void reset() { *this = DeferredInserts(); }
+};
+
+// Where a streaming import puts its next batch: right after the batches before
+// it. Edits other code makes to the target playlist meanwhile move that point;
+// after a reorder there is no such point any more and the rest is appended.
+struct ImportInsertPoint {
+    t_size index = SIZE_MAX;  // SIZE_MAX = append
+
+    // Items inserted at our point go after our batches, so they don't move it
+    void itemsInserted(t_size base, t_size count) {
+        if (index != SIZE_MAX && base < index) index += count;
+    }
+    void itemsRemoved(const IndexRuns& removed) {
+        if (index != SIZE_MAX) index = remapIndexForRemove(removed, index);
+    }
+    void itemsReordered() { index = SIZE_MAX; }
+};
+
+// Drop entries for removed items and shift the rest. Appends an (empty)
+// dirty range at each removal point so the items that became adjacent are rechecked.
+void remapModelForRemove(GroupDetectionResult& model, const IndexRuns& removed,
+                         IndexRuns& dirty, GroupSpliceLog& log);
+
+using HandleAccessor = std::function<metadb_handle_ptr(t_size)>;
+
+// Re-detect around dirty ranges (post-edit indices, ascending) and splice the
+// fresh groups into the model. Returns the number of items re-formatted.
+t_size redetectDirtyRanges(GroupDetectionResult& model, t_size itemCount, const IndexRuns& dirty,
+                           const GroupDetectionParams& params, const HandleAccessor& handleAt,
+                           GroupSpliceLog& log);
+
+} // namespace simplaylist
@@ -0,0 +1,55 @@
+//
+//  GroupEstimate.cpp
+//  foo_simplaylist_mac
+//
+
+#include "GroupEstimate.h"
+#include <algorithm>
+#include <cmath>
+
+namespace simplaylist {
+
+GroupEstimate measureGroups(const GroupDetectionResult& detected, t_size begin, t_size end) {
+    GroupEstimate estimate;
+    const std::vector<t_size>& starts = detected.groupStarts;
+    auto first = std::lower_bound(starts.begin(), starts.end(), begin);
+    auto last = std::lower_bound(first, starts.end(), end);
+    size_t groups = (size_t)(last - first);
+    if (groups == 0) return estimate;
+
+    // Complete groups end where the next one starts
+    t_size measuredEnd = groups > 1 ? *(last - 1) : end;
+    if (groups > 1) groups--;
+
+    const std::vector<t_size>& subgroups = detected.subgroupStarts;
+    size_t subgroupCount = (size_t)(std::lower_bound(subgroups.begin(), subgroups.end(), measuredEnd) -
+                                    std::lower_bound(subgroups.begin(), subgroups.end(), *first));
+
+    estimate.itemsPerGroup = (double)(measuredEnd - *first) / (double)groups;
+    estimate.subgroupsPerGroup = (double)subgroupCount / (double)groups;
+    return estimate;
+}
+
+void appendEstimatedGroups(GroupDetectionResult& out, t_size begin, t_size end, const GroupEstimate& estimate) {
+    if (begin >= end) return;
+    t_size count = end - begin;
+    double itemsPerGroup = std::max(1.0, estimate.itemsPerGroup > 0 ? estimate.itemsPerGroup : (double)count);
+    t_size groups = std::min<t_size>(count, std::max<t_size>(1, (t_size)llround((double)count / itemsPerGroup)));
+
+    for (t_size g = 0; g < groups; g++) {
+        t_size groupBegin = begin + g * count / groups;
+        t_size groupEnd = begin + (g + 1) * count / groups;
+        out.groupStarts.push_back(groupBegin);
+        out.groupHeaders.emplace_back();
+        out.groupArtKeys.emplace_back();
+
+        t_size groupItems = groupEnd - groupBegin;
+        t_size subgroups = std::min<t_size>((t_size)llround(estimate.subgroupsPerGroup), groupItems);
+        for (t_size s = 0; s < subgroups; s++) {
+            out.subgroupStarts.push_back(groupBegin + s * groupItems / subgroups);
+            out.subgroupHeaders.emplace_back();
+        }
+    }
+}
+
+} // namespace simplaylist
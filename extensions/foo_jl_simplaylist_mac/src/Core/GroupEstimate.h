@@ -0,0 +1,30 @@
+//
+//  GroupEstimate.h
+//  foo_simplaylist_mac
+//
+//  Placeholder groups for items whose groups are not detected yet. They are
+//  sized from the groups detected so far, so the rows they take up (headers,
+//  subgroup rows, padding) roughly match what full detection will produce
+//  and the anchor row moves little when the real groups replace them.
+//  Placeholders have empty headers and art keys.
+//
+
+#pragma once
+#include "GroupDetection.h"
+
+namespace simplaylist {
+
+struct GroupEstimate {
+    double itemsPerGroup = 0;      // 0 = nothing measured
+    double subgroupsPerGroup = 0;
+};
+
+// Averages over the complete groups of detected that start in [begin, end).
+// The group reaching end may continue past it, so it only counts when it is
+// the only one.
+GroupEstimate measureGroups(const GroupDetectionResult& detected, t_size begin, t_size end);
+
+// Append evenly sized placeholder groups covering [begin, end)
+void appendEstimatedGroups(GroupDetectionResult& out, t_size begin, t_size end, const GroupEstimate& estimate);
+
+} // namespace simplaylist
@@ -0,0 +1,145 @@
+//
+//  GroupIndex.cpp
+//  foo_simplaylist_mac
+//
+
+#include "GroupIndex.h"
+#include <algorithm>
+
+namespace simplaylist {
+
+void GroupIndex::assign(std::vector<int64_t> groupStarts,
+                        std::vector<int64_t> subgroupStarts,
+                        std::vector<int32_t> paddingRows) {
+    m_groupStarts = std::move(groupStarts);
+    m_subgroupStarts = std::move(subgroupStarts);
+    m_paddingRows = std::move(paddingRows);
+    if (m_groupStarts.empty()) m_subgroupStarts.clear();
+    rebuildDerived();
+}
+
+void GroupIndex::clear() {
+    m_groupStarts.clear();
+    m_subgroupStarts.clear();
+    m_paddingRows.clear();
+    rebuildDerived();
+}
+
+void GroupIndex::setHeaderRowsPerGroup(int32_t rows) {
+    if (rows == m_headerRows) return;
+    m_headerRows = rows;
+    rebuildDerived();
+}
+
+void GroupIndex::rebuildDerived() {
+    const size_t groupCount = m_groupStarts.size();
+    const size_t subgroupCount = m_subgroupStarts.size();
+
+    m_groupRows.resize(groupCount);
+    m_paddingBefore.resize(groupCount + 1);
+    m_firstSubgroup.resize(groupCount + 1);
+    m_subgroupRows.resize(subgroupCount);
+
+    // Subgroups belong to the group containing their start (a subgroup at the
+    // group's first track counts for that group) - one merge pass over both lists
+    int64_t padding = 0;
+    size_t s = 0;
+    for (size_t g = 0; g < groupCount; g++) {
+        while (s < subgroupCount && m_subgroupStarts[s] < m_groupStarts[g]) s++;
+        m_paddingBefore[g] = padding;
+        m_firstSubgroup[g] = (int64_t)s;
+        m_groupRows[g] = m_groupStarts[g] + (int64_t)g * m_headerRows + (int64_t)s + padding;
+        padding += paddingRows(g);
+    }
+    m_paddingBefore[groupCount] = padding;
+    m_firstSubgroup[groupCount] = (int64_t)subgroupCount;
+
+    // Subgroup header k sits before its first track: every earlier subgroup
+    // header and the headers/padding of its own and earlier groups come first
+    size_t g = 0;
+    for (size_t k = 0; k < subgroupCount; k++) {
+        while (g + 1 < groupCount && m_groupStarts[g + 1] <= m_subgroupStarts[k]) g++;
+        m_subgroupRows[k] = m_subgroupStarts[k] + (int64_t)(g + 1) * m_headerRows +
+                            (int64_t)k + m_paddingBefore[g];
+    }
+}
+
+int64_t GroupIndex::rowCount() const {
+    if (m_groupStarts.empty()) return m_itemCount;
+    return m_itemCount + (int64_t)m_groupStarts.size() * m_headerRows +
+           (int64_t)m_subgroupStarts.size() + m_paddingBefore.back();
+}
+
+int64_t GroupIndex::groupForRow(int64_t row) const {
+    if (m_groupStarts.empty() || row < 0) return -1;
+    // Last group whose first row is <= row
+    auto it = std::upper_bound(m_groupRows.begin(), m_groupRows.end(), row);
+    if (it == m_groupRows.begin()) return 0;
+    return (int64_t)(it - m_groupRows.begin()) - 1;
+}
+
+int64_t GroupIndex::groupForPlaylistIndex(int64_t playlistIndex) const {
+    if (m_groupStarts.empty() || playlistIndex < 0) return -1;
+    auto it = std::upper_bound(m_groupStarts.begin(), m_groupStarts.end(), playlistIndex);
+    if (it == m_groupStarts.begin()) return 0;
+    return (int64_t)(it - m_groupStarts.begin()) - 1;
+}
+
+int64_t GroupIndex::rowForPlaylistIndex(int64_t playlistIndex) const {
+    if (playlistIndex < 0 || playlistIndex >= m_itemCount) return -1;
+    if (m_groupStarts.empty()) return playlistIndex;
+
+    size_t g = (size_t)groupForPlaylistIndex(playlistIndex);
+    // Subgroup headers at or before this track (a subgroup starting here is drawn above it)
+    int64_t subgroupsBefore = std::upper_bound(m_subgroupStarts.begin(), m_subgroupStarts.end(),
+                                               playlistIndex) - m_subgroupStarts.begin();
+    return playlistIndex + (int64_t)(g + 1) * m_headerRows + subgroupsBefore + m_paddingBefore[g];
+}
+
+GroupIndex::RowKind GroupIndex::kindOfRow(int64_t row, int64_t* outIndex) const {
+    if (outIndex) *outIndex = -1;
+    if (row < 0 || row >= rowCount()) return RowKind::Invalid;
+
+    if (m_groupStarts.empty()) {
+        if (outIndex) *outIndex = row;
+        return RowKind::Track;
+    }
+
+    size_t g = (size_t)groupForRow(row);
+    int64_t firstRow = m_groupRows[g];
+    if (row < firstRow + m_headerRows) {
+        if (outIndex) *outIndex = (int64_t)g;
+        return RowKind::GroupHeader;
+    }
+
+    // Subgroup headers of this group at or before row
+    auto groupSubBegin = m_subgroupRows.begin() + m_firstSubgroup[g];
+    auto groupSubEnd = m_subgroupRows.begin() + m_firstSubgroup[g + 1];
+    auto it = std::upper_bound(groupSubBegin, groupSubEnd, row);
+    if (it != groupSubBegin && *(it - 1) == row) {
+        if (outIndex) *outIndex = (int64_t)(it - 1 - m_subgroupRows.begin());
+        return RowKind::SubgroupHeader;
+    }
+
+    int64_t position = row - firstRow - m_headerRows - (int64_t)(it - groupSubBegin);
+    int64_t trackCount = groupEnd(g) - groupStart(g);
+    if (position >= trackCount) {
+        if (outIndex) *outIndex = (int64_t)g;
+        return RowKind::Padding;
+    }
+
+    if (outIndex) *outIndex = groupStart(g) + position;
+    return RowKind::Track;
+}
+
+int64_t GroupIndex::playlistIndexForRow(int64_t row) const {
+    int64_t index;
+    return kindOfRow(row, &index) == RowKind::Track ? index : -1;
+}
+
+int64_t GroupIndex::subgroupForRow(int64_t row) const {
+    int64_t index;
+    return kindOfRow(row, &index) == RowKind::SubgroupHeader ? index : -1;
+}
+
+} // namespace simplaylist
@@ -0,0 +1,100 @@
+//
+//  GroupIndex.h
+//  foo_simplaylist_mac
+//
+//  Row <-> playlist index mapping for the sparse group model.
+//  Struct-of-arrays over contiguous integer vectors with prefix sums:
+//  every lookup is a binary search or direct read, no boxing.
+//  Plain C++ (no SDK / Cocoa dependency).
+//
+//  Row layout of group g:
+//    [header row]          - absent when headerRowsPerGroup == 0 (style 3)
+//    tracks, each subgroup header directly before its first track
+//    [padding rows]        - extra rows so album art fits
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace simplaylist {
+
+class GroupIndex {
+public:
+    enum class RowKind {
+        Invalid,
+        Track,           // index = playlist index
+        GroupHeader,     // index = group index
+        SubgroupHeader,  // index = subgroup index
+        Padding          // index = group index
+    };
+
+    // Replace the layout. Starts must be ascending; paddingRows has one entry
+    // per group (or is empty for no padding). Subgroups are ignored without groups.
+    void assign(std::vector<int64_t> groupStarts,
+                std::vector<int64_t> subgroupStarts,
+                std::vector<int32_t> paddingRows);
+    void clear();
+
+    // Item count only affects the last group's extent - O(1)
+    void setItemCount(int64_t itemCount) { m_itemCount = itemCount; }
+    int64_t itemCount() const { return m_itemCount; }
+
+    // 1 = each group has a header row, 0 = header drawn in the group column
+    void setHeaderRowsPerGroup(int32_t rows);
+    int32_t headerRowsPerGroup() const { return m_headerRows; }
+
+    size_t groupCount() const { return m_groupStarts.size(); }
+    size_t subgroupCount() const { return m_subgroupStarts.size(); }
+    bool empty() const { return m_groupStarts.empty(); }
+
+    // Total display rows: items + group headers + subgroup headers + padding
+    int64_t rowCount() const;
+
+    // Per-group accessors (g must be < groupCount())
+    int64_t groupStart(size_t g) const { return m_groupStarts[g]; }
+    int64_t groupEnd(size_t g) const {
+        return (g + 1 < m_groupStarts.size()) ? m_groupStarts[g + 1] : m_itemCount;
+    }
+    int32_t paddingRows(size_t g) const { return g < m_paddingRows.size() ? m_paddingRows[g] : 0; }
+    int32_t subgroupCountInGroup(size_t g) const {
+        return (int32_t)(m_firstSubgroup[g + 1] - m_firstSubgroup[g]);
+    }
+    int64_t totalRowsInGroup(size_t g) const {
+        return m_headerRows + subgroupCountInGroup(g) + (groupEnd(g) - groupStart(g)) + paddingRows(g);
+    }
+    // First row of the group (header row, or first content row without headers)
+    int64_t firstRowOfGroup(size_t g) const { return m_groupRows[g]; }
+    int64_t subgroupStart(size_t s) const { return m_subgroupStarts[s]; }
+    int64_t subgroupRow(size_t s) const { return m_subgroupRows[s]; }
+
+    // Lookups - return -1 when out of range
+    int64_t groupForRow(int64_t row) const;
+    int64_t groupForPlaylistIndex(int64_t playlistIndex) const;
+    int64_t rowForPlaylistIndex(int64_t playlistIndex) const;
+    int64_t playlistIndexForRow(int64_t row) const;  // -1 for header/padding rows
+    int64_t subgroupForRow(int64_t row) const;       // -1 unless a subgroup header row
+
+    // Classify a row; outIndex receives the playlist / group / subgroup index
+    RowKind kindOfRow(int64_t row, int64_t* outIndex = nullptr) const;
+
+private:
+    void rebuildDerived();
+
+    int64_t m_itemCount = 0;
+    int32_t m_headerRows = 1;
+
+    // Source data
+    std::vector<int64_t> m_groupStarts;
+    std::vector<int64_t> m_subgroupStarts;
+    std::vector<int32_t> m_paddingRows;
+
+    // Derived (prefix sums)
+    std::vector<int64_t> m_groupRows;      // First row of each group
+    std::vector<int64_t> m_paddingBefore;  // Padding rows before each group (size G + 1)
+    std::vector<int64_t> m_firstSubgroup;  // First subgroup index of each group (size G + 1)
+    std::vector<int64_t> m_subgroupRows;   // Row of each subgroup header (ascending)
+};
+
+} // namespace simplaylist
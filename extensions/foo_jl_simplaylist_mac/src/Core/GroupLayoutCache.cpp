@@ -0,0 +1,78 @@
+//
+//  GroupLayoutCache.cpp
+//  foo_simplaylist_mac
+//
+
+#include "GroupLayoutCache.h"
+#include <cstring>
+
+namespace simplaylist {
+
+PlaylistFingerprint fingerprintHandles(const metadb_handle_list& handles) {
+    // FNV-1a over pointer values
+    PlaylistFingerprint fingerprint;
+    fingerprint.itemCount = handles.get_count();
+    uint64_t hash = 14695981039346656037ULL;
+    for (t_size i = 0; i < fingerprint.itemCount; i++) {
+        hash ^= (uint64_t)(uintptr_t)handles[i].get_ptr();
+        hash *= 1099511628211ULL;
+    }
+    fingerprint.hash = hash;
+    return fingerprint;
+}
+
+GroupLayoutCache& GroupLayoutCache::instance() {
+    static GroupLayoutCache cache;
+    return cache;
+}
+
+std::string GroupLayoutCache::keyForPlaylist(t_size playlist, const std::string& groupingKey) {
+    playlist_manager_v5::ptr pm5;
+    if (!playlist_manager::get()->service_query_t(pm5)) return std::string();
+
+    GUID guid = pm5->playlist_get_guid(playlist);
+    if (guid == pfc::guid_null) return std::string();
+
+    std::string key(reinterpret_cast<const char*>(&guid), sizeof(guid));
+    key += groupingKey;
+    return key;
+}
+
+std::shared_ptr<const GroupDetectionResult> GroupLayoutCache::lookup(const std::string& key,
+                                                                     const PlaylistFingerprint& fingerprint) {
+    if (key.empty()) return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->key != key) continue;
+        if (!(it->fingerprint == fingerprint)) {
+            m_entries.erase(it);  // Playlist changed while not displayed
+            return nullptr;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        return m_entries.front().result;
+    }
+    return nullptr;
+}
+
+void GroupLayoutCache::store(const std::string& key, const PlaylistFingerprint& fingerprint,
+                             std::shared_ptr<const GroupDetectionResult> result) {
+    if (key.empty() || !result) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->key == key) {
+            m_entries.erase(it);
+            break;
+        }
+    }
+    m_entries.push_front({key, fingerprint, std::move(result)});
+    if (m_entries.size() > kMaxEntries) m_entries.pop_back();
+}
+
+void GroupLayoutCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+} // namespace simplaylist
@@ -0,0 +1,68 @@
+//
+//  GroupLayoutCache.h
+//  foo_simplaylist_mac
+//
+//  Remembers complete group detection results per playlist so switching back
+//  to a playlist can show the grouped view immediately.
+//  Keyed by playlist GUID + grouping patterns; an entry is only returned when
+//  the playlist content fingerprint (item count + hash of handle pointers)
+//  still matches. Shared by all SimPlaylist instances, bounded LRU.
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include "GroupDetection.h"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace simplaylist {
+
+struct PlaylistFingerprint {
+    t_size itemCount = 0;
+    uint64_t hash = 0;
+
+    bool operator==(const PlaylistFingerprint& other) const {
+        return itemCount == other.itemCount && hash == other.hash;
+    }
+};
+
+// Rolling hash of handle pointers - metadb handles are unique per location
+// for the session, so equal fingerprints mean the same items in the same order
+PlaylistFingerprint fingerprintHandles(const metadb_handle_list& handles);
+
+class GroupLayoutCache {
+public:
+    // Playlists remembered (most recently stored first)
+    static constexpr size_t kMaxEntries = 16;
+
+    static GroupLayoutCache& instance();
+
+    // Cache key for a playlist and grouping configuration.
+    // Returns empty when the playlist has no GUID (older hosts) - caching is skipped.
+    static std::string keyForPlaylist(t_size playlist, const std::string& groupingKey);
+
+    // Returns the stored result when key and fingerprint match, else nullptr
+    std::shared_ptr<const GroupDetectionResult> lookup(const std::string& key,
+                                                       const PlaylistFingerprint& fingerprint);
+
+    void store(const std::string& key, const PlaylistFingerprint& fingerprint,
+               std::shared_ptr<const GroupDetectionResult> result);
+
+    void clear();
+
+private:
+    GroupLayoutCache() = default;
+
+    struct Entry {
+        std::string key;
+        PlaylistFingerprint fingerprint;
+        std::shared_ptr<const GroupDetectionResult> result;
+    };
+
+    std::list<Entry> m_entries;  // Front = most recent
+    std::mutex m_mutex;
+};
+
+} // namespace simplaylist
@@ -0,0 +1,67 @@
+//
+//  ImportQueue.cpp
+//  foo_simplaylist_mac
+//
+
+#include "ImportQueue.h"
+#include <algorithm>
+#include <iterator>
+
+namespace simplaylist {
+
+void ImportQueue::add(std::vector<std::string> locations) {
+    release(locations);
+}
+
+void ImportQueue::setUnitCount(size_t count) {
+    m_unitLocations.assign(count, {});
+    m_unitDone.assign(count, false);
+    m_nextUnit = 0;
+    m_enumerating = count > 0;
+}
+
+void ImportQueue::unitFinished(size_t unit, std::vector<std::string> locations) {
+    if (unit >= m_unitDone.size() || m_unitDone[unit]) return;
+    m_unitLocations[unit] = std::move(locations);
+    m_unitDone[unit] = true;
+
+    while (m_nextUnit < m_unitDone.size() && m_unitDone[m_nextUnit]) {
+        release(m_unitLocations[m_nextUnit]);
+        std::vector<std::string>().swap(m_unitLocations[m_nextUnit]);
+        m_nextUnit++;
+    }
+    if (m_nextUnit == m_unitDone.size()) m_enumerating = false;
+}
+
+std::vector<std::string> ImportQueue::nextBatch() {
+    std::vector<std::string> batch;
+    size_t available = pendingCount();
+    if (available == 0 || (available < m_batchSize && m_enumerating)) return batch;
+
+    size_t count = std::min(available, m_batchSize);
+    auto first = m_pending.begin() + (std::ptrdiff_t)m_cursor;
+    batch.assign(std::make_move_iterator(first), std::make_move_iterator(first + (std::ptrdiff_t)count));
+    m_cursor += count;
+    if (m_cursor == m_pending.size()) {
+        m_pending.clear();
+        m_cursor = 0;
+    }
+    return batch;
+}
+
+void ImportQueue::clear() {
+    std::vector<std::string>().swap(m_pending);
+    m_cursor = 0;
+    m_unitLocations.clear();
+    m_unitDone.clear();
+    m_nextUnit = 0;
+    m_enumerating = false;
+}
+
+void ImportQueue::release(std::vector<std::string>& locations) {
+    m_found += locations.size();
+    m_pending.insert(m_pending.end(), std::make_move_iterator(locations.begin()),
+                     std::make_move_iterator(locations.end()));
+}
+
+} // namespace simplaylist
@@ -0,0 +1,61 @@
+//
+//  ImportQueue.h
+//  foo_simplaylist_mac
+//
+//  Locations of a streaming import in drop order. Folder walk units finish in
+//  any order but are released in order; released locations are handed out in
+//  batches, and only full batches while units are still being walked.
+//  Plain C++ (no SDK / Cocoa dependency) - StreamingImport does the walking
+//  and the SDK calls.
+//
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace simplaylist {
+
+class ImportQueue {
+public:
+    explicit ImportQueue(size_t batchSize) : m_batchSize(batchSize) {}
+
+    // Locations known up front, released immediately
+    void add(std::vector<std::string> locations);
+
+    // Folder walk started; unit count not known yet
+    void beginUnits() { m_enumerating = true; }
+    // Walk units to wait for (0 = nothing to walk)
+    void setUnitCount(size_t count);
+    // A unit's locations; released once every earlier unit has finished
+    void unitFinished(size_t unit, std::vector<std::string> locations);
+
+    bool enumerating() const { return m_enumerating; }
+    size_t locationsFound() const { return m_found; }
+    size_t pendingCount() const { return m_pending.size() - m_cursor; }
+
+    // Nothing left to hand out and no unit outstanding
+    bool drained() const { return !m_enumerating && pendingCount() == 0; }
+
+    // Next batch in drop order; empty while a full batch isn't ready
+    std::vector<std::string> nextBatch();
+
+    void clear();
+
+private:
+    void release(std::vector<std::string>& locations);
+
+    size_t m_batchSize;
+    bool m_enumerating = false;
+    size_t m_found = 0;
+
+    // Released locations, handed out from m_cursor
+    std::vector<std::string> m_pending;
+    size_t m_cursor = 0;
+
+    std::vector<std::vector<std::string>> m_unitLocations;
+    std::vector<bool> m_unitDone;
+    size_t m_nextUnit = 0;
+};
+
+} // namespace simplaylist
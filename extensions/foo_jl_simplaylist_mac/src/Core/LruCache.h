@@ -0,0 +1,87 @@
+//
+//  LruCache.h
+//  foo_simplaylist_mac
+//
+//  Bounded least-recently-used map: hash lookup + recency list, O(1) per
+//  operation. Not thread-safe - callers hold their own lock.
+//
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace simplaylist {
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity = 1024) : m_capacity(capacity ? capacity : 1) {}
+
+    // Value for key (marks it most recently used), nullptr if absent.
+    // The pointer is valid until the next mutating call.
+    Value* get(const Key& key) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return nullptr;
+        m_order.splice(m_order.begin(), m_order, it->second);
+        return &it->second->second;
+    }
+
+    // Lookup without changing recency
+    const Value* peek(const Key& key) const {
+        auto it = m_index.find(key);
+        return it == m_index.end() ? nullptr : &it->second->second;
+    }
+
+    // Insert or replace; evicts the least recently used entry when full
+    void put(const Key& key, Value value) {
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            it->second->second = std::move(value);
+            m_order.splice(m_order.begin(), m_order, it->second);
+            return;
+        }
+        if (m_order.size() >= m_capacity) {
+            m_index.erase(m_order.back().first);
+            m_order.pop_back();
+        }
+        m_order.emplace_front(key, std::move(value));
+        m_index.emplace(key, m_order.begin());
+    }
+
+    bool erase(const Key& key) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return false;
+        m_order.erase(it->second);
+        m_index.erase(it);
+        return true;
+    }
+
+    void clear() {
+        m_index.clear();
+        m_order.clear();
+    }
+
+    size_t size() const { return m_order.size(); }
+    size_t capacity() const { return m_capacity; }
+
+    // Shrinking evicts least recently used entries
+    void setCapacity(size_t capacity) {
+        m_capacity = capacity ? capacity : 1;
+        while (m_order.size() > m_capacity) {
+            m_index.erase(m_order.back().first);
+            m_order.pop_back();
+        }
+    }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    size_t m_capacity;
+    std::list<Entry> m_order;  // Front = most recent
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> m_index;
+};
+
+} // namespace simplaylist
@@ -0,0 +1,126 @@
+//
+//  PlaylistFormatContext.cpp
+//  foo_simplaylist_mac
+//
+
+#include "PlaylistFormatContext.h"
+#include <algorithm>
+
+namespace simplaylist {
+
+namespace {
+
+// Field names are case-insensitive; name is not null-terminated
+bool fieldIs(const char* name, t_size length, const char* field) {
+    t_size i = 0;
+    for (; i < length && field[i]; i++) {
+        char c = name[i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != field[i]) return false;
+    }
+    return i == length && !field[i];
+}
+
+void writeText(titleformat_text_out* out, const std::string& text) {
+    out->write(titleformat_inputtypes::unknown, text.c_str(), text.size());
+}
+
+} // namespace
+
+class PlaylistFormatContext::Hook : public titleformat_hook {
+public:
+    Hook(const PlaylistFormatContext& context, t_size item)
+        : m_context(context), m_item(item), m_list(item, context.m_itemCount) {}
+
+    bool process_field(titleformat_text_out* out, const char* name, t_size nameLength, bool& foundFlag) override {
+        if (m_list.process_field(out, name, nameLength, foundFlag)) return true;
+        foundFlag = false;
+
+        if (fieldIs(name, nameLength, "playlist_name")) {
+            writeText(out, m_context.m_name);
+            foundFlag = true;
+            return true;
+        }
+        if (fieldIs(name, nameLength, "queue_index") || fieldIs(name, nameLength, "queue_indexes") ||
+            fieldIs(name, nameLength, "queue_total")) {
+            // Empty (not found) unless this item is queued
+            auto range = std::equal_range(m_context.m_queued.begin(), m_context.m_queued.end(),
+                                          std::make_pair(m_item, (t_size)0), ItemLess());
+            if (range.first == range.second) return true;
+
+            std::string text;
+            if (fieldIs(name, nameLength, "queue_total")) {
+                text = std::to_string(m_context.m_queueTotal);
+            } else if (fieldIs(name, nameLength, "queue_index")) {
+                text = std::to_string(range.first->second);
+            } else {
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (!text.empty()) text.push_back(',');
+                    text += std::to_string(it->second);
+                }
+            }
+            writeText(out, text);
+            foundFlag = true;
+            return true;
+        }
+        if (fieldIs(name, nameLength, "isplaying") || fieldIs(name, nameLength, "ispaused")) {
+            bool set = m_item == m_context.m_playingItem &&
+                       (fieldIs(name, nameLength, "isplaying") || m_context.m_paused);
+            if (set) writeText(out, "1");
+            foundFlag = set;
+            return true;
+        }
+        return false;
+    }
+
+    bool process_function(titleformat_text_out*, const char*, t_size, titleformat_hook_function_params*,
+                          bool& foundFlag) override {
+        foundFlag = false;
+        return false;
+    }
+
+private:
+    struct ItemLess {
+        bool operator()(const std::pair<t_size, t_size>& a, const std::pair<t_size, t_size>& b) const {
+            return a.first < b.first;
+        }
+    };
+
+    const PlaylistFormatContext& m_context;
+    t_size m_item;
+    titleformat_hook_impl_list m_list;
+};
+
+PlaylistFormatContext PlaylistFormatContext::capture(t_size playlist, t_size firstItem) {
+    PlaylistFormatContext context;
+    context.m_firstItem = firstItem;
+
+    auto pm = playlist_manager::get();
+    context.m_itemCount = pm->playlist_get_item_count(playlist);
+    pfc::string8 name;
+    if (pm->playlist_get_name(playlist, name)) context.m_name.assign(name.get_ptr(), name.get_length());
+
+    pfc::list_t<t_playback_queue_item> queue;
+    pm->queue_get_contents(queue);
+    context.m_queueTotal = queue.get_count();
+    for (t_size i = 0; i < queue.get_count(); i++) {
+        if (queue[i].m_playlist == playlist) context.m_queued.push_back({queue[i].m_item, i + 1});
+    }
+    std::sort(context.m_queued.begin(), context.m_queued.end());
+
+    t_size playingPlaylist = SIZE_MAX;
+    t_size playingItem = SIZE_MAX;
+    if (pm->get_playing_item_location(&playingPlaylist, &playingItem) && playingPlaylist == playlist) {
+        context.m_playingItem = playingItem;
+        context.m_paused = playback_control::get()->is_paused();
+    }
+    return context;
+}
+
+void PlaylistFormatContext::format(const metadb_handle_ptr& handle, t_size index, pfc::string_base& out,
+                                   const titleformat_object::ptr& script) const {
+    Hook hook(*this, m_firstItem + index);
+    handle->format_title(&hook, out, script, nullptr);
+}
+
+} // namespace simplaylist
@@ -0,0 +1,43 @@
+//
+//  PlaylistFormatContext.h
+//  foo_simplaylist_mac
+//
+//  Playlist fields for formatting off the main thread. Rows format with
+//  playlist_item_format_title, which is main-thread only; capture() takes a
+//  snapshot of what it adds to the track fields (%list_index%, %list_total%,
+//  %playlist_name%, %queue_index%, %queue_indexes%, %queue_total%,
+//  %isplaying%, %ispaused%) so background search and sort passes see the
+//  same values as the rows.
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace simplaylist {
+
+class PlaylistFormatContext {
+public:
+    // Main thread only. Formatted handles are the playlist's items from
+    // firstItem on: handle i is playlist item firstItem + i.
+    static PlaylistFormatContext capture(t_size playlist, t_size firstItem = 0);
+
+    // Thread-safe: reads only the snapshot
+    void format(const metadb_handle_ptr& handle, t_size index, pfc::string_base& out,
+                const titleformat_object::ptr& script) const;
+
+private:
+    class Hook;
+
+    t_size m_firstItem = 0;
+    t_size m_itemCount = 0;
+    std::string m_name;
+    std::vector<std::pair<t_size, t_size>> m_queued;  // (item, 1-based queue position), sorted
+    t_size m_queueTotal = 0;
+    t_size m_playingItem = SIZE_MAX;
+    bool m_paused = false;
+};
+
+} // namespace simplaylist
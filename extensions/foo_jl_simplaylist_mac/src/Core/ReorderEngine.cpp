@@ -0,0 +1,118 @@
+//
+//  ReorderEngine.cpp
+//  foo_simplaylist_mac
+//
+
+#include "ReorderEngine.h"
+#include <algorithm>
+
+namespace simplaylist {
+
+bool planMove(const IndexRuns& moved, t_size itemCount, t_size destination, MovePlan& out) {
+    out = MovePlan();
+    destination = std::min(destination, itemCount);
+
+    // Clamp runs to the playlist and count moved items before the destination
+    t_size movedBefore = 0;
+    for (const IndexRun& run : moved) {
+        if (run.count == 0 || run.start >= itemCount) continue;
+        t_size count = std::min(run.count, itemCount - run.start);
+        out.moved.push_back({run.start, count});
+        out.movedCount += count;
+        if (run.start < destination) movedBefore += std::min(count, destination - run.start);
+    }
+    if (out.movedCount == 0) return false;
+    out.insertAt = destination - movedBefore;
+
+    // A single run dropped onto its own position is a no-op
+    if (out.moved.size() == 1 && out.moved[0].start == out.insertAt) {
+        out = MovePlan();
+        return false;
+    }
+
+    // One pass: non-moved items fill the order around the block, moved items fill the block
+    out.order.resize(itemCount);
+    t_size write = 0;
+    t_size blockWrite = out.insertAt;
+    t_size next = 0;  // First old index not yet placed
+    auto placeKept = [&](t_size from, t_size to) {
+        for (t_size i = from; i < to; i++) {
+            if (write == out.insertAt) write += out.movedCount;
+            out.order[write++] = i;
+        }
+    };
+    for (const IndexRun& run : out.moved) {
+        placeKept(next, run.start);
+        for (t_size i = run.start; i < run.start + run.count; i++) {
+            out.order[blockWrite++] = i;
+        }
+        next = run.start + run.count;
+    }
+    placeKept(next, itemCount);
+    return true;
+}
+
+t_size remapIndexForMove(const MovePlan& plan, t_size index) {
+    t_size movedBefore = 0;
+    for (const IndexRun& run : plan.moved) {
+        if (index < run.start) break;
+        if (index < run.start + run.count) {
+            return plan.insertAt + movedBefore + (index - run.start);
+        }
+        movedBefore += run.count;
+    }
+    t_size kept = index - movedBefore;  // Position among non-moved items
+    return kept < plan.insertAt ? kept : kept + plan.movedCount;
+}
+
+SelectionModel remapSelectionForMove(const MovePlan& plan, const SelectionModel& selection) {
+    if (plan.empty() || selection.empty()) return selection;
+
+    SelectionModel movedItems;
+    for (const IndexRun& run : plan.moved) {
+        movedItems.appendRun((int64_t)run.start, (int64_t)(run.start + run.count));
+    }
+
+    // Selected items inside the moved runs, translated into the block
+    SelectionModel block;
+    const auto& selected = selection.runs();
+    size_t s = 0;
+    int64_t blockOffset = (int64_t)plan.insertAt;
+    for (const SelectionModel::Run& run : movedItems.runs()) {
+        while (s < selected.size() && selected[s].end <= run.start) s++;
+        for (size_t k = s; k < selected.size() && selected[k].start < run.end; k++) {
+            int64_t from = std::max(selected[k].start, run.start);
+            int64_t to = std::min(selected[k].end, run.end);
+            block.appendRun(blockOffset + (from - run.start), blockOffset + (to - run.start));
+        }
+        blockOffset += run.count();
+    }
+
+    // Everything else: close the gaps, then open the block
+    SelectionModel result = selection;
+    result.subtract(movedItems);
+    result.shiftForRemove(movedItems.runs());
+    result.shiftForInsert((int64_t)plan.insertAt, (int64_t)plan.movedCount);
+    result.unionWith(block);
+    return result;
+}
+
+void remapModelForMove(GroupDetectionResult& model, const MovePlan& plan,
+                       IndexRuns& dirty, GroupSpliceLog& log) {
+    IndexRuns seams;
+    remapModelForRemove(model, plan.moved, seams, log);
+    IndexRuns inserted;
+    remapModelForInsert(model, plan.insertAt, plan.movedCount, inserted);
+
+    // Seams after the insertion point move past the block; keep dirty ascending
+    for (IndexRun& seam : seams) {
+        if (seam.start >= plan.insertAt) seam.start += plan.movedCount;
+    }
+    size_t firstAfter = 0;
+    while (firstAfter < seams.size() && seams[firstAfter].start < plan.insertAt) firstAfter++;
+    dirty.insert(dirty.end(), seams.begin(), seams.begin() + firstAfter);
+    dirty.insert(dirty.end(), inserted.begin(), inserted.end());
+    dirty.insert(dirty.end(), seams.begin() + firstAfter, seams.end());
+}
+
+} // namespace simplaylist
@@ -0,0 +1,44 @@
+//
+//  ReorderEngine.h
+//  foo_simplaylist_mac
+//
+//  Drag-reorder as a block move: the dragged items (any set of runs) end up
+//  contiguous at the drop point in their original order, everything else keeps
+//  its relative order. The permutation is built in one O(n) pass over flat
+//  arrays for a single playlist_reorder_items call, and the same plan drives
+//  the incremental group update (remove the moved runs, insert one block).
+//
+
+#pragma once
+#include "GroupDetection.h"
+#include "SelectionModel.h"
+#include <vector>
+
+namespace simplaylist {
+
+struct MovePlan {
+    IndexRuns moved;            // Old indices, ascending, non-adjacent
+    t_size movedCount = 0;
+    t_size insertAt = 0;        // Block start in the new order
+    std::vector<t_size> order;  // order[newIndex] = oldIndex
+
+    bool empty() const { return order.empty(); }
+};
+
+// Plan moving `moved` (ascending runs within [0, itemCount)) before the item
+// at `destination` (itemCount = append). Returns false when nothing moves.
+bool planMove(const IndexRuns& moved, t_size itemCount, t_size destination, MovePlan& out);
+
+// New index of an old index under the plan - O(runs)
+t_size remapIndexForMove(const MovePlan& plan, t_size index);
+
+// Move selection state along with the items - O(selection runs + moved runs)
+SelectionModel remapSelectionForMove(const MovePlan& plan, const SelectionModel& selection);
+
+// Remap the group model as "remove the moved runs, insert movedCount at
+// insertAt". Dirty ranges (ascending, post-move indices) cover the insertion
+// and each seam the moved items left behind.
+void remapModelForMove(GroupDetectionResult& model, const MovePlan& plan,
+                       IndexRuns& dirty, GroupSpliceLog& log);
+
+} // namespace simplaylist
@@ -0,0 +1,104 @@
+//
+//  RowLayoutCache.h
+//  foo_simplaylist_mac
+//
+//  Shaped (and truncated) CoreText lines for track cells, so redrawing a row
+//  that hasn't changed is a lookup plus CTLineDraw instead of building an
+//  attributed string and laying it out again.
+//  Keyed by (playlist index, column); an entry is only returned while the
+//  cell text, column width and style key (appearance generation, alignment,
+//  selected/playing) still match, so changed values never draw stale text.
+//
+
+#pragma once
+#include "LruCache.h"
+#include <CoreText/CoreText.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace simplaylist {
+
+class RowLayoutCache {
+public:
+    // Cells kept - several screens of rows x typical column counts
+    static constexpr size_t kCapacity = 4096;
+
+    struct Line {
+        CTLineRef line = nullptr;  // Owned
+        CGFloat penOffset = 0;     // Horizontal offset for alignment
+
+        Line() = default;
+        Line(CTLineRef ownedLine, CGFloat offset) : line(ownedLine), penOffset(offset) {}
+        Line(const Line&) = delete;
+        Line& operator=(const Line&) = delete;
+        Line(Line&& other) noexcept : line(other.line), penOffset(other.penOffset) { other.line = nullptr; }
+        Line& operator=(Line&& other) noexcept {
+            if (this != &other) {
+                if (line) CFRelease(line);
+                line = other.line;
+                penOffset = other.penOffset;
+                other.line = nullptr;
+            }
+            return *this;
+        }
+        ~Line() { if (line) CFRelease(line); }
+    };
+
+    RowLayoutCache() : m_entries(kCapacity) {}
+
+    // Cached line for the cell, nullptr when missing or built from other text/width/style
+    const Line* find(int64_t row, size_t column, const char* text, size_t length,
+                     CGFloat width, uint32_t styleKey) {
+        Entry* entry = m_entries.get(Key{row, column});
+        if (!entry) return nullptr;
+        if (entry->width != width || entry->styleKey != styleKey ||
+            entry->text.size() != length || std::memcmp(entry->text.data(), text, length) != 0) {
+            return nullptr;
+        }
+        return &entry->line;
+    }
+
+    // Store a line built for the cell (takes ownership of line)
+    const Line* store(int64_t row, size_t column, const char* text, size_t length,
+                      CGFloat width, uint32_t styleKey, CTLineRef line, CGFloat penOffset) {
+        Key key{row, column};
+        Entry* entry = m_entries.get(key);
+        if (!entry) {
+            m_entries.put(key, Entry());
+            entry = m_entries.get(key);
+        }
+        entry->text.assign(text, length);  // Reuses the string's buffer when replacing
+        entry->width = width;
+        entry->styleKey = styleKey;
+        entry->line = Line(line, penOffset);
+        return &entry->line;
+    }
+
+    void clear() { m_entries.clear(); }
+    size_t size() const { return m_entries.size(); }
+
+private:
+    struct Key {
+        int64_t row;
+        size_t column;
+        bool operator==(const Key& other) const { return row == other.row && column == other.column; }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<int64_t>()(key.row) * 31 + key.column;
+        }
+    };
+
+    struct Entry {
+        std::string text;  // UTF-8 the line was built from
+        CGFloat width = 0;
+        uint32_t styleKey = 0;
+        Line line;
+    };
+
+    LruCache<Key, Entry, KeyHash> m_entries;
+};
+
+} // namespace simplaylist
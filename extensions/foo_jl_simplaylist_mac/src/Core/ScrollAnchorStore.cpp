@@ -0,0 +1,132 @@
+//
+//  ScrollAnchorStore.cpp
+//  foo_simplaylist_mac
+//
+
+#include "ScrollAnchorStore.h"
+#include "ConfigHelper.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace simplaylist {
+
+namespace {
+
+const size_t kGuidDigits = sizeof(GUID) * 2;
+const size_t kIndexDigits = 8;
+const size_t kRecordDigits = kGuidDigits + kIndexDigits;
+
+const char kHexDigits[] = "0123456789abcdef";
+
+void appendHex(std::string& out, const uint8_t* bytes, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out.push_back(kHexDigits[bytes[i] >> 4]);
+        out.push_back(kHexDigits[bytes[i] & 0xF]);
+    }
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool parseHex(const char* text, uint8_t* bytes, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int high = hexValue(text[i * 2]);
+        int low = hexValue(text[i * 2 + 1]);
+        if (high < 0 || low < 0) return false;
+        bytes[i] = (uint8_t)((high << 4) | low);
+    }
+    return true;
+}
+
+} // namespace
+
+ScrollAnchorStore& ScrollAnchorStore::instance() {
+    static ScrollAnchorStore store;
+    return store;
+}
+
+GUID ScrollAnchorStore::guidForPlaylist(t_size playlist) {
+    playlist_manager_v5::ptr pm5;
+    if (!playlist_manager::get()->service_query_t(pm5)) return pfc::guid_null;
+    return pm5->playlist_get_guid(playlist);
+}
+
+bool ScrollAnchorStore::lookup(const GUID& playlist, t_size& outIndex) {
+    if (playlist == pfc::guid_null) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    loadIfNeeded();
+    for (const Entry& entry : m_entries) {
+        if (entry.playlist == playlist) {
+            outIndex = entry.index;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ScrollAnchorStore::store(const GUID& playlist, t_size index) {
+    if (playlist == pfc::guid_null) return;
+    uint32_t value = (uint32_t)std::min<t_size>(index, UINT32_MAX);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    loadIfNeeded();
+    auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                           [&playlist](const Entry& entry) { return entry.playlist == playlist; });
+    if (it != m_entries.end() && it == m_entries.begin() && it->index == value) return;
+
+    if (it != m_entries.end()) m_entries.erase(it);
+    m_entries.insert(m_entries.begin(), Entry{playlist, value});
+    if (m_entries.size() > kMaxEntries) m_entries.resize(kMaxEntries);
+    m_dirty = true;
+}
+
+void ScrollAnchorStore::flush() {
+    std::string encoded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_dirty) return;
+        m_dirty = false;
+
+        encoded.reserve(m_entries.size() * kRecordDigits);
+        for (const Entry& entry : m_entries) {
+            uint8_t guidBytes[sizeof(GUID)];
+            memcpy(guidBytes, &entry.playlist, sizeof(GUID));
+            appendHex(encoded, guidBytes, sizeof(GUID));
+            uint8_t indexBytes[4] = {(uint8_t)(entry.index >> 24), (uint8_t)(entry.index >> 16),
+                                     (uint8_t)(entry.index >> 8), (uint8_t)entry.index};
+            appendHex(encoded, indexBytes, sizeof(indexBytes));
+        }
+    }
+    simplaylist_config::setConfigString(simplaylist_config::kScrollAnchors, encoded.c_str());
+}
+
+void ScrollAnchorStore::loadIfNeeded() {
+    if (m_loaded) return;
+    m_loaded = true;
+
+    std::string encoded = simplaylist_config::getConfigString(simplaylist_config::kScrollAnchors, "");
+    size_t count = std::min(encoded.size() / kRecordDigits, kMaxEntries);
+    m_entries.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const char* record = encoded.data() + i * kRecordDigits;
+        Entry entry;
+        uint8_t guidBytes[sizeof(GUID)];
+        uint8_t indexBytes[4];
+        if (!parseHex(record, guidBytes, sizeof(GUID)) ||
+            !parseHex(record + kGuidDigits, indexBytes, sizeof(indexBytes))) {
+            continue;  // Damaged record - skip it
+        }
+        memcpy(&entry.playlist, guidBytes, sizeof(GUID));
+        entry.index = ((uint32_t)indexBytes[0] << 24) | ((uint32_t)indexBytes[1] << 16) |
+                      ((uint32_t)indexBytes[2] << 8) | (uint32_t)indexBytes[3];
+        m_entries.push_back(entry);
+    }
+}
+
+} // namespace simplaylist
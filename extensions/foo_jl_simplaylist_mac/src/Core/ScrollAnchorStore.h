@@ -0,0 +1,51 @@
+//
+//  ScrollAnchorStore.h
+//  foo_simplaylist_mac
+//
+//  Scroll position (first visible playlist index) per playlist, keyed by
+//  playlist GUID so it follows a playlist through reordering and restarts.
+//  Persisted as one config string of fixed-width hex records (32 GUID digits
+//  + 8 index digits), most recently used first and capped at kMaxEntries.
+//  Shared by all SimPlaylist instances; writes are deferred to flush().
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include <mutex>
+#include <vector>
+
+namespace simplaylist {
+
+class ScrollAnchorStore {
+public:
+    // Playlists remembered
+    static constexpr size_t kMaxEntries = 256;
+
+    static ScrollAnchorStore& instance();
+
+    // Stable identity of a playlist; guid_null on hosts without playlist_manager_v5
+    static GUID guidForPlaylist(t_size playlist);
+
+    bool lookup(const GUID& playlist, t_size& outIndex);
+    void store(const GUID& playlist, t_size index);
+
+    // Write pending changes to the config store
+    void flush();
+
+private:
+    ScrollAnchorStore() = default;
+
+    struct Entry {
+        GUID playlist;
+        uint32_t index;
+    };
+
+    void loadIfNeeded();
+
+    std::vector<Entry> m_entries;  // Front = most recent
+    bool m_loaded = false;
+    bool m_dirty = false;
+    std::mutex m_mutex;
+};
+
+} // namespace simplaylist
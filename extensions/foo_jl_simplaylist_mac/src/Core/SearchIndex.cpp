@@ -0,0 +1,205 @@
+//
+//  SearchIndex.cpp
+//  foo_simplaylist_mac
+//
+
+#include "SearchIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+
+namespace simplaylist {
+
+namespace {
+
+uint32_t trigramAt(const char* p) {
+    return ((uint32_t)(uint8_t)p[0] << 16) | ((uint32_t)(uint8_t)p[1] << 8) | (uint32_t)(uint8_t)p[2];
+}
+
+// Distinct trigrams of text, sorted
+void collectTrigrams(const std::string& text, std::vector<uint32_t>& out) {
+    out.clear();
+    if (text.size() < 3) return;
+    out.reserve(text.size() - 2);
+    for (size_t i = 0; i + 3 <= text.size(); i++) {
+        out.push_back(trigramAt(text.data() + i));
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+std::vector<std::string> splitTerms(const std::string& query) {
+    std::vector<std::string> terms;
+    size_t i = 0;
+    while (i < query.size()) {
+        while (i < query.size() && isspace((unsigned char)query[i])) i++;
+        size_t start = i;
+        while (i < query.size() && !isspace((unsigned char)query[i])) i++;
+        if (i > start) terms.emplace_back(query, start, i - start);
+    }
+    return terms;
+}
+
+} // namespace
+
+void SearchIndex::build(std::vector<std::string> texts) {
+    clear();
+    size_t count = texts.size();
+    m_slotText = std::move(texts);
+    m_slotOfItem.resize(count);
+    std::iota(m_slotOfItem.begin(), m_slotOfItem.end(), (Slot)0);
+    m_itemOfSlot.resize(count);
+    std::iota(m_itemOfSlot.begin(), m_itemOfSlot.end(), (uint32_t)0);
+    for (Slot slot = 0; slot < (Slot)count; slot++) addPostings(slot);
+}
+
+void SearchIndex::clear() {
+    m_slotOfItem.clear();
+    m_itemOfSlot.clear();
+    m_slotText.clear();
+    m_freeSlots.clear();
+    m_postings.clear();
+    m_postingEntries = 0;
+    m_staleEntries = 0;
+}
+
+void SearchIndex::insert(size_t base, std::vector<std::string> texts) {
+    base = std::min(base, m_slotOfItem.size());
+    std::vector<Slot> slots;
+    slots.reserve(texts.size());
+    for (std::string& text : texts) slots.push_back(allocateSlot(std::move(text)));
+    m_slotOfItem.insert(m_slotOfItem.begin() + base, slots.begin(), slots.end());
+    rebuildItemOfSlot();
+}
+
+void SearchIndex::remove(const IndexRuns& removed) {
+    if (removed.empty()) return;
+    std::vector<Slot> kept;
+    kept.reserve(m_slotOfItem.size());
+    size_t next = 0;
+    for (const IndexRun& run : removed) {
+        size_t start = std::min(run.start, m_slotOfItem.size());
+        size_t end = std::min(run.start + run.count, m_slotOfItem.size());
+        if (start < next) start = next;
+        kept.insert(kept.end(), m_slotOfItem.begin() + next, m_slotOfItem.begin() + start);
+        for (size_t i = start; i < end; i++) releaseSlot(m_slotOfItem[i]);
+        next = std::max(next, end);
+    }
+    kept.insert(kept.end(), m_slotOfItem.begin() + next, m_slotOfItem.end());
+    m_slotOfItem = std::move(kept);
+    rebuildItemOfSlot();
+    compactIfNeeded();
+}
+
+void SearchIndex::update(size_t index, std::string text) {
+    if (index >= m_slotOfItem.size()) return;
+    Slot slot = m_slotOfItem[index];
+    if (m_slotText[slot] == text) return;
+
+    std::vector<uint32_t> trigrams;
+    collectTrigrams(m_slotText[slot], trigrams);
+    m_staleEntries += trigrams.size();
+    m_slotText[slot] = std::move(text);
+    addPostings(slot);
+    compactIfNeeded();
+}
+
+void SearchIndex::reorder(const std::vector<t_size>& order) {
+    if (order.size() != m_slotOfItem.size()) return;
+    std::vector<Slot> reordered(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        reordered[i] = m_slotOfItem[order[i]];
+    }
+    m_slotOfItem = std::move(reordered);
+    rebuildItemOfSlot();
+}
+
+std::vector<t_size> SearchIndex::query(const std::string& foldedQuery) const {
+    std::vector<t_size> result;
+    std::vector<std::string> terms = splitTerms(foldedQuery);
+    if (terms.empty()) return result;
+
+    // Candidates come from the rarest trigram of any term
+    const std::vector<Slot>* narrowest = nullptr;
+    for (const std::string& term : terms) {
+        for (size_t i = 0; i + 3 <= term.size(); i++) {
+            auto it = m_postings.find(trigramAt(term.data() + i));
+            if (it == m_postings.end()) return result;  // Trigram nowhere - no match
+            if (!narrowest || it->second.size() < narrowest->size()) narrowest = &it->second;
+        }
+    }
+
+    auto matches = [&terms](const std::string& text) {
+        for (const std::string& term : terms) {
+            if (text.find(term) == std::string::npos) return false;
+        }
+        return true;
+    };
+
+    if (narrowest) {
+        for (Slot slot : *narrowest) {
+            uint32_t item = m_itemOfSlot[slot];
+            if (item != kNoItem && matches(m_slotText[slot])) result.push_back(item);
+        }
+        // Retagged slots can be listed twice
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    } else {
+        // Only one- and two-character terms - scan the texts
+        for (size_t item = 0; item < m_slotOfItem.size(); item++) {
+            if (matches(m_slotText[m_slotOfItem[item]])) result.push_back(item);
+        }
+    }
+    return result;
+}
+
+SearchIndex::Slot SearchIndex::allocateSlot(std::string text) {
+    Slot slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_slotText[slot] = std::move(text);
+    } else {
+        slot = (Slot)m_slotText.size();
+        m_slotText.push_back(std::move(text));
+        m_itemOfSlot.push_back(kNoItem);
+    }
+    addPostings(slot);
+    return slot;
+}
+
+void SearchIndex::releaseSlot(Slot slot) {
+    std::vector<uint32_t> trigrams;
+    collectTrigrams(m_slotText[slot], trigrams);
+    m_staleEntries += trigrams.size();
+    std::string().swap(m_slotText[slot]);
+    m_itemOfSlot[slot] = kNoItem;
+    m_freeSlots.push_back(slot);
+}
+
+void SearchIndex::addPostings(Slot slot) {
+    std::vector<uint32_t> trigrams;
+    collectTrigrams(m_slotText[slot], trigrams);
+    for (uint32_t trigram : trigrams) m_postings[trigram].push_back(slot);
+    m_postingEntries += trigrams.size();
+}
+
+void SearchIndex::rebuildItemOfSlot() {
+    std::fill(m_itemOfSlot.begin(), m_itemOfSlot.end(), kNoItem);
+    for (size_t item = 0; item < m_slotOfItem.size(); item++) {
+        m_itemOfSlot[m_slotOfItem[item]] = (uint32_t)item;
+    }
+}
+
+void SearchIndex::compactIfNeeded() {
+    if (m_staleEntries * 2 <= m_postingEntries) return;
+
+    m_postings.clear();
+    m_postingEntries = 0;
+    m_staleEntries = 0;
+    for (Slot slot = 0; slot < (Slot)m_slotText.size(); slot++) {
+        if (m_itemOfSlot[slot] != kNoItem) addPostings(slot);
+    }
+}
+
+} // namespace simplaylist
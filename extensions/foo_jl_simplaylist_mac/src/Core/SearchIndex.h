@@ -0,0 +1,77 @@
+//
+//  SearchIndex.h
+//  foo_simplaylist_mac
+//
+//  Type-to-find / filter index over the formatted column values of a playlist.
+//  Each item's columns are formatted once, folded (lowercase, no diacritics)
+//  and joined into one string; a trigram -> item posting map narrows a query
+//  to the items holding its rarest trigram, which are then verified by
+//  substring match. Items live in stable slots so inserts, removes, retags and
+//  reorders only touch the affected items plus an index -> slot table.
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include "GroupDetection.h"
+#include "PlaylistFormatContext.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace simplaylist {
+
+// Lowercase + strip diacritics/width variants. ASCII is folded in place;
+// anything else goes through CFStringFold.
+void foldSearchText(const char* text, size_t length, std::string& out);
+
+// Format and fold handles[begin, end) with the given column scripts, spread
+// across cores like group detection. With a context, playlist fields format
+// as in the rows (handles[i] is the context's item i); without one only track
+// fields are available. Returns false if cancelled.
+bool formatSearchTexts(const metadb_handle_list& handles, t_size begin, t_size end,
+                       const std::vector<titleformat_object::ptr>& scripts,
+                       const PlaylistFormatContext* context,
+                       std::vector<std::string>& out, const std::atomic<bool>* cancelled);
+
+class SearchIndex {
+public:
+    // Replace the whole index; texts[i] is the folded text of item i
+    void build(std::vector<std::string> texts);
+    void clear();
+    size_t itemCount() const { return m_slotOfItem.size(); }
+
+    // Playlist edits - indices as reported by the playlist callbacks
+    void insert(size_t base, std::vector<std::string> texts);
+    void remove(const IndexRuns& removed);
+    void update(size_t index, std::string text);
+    void reorder(const std::vector<t_size>& order);  // order[newIndex] = oldIndex
+
+    // Items (ascending) whose text contains every whitespace-separated term
+    // of the folded query. An empty query matches nothing.
+    std::vector<t_size> query(const std::string& foldedQuery) const;
+
+private:
+    using Slot = uint32_t;
+    static constexpr Slot kNoItem = UINT32_MAX;
+
+    Slot allocateSlot(std::string text);
+    void releaseSlot(Slot slot);
+    void addPostings(Slot slot);
+    void rebuildItemOfSlot();
+    void compactIfNeeded();
+
+    std::vector<Slot> m_slotOfItem;        // Playlist index -> slot
+    std::vector<uint32_t> m_itemOfSlot;    // Slot -> playlist index (kNoItem = free)
+    std::vector<std::string> m_slotText;   // Slot -> folded text
+    std::vector<Slot> m_freeSlots;
+
+    // Trigram -> slots. Entries of freed or retagged slots are left in place
+    // (the substring check rejects them) and swept once they outnumber live ones.
+    std::unordered_map<uint32_t, std::vector<Slot>> m_postings;
+    size_t m_postingEntries = 0;
+    size_t m_staleEntries = 0;
+};
+
+} // namespace simplaylist
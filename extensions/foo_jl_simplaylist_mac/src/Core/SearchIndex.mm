@@ -0,0 +1,105 @@
+//
+//  SearchIndex.mm
+//  foo_simplaylist_mac
+//
+//  Search text folding (CFStringFold) and the parallel formatting pass that
+//  feeds the index. The index itself is plain C++ in SearchIndex.cpp.
+//
+
+#import <CoreFoundation/CoreFoundation.h>
+#include "SearchIndex.h"
+#include <dispatch/dispatch.h>
+#include <algorithm>
+#include <thread>
+
+namespace simplaylist {
+
+namespace {
+
+// Below this many items formatting stays on the calling thread
+const t_size kParallelMinItems = 4096;
+const t_size kMinChunkItems = 2048;
+const t_size kCancelCheckInterval = 512;
+
+// Separates column values so a term never matches across two columns
+const char kColumnSeparator = '\n';
+
+} // namespace
+
+void foldSearchText(const char* text, size_t length, std::string& out) {
+    out.clear();
+    bool ascii = true;
+    for (size_t i = 0; i < length; i++) {
+        if ((unsigned char)text[i] >= 0x80) { ascii = false; break; }
+    }
+    if (ascii) {
+        out.resize(length);
+        for (size_t i = 0; i < length; i++) out[i] = (char)tolower((unsigned char)text[i]);
+        return;
+    }
+
+    CFStringRef source = CFStringCreateWithBytes(kCFAllocatorDefault, (const UInt8*)text, (CFIndex)length,
+                                                 kCFStringEncodingUTF8, false);
+    if (!source) return;
+    CFMutableStringRef folded = CFStringCreateMutableCopy(kCFAllocatorDefault, 0, source);
+    CFRelease(source);
+    CFStringFold(folded, kCFCompareCaseInsensitive | kCFCompareDiacriticInsensitive | kCFCompareWidthInsensitive,
+                 nullptr);
+
+    CFRange range = CFRangeMake(0, CFStringGetLength(folded));
+    CFIndex byteCount = 0;
+    CFStringGetBytes(folded, range, kCFStringEncodingUTF8, '?', false, nullptr, 0, &byteCount);
+    out.resize((size_t)byteCount);
+    CFStringGetBytes(folded, range, kCFStringEncodingUTF8, '?', false, (UInt8*)out.data(), byteCount, nullptr);
+    CFRelease(folded);
+}
+
+bool formatSearchTexts(const metadb_handle_list& handles, t_size begin, t_size end,
+                       const std::vector<titleformat_object::ptr>& scripts,
+                       const PlaylistFormatContext* context,
+                       std::vector<std::string>& out, const std::atomic<bool>* cancelled) {
+    end = std::min(end, handles.get_count());
+    out.assign(end > begin ? end - begin : 0, std::string());
+    if (begin >= end) return true;
+
+    auto formatRange = [&](t_size from, t_size to) -> bool {
+        pfc::string8 value;
+        std::string joined;
+        for (t_size i = from; i < to; i++) {
+            if (cancelled && (i - from) % kCancelCheckInterval == 0 && cancelled->load(std::memory_order_relaxed)) {
+                return false;
+            }
+            joined.clear();
+            for (const auto& script : scripts) {
+                if (!script.is_valid()) continue;
+                if (context) {
+                    context->format(handles[i], i, value, script);
+                } else {
+                    handles[i]->format_title(nullptr, value, script, nullptr);
+                }
+                if (!joined.empty()) joined.push_back(kColumnSeparator);
+                joined.append(value.get_ptr(), value.get_length());
+            }
+            foldSearchText(joined.data(), joined.size(), out[i - begin]);
+        }
+        return true;
+    };
+
+    t_size count = end - begin;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    if (count < kParallelMinItems || cores == 1) {
+        return formatRange(begin, end);
+    }
+
+    t_size chunkCount = std::max<t_size>(1, std::min<t_size>((t_size)cores * 4, count / kMinChunkItems));
+    t_size chunkSize = (count + chunkCount - 1) / chunkCount;
+    std::atomic<bool> chunkCancelled{false};
+    dispatch_apply(chunkCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t c) {
+        t_size from = begin + c * chunkSize;
+        t_size to = std::min(end, from + chunkSize);
+        if (from < to && !formatRange(from, to)) chunkCancelled = true;
+    });
+    return !chunkCancelled;
+}
+
+} // namespace simplaylist
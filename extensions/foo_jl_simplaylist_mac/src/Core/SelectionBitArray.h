@@ -0,0 +1,49 @@
+//
+//  SelectionBitArray.h
+//  foo_simplaylist_mac
+//
+//  SDK side of SelectionModel: a bit_array view over the runs for bulk
+//  playlist_manager calls (playlist_set_selection, playlist_remove_items),
+//  and building a model from a playlist selection mask.
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include "SelectionModel.h"
+
+namespace simplaylist {
+
+// Read-only bit_array over a SelectionModel. find() jumps run to run, so
+// SDK scans over the mask cost O(runs) rather than O(items).
+class SelectionBitArray : public bit_array {
+public:
+    explicit SelectionBitArray(const SelectionModel& selection) : m_selection(selection) {}
+
+    bool get(t_size n) const override { return m_selection.contains((int64_t)n); }
+
+    t_size find(bool val, t_size start, t_ssize count) const override {
+        if (count < 0) return bit_array::find(val, start, count);  // Backward scans are rare
+        int64_t end = (int64_t)start + count;
+        int64_t found = val ? m_selection.nextSelected((int64_t)start)
+                            : m_selection.nextUnselected((int64_t)start);
+        return (t_size)((found < 0 || found > end) ? end : found);
+    }
+
+private:
+    const SelectionModel& m_selection;
+};
+
+// Selection runs from a playlist selection mask over [0, count)
+inline SelectionModel selectionFromMask(const bit_array& mask, t_size count) {
+    SelectionModel selection;
+    t_size i = mask.find_first(true, 0, count);
+    while (i < count) {
+        t_size end = mask.find_first(false, i, count);
+        selection.appendRun((int64_t)i, (int64_t)end);
+        if (end >= count) break;
+        i = mask.find_first(true, end, count);
+    }
+    return selection;
+}
+
+} // namespace simplaylist
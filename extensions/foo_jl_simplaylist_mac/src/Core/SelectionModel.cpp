@@ -0,0 +1,256 @@
+//
+//  SelectionModel.cpp
+//  foo_simplaylist_mac
+//
+
+#include "SelectionModel.h"
+#include <algorithm>
+
+namespace simplaylist {
+
+size_t SelectionModel::runAtOrAfter(int64_t index) const {
+    auto it = std::partition_point(m_runs.begin(), m_runs.end(),
+                                   [index](const Run& run) { return run.end <= index; });
+    return (size_t)(it - m_runs.begin());
+}
+
+void SelectionModel::recount() {
+    m_count = 0;
+    for (const Run& run : m_runs) m_count += run.count();
+}
+
+bool SelectionModel::contains(int64_t index) const {
+    size_t i = runAtOrAfter(index);
+    return i < m_runs.size() && m_runs[i].start <= index;
+}
+
+bool SelectionModel::intersects(int64_t start, int64_t end) const {
+    if (start >= end) return false;
+    size_t i = runAtOrAfter(start);
+    return i < m_runs.size() && m_runs[i].start < end;
+}
+
+bool SelectionModel::containsRange(int64_t start, int64_t end) const {
+    if (start >= end) return true;
+    size_t i = runAtOrAfter(start);
+    return i < m_runs.size() && m_runs[i].start <= start && m_runs[i].end >= end;
+}
+
+int64_t SelectionModel::nextSelected(int64_t from) const {
+    size_t i = runAtOrAfter(from);
+    if (i >= m_runs.size()) return -1;
+    return std::max(from, m_runs[i].start);
+}
+
+int64_t SelectionModel::nextUnselected(int64_t from) const {
+    size_t i = runAtOrAfter(from);
+    // Runs never touch, so the end of a run is always unselected
+    if (i < m_runs.size() && m_runs[i].start <= from) return m_runs[i].end;
+    return from;
+}
+
+void SelectionModel::clear() {
+    m_runs.clear();
+    m_count = 0;
+}
+
+void SelectionModel::selectRange(int64_t start, int64_t end) {
+    if (start >= end) return;
+
+    // Runs overlapping or touching [start, end) merge into one
+    size_t lo = runAtOrAfter(start - 1);
+    size_t hi = lo;
+    while (hi < m_runs.size() && m_runs[hi].start <= end) hi++;
+
+    Run merged{start, end};
+    if (lo < hi) {
+        merged.start = std::min(start, m_runs[lo].start);
+        merged.end = std::max(end, m_runs[hi - 1].end);
+    }
+    m_runs.erase(m_runs.begin() + lo, m_runs.begin() + hi);
+    m_runs.insert(m_runs.begin() + lo, merged);
+    recount();
+}
+
+void SelectionModel::deselectRange(int64_t start, int64_t end) {
+    if (start >= end) return;
+
+    size_t lo = runAtOrAfter(start);
+    size_t hi = lo;
+    while (hi < m_runs.size() && m_runs[hi].start < end) hi++;
+    if (lo == hi) return;
+
+    // Keep the parts of the first and last overlapping run outside [start, end)
+    Run pieces[2];
+    size_t pieceCount = 0;
+    if (m_runs[lo].start < start) pieces[pieceCount++] = {m_runs[lo].start, start};
+    if (m_runs[hi - 1].end > end) pieces[pieceCount++] = {end, m_runs[hi - 1].end};
+
+    m_runs.erase(m_runs.begin() + lo, m_runs.begin() + hi);
+    m_runs.insert(m_runs.begin() + lo, pieces, pieces + pieceCount);
+    recount();
+}
+
+void SelectionModel::setRange(int64_t start, int64_t end) {
+    clear();
+    appendRun(start, end);
+}
+
+void SelectionModel::toggle(int64_t index) {
+    if (contains(index)) {
+        deselectRange(index, index + 1);
+    } else {
+        selectRange(index, index + 1);
+    }
+}
+
+void SelectionModel::appendRun(int64_t start, int64_t end) {
+    if (start >= end) return;
+    if (!m_runs.empty() && m_runs.back().end >= start) {
+        Run& back = m_runs.back();
+        if (end > back.end) {
+            m_count += end - back.end;
+            back.end = end;
+        }
+        return;
+    }
+    m_runs.push_back({start, end});
+    m_count += end - start;
+}
+
+void SelectionModel::unionWith(const SelectionModel& other) {
+    if (other.empty()) return;
+    if (empty()) {
+        *this = other;
+        return;
+    }
+
+    SelectionModel result;
+    result.m_runs.reserve(m_runs.size() + other.m_runs.size());
+    size_t i = 0, j = 0;
+    while (i < m_runs.size() || j < other.m_runs.size()) {
+        bool takeMine = j >= other.m_runs.size() ||
+                        (i < m_runs.size() && m_runs[i].start <= other.m_runs[j].start);
+        const Run& run = takeMine ? m_runs[i++] : other.m_runs[j++];
+        result.appendRun(run.start, run.end);
+    }
+    *this = std::move(result);
+}
+
+void SelectionModel::subtract(const SelectionModel& other) {
+    if (empty() || other.empty()) return;
+
+    SelectionModel result;
+    result.m_runs.reserve(m_runs.size() + other.m_runs.size());
+    const std::vector<Run>& cuts = other.m_runs;
+    size_t j = 0;
+    for (const Run& run : m_runs) {
+        int64_t start = run.start;
+        while (j < cuts.size() && cuts[j].end <= start) j++;
+        // A cut may span several of our runs, so later runs rescan from j
+        for (size_t k = j; k < cuts.size() && cuts[k].start < run.end; k++) {
+            if (cuts[k].start > start) result.appendRun(start, cuts[k].start);
+            start = std::max(start, cuts[k].end);
+        }
+        result.appendRun(start, run.end);
+    }
+    *this = std::move(result);
+}
+
+void SelectionModel::invert(int64_t itemCount) {
+    SelectionModel result;
+    result.m_runs.reserve(m_runs.size() + 1);
+    int64_t gapStart = 0;
+    for (const Run& run : m_runs) {
+        if (run.start >= itemCount) break;
+        result.appendRun(gapStart, run.start);
+        gapStart = run.end;
+    }
+    result.appendRun(gapStart, itemCount);
+    *this = std::move(result);
+}
+
+void SelectionModel::shiftForInsert(int64_t base, int64_t count) {
+    if (count <= 0) return;
+
+    size_t i = runAtOrAfter(base);
+    if (i >= m_runs.size()) return;
+
+    // A run containing base splits around the inserted (unselected) items
+    if (m_runs[i].start < base) {
+        Run tail{base + count, m_runs[i].end + count};
+        m_runs[i].end = base;
+        m_runs.insert(m_runs.begin() + i + 1, tail);
+        i += 2;
+    }
+    for (; i < m_runs.size(); i++) {
+        m_runs[i].start += count;
+        m_runs[i].end += count;
+    }
+}
+
+void SelectionModel::shiftForRemove(const std::vector<Run>& removed) {
+    if (empty() || removed.empty()) return;
+
+    SelectionModel result;
+    result.m_runs.reserve(m_runs.size());
+    size_t j = 0;
+    int64_t shift = 0;  // Removed items before the current position
+    for (const Run& run : m_runs) {
+        int64_t start = run.start;
+        while (start < run.end) {
+            while (j < removed.size() && removed[j].end <= start) {
+                shift += removed[j].count();
+                j++;
+            }
+            if (j < removed.size() && removed[j].start <= start) {
+                start = removed[j].end;  // Skip the removed part
+                continue;
+            }
+            int64_t pieceEnd = (j < removed.size()) ? std::min(run.end, removed[j].start) : run.end;
+            // Runs separated only by removed items become adjacent and merge
+            result.appendRun(start - shift, pieceEnd - shift);
+            start = pieceEnd;
+        }
+    }
+    *this = std::move(result);
+}
+
+void SelectionModel::truncate(int64_t itemCount) {
+    while (!m_runs.empty() && m_runs.back().start >= itemCount) m_runs.pop_back();
+    if (!m_runs.empty() && m_runs.back().end > itemCount) m_runs.back().end = itemCount;
+    recount();
+}
+
+SelectionModel SelectionModel::difference(const SelectionModel& a, const SelectionModel& b) {
+    // Sweep both boundary sequences (start, end, start, end, ...); the state
+    // differs wherever an odd number of boundaries has been crossed
+    auto boundary = [](const std::vector<Run>& runs, size_t k) {
+        return (k & 1) ? runs[k / 2].end : runs[k / 2].start;
+    };
+
+    SelectionModel result;
+    size_t na = a.m_runs.size() * 2, nb = b.m_runs.size() * 2;
+    size_t i = 0, j = 0;
+    bool differs = false;
+    int64_t runStart = 0;
+    while (i < na || j < nb) {
+        int64_t pa = i < na ? boundary(a.m_runs, i) : INT64_MAX;
+        int64_t pb = j < nb ? boundary(b.m_runs, j) : INT64_MAX;
+        int64_t point = std::min(pa, pb);
+        bool toggled = false;
+        if (pa == point) { i++; toggled = !toggled; }
+        if (pb == point) { j++; toggled = !toggled; }
+        if (!toggled) continue;
+
+        differs = !differs;
+        if (differs) {
+            runStart = point;
+        } else {
+            result.appendRun(runStart, point);
+        }
+    }
+    return result;
+}
+
+} // namespace simplaylist
@@ -0,0 +1,79 @@
+//
+//  SelectionModel.h
+//  foo_simplaylist_mac
+//
+//  Playlist selection stored as sorted runs of selected indices, so select-all,
+//  invert or a shift-click range is a handful of runs instead of one entry per
+//  item. Set operations and insert/remove shifts are O(runs).
+//  Plain C++ (no SDK / Cocoa dependency) - see SelectionBitArray.h for the SDK side.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace simplaylist {
+
+class SelectionModel {
+public:
+    // Half-open [start, end). Runs are sorted, non-empty and never touch.
+    struct Run {
+        int64_t start;
+        int64_t end;
+
+        int64_t count() const { return end - start; }
+        bool operator==(const Run& other) const { return start == other.start && end == other.end; }
+    };
+
+    const std::vector<Run>& runs() const { return m_runs; }
+    size_t runCount() const { return m_runs.size(); }
+    bool empty() const { return m_runs.empty(); }
+    int64_t count() const { return m_count; }
+    int64_t first() const { return m_runs.empty() ? -1 : m_runs.front().start; }
+    int64_t last() const { return m_runs.empty() ? -1 : m_runs.back().end - 1; }
+
+    // O(log runs)
+    bool contains(int64_t index) const;
+    bool intersects(int64_t start, int64_t end) const;      // Any selected in [start, end)
+    bool containsRange(int64_t start, int64_t end) const;   // All selected in [start, end)
+    int64_t nextSelected(int64_t from) const;    // First selected >= from, -1 if none
+    int64_t nextUnselected(int64_t from) const;  // First unselected >= from
+
+    void clear();
+    void selectRange(int64_t start, int64_t end);
+    void deselectRange(int64_t start, int64_t end);
+    void setRange(int64_t start, int64_t end);  // Selection becomes exactly [start, end)
+    void toggle(int64_t index);
+
+    // Append a run past the current last one (adjacent runs merge) - O(1),
+    // for building from an ascending scan
+    void appendRun(int64_t start, int64_t end);
+
+    // Set operations - O(runs + other runs)
+    void unionWith(const SelectionModel& other);
+    void subtract(const SelectionModel& other);
+    void invert(int64_t itemCount);  // Complement within [0, itemCount)
+
+    // Playlist edits: items inserted at base arrive unselected and later items
+    // move up; removed runs drop out and later items move down
+    void shiftForInsert(int64_t base, int64_t count);
+    void shiftForRemove(const std::vector<Run>& removed);
+    void truncate(int64_t itemCount);
+
+    // Indices whose state differs between a and b (symmetric difference)
+    static SelectionModel difference(const SelectionModel& a, const SelectionModel& b);
+
+    bool operator==(const SelectionModel& other) const { return m_runs == other.m_runs; }
+    bool operator!=(const SelectionModel& other) const { return !(*this == other); }
+
+private:
+    // Index of the first run with end > index
+    size_t runAtOrAfter(int64_t index) const;
+    void recount();
+
+    std::vector<Run> m_runs;
+    int64_t m_count = 0;
+};
+
+} // namespace simplaylist
@@ -0,0 +1,266 @@
+//
+//  SortEngine.cpp
+//  foo_simplaylist_mac
+//
+
+#include "SortEngine.h"
+#include "SearchIndex.h"
+#include <dispatch/dispatch.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+
+namespace simplaylist {
+
+namespace {
+
+// Below this many items everything stays on the calling thread
+const t_size kParallelMinItems = 4096;
+const t_size kMinChunkItems = 2048;
+const t_size kCancelCheckInterval = 512;
+
+// Longest digit run encoded exactly; longer runs compare by their first 255 digits
+const size_t kMaxDigitRun = 255;
+
+struct KeyColumn {
+    bool numeric = true;  // Every non-empty value parsed as a number
+    bool descending = false;
+    std::vector<double> numbers;
+    std::vector<std::string> collation;
+};
+
+// Plain decimal ("12", "-3.5", " 7 ") - no exponents, hex or inf/nan
+bool parseNumber(const char* text, size_t length, double& out) {
+    size_t begin = 0;
+    size_t end = length;
+    while (begin < end && isspace((unsigned char)text[begin])) begin++;
+    while (end > begin && isspace((unsigned char)text[end - 1])) end--;
+    if (begin == end) return false;
+
+    size_t i = begin;
+    if (text[i] == '-' || text[i] == '+') i++;
+    bool digits = false;
+    bool dot = false;
+    for (; i < end; i++) {
+        char c = text[i];
+        if (c >= '0' && c <= '9') {
+            digits = true;
+        } else if (c == '.' && !dot) {
+            dot = true;
+        } else {
+            return false;
+        }
+    }
+    if (!digits) return false;
+    out = strtod(std::string(text + begin, end - begin).c_str(), nullptr);
+    return true;
+}
+
+struct ExtractContext {
+    const metadb_handle_list* handles;
+    const std::vector<SortKeySpec>* keys;
+    const PlaylistFormatContext* format;  // Null: track fields only
+    std::vector<KeyColumn>* columns;
+    const std::atomic<bool>* cancelled;
+    t_size chunkSize;
+    std::vector<char>* chunkNotNumeric;  // chunk * keyCount + key
+    std::atomic<bool>* chunkCancelled;
+};
+
+void extractRange(const ExtractContext& ctx, t_size from, t_size to, char* notNumeric) {
+    const std::vector<SortKeySpec>& keys = *ctx.keys;
+    pfc::string8 value;
+    std::string folded;
+    for (t_size i = from; i < to; i++) {
+        if (ctx.cancelled && (i - from) % kCancelCheckInterval == 0 &&
+            ctx.cancelled->load(std::memory_order_relaxed)) {
+            *ctx.chunkCancelled = true;
+            return;
+        }
+        for (size_t k = 0; k < keys.size(); k++) {
+            KeyColumn& column = (*ctx.columns)[k];
+            value.reset();
+            if (keys[k].script.is_valid()) {
+                if (ctx.format) {
+                    ctx.format->format((*ctx.handles)[i], i, value, keys[k].script);
+                } else {
+                    (*ctx.handles)[i]->format_title(nullptr, value, keys[k].script, nullptr);
+                }
+            }
+
+            double number = -HUGE_VAL;  // Empty values sort first
+            if (value.get_length() > 0 && !parseNumber(value.get_ptr(), value.get_length(), number)) {
+                notNumeric[k] = 1;
+            }
+            column.numbers[i] = number;
+
+            foldSearchText(value.get_ptr(), value.get_length(), folded);
+            makeCollationKey(folded, column.collation[i]);
+        }
+    }
+}
+
+void extractChunk(void* context, size_t chunk) {
+    ExtractContext* ctx = static_cast<ExtractContext*>(context);
+    t_size count = ctx->handles->get_count();
+    t_size from = chunk * ctx->chunkSize;
+    t_size to = std::min(count, from + ctx->chunkSize);
+    size_t keyCount = ctx->keys->size();
+    if (from < to) extractRange(*ctx, from, to, ctx->chunkNotNumeric->data() + chunk * keyCount);
+}
+
+struct KeyLess {
+    const std::vector<KeyColumn>* columns;
+
+    bool operator()(t_size a, t_size b) const {
+        for (const KeyColumn& column : *columns) {
+            int cmp;
+            if (column.numeric) {
+                double x = column.numbers[a];
+                double y = column.numbers[b];
+                cmp = x < y ? -1 : (y < x ? 1 : 0);
+            } else {
+                cmp = column.collation[a].compare(column.collation[b]);
+            }
+            if (cmp != 0) return column.descending ? cmp > 0 : cmp < 0;
+        }
+        return false;
+    }
+};
+
+struct SortContext {
+    std::vector<t_size>* order;
+    std::vector<t_size>* buffer;
+    KeyLess less;
+    t_size width;  // Sorted run length (sort pass: chunk size)
+};
+
+void sortChunk(void* context, size_t chunk) {
+    SortContext* ctx = static_cast<SortContext*>(context);
+    t_size count = ctx->order->size();
+    t_size from = chunk * ctx->width;
+    t_size to = std::min(count, from + ctx->width);
+    if (from < to) std::stable_sort(ctx->order->begin() + from, ctx->order->begin() + to, ctx->less);
+}
+
+// Merge runs [2p*width, (2p+1)*width) and [(2p+1)*width, (2p+2)*width) into buffer.
+// std::merge takes from the left run on ties, which keeps the sort stable.
+void mergePair(void* context, size_t pair) {
+    SortContext* ctx = static_cast<SortContext*>(context);
+    t_size count = ctx->order->size();
+    t_size from = pair * 2 * ctx->width;
+    t_size mid = std::min(count, from + ctx->width);
+    t_size to = std::min(count, mid + ctx->width);
+    auto src = ctx->order->begin();
+    std::merge(src + from, src + mid, src + mid, src + to, ctx->buffer->begin() + from, ctx->less);
+}
+
+} // namespace
+
+void makeCollationKey(const std::string& folded, std::string& out) {
+    out.clear();
+    out.reserve(folded.size() + 4);
+    size_t i = 0;
+    size_t n = folded.size();
+    while (i < n) {
+        char c = folded[i];
+        if (c < '0' || c > '9') {
+            out.push_back(c);
+            i++;
+            continue;
+        }
+        // Digit run -> '0', length, digits without leading zeros. The shared
+        // '0' lead keeps runs ordered against text; length then decides magnitude.
+        size_t start = i;
+        while (i < n && folded[i] >= '0' && folded[i] <= '9') i++;
+        while (start + 1 < i && folded[start] == '0') start++;
+        size_t length = std::min(i - start, kMaxDigitRun);
+        out.push_back('0');
+        out.push_back((char)(unsigned char)length);
+        out.append(folded, start, length);
+    }
+}
+
+bool computeSortOrder(const metadb_handle_list& handles, const std::vector<SortKeySpec>& keys,
+                      const PlaylistFormatContext* context, std::vector<t_size>& order,
+                      const std::atomic<bool>* cancelled) {
+    t_size count = handles.get_count();
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    t_size chunkCount = 1;
+    if (count >= kParallelMinItems && cores > 1) {
+        chunkCount = std::max<t_size>(1, std::min<t_size>((t_size)cores * 4, count / kMinChunkItems));
+    }
+    return computeSortOrderChunked(handles, keys, context, order, cancelled, chunkCount);
+}
+
+bool computeSortOrderChunked(const metadb_handle_list& handles, const std::vector<SortKeySpec>& keys,
+                             const PlaylistFormatContext* context, std::vector<t_size>& order,
+                             const std::atomic<bool>* cancelled, t_size chunkCount) {
+    t_size count = handles.get_count();
+    order.resize(count);
+    std::iota(order.begin(), order.end(), (t_size)0);
+    if (count < 2 || keys.empty()) return true;
+
+    std::vector<KeyColumn> columns(keys.size());
+    for (size_t k = 0; k < keys.size(); k++) {
+        columns[k].descending = keys[k].descending;
+        columns[k].numbers.resize(count);
+        columns[k].collation.resize(count);
+    }
+
+    chunkCount = std::max<t_size>(1, std::min(chunkCount, count));
+    bool parallel = chunkCount > 1;
+    t_size chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    // Extract every key of every item once
+    std::vector<char> chunkNotNumeric(chunkCount * keys.size(), 0);
+    std::atomic<bool> chunkCancelled{false};
+    ExtractContext extract{&handles, &keys, context, &columns, cancelled,
+                           chunkSize, &chunkNotNumeric, &chunkCancelled};
+    if (parallel) {
+        dispatch_apply_f(chunkCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), &extract, extractChunk);
+    } else {
+        extractChunk(&extract, 0);
+    }
+    if (chunkCancelled) return false;
+
+    // A column is numeric only if every chunk agrees; keep just the key kind in use
+    for (size_t k = 0; k < keys.size(); k++) {
+        for (t_size c = 0; c < chunkCount; c++) {
+            if (chunkNotNumeric[c * keys.size() + k]) {
+                columns[k].numeric = false;
+                break;
+            }
+        }
+        if (columns[k].numeric) {
+            std::vector<std::string>().swap(columns[k].collation);
+        } else {
+            std::vector<double>().swap(columns[k].numbers);
+        }
+    }
+
+    SortContext sort{&order, nullptr, KeyLess{&columns}, chunkSize};
+    if (!parallel) {
+        std::stable_sort(order.begin(), order.end(), sort.less);
+        return true;
+    }
+
+    // Sort chunks concurrently, then merge neighbouring runs until one is left
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+    dispatch_apply_f(chunkCount, queue, &sort, sortChunk);
+
+    std::vector<t_size> buffer(count);
+    sort.buffer = &buffer;
+    for (t_size width = chunkSize; width < count; width *= 2) {
+        if (cancelled && cancelled->load(std::memory_order_relaxed)) return false;
+        sort.width = width;
+        size_t pairs = (count + 2 * width - 1) / (2 * width);
+        dispatch_apply_f(pairs, queue, &sort, mergePair);
+        order.swap(buffer);
+    }
+    return true;
+}
+
+} // namespace simplaylist
@@ -0,0 +1,46 @@
+//
+//  SortEngine.h
+//  foo_simplaylist_mac
+//
+//  Column-header sort. Every item's sort keys are formatted once, spread
+//  across cores, and turned into flat comparable keys: a column whose
+//  non-empty values all parse as numbers compares as doubles, anything else
+//  compares by a precomputed collation key (folded text with digit runs
+//  encoded so "2" sorts before "10"). A chunked stable sort plus parallel
+//  merge passes produces the permutation for one playlist_reorder_items call.
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include "PlaylistFormatContext.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace simplaylist {
+
+struct SortKeySpec {
+    titleformat_object::ptr script;
+    bool descending = false;
+};
+
+// Collation key of already-folded text - compare with plain byte order
+void makeCollationKey(const std::string& folded, std::string& out);
+
+// Stable multi-key order of handles: order[newIndex] = oldIndex. Keys are
+// applied in priority order; items equal on every key keep their playlist
+// order. Keys format through the context when given (playlist fields as in
+// the rows), else from track fields only. Thread-safe. Returns false if
+// cancelled.
+bool computeSortOrder(const metadb_handle_list& handles, const std::vector<SortKeySpec>& keys,
+                      const PlaylistFormatContext* context, std::vector<t_size>& order,
+                      const std::atomic<bool>* cancelled);
+
+// The sort with an explicit chunk count: keys are extracted and sorted in
+// chunkCount chunks of ceil(count / chunkCount) items, then merged pairwise.
+// computeSortOrder picks the count from the core count (1 below 4096 items).
+bool computeSortOrderChunked(const metadb_handle_list& handles, const std::vector<SortKeySpec>& keys,
+                             const PlaylistFormatContext* context, std::vector<t_size>& order,
+                             const std::atomic<bool>* cancelled, t_size chunkCount);
+
+} // namespace simplaylist
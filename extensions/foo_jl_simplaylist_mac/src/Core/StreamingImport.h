@@ -0,0 +1,91 @@
+//
+//  StreamingImport.h
+//  foo_simplaylist_mac
+//
+//  Drag-and-drop import that fills the playlist while it runs. Dropped folders
+//  are walked in parallel (one work unit per dropped file / first-level entry),
+//  finished units are released in drop order, and every kBatchSize locations
+//  go through process_locations_async and are inserted as soon as they resolve.
+//  Each insert is an ordinary items-added event, so the group model extends
+//  incrementally instead of the view waiting for the whole drop. Edits made
+//  to the target playlist while the import runs move the insertion point.
+//
+
+#pragma once
+#include "../fb2k_sdk.h"
+#include "GroupDetection.h"
+#include "ImportQueue.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace simplaylist {
+
+class StreamingImportPlaylistCallback;
+
+struct ImportProgress {
+    size_t locationsFound = 0;     // Files / paths queued so far
+    size_t locationsResolved = 0;  // Handed to the SDK and completed
+    size_t itemsInserted = 0;      // Playlist items added
+    bool enumerating = false;      // Still walking dropped folders
+    bool finished = false;         // Done, cancelled or target playlist gone
+    bool cancelled = false;
+};
+
+class StreamingImport : public std::enable_shared_from_this<StreamingImport> {
+public:
+    using ProgressHandler = std::function<void(const ImportProgress&)>;
+
+    // Locations resolved per process_locations_async call
+    static constexpr size_t kBatchSize = 256;
+
+    // Start importing into playlist at insertAt (SIZE_MAX = append). The
+    // playlist is followed by GUID, so it may move while the import runs.
+    // expandFolders: locations are filesystem paths and folders are walked
+    // here; otherwise they are passed to the SDK as-is (fb2k native paths).
+    // Main thread only; progress is reported on the main thread.
+    static std::shared_ptr<StreamingImport> start(t_size playlist, t_size insertAt,
+                                                  std::vector<std::string> locations,
+                                                  bool expandFolders,
+                                                  ProgressHandler progress);
+
+    // Stop after the batch in flight (its items are dropped). Main thread only.
+    void cancel();
+
+    const ImportProgress& progress() const { return m_progress; }
+    bool finished() const { return m_progress.finished; }
+
+    StreamingImport(t_size playlist, t_size insertAt, ProgressHandler progress);
+    ~StreamingImport();
+
+private:
+    friend class StreamingImportNotify;
+    friend class StreamingImportPlaylistCallback;
+
+    void enumerate(std::vector<std::string> roots);
+    void unitFinished(size_t unit, std::vector<std::string> files);
+    void pump();
+    t_size currentPlaylist() const;
+    void batchResolved(metadb_handle_list_cref items, size_t locationCount);
+    void batchAborted();
+    void finish(bool cancelled);
+    void report();
+
+    t_size m_playlist;     // Index at start; used on hosts without playlist GUIDs
+    GUID m_playlistGuid;
+    ImportInsertPoint m_insertAt;
+    std::unique_ptr<StreamingImportPlaylistCallback> m_playlistCallback;  // While running
+    bool m_inserting = false;  // Our own insert - not an outside edit
+    ProgressHandler m_progressHandler;
+    ImportProgress m_progress;
+    std::atomic<bool> m_cancelled{false};
+
+    ImportQueue m_queue{kBatchSize};
+    bool m_batchInFlight = false;
+    bool m_firstInsert = true;
+};
+
+} // namespace simplaylist
@@ -0,0 +1,319 @@
+//
+//  StreamingImport.mm
+//  foo_simplaylist_mac
+//
+
+#import <Foundation/Foundation.h>
+#include "StreamingImport.h"
+#include <algorithm>
+
+namespace simplaylist {
+
+namespace {
+
+// Same order the playlist gets from metadb_handle_list::sort_by_path, so
+// batches line up with each other and with the per-batch sort
+bool pathLess(const std::string& a, const std::string& b) {
+    return metadb::path_compare(a.c_str(), b.c_str()) < 0;
+}
+
+struct WalkUnit {
+    std::string path;
+    bool isDirectory = false;
+    bool filter = false;  // Found inside a dropped folder - keep playable files only
+};
+
+// All playable files under a directory, sorted
+std::vector<std::string> walkDirectory(const std::string& path, const std::atomic<bool>& cancelled) {
+    std::vector<std::string> files;
+    NSURL *root = [NSURL fileURLWithPath:[NSString stringWithUTF8String:path.c_str()] isDirectory:YES];
+    NSDirectoryEnumerator<NSURL *> *enumerator = [[NSFileManager defaultManager]
+        enumeratorAtURL:root
+        includingPropertiesForKeys:@[NSURLIsRegularFileKey]
+        options:NSDirectoryEnumerationSkipsHiddenFiles | NSDirectoryEnumerationSkipsPackageDescendants
+        errorHandler:nil];
+
+    for (NSURL *url in enumerator) {
+        if (cancelled.load(std::memory_order_relaxed)) break;
+        @autoreleasepool {
+            NSNumber *isFile = nil;
+            [url getResourceValue:&isFile forKey:NSURLIsRegularFileKey error:nil];
+            if (!isFile.boolValue) continue;
+            const char *filePath = url.path.fileSystemRepresentation;
+            if (filePath && input_entry::g_is_supported_path(filePath)) {
+                files.emplace_back(filePath);
+            }
+        }
+    }
+    std::sort(files.begin(), files.end(), pathLess);
+    return files;
+}
+
+} // namespace
+
+class StreamingImportNotify : public process_locations_notify {
+public:
+    StreamingImportNotify(std::shared_ptr<StreamingImport> owner, size_t locationCount)
+        : m_owner(std::move(owner)), m_locationCount(locationCount) {}
+
+    void on_completion(metadb_handle_list_cref items) override {
+        m_owner->batchResolved(items, m_locationCount);
+    }
+
+    void on_aborted() override {
+        m_owner->batchAborted();
+    }
+
+private:
+    std::shared_ptr<StreamingImport> m_owner;
+    size_t m_locationCount;
+};
+
+// Follows edits to the target playlist made by anything but the import itself
+class StreamingImportPlaylistCallback : public playlist_callback_impl_base {
+public:
+    explicit StreamingImportPlaylistCallback(StreamingImport* owner)
+        : playlist_callback_impl_base(flag_on_items_added | flag_on_items_removed | flag_on_items_reordered),
+          m_owner(owner) {}
+
+    void on_items_added(t_size p_playlist, t_size p_start, metadb_handle_list_cref p_data,
+                        const bit_array& p_selection) override {
+        if (isOutsideEdit(p_playlist)) m_owner->m_insertAt.itemsInserted(p_start, p_data.get_count());
+    }
+
+    void on_items_removed(t_size p_playlist, const bit_array& p_mask, t_size p_old_count,
+                          t_size p_new_count) override {
+        if (isOutsideEdit(p_playlist)) m_owner->m_insertAt.itemsRemoved(indexRunsFromMask(p_mask, p_old_count));
+    }
+
+    void on_items_reordered(t_size p_playlist, const t_size* p_order, t_size p_count) override {
+        if (isOutsideEdit(p_playlist)) m_owner->m_insertAt.itemsReordered();
+    }
+
+private:
+    bool isOutsideEdit(t_size playlist) const {
+        return !m_owner->m_inserting && playlist == m_owner->currentPlaylist();
+    }
+
+    StreamingImport* m_owner;
+};
+
+StreamingImport::StreamingImport(t_size playlist, t_size insertAt, ProgressHandler progress)
+    : m_playlist(playlist), m_playlistGuid(pfc::guid_null), m_progressHandler(std::move(progress)) {
+    m_insertAt.index = insertAt;
+    playlist_manager_v5::ptr pm5;
+    if (playlist_manager::get()->service_query_t(pm5)) m_playlistGuid = pm5->playlist_get_guid(playlist);
+    if (insertAt != SIZE_MAX) m_playlistCallback = std::make_unique<StreamingImportPlaylistCallback>(this);
+}
+
+StreamingImport::~StreamingImport() = default;
+
+std::shared_ptr<StreamingImport> StreamingImport::start(t_size playlist, t_size insertAt,
+                                                        std::vector<std::string> locations,
+                                                        bool expandFolders,
+                                                        ProgressHandler progress) {
+    auto import = std::make_shared<StreamingImport>(playlist, insertAt, std::move(progress));
+    locations.erase(std::remove(locations.begin(), locations.end(), std::string()), locations.end());
+    std::sort(locations.begin(), locations.end(), pathLess);
+
+    if (expandFolders) {
+        import->m_queue.beginUnits();
+        import->enumerate(std::move(locations));
+    } else {
+        import->m_queue.add(std::move(locations));
+    }
+    import->report();
+    import->pump();
+    return import;
+}
+
+void StreamingImport::cancel() {
+    if (m_progress.finished) return;
+    m_cancelled = true;
+    // A batch in flight finishes (and is dropped) in batchResolved
+    if (!m_batchInFlight) finish(true);
+}
+
+// Units are the dropped files plus the first-level entries of dropped folders,
+// so a single dropped library folder still spreads across all cores
+void StreamingImport::enumerate(std::vector<std::string> roots) {
+    std::shared_ptr<StreamingImport> self = shared_from_this();
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        std::vector<WalkUnit> units;
+        NSFileManager *fm = [NSFileManager defaultManager];
+        for (const std::string& root : roots) {
+            if (self->m_cancelled) break;
+            NSString *rootPath = [NSString stringWithUTF8String:root.c_str()];
+            BOOL isDirectory = NO;
+            if (![fm fileExistsAtPath:rootPath isDirectory:&isDirectory]) continue;
+            if (!isDirectory) {
+                units.push_back({root, false, false});  // Dropped file - the SDK decides (playlists, cue sheets)
+                continue;
+            }
+
+            std::vector<WalkUnit> children;
+            NSArray<NSURL *> *entries = [fm contentsOfDirectoryAtURL:[NSURL fileURLWithPath:rootPath isDirectory:YES]
+                                          includingPropertiesForKeys:@[NSURLIsDirectoryKey]
+                                                             options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                               error:nil];
+            for (NSURL *entry in entries) {
+                NSNumber *entryIsDirectory = nil;
+                [entry getResourceValue:&entryIsDirectory forKey:NSURLIsDirectoryKey error:nil];
+                const char *entryPath = entry.path.fileSystemRepresentation;
+                if (entryPath) children.push_back({entryPath, entryIsDirectory.boolValue == YES, true});
+            }
+            std::sort(children.begin(), children.end(),
+                      [](const WalkUnit& a, const WalkUnit& b) { return pathLess(a.path, b.path); });
+            units.insert(units.end(), children.begin(), children.end());
+        }
+
+        size_t unitCount = units.size();
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (self->m_progress.finished) return;
+            self->m_queue.setUnitCount(unitCount);
+            if (unitCount == 0) {
+                self->report();
+                self->pump();
+            }
+        });
+
+        // Walk units concurrently; each result goes to the main thread as soon as it is ready
+        const std::vector<WalkUnit>* walkUnits = &units;  // dispatch_apply is synchronous
+        dispatch_queue_t walkQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+        dispatch_apply(unitCount, walkQueue, ^(size_t i) {
+            auto files = std::make_shared<std::vector<std::string>>();
+            const WalkUnit& unit = (*walkUnits)[i];
+            if (!self->m_cancelled) {
+                if (unit.isDirectory) {
+                    *files = walkDirectory(unit.path, self->m_cancelled);
+                } else if (!unit.filter || input_entry::g_is_supported_path(unit.path.c_str())) {
+                    files->push_back(unit.path);
+                }
+            }
+            dispatch_async(dispatch_get_main_queue(), ^{
+                self->unitFinished(i, std::move(*files));
+            });
+        });
+    });
+}
+
+void StreamingImport::unitFinished(size_t unit, std::vector<std::string> files) {
+    if (m_progress.finished) return;
+    m_queue.unitFinished(unit, std::move(files));
+    report();
+    pump();
+}
+
+void StreamingImport::pump() {
+    if (m_progress.finished || m_batchInFlight) return;
+    if (m_cancelled) {
+        finish(true);
+        return;
+    }
+    if (m_queue.drained()) {
+        finish(false);
+        return;
+    }
+
+    std::vector<std::string> batch = m_queue.nextBatch();
+    if (batch.empty()) return;  // Waiting for folder walks to fill a batch
+
+    size_t count = batch.size();
+    pfc::list_t<const char*> paths;
+    for (const std::string& path : batch) {
+        paths.add_item(path.c_str());
+    }
+
+    m_batchInFlight = true;
+    auto notify = fb2k::service_new<StreamingImportNotify>(shared_from_this(), count);
+    playlist_incoming_item_filter_v2::get()->process_locations_async(
+        paths,
+        playlist_incoming_item_filter_v2::op_flag_no_filter |
+        playlist_incoming_item_filter_v2::op_flag_delay_ui |
+        playlist_incoming_item_filter_v2::op_flag_background,
+        nullptr, nullptr, nullptr,
+        notify
+    );
+}
+
+// Target playlist's index now (SIZE_MAX = removed). Playlists added, removed
+// or reordered while the import runs move it.
+t_size StreamingImport::currentPlaylist() const {
+    auto pm = playlist_manager::get();
+    if (m_playlistGuid != pfc::guid_null) {
+        playlist_manager_v5::ptr pm5;
+        if (pm->service_query_t(pm5)) return pm5->find_playlist_by_guid(m_playlistGuid);
+    }
+    return m_playlist < pm->get_playlist_count() ? m_playlist : SIZE_MAX;
+}
+
+void StreamingImport::batchResolved(metadb_handle_list_cref items, size_t locationCount) {
+    m_batchInFlight = false;
+    m_progress.locationsResolved += locationCount;
+    if (m_progress.finished) return;
+    if (m_cancelled) {
+        finish(true);
+        return;
+    }
+
+    auto pm = playlist_manager::get();
+    t_size playlist = currentPlaylist();
+    if (playlist == SIZE_MAX) {
+        finish(true);
+        return;
+    }
+
+    if (items.get_count() > 0) {
+        // process_locations_async doesn't preserve order for folder drops
+        metadb_handle_list sortedItems(items);
+        sortedItems.sort_by_path();
+
+        bool firstInsert = m_firstInsert;
+        if (firstInsert) {
+            pm->playlist_undo_backup(playlist);
+            // Clear existing selection before inserting new items
+            pm->playlist_set_selection(playlist, pfc::bit_array_true(), pfc::bit_array_false());
+            m_firstInsert = false;
+        }
+        // Insert and select the new items; later batches go right after this one
+        m_inserting = true;
+        t_size base = pm->playlist_insert_items(playlist, m_insertAt.index, sortedItems, pfc::bit_array_val(true));
+        m_inserting = false;
+        if (base == SIZE_MAX) {  // Locked meanwhile
+            finish(true);
+            return;
+        }
+        if (m_insertAt.index != SIZE_MAX) m_insertAt.index = base + sortedItems.get_count();
+        m_progress.itemsInserted += sortedItems.get_count();
+        if (firstInsert) pm->playlist_set_focus_item(playlist, base);
+    }
+
+    report();
+    pump();
+}
+
+void StreamingImport::batchAborted() {
+    // User dismissed the SDK's progress dialog - stop the whole import
+    m_batchInFlight = false;
+    m_cancelled = true;
+    finish(true);
+}
+
+void StreamingImport::finish(bool cancelled) {
+    if (m_progress.finished) return;
+    m_progress.finished = true;
+    m_progress.cancelled = cancelled;
+    m_progress.enumerating = false;
+    m_cancelled = true;  // Stops folder walkers still running
+    m_queue.clear();
+    m_playlistCallback.reset();
+    report();
+}
+
+void StreamingImport::report() {
+    if (!m_progress.finished) m_progress.enumerating = m_queue.enumerating();
+    m_progress.locationsFound = m_queue.locationsFound();
+    if (m_progressHandler) m_progressHandler(m_progress);
+}
+
+} // namespace simplaylist
@@ -0,0 +1,121 @@
+//
+//  TileManager.cpp
+//  foo_simplaylist_mac
+//
+
+#include "TileManager.h"
+#include <algorithm>
+#include <cmath>
+
+namespace simplaylist {
+
+void TileManager::setTileHeight(double height) {
+    if (height <= 0 || height == m_tileHeight) return;
+    releaseAll();
+    m_tileHeight = height;
+}
+
+void TileManager::setContentHeight(double height) {
+    height = std::max(0.0, height);
+    if (height == m_contentHeight) return;
+
+    // The tiles holding the old and new end show a partial last row range
+    if (m_contentHeight > 0) invalidateSpan(m_contentHeight - 1, m_contentHeight);
+    m_contentHeight = height;
+    if (height > 0) invalidateSpan(height - 1, height);
+}
+
+int64_t TileManager::tileCount() const {
+    if (m_contentHeight <= 0) return 0;
+    return (int64_t)std::ceil(m_contentHeight / m_tileHeight);
+}
+
+double TileManager::tileHeightAt(int64_t tile) const {
+    double top = tileTop(tile);
+    return std::max(0.0, std::min(m_tileHeight, m_contentHeight - top));
+}
+
+TileManager::Range TileManager::tilesForSpan(double top, double bottom) const {
+    Range range;
+    int64_t count = tileCount();
+    top = std::max(0.0, top);
+    bottom = std::min(m_contentHeight, bottom);
+    if (count == 0 || bottom <= top) return range;
+
+    range.first = std::min(count - 1, (int64_t)std::floor(top / m_tileHeight));
+    range.last = std::min(count - 1, (int64_t)std::ceil(bottom / m_tileHeight) - 1);
+    range.last = std::max(range.first, range.last);
+    return range;
+}
+
+TileManager::Update TileManager::update(double visibleTop, double visibleBottom, int64_t overscanTiles) {
+    Update result;
+    result.released.swap(m_pendingRelease);
+
+    Range visible = tilesForSpan(visibleTop, visibleBottom);
+    Range resident;
+    if (!visible.empty()) {
+        resident.first = std::max<int64_t>(0, visible.first - overscanTiles);
+        resident.last = std::min(tileCount() - 1, visible.last + overscanTiles);
+    }
+
+    for (int64_t tile = m_resident.first; tile <= m_resident.last; tile++) {
+        if (!resident.contains(tile)) result.released.push_back(tile);
+    }
+
+    auto needsDraw = [&](int64_t tile) {
+        return !m_resident.contains(tile) || m_allDirty || m_dirty.count(tile) != 0;
+    };
+
+    // Visible tiles first, then overscan outward from the viewport
+    for (int64_t tile = visible.first; tile <= visible.last; tile++) {
+        if (needsDraw(tile)) result.toDraw.push_back(tile);
+    }
+    for (int64_t step = 1; step <= overscanTiles; step++) {
+        int64_t above = visible.first - step;
+        int64_t below = visible.last + step;
+        if (resident.contains(above) && needsDraw(above)) result.toDraw.push_back(above);
+        if (resident.contains(below) && needsDraw(below)) result.toDraw.push_back(below);
+    }
+
+    m_resident = resident;
+    m_dirty.clear();
+    m_allDirty = false;
+    return result;
+}
+
+void TileManager::invalidateSpan(double top, double bottom) {
+    if (m_resident.empty() || m_allDirty) return;
+    Range range = tilesForSpan(top, bottom);
+    int64_t first = std::max(range.first, m_resident.first);
+    int64_t last = std::min(range.last, m_resident.last);
+    for (int64_t tile = first; tile <= last; tile++) {
+        m_dirty.insert(tile);
+    }
+}
+
+void TileManager::invalidateFrom(double top) {
+    if (m_resident.empty() || m_allDirty) return;
+    // Resident tiles past the content end are released on the next update
+    int64_t first = std::max(m_resident.first, (int64_t)std::floor(std::max(0.0, top) / m_tileHeight));
+    for (int64_t tile = first; tile <= m_resident.last; tile++) {
+        m_dirty.insert(tile);
+    }
+}
+
+void TileManager::invalidateAll() {
+    if (m_resident.empty()) return;
+    m_allDirty = true;
+    m_dirty.clear();
+}
+
+void TileManager::releaseAll() {
+    for (int64_t tile = m_resident.first; tile <= m_resident.last; tile++) {
+        m_pendingRelease.push_back(tile);
+    }
+    m_resident = Range();
+    m_dirty.clear();
+    m_allDirty = false;
+}
+
+} // namespace simplaylist
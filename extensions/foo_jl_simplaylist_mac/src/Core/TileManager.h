@@ -0,0 +1,79 @@
+//
+//  TileManager.h
+//  foo_simplaylist_mac
+//
+//  Bookkeeping for tiled playlist rendering: content is split into fixed-height
+//  horizontal tiles, only tiles around the viewport are resident, and a tile is
+//  drawn again only when it becomes resident or something inside it changed.
+//  Pure C++ (no SDK/Cocoa dependency) - the view maps tiles to layers.
+//
+
+#pragma once
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace simplaylist {
+
+class TileManager {
+public:
+    struct Range {
+        int64_t first = 0;
+        int64_t last = -1;  // Inclusive; last < first = empty
+
+        bool empty() const { return last < first; }
+        bool contains(int64_t tile) const { return tile >= first && tile <= last; }
+        bool operator==(const Range& other) const {
+            return (empty() && other.empty()) || (first == other.first && last == other.last);
+        }
+    };
+
+    struct Update {
+        std::vector<int64_t> released;  // No longer resident - their layers can be reused
+        std::vector<int64_t> toDraw;    // Newly resident or invalidated, visible tiles first
+    };
+
+    // Tile height in points (> 0). Changing it releases every tile.
+    void setTileHeight(double height);
+    double tileHeight() const { return m_tileHeight; }
+
+    // Total content height in points. Tiles past the new end are released on the
+    // next update; the tiles holding the old and new end are redrawn.
+    void setContentHeight(double height);
+    double contentHeight() const { return m_contentHeight; }
+
+    int64_t tileCount() const;
+    double tileTop(int64_t tile) const { return (double)tile * m_tileHeight; }
+    double tileHeightAt(int64_t tile) const;  // Last tile may be shorter
+
+    // Tiles overlapping [top, bottom), clamped to the content
+    Range tilesForSpan(double top, double bottom) const;
+
+    // Make the tiles covering [visibleTop, visibleBottom) plus overscanTiles on each
+    // side resident; report released tiles and the tiles that need drawing
+    Update update(double visibleTop, double visibleBottom, int64_t overscanTiles);
+
+    // Mark resident tiles overlapping [top, bottom) for redraw on the next update
+    void invalidateSpan(double top, double bottom);
+    // Rows from top down moved (items inserted or removed above them): mark the
+    // resident tiles from top to the end for redraw, tiles above keep their content
+    void invalidateFrom(double top);
+    void invalidateAll();
+
+    // Forget every tile (all are reported as released on the next update)
+    void releaseAll();
+
+    const Range& residentRange() const { return m_resident; }
+    bool isResident(int64_t tile) const { return m_resident.contains(tile); }
+    bool isDirty(int64_t tile) const { return m_dirty.count(tile) != 0; }
+
+private:
+    double m_tileHeight = 512;
+    double m_contentHeight = 0;
+    Range m_resident;
+    std::unordered_set<int64_t> m_dirty;  // Resident tiles awaiting redraw
+    bool m_allDirty = false;
+    std::vector<int64_t> m_pendingRelease;  // From releaseAll / tile height changes
+};
+
+} // namespace simplaylist
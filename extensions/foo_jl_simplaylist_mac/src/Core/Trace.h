@@ -0,0 +1,21 @@
+//
+//  Trace.h
+//  foo_simplaylist_mac
+//
+//  Diagnostic logging for hot paths. Compiled out unless the build defines
+//  SIMPLAYLIST_TRACE_ENABLED=1, so call sites cost nothing in release builds.
+//  Usage: SIMPLAYLIST_TRACE("bad index " << index);
+//
+
+#pragma once
+
+#ifndef SIMPLAYLIST_TRACE_ENABLED
+#define SIMPLAYLIST_TRACE_ENABLED 0
+#endif
+
+#if SIMPLAYLIST_TRACE_ENABLED
+#include "../fb2k_sdk.h"
+#define SIMPLAYLIST_TRACE(message) (FB2K_console_formatter() << "[SimPlaylist] " << message)
+#else
+#define SIMPLAYLIST_TRACE(message) ((void)0)
+#endif
@@ -12,6 +12,8 @@
 #import "../UI/SimPlaylistView.h"
 #import "../UI/SimPlaylistController.h"
 #import "PlaylistCallbacks.h"
+#include "../Core/CoverProbeCache.h"
+#import "../Core/AlbumArtCache.h"
 #import "../../../../shared/JLConstraintDebugger.h"
 
 // Component version declaration with unified branding
@@ -91,6 +93,20 @@ public:
 
     void on_quit() override {
         SimPlaylistCallbackManager::instance().shutdownCallbacks();
+
+        auto probeStats = simplaylist::CoverProbeCache::instance().stats();
+        if (probeStats.hits + probeStats.misses > 0) {
+            FB2K_console_formatter() << "[SimPlaylist] Cover probe cache: " << probeStats.hits << " hits, "
+                                     << probeStats.misses << " directory listings, "
+                                     << probeStats.syscallsSaved << " file system calls saved";
+        }
+
+        AlbumArtLoadStats artStats = [AlbumArtCache loadStats];
+        if (artStats.decodes + artStats.cancelled > 0) {
+            FB2K_console_formatter() << "[SimPlaylist] Album art loads: " << artStats.decodes << " decoded ("
+                                     << artStats.wastedDecodes << " wasted off-screen), "
+                                     << artStats.cancelled << " cancelled before decoding";
+        }
         console::info("[SimPlaylist] Component shutting down");
     }
 };
@@ -9,6 +9,8 @@
 
 #import <Cocoa/Cocoa.h>
 #include "../fb2k_sdk.h"
+#include "../Core/GroupDetection.h"
+#include "../Core/SelectionBitArray.h"
 
 @class SimPlaylistController;
 
@@ -22,12 +24,16 @@ public:
 
     // Playlist event dispatch
     void onPlaylistSwitched();
-    void onItemsAdded(t_size base, t_size count);
-    void onItemsRemoved();
-    void onItemsReordered();
+    void onItemsAdded(t_size base, t_size count, const bit_array& selection);
+    void onItemsRemoved(const bit_array& mask, t_size oldCount, t_size newCount);
+    void onItemsReordered(const t_size* order, t_size count);
     void onSelectionChanged();
     void onFocusChanged(t_size from, t_size to);
-    void onItemsModified();
+    void onItemsModified(const bit_array& mask);
+
+    // Sequence number of the last structural playlist event (add/remove/reorder/modify/switch).
+    // Read on the main thread by a full rebuild: queued events at or below it are already reflected.
+    uint64_t eventSerial() const;
 
     // Playback event dispatch
     void onPlaybackNewTrack(metadb_handle_ptr track);
@@ -44,3 +50,4 @@ private:
 // Convenience functions
 void SimPlaylistCallbackManager_registerController(SimPlaylistController* controller);
 void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* controller);
+uint64_t SimPlaylistCallbackManager_eventSerial();
@@ -7,6 +7,7 @@
 
 #import "PlaylistCallbacks.h"
 #import "../UI/SimPlaylistController.h"
+#import <atomic>
 #import <mutex>
 #import <vector>
 
@@ -14,6 +15,9 @@
 static std::mutex g_controllersMutex;
 static std::vector<__weak SimPlaylistController*> g_controllers;
 
+// Structural event sequence (playlist callbacks arrive on the main thread)
+static std::atomic<uint64_t> g_eventSerial{0};
+
 // Callback manager implementation
 SimPlaylistCallbackManager& SimPlaylistCallbackManager::instance() {
     static SimPlaylistCallbackManager manager;
@@ -39,7 +43,12 @@ void SimPlaylistCallbackManager::unregisterController(SimPlaylistController* con
     );
 }
 
+uint64_t SimPlaylistCallbackManager::eventSerial() const {
+    return g_eventSerial.load();
+}
+
 void SimPlaylistCallbackManager::onPlaylistSwitched() {
+    ++g_eventSerial;
     dispatch_async(dispatch_get_main_queue(), ^{
         std::lock_guard<std::mutex> lock(g_controllersMutex);
         for (__weak SimPlaylistController* weak : g_controllers) {
@@ -49,34 +58,46 @@ void SimPlaylistCallbackManager::onPlaylistSwitched() {
     });
 }
 
-void SimPlaylistCallbackManager::onItemsAdded(t_size base, t_size count) {
+void SimPlaylistCallbackManager::onItemsAdded(t_size base, t_size count, const bit_array& selection) {
+    // Selection of the inserted items, relative to base - captured as runs like removals
+    simplaylist::SelectionModel inserted = simplaylist::selectionFromMask(selection, count);
     NSInteger b = base;
     NSInteger cnt = count;
+    uint64_t serial = ++g_eventSerial;
     dispatch_async(dispatch_get_main_queue(), ^{
         std::lock_guard<std::mutex> lock(g_controllersMutex);
         for (__weak SimPlaylistController* weak : g_controllers) {
             SimPlaylistController* c = weak;
-            if (c) [c handleItemsAdded:b count:cnt];
+            if (c) [c handleItemsAdded:b count:cnt selection:inserted serial:serial];
         }
     });
 }
 
-void SimPlaylistCallbackManager::onItemsRemoved() {
+void SimPlaylistCallbackManager::onItemsRemoved(const bit_array& mask, t_size oldCount, t_size newCount) {
+    // Mask is only valid during the callback - capture it as runs
+    simplaylist::IndexRuns removed = simplaylist::indexRunsFromMask(mask, oldCount);
+    NSInteger oldCnt = oldCount;
+    NSInteger newCnt = newCount;
+    uint64_t serial = ++g_eventSerial;
     dispatch_async(dispatch_get_main_queue(), ^{
         std::lock_guard<std::mutex> lock(g_controllersMutex);
         for (__weak SimPlaylistController* weak : g_controllers) {
             SimPlaylistController* c = weak;
-            if (c) [c handleItemsRemoved];
+            if (c) [c handleItemsRemoved:removed oldCount:oldCnt newCount:newCnt serial:serial];
         }
     });
 }
 
-void SimPlaylistCallbackManager::onItemsReordered() {
+void SimPlaylistCallbackManager::onItemsReordered(const t_size* order, t_size count) {
+    // Order is only valid during the callback - copy it so a move we started
+    // can be matched against its plan
+    std::vector<t_size> newOrder(order, order + count);
+    uint64_t serial = ++g_eventSerial;
     dispatch_async(dispatch_get_main_queue(), ^{
         std::lock_guard<std::mutex> lock(g_controllersMutex);
         for (__weak SimPlaylistController* weak : g_controllers) {
             SimPlaylistController* c = weak;
-            if (c) [c handleItemsReordered];
+            if (c) [c handleItemsReordered:newOrder serial:serial];
         }
     });
 }
@@ -103,12 +124,15 @@ void SimPlaylistCallbackManager::onFocusChanged(t_size from, t_size to) {
     });
 }
 
-void SimPlaylistCallbackManager::onItemsModified() {
+void SimPlaylistCallbackManager::onItemsModified(const bit_array& mask) {
+    t_size itemCount = playlist_manager::get()->activeplaylist_get_item_count();
+    simplaylist::IndexRuns modified = simplaylist::indexRunsFromMask(mask, itemCount);
+    uint64_t serial = ++g_eventSerial;
     dispatch_async(dispatch_get_main_queue(), ^{
         std::lock_guard<std::mutex> lock(g_controllersMutex);
         for (__weak SimPlaylistController* weak : g_controllers) {
             SimPlaylistController* c = weak;
-            if (c) [c handleItemsModified];
+            if (c) [c handleItemsModified:modified serial:serial];
         }
     });
 }
@@ -138,6 +162,10 @@ void SimPlaylistCallbackManager_registerController(SimPlaylistController* contro
     SimPlaylistCallbackManager::instance().registerController(controller);
 }
 
+uint64_t SimPlaylistCallbackManager_eventSerial() {
+    return SimPlaylistCallbackManager::instance().eventSerial();
+}
+
 void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* controller) {
     SimPlaylistCallbackManager::instance().unregisterController(controller);
 }
@@ -156,15 +184,15 @@ public:
     ) {}
 
     void on_items_added(t_size base, metadb_handle_list_cref data, const bit_array& selection) override {
-        SimPlaylistCallbackManager::instance().onItemsAdded(base, data.get_count());
+        SimPlaylistCallbackManager::instance().onItemsAdded(base, data.get_count(), selection);
     }
 
     void on_items_removed(const bit_array& mask, t_size old_count, t_size new_count) override {
-        SimPlaylistCallbackManager::instance().onItemsRemoved();
+        SimPlaylistCallbackManager::instance().onItemsRemoved(mask, old_count, new_count);
     }
 
     void on_items_reordered(const t_size* order, t_size count) override {
-        SimPlaylistCallbackManager::instance().onItemsReordered();
+        SimPlaylistCallbackManager::instance().onItemsReordered(order, count);
     }
 
     void on_items_selection_change(const bit_array& affected, const bit_array& state) override {
@@ -176,7 +204,7 @@ public:
     }
 
     void on_items_modified(const bit_array& mask) override {
-        SimPlaylistCallbackManager::instance().onItemsModified();
+        SimPlaylistCallbackManager::instance().onItemsModified(mask);
     }
 
     void on_playlist_switch() override {
@@ -9,6 +9,8 @@
 
 #import <Cocoa/Cocoa.h>
 #include "../fb2k_sdk.h"
+#include "../Core/GroupDetection.h"
+#include "../Core/SelectionModel.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -20,13 +22,21 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) SimPlaylistView *playlistView;
 
 // Playlist event handlers (called from PlaylistCallbacks)
+// serial: callback sequence number - events already reflected by a full rebuild are skipped
 - (void)handlePlaylistSwitched;
-- (void)handleItemsAdded:(NSInteger)base count:(NSInteger)count;
-- (void)handleItemsRemoved;
-- (void)handleItemsReordered;
+// selection: which inserted items arrive selected (indices relative to base)
+- (void)handleItemsAdded:(NSInteger)base
+                   count:(NSInteger)count
+               selection:(const simplaylist::SelectionModel &)selection
+                  serial:(uint64_t)serial;
+- (void)handleItemsRemoved:(const simplaylist::IndexRuns &)removed
+                  oldCount:(NSInteger)oldCount
+                  newCount:(NSInteger)newCount
+                    serial:(uint64_t)serial;
+- (void)handleItemsReordered:(const std::vector<t_size> &)order serial:(uint64_t)serial;
 - (void)handleSelectionChanged;
 - (void)handleFocusChanged:(NSInteger)from to:(NSInteger)to;
-- (void)handleItemsModified;
+- (void)handleItemsModified:(const simplaylist::IndexRuns &)modified serial:(uint64_t)serial;
 
 // Playback event handlers
 - (void)handlePlaybackNewTrack:(metadb_handle_ptr)track;
@@ -13,258 +13,262 @@
 #import "../Core/ColumnDefinition.h"
 #import "../Core/GroupPreset.h"
 #import "../Core/TitleFormatHelper.h"
+#import "../Core/ColumnFormatEngine.h"
+#include "../Core/ColumnSet.h"
+#import "../Core/GroupDetection.h"
+#include "../Core/GroupEstimate.h"
+#import "../Core/GroupLayoutCache.h"
 #import "../Core/ConfigHelper.h"
 #import "../Core/AlbumArtCache.h"
-
-#include <set>
+#include "../Core/ReorderEngine.h"
+#include "../Core/SelectionBitArray.h"
+#include "../Core/StreamingImport.h"
+#include "../Core/ScrollAnchorStore.h"
+#include "../Core/SearchIndex.h"
+#include "../Core/SortEngine.h"
+#include "../Core/Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 
+// Global debug flag - set to true to enable debug logging
+// Output goes to /tmp/simplaylist_subgroup_debug.txt
+static bool g_subgroupDebugEnabled = false;
+
 // =============================================================================
-// SUBGROUP DETECTION HELPER
+// GROUP DETECTION HELPERS
 // =============================================================================
-// Encapsulates subgroup detection logic to ensure all code paths use IDENTICAL logic.
-// This eliminates bugs where one path is fixed but another isn't.
-
-struct SubgroupDetector {
-    pfc::string8 currentSubgroup;  // Tracks the current subgroup value
-    bool showFirstSubgroup;         // Config setting
-
-    // Debug logging support
-    FILE* debugFile;
-    bool debugEnabled;
-
-    SubgroupDetector(bool showFirst, bool enableDebug = false)
-        : currentSubgroup("")
-        , showFirstSubgroup(showFirst)
-        , debugFile(nullptr)
-        , debugEnabled(enableDebug)
-    {
-        if (debugEnabled) {
-            debugFile = fopen("/tmp/simplaylist_subgroup_debug.txt", "a");
-            if (debugFile) {
-                fprintf(debugFile, "\n=== New SubgroupDetector created (showFirst=%d) ===\n", showFirst);
-                fflush(debugFile);
-            }
-        }
-    }
-
-    ~SubgroupDetector() {
-        if (debugFile) {
-            fclose(debugFile);
-        }
-    }
 
-    // Initialize from existing state (for continuation from partial detection)
-    void initFromState(const char* existingSubgroup) {
-        currentSubgroup = existingSubgroup;
-        if (debugEnabled && debugFile) {
-            fprintf(debugFile, "initFromState: '%s'\n", existingSubgroup);
-            fflush(debugFile);
-        }
-    }
+// View-ready snapshot of a detection result (built off the main thread)
+struct GroupViewArrays {
+    std::vector<int64_t> groupStarts;
+    NSArray<NSString *> *groupHeaders;
+    NSArray<NSString *> *groupArtKeys;
+    std::vector<int64_t> subgroupStarts;
+    NSArray<NSString *> *subgroupHeaders;
+    // Placeholder groups (GroupEstimate) at either end while detection is partial
+    size_t estimatedLeadingGroups = 0;
+    size_t estimatedTrailingGroups = 0;
+};
 
-    // Call when entering a new group - clears subgroup tracking
-    void enterNewGroup() {
-        currentSubgroup = "";
-        if (debugEnabled && debugFile) {
-            fprintf(debugFile, "enterNewGroup: cleared currentSubgroup\n");
-            fflush(debugFile);
-        }
+static NSArray<NSString *> *stringArrayFromVector(const std::vector<std::string>& strings) {
+    NSMutableArray<NSString *> *array = [NSMutableArray arrayWithCapacity:strings.size()];
+    for (const std::string& str : strings) {
+        [array addObject:[NSString stringWithUTF8String:str.c_str()] ?: @""];
     }
+    return array;
+}
 
-    // Check if a subgroup header should be added for this track
-    // Returns: true if subgroup header should be added
-    // Updates: currentSubgroup tracking state
-    bool shouldAddSubgroup(const pfc::string8& formattedSubgroup, bool isNewGroup,
-                           NSMutableArray<NSNumber*>* subgroupStarts,
-                           NSMutableArray<NSString*>* subgroupHeaders,
-                           t_size playlistIndex, const char* debugTrackName = nullptr) {
-
-        // Only consider non-empty subgroup values (ignore tracks with missing disc tags)
-        if (formattedSubgroup.get_length() == 0) {
-            if (debugEnabled && debugFile) {
-                fprintf(debugFile, "[%zu] '%s': empty subgroup, skipped\n",
-                        playlistIndex, debugTrackName ? debugTrackName : "");
-                fflush(debugFile);
-            }
-            return false;
-        }
-
-        bool isFirstSubgroupInGroup = (currentSubgroup.get_length() == 0);
-        bool isDifferentSubgroup = (strcmp(formattedSubgroup.c_str(), currentSubgroup.c_str()) != 0);
-
-        bool shouldAdd = false;
-        const char* reason = "";
-
-        if (isFirstSubgroupInGroup) {
-            // First non-empty subgroup in this group
-            // Only add if: (1) this is the start of a new group, AND (2) showFirstSubgroup is enabled
-            if (isNewGroup && showFirstSubgroup) {
-                shouldAdd = true;
-                reason = "first subgroup at group start (showFirst=ON)";
-            } else {
-                reason = isNewGroup ? "first subgroup but showFirst=OFF" : "first subgroup but NOT at group start";
-            }
-        } else if (isDifferentSubgroup) {
-            // Real disc change (e.g., Disc 1 -> Disc 2) - always show
-            shouldAdd = true;
-            reason = "disc change";
-        } else {
-            reason = "same subgroup";
-        }
-
-        if (debugEnabled && debugFile) {
-            fprintf(debugFile, "[%zu] '%s': subgroup='%s' (len=%zu), current='%s', isNew=%d, isFirst=%d, isDiff=%d -> %s: %s\n",
-                    playlistIndex,
-                    debugTrackName ? debugTrackName : "",
-                    formattedSubgroup.c_str(),
-                    formattedSubgroup.get_length(),
-                    currentSubgroup.c_str(),
-                    isNewGroup,
-                    isFirstSubgroupInGroup,
-                    isDifferentSubgroup,
-                    shouldAdd ? "ADD" : "SKIP",
-                    reason);
-            fflush(debugFile);
-        }
+static std::vector<int64_t> startsFromVector(const std::vector<t_size>& indices) {
+    return std::vector<int64_t>(indices.begin(), indices.end());
+}
 
-        if (shouldAdd) {
-            [subgroupStarts addObject:@(playlistIndex)];
-            [subgroupHeaders addObject:[NSString stringWithUTF8String:formattedSubgroup.c_str()]];
+// Subgroups per group (a subgroup starting at a group's first track belongs to that group)
+static std::vector<int32_t> subgroupCountsPerGroup(const std::vector<int64_t>& groupStarts,
+                                                   const std::vector<int64_t>& subgroupStarts) {
+    std::vector<int32_t> counts(groupStarts.size(), 0);
+    size_t groupIndex = 0;
+    for (int64_t subgroupStart : subgroupStarts) {
+        while (groupIndex + 1 < groupStarts.size() && groupStarts[groupIndex + 1] <= subgroupStart) {
+            groupIndex++;
         }
-
-        // Always update currentSubgroup when formatted value is non-empty
-        currentSubgroup = formattedSubgroup;
-
-        return shouldAdd;
+        if (groupIndex < counts.size()) counts[groupIndex]++;
     }
+    return counts;
+}
 
-    // Get current subgroup value (for passing to continuation)
-    const char* getCurrentSubgroup() const {
-        return currentSubgroup.c_str();
-    }
-};
-
-// Global debug flag - set to true to enable debug logging
-// Output goes to /tmp/simplaylist_subgroup_debug.txt
-static bool g_subgroupDebugEnabled = false;
-
-// =============================================================================
-// ASYNC FILE IMPORT (copied from Plorg's working implementation)
-// =============================================================================
-
-class SimPlaylistImportNotify : public process_locations_notify {
-public:
-    t_size m_playlistIndex;
-    t_size m_insertAt;
-    pfc::string_list_impl m_paths;  // Keeps paths alive during async operation
-
-    SimPlaylistImportNotify(t_size playlistIndex, t_size insertAt)
-        : m_playlistIndex(playlistIndex), m_insertAt(insertAt) {}
+// Drop subgroups in groups that only have one subgroup (hideSingleSubgroup setting).
+// Updates starts, headers and counts in place.
+static void filterSingleSubgroups(const std::vector<int64_t>& groupStarts,
+                                  std::vector<int32_t>& counts,
+                                  std::vector<int64_t>& subgroupStarts,
+                                  NSArray<NSString *> *__strong &subgroupHeaders) {
+    std::vector<int64_t> filteredStarts;
+    NSMutableArray<NSString *> *filteredHeaders = [NSMutableArray array];
 
-    void on_completion(metadb_handle_list_cref items) override {
-        if (items.get_count() > 0) {
-            auto pm = playlist_manager::get();
-            if (m_playlistIndex < pm->get_playlist_count()) {
-                // Sort items by path for proper track ordering
-                // (process_locations_async doesn't preserve order for folder drops)
-                metadb_handle_list sortedItems(items);
-                sortedItems.sort_by_path();
-
-                pm->playlist_undo_backup(m_playlistIndex);
-                // Clear existing selection before inserting new items
-                pm->playlist_set_selection(m_playlistIndex, pfc::bit_array_true(), pfc::bit_array_false());
-                // Insert and select only the new items
-                pm->playlist_insert_items(m_playlistIndex, m_insertAt, sortedItems, pfc::bit_array_val(true));
-                // Set focus to first inserted item
-                pm->playlist_set_focus_item(m_playlistIndex, m_insertAt);
+    size_t groupIndex = 0;
+    for (size_t i = 0; i < subgroupStarts.size(); i++) {
+        while (groupIndex + 1 < groupStarts.size() && groupStarts[groupIndex + 1] <= subgroupStarts[i]) {
+            groupIndex++;
+        }
+        if (groupIndex < counts.size() && counts[groupIndex] > 1) {
+            filteredStarts.push_back(subgroupStarts[i]);
+            if (i < subgroupHeaders.count) {
+                [filteredHeaders addObject:subgroupHeaders[i]];
             }
         }
     }
 
-    void on_aborted() override {}
+    // Only update if we filtered something out
+    if (filteredStarts.size() != subgroupStarts.size()) {
+        subgroupStarts = std::move(filteredStarts);
+        subgroupHeaders = filteredHeaders;
+        counts = subgroupCountsPerGroup(groupStarts, subgroupStarts);
+    }
+}
 
-    void startImport() {
-        if (m_paths.get_count() == 0) return;
+// Mirror model splice ops into a string array. Inserted slots are filled from the
+// final model strings, so only the spliced groups create new NSStrings.
+static NSArray<NSString *> *spliceStringArray(NSArray<NSString *> *array,
+                                              const std::vector<simplaylist::SpliceOp>& ops,
+                                              const std::vector<std::string>& finalStrings) {
+    if (ops.empty()) return array;
 
-        pfc::list_t<const char*> pathPtrs;
-        for (t_size i = 0; i < m_paths.get_count(); i++) {
-            pathPtrs.add_item(m_paths[i]);
+    NSMutableArray *result = [array mutableCopy];
+    NSNull *placeholder = [NSNull null];
+    size_t firstTouched = SIZE_MAX;
+    for (const simplaylist::SpliceOp& op : ops) {
+        [result removeObjectsInRange:NSMakeRange(op.at, op.removeCount)];
+        for (size_t i = 0; i < op.insertCount; i++) {
+            [result insertObject:placeholder atIndex:op.at + i];
         }
-
-        playlist_incoming_item_filter_v2::get()->process_locations_async(
-            pathPtrs,
-            playlist_incoming_item_filter_v2::op_flag_no_filter |
-            playlist_incoming_item_filter_v2::op_flag_delay_ui |
-            playlist_incoming_item_filter_v2::op_flag_background,
-            nullptr, nullptr, nullptr,
-            this
-        );
+        firstTouched = std::min(firstTouched, op.at);
     }
-};
-
-static void importFilesToPlaylistAsync(t_size playlistIndex, t_size insertAt, NSArray<NSURL*>* urls) {
-    if (urls.count == 0) return;
-
-    auto pm = playlist_manager::get();
-    if (playlistIndex >= pm->get_playlist_count()) return;
 
-    // Sort URLs by filename (last path component) for proper track ordering
-    // Files are typically named with track numbers (e.g., "01 - Song.mp3")
-    NSArray<NSURL*>* sortedURLs = [urls sortedArrayUsingComparator:^NSComparisonResult(NSURL* a, NSURL* b) {
-        return [a.lastPathComponent localizedStandardCompare:b.lastPathComponent];
-    }];
-
-    auto notify = fb2k::service_new<SimPlaylistImportNotify>(playlistIndex, insertAt);
-
-    for (NSURL* url in sortedURLs) {
-        // Accept file URLs or URLs with file path (media library may use different scheme)
-        NSString* path = url.path;
-        if (path && path.length > 0) {
-            notify->m_paths.add_item([path UTF8String]);
+    NSUInteger count = MIN(result.count, (NSUInteger)finalStrings.size());
+    for (NSUInteger i = firstTouched; i < count; i++) {
+        if (result[i] == placeholder) {
+            result[i] = [NSString stringWithUTF8String:finalStrings[i].c_str()] ?: @"";
         }
     }
+    return result;
+}
 
-    notify->startImport();
+static GroupViewArrays makeGroupViewArrays(const simplaylist::GroupDetectionResult& result) {
+    GroupViewArrays arrays;
+    arrays.groupStarts = startsFromVector(result.groupStarts);
+    arrays.groupHeaders = stringArrayFromVector(result.groupHeaders);
+    arrays.groupArtKeys = stringArrayFromVector(result.groupArtKeys);
+    arrays.subgroupStarts = startsFromVector(result.subgroupStarts);
+    arrays.subgroupHeaders = stringArrayFromVector(result.subgroupHeaders);
+    return arrays;
 }
 
-// Import files using foobar2000 native paths (supports file://, mac-volume://, etc.)
-static void importFb2kPathsToPlaylistAsync(t_size playlistIndex, t_size insertAt, NSArray<NSString*>* fb2kPaths) {
-    if (fb2kPaths.count == 0) return;
+// Append a detection result whose items all follow out's
+static void appendDetectionResult(simplaylist::GroupDetectionResult& out,
+                                  const simplaylist::GroupDetectionResult& more) {
+    out.groupStarts.insert(out.groupStarts.end(), more.groupStarts.begin(), more.groupStarts.end());
+    out.groupHeaders.insert(out.groupHeaders.end(), more.groupHeaders.begin(), more.groupHeaders.end());
+    out.groupArtKeys.insert(out.groupArtKeys.end(), more.groupArtKeys.begin(), more.groupArtKeys.end());
+    out.subgroupStarts.insert(out.subgroupStarts.end(), more.subgroupStarts.begin(), more.subgroupStarts.end());
+    out.subgroupHeaders.insert(out.subgroupHeaders.end(), more.subgroupHeaders.begin(), more.subgroupHeaders.end());
+}
 
-    auto pm = playlist_manager::get();
-    if (playlistIndex >= pm->get_playlist_count()) return;
+// View arrays for a detection that covers [begin, end) only: placeholder groups
+// sized from it fill [0, begin) and [end, itemCount), so the content height
+// is close to the final one before detection completes
+static GroupViewArrays makePartialViewArrays(const simplaylist::GroupDetectionResult& detected,
+                                             t_size begin, t_size end, t_size itemCount) {
+    simplaylist::GroupEstimate estimate = simplaylist::measureGroups(detected, begin, end);
+    simplaylist::GroupDetectionResult partial;
+    simplaylist::appendEstimatedGroups(partial, 0, begin, estimate);
+    size_t leadingGroups = partial.groupStarts.size();
+    appendDetectionResult(partial, detected);
+    size_t detectedGroups = partial.groupStarts.size();
+    simplaylist::appendEstimatedGroups(partial, end, itemCount, estimate);
+
+    GroupViewArrays arrays = makeGroupViewArrays(partial);
+    arrays.estimatedLeadingGroups = leadingGroups;
+    arrays.estimatedTrailingGroups = partial.groupStarts.size() - detectedGroups;
+    return arrays;
+}
 
-    // Sort paths by filename for proper track ordering
-    NSArray<NSString*>* sortedPaths = [fb2kPaths sortedArrayUsingComparator:^NSComparisonResult(NSString* a, NSString* b) {
-        return [a.lastPathComponent localizedStandardCompare:b.lastPathComponent];
-    }];
+// Everything that affects detection output - part of the layout cache key
+static std::string groupingKeyForPreset(GroupPreset *preset) {
+    std::string key = [preset.headerPattern UTF8String] ?: "";
+    key += '\x1f';
+    key += [[preset subgroupPattern] UTF8String] ?: "";
+    key += '\x1f';
+    key += simplaylist_config::getConfigBool(
+        simplaylist_config::kShowFirstSubgroupHeader,
+        simplaylist_config::kDefaultShowFirstSubgroupHeader) ? '1' : '0';
+    return key;
+}
 
-    auto notify = fb2k::service_new<SimPlaylistImportNotify>(playlistIndex, insertAt);
+// Compile preset patterns and read subgroup settings (main thread)
+static simplaylist::GroupDetectionParams makeDetectionParams(GroupPreset *preset) {
+    simplaylist::GroupDetectionParams params;
+    static_api_ptr_t<titleformat_compiler>()->compile_safe_ex(
+        params.headerScript,
+        [preset.headerPattern UTF8String],
+        nullptr
+    );
 
-    for (NSString* path in sortedPaths) {
-        if (path && path.length > 0) {
-            // Pass foobar2000 native paths directly (file://, mac-volume://, etc.)
-            notify->m_paths.add_item([path UTF8String]);
-        }
+    NSString *subgroupPattern = [preset subgroupPattern];
+    if (subgroupPattern && subgroupPattern.length > 0) {
+        static_api_ptr_t<titleformat_compiler>()->compile_safe_ex(
+            params.subgroupScript,
+            [subgroupPattern UTF8String],
+            nullptr
+        );
     }
 
-    notify->startImport();
+    // Check if we should show the first subgroup header for each group
+    params.showFirstSubgroup = simplaylist_config::getConfigBool(
+        simplaylist_config::kShowFirstSubgroupHeader,
+        simplaylist_config::kDefaultShowFirstSubgroupHeader);
+    params.debug = g_subgroupDebugEnabled;
+    return params;
 }
 
 // Forward declare callback manager
 @class SimPlaylistController;
 void SimPlaylistCallbackManager_registerController(SimPlaylistController* controller);
 void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* controller);
+uint64_t SimPlaylistCallbackManager_eventSerial();
 
-@interface SimPlaylistController () <SimPlaylistViewDelegate, SimPlaylistHeaderBarDelegate> {
+@interface SimPlaylistController () <SimPlaylistViewDelegate, SimPlaylistHeaderBarDelegate, NSSearchFieldDelegate> {
     // Context menu manager - must be stored for execute_by_id to work
     contextmenu_manager_v2::ptr _contextMenuManager;
     contextmenu_manager::ptr _contextMenuManagerV1;
+    // Compiled column scripts - rebuilt in columnsDidChange, read by every formatting path
+    simplaylist::ColumnSet _columnSet;
+    pfc::string8 _legacyFormatBuffer;  // Reused by columnValuesForPlaylistIndex:
+    // Batch column formatter - compiled patterns + ring of formatted visible rows
+    simplaylist::ColumnFormatEngine _columnEngine;
+    // Complete group detection result for the current playlist. Playlist edits
+    // re-detect only the groups around the edit and splice them into this model.
+    simplaylist::GroupDetectionResult _groupModel;
+    simplaylist::GroupDetectionParams _groupParams;
+    GroupViewArrays _groupArrays;     // Unfiltered view arrays mirroring _groupModel
+    NSInteger _groupModelItemCount;   // Items covered by _groupModel (-1 = detection pending)
+    BOOL _groupModelGrouped;          // NO = flat list, model stays empty
+    uint64_t _rebuildEventSerial;     // Last callback serial reflected by rebuildFromPlaylist
+    simplaylist::DeferredInserts _deferredInserts;  // Inserts waiting for background detection
+    std::string _groupModelGroupingKey;  // Grouping configuration _groupModel was detected with
+    std::string _groupModelCacheKey;     // GroupLayoutCache key (empty = not cacheable)
+    GUID _currentPlaylistGuid;        // Identity of _currentPlaylistIndex - indices shift when playlists move
+    simplaylist::MovePlan _pendingMove;  // Drag move sent to the SDK, matched in handleItemsReordered
+    std::vector<std::shared_ptr<simplaylist::StreamingImport>> _imports;  // Drops still being inserted
+    // Search: folded column text of every item, kept in step with playlist edits while the search bar is open
+    simplaylist::SearchIndex _searchIndex;
+    std::vector<titleformat_object::ptr> _searchScripts;  // Column scripts the index was built with
+    BOOL _searchIndexReady;
+    uint64_t _searchIndexSerial;       // Last callback serial reflected by _searchIndex
+    std::shared_ptr<std::atomic<bool>> _searchBuildCancel;  // Background build in flight
+    std::string _searchQuery;          // Folded search field text
+    BOOL _searchAwaitingIndex;         // Query typed before the index was ready
+    std::vector<t_size> _searchMatches;  // Playlist indices matching _searchQuery, ascending
+    // Filter view: the view shows _filterRows (view item index -> playlist index)
+    BOOL _filterActive;
+    std::vector<t_size> _filterRows;
+    // Column sort: (column index, descending) of the last header sort, in key priority order
+    std::vector<std::pair<NSInteger, bool>> _sortKeys;
+    std::vector<t_size> _pendingSortOrder;  // Sort permutation sent to the SDK, matched in handleItemsReordered
+    std::shared_ptr<std::atomic<bool>> _sortCancel;  // Background key extraction in flight
 }
 @property (nonatomic, strong) SimPlaylistView *playlistView;
 @property (nonatomic, strong) SimPlaylistHeaderBar *headerBar;
 @property (nonatomic, strong) NSScrollView *scrollView;
+@property (nonatomic, strong) NSView *importProgressView;  // Created on first import
+@property (nonatomic, strong) NSProgressIndicator *importProgressBar;
+@property (nonatomic, strong) NSTextField *importProgressLabel;
+@property (nonatomic, strong) NSView *searchBar;  // Created on first Cmd+F / type-to-find
+@property (nonatomic, strong) NSSearchField *searchField;
+@property (nonatomic, strong) NSButton *filterCheckbox;
+@property (nonatomic, strong) NSTextField *searchStatusLabel;
 @property (nonatomic, strong) NSArray<ColumnDefinition *> *columns;
 @property (nonatomic, strong) NSArray<ColumnDefinition *> *availableColumnTemplates;  // Combined hardcoded + SDK columns
 @property (nonatomic, strong) NSArray<GroupPreset *> *groupPresets;
@@ -272,7 +276,6 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
 @property (nonatomic, assign) NSInteger currentPlaylistIndex;
 @property (nonatomic, assign) NSInteger playingPlaylistIndex;  // Track which playlist item is playing
 @property (nonatomic, assign) BOOL needsRedraw;  // Coalesced redraw flag
-@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSNumber *> *scrollAnchorIndices;  // First visible playlist index per playlist
 @property (nonatomic, assign) NSInteger scrollRestorePlaylistIndex;  // Playlist index for pending scroll restore (-1 = none)
 @property (nonatomic, assign) BOOL currentPlaylistInitialized;  // True after groups loaded and scroll position set
 @property (nonatomic, assign) BOOL isSettingSelection;  // Flag to skip callback when we're setting selection
@@ -292,13 +295,29 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
         _activePresetIndex = 0;
         _currentPlaylistIndex = -1;
         _playingPlaylistIndex = -1;
-        _scrollAnchorIndices = [NSMutableDictionary dictionary];
         _scrollRestorePlaylistIndex = -1;
         _currentPlaylistInitialized = NO;
+        _groupModelItemCount = -1;
+        [self columnsDidChange];
     }
     return self;
 }
 
+// Recompile column patterns - call whenever _columns changes (add/remove/reorder)
+- (void)columnsDidChange {
+    std::vector<std::string> patterns;
+    patterns.reserve(_columns.count);
+    for (ColumnDefinition *col in _columns) {
+        patterns.push_back(col.pattern ? std::string([col.pattern UTF8String]) : std::string());
+    }
+    _columnSet.setPatterns(patterns);
+    _columnEngine.setColumns(_columnSet);
+    // Sort keys refer to column positions
+    [self clearSortState];
+    // Search text is made of the column values
+    if ([self searchBarVisible]) [self startSearchIndexBuild];
+}
+
 - (void)loadView {
     // Create container view
     NSView *container = [[NSView alloc] initWithFrame:NSMakeRect(0, 0, 400, 300)];
@@ -340,6 +359,7 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
     _playlistView.albumArtSize = simplaylist_config::getConfigInt(
         simplaylist_config::kAlbumArtSize,
         simplaylist_config::kDefaultAlbumArtSize);
+    [[AlbumArtCache sharedCache] setThumbnailDisplaySize:_playlistView.albumArtSize];
     _playlistView.wantsLayer = YES;  // Layer backing for smooth drawing
 
     // Configure scroll view
@@ -372,6 +392,12 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
                                                  name:@"SimPlaylistRedrawNeeded"
                                                object:nil];
 
+    // Keep the scroll position of the shown playlist across restarts
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(applicationWillTerminate:)
+                                                 name:NSApplicationWillTerminateNotification
+                                               object:nil];
+
     // Register for callbacks
     SimPlaylistCallbackManager_registerController(self);
 
@@ -386,6 +412,9 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
     // Sync header bar horizontal scroll with content
     NSClipView *clipView = _scrollView.contentView;
     [_headerBar setScrollOffset:clipView.bounds.origin.x];
+
+    // Only tiles scrolled into range are drawn; the rest just move
+    [_playlistView updateTilesForVisibleRect];
 }
 
 - (void)scrollViewFrameDidChange:(NSNotification *)notification {
@@ -420,10 +449,11 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
         simplaylist_config::kAlbumArtSize,
         simplaylist_config::kDefaultAlbumArtSize);
     _playlistView.albumArtSize = newArtSize;
+    [[AlbumArtCache sharedCache] setThumbnailDisplaySize:newArtSize];
 
     // Store scroll anchor for current playlist so it gets restored after rebuild
     if (savedAnchorIndex >= 0 && _currentPlaylistIndex >= 0) {
-        _scrollAnchorIndices[@(_currentPlaylistIndex)] = @(savedAnchorIndex);
+        simplaylist::ScrollAnchorStore::instance().store(_currentPlaylistGuid, (t_size)savedAnchorIndex);
         _scrollRestorePlaylistIndex = _currentPlaylistIndex;
     }
 
@@ -432,9 +462,14 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
     [_headerBar setNeedsDisplay:YES];
 }
 
+- (void)applicationWillTerminate:(NSNotification *)notification {
+    [self saveCurrentScrollAnchor];
+    simplaylist::ScrollAnchorStore::instance().flush();
+}
+
 - (void)handleRedrawNeeded:(NSNotification *)notification {
     // Lightweight redraw for settings that don't affect grouping (e.g., dim parentheses, now playing shading)
-    [_playlistView clearFormattedValuesCache];
+    _columnEngine.invalidate();
     [_playlistView setNeedsDisplay:YES];
 }
 
@@ -477,6 +512,12 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
 }
 
 - (void)dealloc {
+    [self saveCurrentScrollAnchor];
+    simplaylist::ScrollAnchorStore::instance().flush();
+    // Stop imports - their progress handlers only hold a weak reference
+    for (auto& import : _imports) import->cancel();
+    [self cancelSearchIndexBuild];
+    [self cancelSort];
     // Remove notification observers
     [[NSNotificationCenter defaultCenter] removeObserver:self];
     // Unregister from callbacks
@@ -485,83 +526,6 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
 
 #pragma mark - Playlist Data Loading (SPARSE MODEL)
 
-// Helper to compute subgroup count per group (for O(1) lookup in totalRowsInGroup)
-- (void)updateSubgroupCountPerGroup {
-    NSArray<NSNumber *> *groupStarts = _playlistView.groupStarts;
-    NSArray<NSNumber *> *subgroupStarts = _playlistView.subgroupStarts;
-
-    NSMutableArray<NSNumber *> *counts = [NSMutableArray arrayWithCapacity:groupStarts.count];
-    for (NSUInteger g = 0; g < groupStarts.count; g++) {
-        [counts addObject:@(0)];
-    }
-
-    // For each subgroup, find which group it belongs to and increment that group's count
-    NSUInteger groupIndex = 0;
-    for (NSNumber *subgroupStart in subgroupStarts) {
-        NSInteger sgIndex = [subgroupStart integerValue];
-        // Find the group this subgroup belongs to
-        while (groupIndex + 1 < groupStarts.count &&
-               [groupStarts[groupIndex + 1] integerValue] <= sgIndex) {
-            groupIndex++;
-        }
-        if (groupIndex < counts.count) {
-            counts[groupIndex] = @([counts[groupIndex] integerValue] + 1);
-        }
-    }
-
-    _playlistView.subgroupCountPerGroup = counts;
-}
-
-// Filter out subgroups in groups that only have one subgroup (when hideSingleSubgroup is enabled)
-- (void)filterSingleSubgroupsIfNeeded {
-    bool hideSingleSubgroup = simplaylist_config::getConfigBool(
-        simplaylist_config::kHideSingleSubgroup,
-        simplaylist_config::kDefaultHideSingleSubgroup);
-
-    if (!hideSingleSubgroup) return;
-
-    NSArray<NSNumber *> *groupStarts = _playlistView.groupStarts;
-    NSArray<NSNumber *> *subgroupStarts = _playlistView.subgroupStarts;
-    NSArray<NSString *> *subgroupHeaders = _playlistView.subgroupHeaders;
-    NSArray<NSNumber *> *subgroupCountPerGroup = _playlistView.subgroupCountPerGroup;
-
-    if (subgroupStarts.count == 0 || groupStarts.count == 0) return;
-
-    // Build filtered arrays - keep only subgroups in groups with count > 1
-    NSMutableArray<NSNumber *> *filteredStarts = [NSMutableArray array];
-    NSMutableArray<NSString *> *filteredHeaders = [NSMutableArray array];
-
-    NSUInteger groupIndex = 0;
-    for (NSUInteger i = 0; i < subgroupStarts.count; i++) {
-        NSInteger sgIndex = [subgroupStarts[i] integerValue];
-
-        // Find which group this subgroup belongs to
-        while (groupIndex + 1 < groupStarts.count &&
-               [groupStarts[groupIndex + 1] integerValue] <= sgIndex) {
-            groupIndex++;
-        }
-
-        // Keep subgroup only if its group has more than one subgroup
-        if (groupIndex < subgroupCountPerGroup.count) {
-            NSInteger count = [subgroupCountPerGroup[groupIndex] integerValue];
-            if (count > 1) {
-                [filteredStarts addObject:subgroupStarts[i]];
-                if (i < subgroupHeaders.count) {
-                    [filteredHeaders addObject:subgroupHeaders[i]];
-                }
-            }
-        }
-    }
-
-    // Only update if we filtered something out
-    if (filteredStarts.count != subgroupStarts.count) {
-        _playlistView.subgroupStarts = filteredStarts;
-        _playlistView.subgroupHeaders = filteredHeaders;
-        // Recalculate counts with filtered data
-        [self updateSubgroupCountPerGroup];
-    }
-}
-
 - (void)rebuildFromPlaylist {
     auto pm = playlist_manager::get();
     t_size activePlaylist = pm->get_active_playlist();
@@ -573,40 +537,60 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
 
     // Save scroll anchor for BOTH playlist switches AND same-playlist refreshes
     // This prevents visual jumping when items are added/removed
-    if (!isFirstLoad && _scrollView && _scrollAnchorIndices && _currentPlaylistInitialized) {
-        NSInteger anchorIndex = [self firstVisiblePlaylistIndex];
-        if (anchorIndex >= 0) {
-            _scrollAnchorIndices[@(_currentPlaylistIndex)] = @(anchorIndex);
-        }
+    if (!isFirstLoad && _currentPlaylistInitialized) {
+        [self saveCurrentScrollAnchor];
+        if (isSwitchingPlaylist) simplaylist::ScrollAnchorStore::instance().flush();
+    }
+
+    // Remember the complete layout of the playlist we're leaving
+    if (isSwitchingPlaylist && !isFirstLoad) {
+        [self storeGroupModelInLayoutCache];
+    }
+
+    if (isSwitchingPlaylist) {
+        [self clearSortState];
+        // The query carries over; it is re-run once the new playlist is indexed
+        _filterActive = NO;
+        _filterRows.clear();
+        _searchMatches.clear();
+        _searchIndex.clear();
+        [self startSearchIndexBuild];
+        _searchAwaitingIndex = [self searchBarVisible] && !_searchQuery.empty();
+    } else if (_filterActive && activePlaylist != SIZE_MAX) {
+        // Same playlist while filtered - re-run the query over the current index
+        [self applySearchResettingScroll:NO];
+        return;
     }
 
     // Reset initialized flag for the new playlist
     _currentPlaylistInitialized = NO;
 
+    // Every callback queued so far is reflected by this rebuild
+    _rebuildEventSerial = SimPlaylistCallbackManager_eventSerial();
+    _groupModelItemCount = -1;
+    _deferredInserts.reset();
+
     // Clear cached data on any playlist change
-    // TODO: For incremental updates (add/remove), could invalidate only affected entries
-    [_playlistView clearFormattedValuesCache];
+    _columnEngine.invalidate();
 
     if (activePlaylist == SIZE_MAX) {
         _playlistView.itemCount = 0;
-        _playlistView.groupStarts = @[];
-        _playlistView.groupHeaders = @[];
-        _playlistView.groupArtKeys = @[];
+        [_playlistView clearGroups];
         _currentPlaylistIndex = -1;
+        _currentPlaylistGuid = pfc::guid_null;
         _playlistView.sourcePlaylistIndex = -1;  // For drag validation
         [_playlistView reloadData];
         return;
     }
 
     _currentPlaylistIndex = activePlaylist;
+    _currentPlaylistGuid = simplaylist::ScrollAnchorStore::guidForPlaylist(activePlaylist);
     _playlistView.sourcePlaylistIndex = activePlaylist;  // For drag validation
     t_size itemCount = pm->playlist_get_item_count(activePlaylist);
 
     if (itemCount == 0) {
         _playlistView.itemCount = 0;
-        _playlistView.groupStarts = @[];
-        _playlistView.groupHeaders = @[];
-        _playlistView.groupArtKeys = @[];
+        [_playlistView clearGroups];
         [_playlistView reloadData];
         return;
     }
@@ -619,11 +603,13 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
 
     BOOL useGrouping = (activePreset && activePreset.headerPattern.length > 0);
 
-    if (useGrouping) {
+    if (useGrouping && [self applyCachedGroupLayoutForPlaylist:activePlaylist itemCount:itemCount preset:activePreset]) {
+        // Complete layout from an earlier visit - validated in background
+    } else if (useGrouping) {
         // Check if we have a saved scroll position for this playlist
         // Use sync when: switching playlists with saved position, OR refreshing current playlist with saved position
         // This avoids the visual "jump" from flat mode to grouped mode
-        BOOL hasSavedPosition = (_scrollAnchorIndices[@(activePlaylist)] != nil);
+        BOOL hasSavedPosition = [self savedScrollAnchorForPlaylist:activePlaylist index:NULL];
 
         if (hasSavedPosition) {
             // SYNCHRONOUS: Detect groups immediately for instant scroll restore
@@ -635,12 +621,12 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
         }
     } else {
         // No grouping - just set item count
+        _groupModel = simplaylist::GroupDetectionResult();
+        _groupArrays = GroupViewArrays();
+        _groupModelGrouped = NO;
+        _groupModelItemCount = itemCount;
         _playlistView.itemCount = itemCount;
-        _playlistView.groupStarts = @[];
-        _playlistView.groupHeaders = @[];
-        _playlistView.groupArtKeys = @[];
-        _playlistView.groupPaddingRows = @[];
-        [_playlistView rebuildPaddingCache];
+        [_playlistView clearGroups];
     }
 
     // Set frame size
@@ -663,15 +649,13 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
     // Mark playlist for scroll restoration if switching
     if (isSwitchingPlaylist) {
         // Check if sync detection already handled the restore
-        BOOL alreadyRestored = (useGrouping && _scrollAnchorIndices[@(activePlaylist)] != nil);
+        BOOL alreadyRestored = (useGrouping && [self savedScrollAnchorForPlaylist:activePlaylist index:NULL]);
 
         if (!alreadyRestored) {
             _scrollRestorePlaylistIndex = activePlaylist;
-            // Only restore immediately if NOT using grouping (groups change row positions)
-            // If using grouping, restore will happen after group detection completes
-            if (!useGrouping) {
-                [self scheduleDeferredScrollRestore];
-            }
+            // Groups still being detected are estimated at their final height and
+            // replaced with the visible item kept in place, so restore right away
+            [self scheduleDeferredScrollRestore];
         }
     }
     // When NOT switching (just refreshing same playlist), keep current scroll position
@@ -697,14 +681,13 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
 
 - (void)performScrollRestore {
     if (_scrollRestorePlaylistIndex < 0) return;
-    if (!_playlistView || !_scrollView || !_scrollAnchorIndices) {
+    if (!_playlistView || !_scrollView) {
         _scrollRestorePlaylistIndex = -1;
         return;
     }
 
-    NSNumber *savedAnchorIndex = _scrollAnchorIndices[@(_scrollRestorePlaylistIndex)];
-    if (savedAnchorIndex) {
-        NSInteger playlistIndex = [savedAnchorIndex integerValue];
+    NSInteger playlistIndex = -1;
+    if ([self savedScrollAnchorForPlaylist:(t_size)_scrollRestorePlaylistIndex index:&playlistIndex]) {
         // Clamp to valid range (items may have been deleted after the anchor)
         if (playlistIndex >= _playlistView.itemCount) {
             playlistIndex = MAX(0, _playlistView.itemCount - 1);
@@ -726,6 +709,25 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
     _scrollRestorePlaylistIndex = -1;
 }
 
+// Scroll anchors are kept per playlist GUID (ScrollAnchorStore), so they follow
+// playlists through reordering and restarts
+- (BOOL)savedScrollAnchorForPlaylist:(t_size)playlist index:(NSInteger *)outIndex {
+    t_size index = 0;
+    GUID guid = simplaylist::ScrollAnchorStore::guidForPlaylist(playlist);
+    if (!simplaylist::ScrollAnchorStore::instance().lookup(guid, index)) return NO;
+    if (outIndex) *outIndex = (NSInteger)index;
+    return YES;
+}
+
+// Stored under the GUID captured when the playlist was shown - by now its
+// index may belong to another playlist
+- (void)saveCurrentScrollAnchor {
+    if (_currentPlaylistIndex < 0 || !_currentPlaylistInitialized || _filterActive) return;
+    NSInteger anchorIndex = [self firstVisiblePlaylistIndex];
+    if (anchorIndex < 0) return;
+    simplaylist::ScrollAnchorStore::instance().store(_currentPlaylistGuid, (t_size)anchorIndex);
+}
+
 // Get the playlist index of the first visible item (for scroll position saving)
 - (NSInteger)firstVisiblePlaylistIndex {
     if (!_scrollView || !_playlistView) return -1;
@@ -754,101 +756,28 @@ void SimPlaylistCallbackManager_unregisterController(SimPlaylistController* cont
 // Generation counter to cancel stale group detection
 static NSInteger _groupDetectionGeneration = 0;
 
-// FAST PARTIAL GROUP DETECTION: Only detect groups up to scroll anchor for instant restore
-- (void)detectGroupsForPlaylistSync:(t_size)playlist itemCount:(t_size)itemCount preset:(GroupPreset *)preset {
-    // Get the anchor position we need to scroll to
-    NSNumber *anchorNum = _scrollAnchorIndices[@(playlist)];
-    NSInteger anchorIndex = anchorNum ? [anchorNum integerValue] : 0;
-
-    // Only detect groups up to anchor + buffer (for visible area)
-    // This is O(anchor) instead of O(all tracks) - much faster for large playlists
-    t_size detectUpTo = MIN(itemCount, (t_size)(anchorIndex + 200));
-
-    // Increment generation to cancel any in-progress async detection
-    NSInteger currentGeneration = ++_groupDetectionGeneration;
-
-    // Get handles only up to what we need
-    auto pm = playlist_manager::get();
-    metadb_handle_list handles;
-    pm->playlist_get_all_items(playlist, handles);
-
-    // Compile header pattern
-    titleformat_object::ptr headerScript;
-    static_api_ptr_t<titleformat_compiler>()->compile_safe_ex(
-        headerScript,
-        [preset.headerPattern UTF8String],
-        nullptr
-    );
-
-    // Compile subgroup pattern (if any)
-    NSString *subgroupPattern = [preset subgroupPattern];
-    titleformat_object::ptr subgroupScript;
-    BOOL hasSubgroups = (subgroupPattern && subgroupPattern.length > 0);
-    if (hasSubgroups) {
-        static_api_ptr_t<titleformat_compiler>()->compile_safe_ex(
-            subgroupScript,
-            [subgroupPattern UTF8String],
-            nullptr
-        );
-    }
-
-    // Build group data synchronously - only up to detectUpTo
-    NSMutableArray<NSNumber *> *groupStarts = [NSMutableArray array];
-    NSMutableArray<NSString *> *groupHeaders = [NSMutableArray array];
-    NSMutableArray<NSString *> *groupArtKeys = [NSMutableArray array];
-
-    // Build subgroup data
-    NSMutableArray<NSNumber *> *subgroupStarts = [NSMutableArray array];
-    NSMutableArray<NSString *> *subgroupHeaders = [NSMutableArray array];
+// Publish detected groups to the view: subgroup counts, single-subgroup filtering,
+// album-art padding and the row index. lastGroupEnd is the exclusive end of the
+// last detected group (itemCount once detection is complete).
+- (void)applyGroupArrays:(const GroupViewArrays &)arrays lastGroupEnd:(NSInteger)lastGroupEnd {
+    const std::vector<int64_t>& groupStarts = arrays.groupStarts;
+    std::vector<int64_t> subgroupStarts = arrays.subgroupStarts;
+    NSArray<NSString *> *subgroupHeaders = arrays.subgroupHeaders;
+    std::vector<int32_t> subgroupCounts = subgroupCountsPerGroup(groupStarts, subgroupStarts);
 
-    // Check if we should show the first subgroup header for each group
-    bool showFirstSubgroup = simplaylist_config::getConfigBool(
-        simplaylist_config::kShowFirstSubgroupHeader,
-        simplaylist_config::kDefaultShowFirstSubgroupHeader);
-
-    // Use shared SubgroupDetector to ensure consistent logic across all code paths
-    SubgroupDetector subgroupDetector(showFirstSubgroup, g_subgroupDebugEnabled);
-
-    pfc::string8 currentHeader("");
-    pfc::string8 formattedHeader;
-    pfc::string8 formattedSubgroup;
-
-    for (t_size i = 0; i < detectUpTo && i < handles.get_count(); i++) {
-        handles[i]->format_title(nullptr, formattedHeader, headerScript, nullptr);
-
-        BOOL isNewGroup = (i == 0 || strcmp(formattedHeader.c_str(), currentHeader.c_str()) != 0);
-
-        if (isNewGroup) {
-            [groupStarts addObject:@(i)];
-            [groupHeaders addObject:[NSString stringWithUTF8String:formattedHeader.c_str()]];
-            [groupArtKeys addObject:[NSString stringWithUTF8String:handles[i]->get_path()]];
-            currentHeader = formattedHeader;
-            subgroupDetector.enterNewGroup();  // Clear subgroup state for new group
-        }
-
-        // Check for subgroup change using shared detector
-        if (hasSubgroups) {
-            handles[i]->format_title(nullptr, formattedSubgroup, subgroupScript, nullptr);
-            subgroupDetector.shouldAddSubgroup(formattedSubgroup, isNewGroup,
-                                                subgroupStarts, subgroupHeaders, i);
-        }
+    bool hideSingleSubgroup = simplaylist_config::getConfigBool(
+        simplaylist_config::kHideSingleSubgroup,
+        simplaylist_config::kDefaultHideSingleSubgroup);
+    if (hideSingleSubgroup && !subgroupStarts.empty()) {
+        filterSingleSubgroups(groupStarts, subgroupCounts, subgroupStarts, subgroupHeaders);
     }
 
-    // Set partial data immediately - enough for visible area
-    _playlistView.itemCount = itemCount;
-    _playlistView.groupStarts = groupStarts;
-    _playlistView.groupHeaders = groupHeaders;
-    _playlistView.groupArtKeys = groupArtKeys;
-    _playlistView.subgroupStarts = subgroupStarts;
-    _playlistView.subgroupHeaders = subgroupHeaders;
-    [self updateSubgroupCountPerGroup];
-    [self filterSingleSubgroupsIfNeeded];  // Filter out single subgroups if setting enabled
-    // NOTE: rebuildSubgroupRowCache must be called AFTER padding is set (below)
-
-    // Calculate padding rows for detected groups
+    // Calculate padding rows for each group based on minimum height for album art
     CGFloat rowHeight = _playlistView.rowHeight;
     CGFloat albumArtSize = _playlistView.albumArtSize;
-    CGFloat padding = 6.0;
+    CGFloat padding = 6.0;  // Same as in drawSparseGroupColumnInRect
+
+    // Minimum rows needed below header to fit album art with padding
     NSInteger minContentRows = (NSInteger)ceil((albumArtSize + padding * 2) / rowHeight);
 
     // Style 2 has header rows but album art starts at header row Y (extra row of space)
@@ -860,275 +789,323 @@ static NSInteger _groupDetectionGeneration = 0;
     // For style 3, add 1 extra row for header text below album art
     NSInteger extraTextSpace = (headerStyle == 3) ? 1 : 0;
 
-    NSMutableArray<NSNumber *> *paddingRows = [NSMutableArray arrayWithCapacity:groupStarts.count];
-    for (NSUInteger g = 0; g < groupStarts.count; g++) {
-        NSInteger groupStart = [groupStarts[g] integerValue];
-        NSInteger groupEnd = (g + 1 < groupStarts.count) ? [groupStarts[g + 1] integerValue] : (NSInteger)detectUpTo;
-        NSInteger trackCount = groupEnd - groupStart;
+    std::vector<int32_t> paddingRows(groupStarts.size());
+    size_t detectedBegin = MIN(arrays.estimatedLeadingGroups, groupStarts.size());
+    size_t detectedEnd = MAX(detectedBegin, groupStarts.size() - MIN(arrays.estimatedTrailingGroups, groupStarts.size()));
+    NSInteger detectedPadding = 0;
+    for (size_t g = 0; g < groupStarts.size(); g++) {
+        NSInteger groupEnd = (g + 1 < groupStarts.size()) ? (NSInteger)groupStarts[g + 1] : lastGroupEnd;
+        NSInteger trackCount = groupEnd - (NSInteger)groupStarts[g];
+
         // Subgroup headers also take vertical space, subtract them from needed padding
-        NSInteger subgroupsInGroup = (g < _playlistView.subgroupCountPerGroup.count)
-            ? [_playlistView.subgroupCountPerGroup[g] integerValue] : 0;
-        NSInteger neededPadding = MAX(minPadding, minContentRows - trackCount - subgroupsInGroup - extraHeaderSpace + extraTextSpace);
-        [paddingRows addObject:@(neededPadding)];
+        NSInteger neededPadding = MAX(minPadding, minContentRows - trackCount - subgroupCounts[g] - extraHeaderSpace + extraTextSpace);
+        paddingRows[g] = (int32_t)neededPadding;
+        if (g >= detectedBegin && g < detectedEnd) detectedPadding += neededPadding;
+    }
+
+    // Placeholder groups are evenly sized, so their own padding would be the
+    // padding of an average group rather than the average padding. Spread the
+    // detected groups' average over them instead (carrying the remainder).
+    if (detectedEnd > detectedBegin && detectedEnd - detectedBegin < groupStarts.size()) {
+        double averagePadding = (double)detectedPadding / (double)(detectedEnd - detectedBegin);
+        double carried = 0;
+        for (size_t g = 0; g < groupStarts.size(); g++) {
+            if (g >= detectedBegin && g < detectedEnd) continue;
+            carried += averagePadding;
+            int32_t rows = (int32_t)MAX((double)minPadding, floor(carried));
+            paddingRows[g] = rows;
+            carried -= rows;
+        }
     }
-    _playlistView.groupPaddingRows = paddingRows;
-    [_playlistView rebuildPaddingCache];
-    [_playlistView rebuildSubgroupRowCache];  // MUST be after padding cache is built
 
-    // Set frame size (will be updated when full detection completes)
+    _playlistView.groupHeaders = arrays.groupHeaders;
+    _playlistView.groupArtKeys = arrays.groupArtKeys;
+    _playlistView.subgroupHeaders = subgroupHeaders;
+    [_playlistView setGroupStarts:groupStarts
+                   subgroupStarts:std::move(subgroupStarts)
+                      paddingRows:std::move(paddingRows)];
+
+    // Recalculate height with group headers, subgroups, and padding
     CGFloat newHeight = [_playlistView totalContentHeightCached];
     [_playlistView setFrameSize:NSMakeSize(_playlistView.frame.size.width, newHeight)];
+}
 
-    // Restore scroll position immediately (we have enough groups)
-    [self performScrollRestore];
-
+// Replace estimated groups with (more) detected ones. Rows above the visible
+// area change size, so the first visible item is kept at its on-screen offset.
+- (void)applyGroupArraysKeepingAnchor:(const GroupViewArrays &)arrays {
+    CGFloat anchorOffset = 0;
+    NSInteger anchorIndex = [self visibleScrollAnchorWithOffset:&anchorOffset];
+    [self applyGroupArrays:arrays lastGroupEnd:_playlistView.itemCount];
+    [self restoreScrollAnchor:anchorIndex offset:anchorOffset];
     [_playlistView setNeedsDisplay:YES];
+}
 
-    // Continue detecting remaining groups in background
-    if (detectUpTo < itemCount) {
-        auto handlesPtr = std::make_shared<metadb_handle_list>(std::move(handles));
-        NSString *headerPattern = preset.headerPattern;
-        NSString *lastHeader = (groupHeaders.count > 0) ? [groupHeaders lastObject] : @"";
-        // IMPORTANT: Use the actual subgroup state from detector, not subgroupHeaders.lastObject
-        // because if showFirstSubgroup=OFF, the first subgroup wasn't added to the list
-        NSString *lastSubgroup = [NSString stringWithUTF8String:subgroupDetector.getCurrentSubgroup()];
-
-        __weak typeof(self) weakSelf = self;
-        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-            if (_groupDetectionGeneration != currentGeneration) return;
+// WINDOWED GROUP DETECTION: detect only the groups around the scroll anchor so a
+// restore deep into a large playlist costs the same as one near the top. The
+// prefix is shown as estimated placeholder groups until background detection
+// replaces them.
+- (void)detectGroupsForPlaylistSync:(t_size)playlist itemCount:(t_size)itemCount preset:(GroupPreset *)preset {
+    // Get the anchor position we need to scroll to
+    NSInteger anchorIndex = 0;
+    [self savedScrollAnchorForPlaylist:playlist index:&anchorIndex];
+    t_size anchor = MIN((t_size)MAX(anchorIndex, (NSInteger)0), itemCount > 0 ? itemCount - 1 : 0);
 
-            // Continue from where we left off
-            NSMutableArray<NSNumber *> *moreGroupStarts = [NSMutableArray array];
-            NSMutableArray<NSString *> *moreGroupHeaders = [NSMutableArray array];
-            NSMutableArray<NSString *> *moreGroupArtKeys = [NSMutableArray array];
-            NSMutableArray<NSNumber *> *moreSubgroupStarts = [NSMutableArray array];
-            NSMutableArray<NSString *> *moreSubgroupHeaders = [NSMutableArray array];
-
-            pfc::string8 bgCurrentHeader([lastHeader UTF8String]);
-            pfc::string8 bgFormattedHeader;
-            pfc::string8 bgFormattedSubgroup;
-
-            titleformat_object::ptr bgHeaderScript;
-            static_api_ptr_t<titleformat_compiler>()->compile_safe_ex(
-                bgHeaderScript,
-                [headerPattern UTF8String],
-                nullptr
-            );
-
-            titleformat_object::ptr bgSubgroupScript;
-            if (hasSubgroups) {
-                static_api_ptr_t<titleformat_compiler>()->compile_safe_ex(
-                    bgSubgroupScript,
-                    [subgroupPattern UTF8String],
-                    nullptr
-                );
-            }
+    // Increment generation to cancel any in-progress async detection
+    NSInteger currentGeneration = ++_groupDetectionGeneration;
 
-            // Read showFirstSubgroup setting for consistent behavior with initial detection
-            bool bgShowFirstSubgroup = simplaylist_config::getConfigBool(
-                simplaylist_config::kShowFirstSubgroupHeader,
-                simplaylist_config::kDefaultShowFirstSubgroupHeader);
+    auto pm = playlist_manager::get();
+    metadb_handle_list handles;
+    pm->playlist_get_all_items(playlist, handles);
 
-            // Use shared SubgroupDetector - initialized from sync portion's final state
-            SubgroupDetector bgSubgroupDetector(bgShowFirstSubgroup, g_subgroupDebugEnabled);
-            bgSubgroupDetector.initFromState([lastSubgroup UTF8String]);
+    simplaylist::GroupDetectionParams params = makeDetectionParams(preset);
+    _groupParams = params;
+    _groupModelGrouped = YES;
+    _groupModelGroupingKey = groupingKeyForPreset(preset);
+    _groupModelCacheKey = simplaylist::GroupLayoutCache::keyForPlaylist(playlist, _groupModelGroupingKey);
+
+    // Window from the start of the anchor's group to anchor + buffer (visible area).
+    // Starting on a group boundary makes the window's groups exact; only headers
+    // are formatted while scanning back to it.
+    t_size windowBegin = simplaylist::findGroupStart(handles, anchor, params);
+    t_size windowEnd = MIN(itemCount, anchor + 200);
+
+    // Window result and detector state are shared with the background continuation
+    auto window = std::make_shared<simplaylist::GroupDetectionResult>();
+    auto state = std::make_shared<simplaylist::GroupDetectionState>();
+    simplaylist::detectGroupsParallel(handles, windowBegin, windowEnd, params, *state, *window, nullptr);
+
+    // Set partial data immediately - the unknown prefix and tail are placeholder
+    // groups shaped like the window's groups, so the height is close to final
+    _playlistView.itemCount = itemCount;
+    GroupViewArrays partialArrays = makePartialViewArrays(*window, windowBegin, windowEnd, itemCount);
+    [self applyGroupArrays:partialArrays lastGroupEnd:(NSInteger)itemCount];
 
-            for (t_size i = detectUpTo; i < handlesPtr->get_count(); i++) {
-                if (_groupDetectionGeneration != currentGeneration) return;
+    // Restore scroll position immediately (the anchor's rows are exact)
+    [self performScrollRestore];
 
-                (*handlesPtr)[i]->format_title(nullptr, bgFormattedHeader, bgHeaderScript, nullptr);
+    [_playlistView setNeedsDisplay:YES];
 
-                BOOL isNewGroup = (strcmp(bgFormattedHeader.c_str(), bgCurrentHeader.c_str()) != 0);
+    if (windowBegin == 0 && windowEnd == itemCount) {
+        // No background detection needed - full data already available
+        _groupModel = std::move(*window);
+        _groupArrays = partialArrays;
+        _groupModelItemCount = (NSInteger)itemCount;
+        _currentPlaylistInitialized = YES;
+        return;
+    }
 
-                if (isNewGroup) {
-                    [moreGroupStarts addObject:@(i)];
-                    [moreGroupHeaders addObject:[NSString stringWithUTF8String:bgFormattedHeader.c_str()]];
-                    [moreGroupArtKeys addObject:[NSString stringWithUTF8String:(*handlesPtr)[i]->get_path()]];
-                    bgCurrentHeader = bgFormattedHeader;
-                    bgSubgroupDetector.enterNewGroup();  // Clear subgroup state for new group
-                }
+    // Detect the prefix and the tail in background; inserts from now on are
+    // relative to this snapshot
+    _deferredInserts.reset();
+    _deferredInserts.open = true;
+    auto handlesPtr = std::make_shared<metadb_handle_list>(std::move(handles));
+    auto detection = std::make_shared<simplaylist::GroupDetectionResult>();
 
-                // Check for subgroup change using shared detector
-                if (hasSubgroups) {
-                    (*handlesPtr)[i]->format_title(nullptr, bgFormattedSubgroup, bgSubgroupScript, nullptr);
-                    bgSubgroupDetector.shouldAddSubgroup(bgFormattedSubgroup, isNewGroup,
-                                                          moreSubgroupStarts, moreSubgroupHeaders, i);
-                }
-            }
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        if (_groupDetectionGeneration != currentGeneration) return;
+        auto stale = [currentGeneration]() { return _groupDetectionGeneration != currentGeneration; };
 
-            if (_groupDetectionGeneration != currentGeneration) return;
+        // The prefix ends right before the window's first group, which a fresh
+        // detector state starts as a new group anyway
+        simplaylist::GroupDetectionState prefixState;
+        if (!simplaylist::detectGroupsParallel(*handlesPtr, 0, windowBegin, params, prefixState, *detection, stale)) {
+            return;
+        }
+        appendDetectionResult(*detection, *window);
 
-            // Merge results on main thread
-            dispatch_async(dispatch_get_main_queue(), ^{
-                __strong typeof(weakSelf) strongSelf = weakSelf;
-                if (!strongSelf) return;
-                if (_groupDetectionGeneration != currentGeneration) return;
+        // Continue from the window's final header/subgroup state so a group
+        // spanning windowEnd merges instead of starting again
+        bool completed = simplaylist::detectGroupsParallel(
+            *handlesPtr, windowEnd, handlesPtr->get_count(), params, *state, *detection, stale);
+        if (!completed || stale()) return;
 
-                // Merge with existing groups
-                NSMutableArray *allStarts = [strongSelf.playlistView.groupStarts mutableCopy];
-                NSMutableArray *allHeaders = [strongSelf.playlistView.groupHeaders mutableCopy];
-                NSMutableArray *allArtKeys = [strongSelf.playlistView.groupArtKeys mutableCopy];
-
-                [allStarts addObjectsFromArray:moreGroupStarts];
-                [allHeaders addObjectsFromArray:moreGroupHeaders];
-                [allArtKeys addObjectsFromArray:moreGroupArtKeys];
-
-                strongSelf.playlistView.groupStarts = allStarts;
-                strongSelf.playlistView.groupHeaders = allHeaders;
-                strongSelf.playlistView.groupArtKeys = allArtKeys;
-
-                // Merge subgroups
-                NSMutableArray *allSubgroupStarts = [strongSelf.playlistView.subgroupStarts mutableCopy];
-                NSMutableArray *allSubgroupHeaders = [strongSelf.playlistView.subgroupHeaders mutableCopy];
-                [allSubgroupStarts addObjectsFromArray:moreSubgroupStarts];
-                [allSubgroupHeaders addObjectsFromArray:moreSubgroupHeaders];
-                strongSelf.playlistView.subgroupStarts = allSubgroupStarts;
-                strongSelf.playlistView.subgroupHeaders = allSubgroupHeaders;
-                [strongSelf updateSubgroupCountPerGroup];
-                [strongSelf filterSingleSubgroupsIfNeeded];  // Filter out single subgroups if setting enabled
-                // NOTE: rebuildSubgroupRowCache must be called AFTER padding is set (below)
-
-                // Recalculate all padding rows (accounting for subgroups and header style)
-                NSInteger bgHeaderStyle = strongSelf.playlistView.headerDisplayStyle;
-                NSInteger bgMinPadding = (bgHeaderStyle == 3) ? 1 : 0;
-                NSInteger bgExtraHeaderSpace = (bgHeaderStyle == 2) ? 1 : 0;
-                NSInteger bgExtraTextSpace = (bgHeaderStyle == 3) ? 1 : 0;
-
-                NSMutableArray<NSNumber *> *allPaddingRows = [NSMutableArray arrayWithCapacity:allStarts.count];
-                for (NSUInteger g = 0; g < allStarts.count; g++) {
-                    NSInteger gStart = [allStarts[g] integerValue];
-                    NSInteger gEnd = (g + 1 < allStarts.count) ? [allStarts[g + 1] integerValue] : (NSInteger)itemCount;
-                    NSInteger trackCount = gEnd - gStart;
-                    // Subgroup headers also take vertical space
-                    NSInteger subgroupsInGroup = (g < strongSelf.playlistView.subgroupCountPerGroup.count)
-                        ? [strongSelf.playlistView.subgroupCountPerGroup[g] integerValue] : 0;
-                    NSInteger neededPadding = MAX(bgMinPadding, minContentRows - trackCount - subgroupsInGroup - bgExtraHeaderSpace + bgExtraTextSpace);
-                    [allPaddingRows addObject:@(neededPadding)];
-                }
-                strongSelf.playlistView.groupPaddingRows = allPaddingRows;
-                [strongSelf.playlistView rebuildPaddingCache];
-                [strongSelf.playlistView rebuildSubgroupRowCache];  // MUST be after padding cache is built
+        GroupViewArrays arrays = makeGroupViewArrays(*detection);
 
-                // Update frame size with complete data
-                CGFloat finalHeight = [strongSelf.playlistView totalContentHeightCached];
-                [strongSelf.playlistView setFrameSize:NSMakeSize(strongSelf.playlistView.frame.size.width, finalHeight)];
+        // Publish merged result on main thread
+        dispatch_async(dispatch_get_main_queue(), ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (!strongSelf) return;
+            if (_groupDetectionGeneration != currentGeneration) return;
 
-                // NOW it's safe to save scroll positions - full data available
-                strongSelf->_currentPlaylistInitialized = YES;
+            [strongSelf applyGroupArraysKeepingAnchor:arrays];
+            strongSelf->_groupModel = std::move(*detection);
+            strongSelf->_groupArrays = arrays;
+            strongSelf->_groupModelItemCount = (NSInteger)itemCount;
 
-                [strongSelf.playlistView setNeedsDisplay:YES];
-            });
+            // NOW it's safe to save scroll positions - full data available
+            strongSelf->_currentPlaylistInitialized = YES;
+            [strongSelf replayDeferredInserts];
         });
-    } else {
-        // No background detection needed - full data already available
-        _currentPlaylistInitialized = YES;
-    }
+    });
 }
 
-// PROGRESSIVE GROUP DETECTION: Shows UI immediately, detects groups without freezing
-- (void)detectGroupsForPlaylist:(t_size)playlist itemCount:(t_size)itemCount preset:(GroupPreset *)preset {
-    // Increment generation to cancel any in-progress detection
-    NSInteger currentGeneration = ++_groupDetectionGeneration;
+#pragma mark - Group Layout Cache
 
-    // IMMEDIATE: Set item count and show flat list right away
-    _playlistView.itemCount = itemCount;
-    _playlistView.groupStarts = @[];
-    _playlistView.groupHeaders = @[];
-    _playlistView.groupArtKeys = @[];
-    _playlistView.groupPaddingRows = @[];
-    _playlistView.totalPaddingRowsCached = 0;
-    _playlistView.cumulativePaddingCache = @[];
-    _playlistView.subgroupStarts = @[];
-    _playlistView.subgroupHeaders = @[];
-    _playlistView.subgroupCountPerGroup = @[];
-    _playlistView.subgroupRowSet = [NSSet set];
-    _playlistView.subgroupRowToIndex = @{};
-
-    // Set frame size and display immediately
-    CGFloat totalHeight = [_playlistView totalContentHeightCached];
-    [_playlistView setFrameSize:NSMakeSize(_playlistView.frame.size.width, totalHeight)];
-    [_playlistView setNeedsDisplay:YES];
+// Hand the complete model of the playlist being left to the layout cache.
+// Skipped while detection is pending or when the playlist changed under us.
+- (void)storeGroupModelInLayoutCache {
+    if (!_groupModelGrouped || _groupModelItemCount < 0 || _groupModelCacheKey.empty()) return;
+    if (_currentPlaylistIndex < 0) return;
 
-    // Get all handles NOW (on main thread, this is fast as it's just pointer copies)
     auto pm = playlist_manager::get();
+    t_size playlist = (t_size)_currentPlaylistIndex;
+    if (playlist >= pm->get_playlist_count()) return;
+    // Playlist indices shift when playlists are added/removed - GUID must still match
+    if (simplaylist::GroupLayoutCache::keyForPlaylist(playlist, _groupModelGroupingKey) != _groupModelCacheKey) return;
+
     metadb_handle_list handles;
     pm->playlist_get_all_items(playlist, handles);
+    if ((NSInteger)handles.get_count() != _groupModelItemCount) return;
 
-    // Copy handles to a shared_ptr for thread safety
-    auto handlesPtr = std::make_shared<metadb_handle_list>(std::move(handles));
-    NSString *headerPattern = preset.headerPattern;
-    NSString *subgroupPattern = [preset subgroupPattern];  // Get first subgroup pattern
+    simplaylist::GroupLayoutCache::instance().store(
+        _groupModelCacheKey, simplaylist::fingerprintHandles(handles),
+        std::make_shared<const simplaylist::GroupDetectionResult>(std::move(_groupModel)));
+    _groupModel = simplaylist::GroupDetectionResult();
+    _groupModelItemCount = -1;
+}
+
+// Show a cached layout immediately. Detection still runs in background and only
+// republishes when the result differs (e.g. tags edited while not displayed).
+- (BOOL)applyCachedGroupLayoutForPlaylist:(t_size)playlist itemCount:(t_size)itemCount preset:(GroupPreset *)preset {
+    std::string groupingKey = groupingKeyForPreset(preset);
+    std::string cacheKey = simplaylist::GroupLayoutCache::keyForPlaylist(playlist, groupingKey);
+    if (cacheKey.empty()) return NO;
+
+    auto pm = playlist_manager::get();
+    metadb_handle_list handles;
+    pm->playlist_get_all_items(playlist, handles);
+    if (handles.get_count() != itemCount) return NO;
+
+    std::shared_ptr<const simplaylist::GroupDetectionResult> cached =
+        simplaylist::GroupLayoutCache::instance().lookup(cacheKey, simplaylist::fingerprintHandles(handles));
+    if (!cached) return NO;
 
-    // PROGRESSIVE: Detect groups in background without blocking UI
+    // Cancel any in-progress detection for the previous playlist
+    NSInteger currentGeneration = ++_groupDetectionGeneration;
+
+    simplaylist::GroupDetectionParams params = makeDetectionParams(preset);
+    _groupParams = params;
+    _groupModelGrouped = YES;
+    _groupModelGroupingKey = groupingKey;
+    _groupModelCacheKey = cacheKey;
+    _groupModel = *cached;
+    _groupArrays = makeGroupViewArrays(_groupModel);
+    _groupModelItemCount = (NSInteger)itemCount;
+
+    _playlistView.itemCount = itemCount;
+    [self applyGroupArrays:_groupArrays lastGroupEnd:(NSInteger)itemCount];
+    _currentPlaylistInitialized = YES;
+
+    if ([self savedScrollAnchorForPlaylist:playlist index:NULL]) {
+        _scrollRestorePlaylistIndex = playlist;
+        [self performScrollRestore];
+    }
+
+    // Validate against a fresh detection (cheap when nothing changed - no UI work)
+    auto handlesPtr = std::make_shared<metadb_handle_list>(std::move(handles));
     __weak typeof(self) weakSelf = self;
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
         if (_groupDetectionGeneration != currentGeneration) return;
 
-        // Compile header pattern
-        titleformat_object::ptr headerScript;
-        static_api_ptr_t<titleformat_compiler>()->compile_safe_ex(
-            headerScript,
-            [headerPattern UTF8String],
-            nullptr
-        );
+        simplaylist::GroupDetectionState state;
+        auto detection = std::make_shared<simplaylist::GroupDetectionResult>();
+        bool completed = simplaylist::detectGroupsParallel(
+            *handlesPtr, 0, handlesPtr->get_count(), params, state, *detection,
+            [currentGeneration]() { return _groupDetectionGeneration != currentGeneration; });
+        if (!completed || _groupDetectionGeneration != currentGeneration) return;
+        if (*detection == *cached) return;
 
-        // Compile subgroup pattern (if any)
-        titleformat_object::ptr subgroupScript;
-        BOOL hasSubgroups = (subgroupPattern && subgroupPattern.length > 0);
-        if (hasSubgroups) {
-            static_api_ptr_t<titleformat_compiler>()->compile_safe_ex(
-                subgroupScript,
-                [subgroupPattern UTF8String],
-                nullptr
-            );
-        }
+        GroupViewArrays arrays = makeGroupViewArrays(*detection);
 
-        // Build group data
-        NSMutableArray<NSNumber *> *groupStarts = [NSMutableArray array];
-        NSMutableArray<NSString *> *groupHeaders = [NSMutableArray array];
-        NSMutableArray<NSString *> *groupArtKeys = [NSMutableArray array];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (!strongSelf) return;
+            if (_groupDetectionGeneration != currentGeneration) return;
+
+            CGFloat anchorOffset;
+            NSInteger anchorIndex = [strongSelf scrollAnchorWithOffset:&anchorOffset];
 
-        // Build subgroup data
-        NSMutableArray<NSNumber *> *subgroupStarts = [NSMutableArray array];
-        NSMutableArray<NSString *> *subgroupHeaders = [NSMutableArray array];
+            [strongSelf applyGroupArrays:arrays lastGroupEnd:(NSInteger)itemCount];
+            strongSelf->_groupModel = std::move(*detection);
+            strongSelf->_groupArrays = arrays;
 
-        // Check if we should show the first subgroup header for each group
-        bool showFirstSubgroup = simplaylist_config::getConfigBool(
-            simplaylist_config::kShowFirstSubgroupHeader,
-            simplaylist_config::kDefaultShowFirstSubgroupHeader);
+            [strongSelf.playlistView reloadData];
+            [strongSelf restoreScrollAnchor:anchorIndex offset:anchorOffset];
+        });
+    });
 
-        // Use shared SubgroupDetector to ensure consistent logic across all code paths
-        SubgroupDetector subgroupDetector(showFirstSubgroup, g_subgroupDebugEnabled);
+    return YES;
+}
 
-        pfc::string8 currentHeader("");
-        pfc::string8 formattedHeader;
-        pfc::string8 formattedSubgroup;
+// Items detected synchronously before the first frame of a first visit
+static const t_size kEstimateSampleItems = 2048;
+// First background slice between partial publishes; each later slice doubles,
+// so re-publishing the growing result stays linear overall
+static const t_size kProgressiveSliceItems = 32768;
 
-        for (t_size i = 0; i < handlesPtr->get_count(); i++) {
-            if (_groupDetectionGeneration != currentGeneration) return;
+// PROGRESSIVE GROUP DETECTION: Shows UI immediately, detects groups without freezing
+- (void)detectGroupsForPlaylist:(t_size)playlist itemCount:(t_size)itemCount preset:(GroupPreset *)preset {
+    // Increment generation to cancel any in-progress detection
+    NSInteger currentGeneration = ++_groupDetectionGeneration;
 
-            // format_title with metadb_handle is thread-safe for reading
-            (*handlesPtr)[i]->format_title(nullptr, formattedHeader, headerScript, nullptr);
+    // Get all handles NOW (on main thread, this is fast as it's just pointer copies)
+    auto pm = playlist_manager::get();
+    metadb_handle_list handles;
+    pm->playlist_get_all_items(playlist, handles);
 
-            BOOL isNewGroup = (i == 0 || strcmp(formattedHeader.c_str(), currentHeader.c_str()) != 0);
+    simplaylist::GroupDetectionParams params = makeDetectionParams(preset);
+    _groupParams = params;
+    _groupModelGrouped = YES;
+    _groupModelGroupingKey = groupingKeyForPreset(preset);
+    _groupModelCacheKey = simplaylist::GroupLayoutCache::keyForPlaylist(playlist, _groupModelGroupingKey);
 
-            if (isNewGroup) {
-                [groupStarts addObject:@(i)];
-                [groupHeaders addObject:[NSString stringWithUTF8String:formattedHeader.c_str()]];
-                [groupArtKeys addObject:[NSString stringWithUTF8String:(*handlesPtr)[i]->get_path()]];
-                currentHeader = formattedHeader;
-                subgroupDetector.enterNewGroup();  // Clear subgroup state for new group
-            }
+    // IMMEDIATE: Detect a small sample and estimate the rest, so the first frame
+    // is grouped and has (close to) its final height
+    auto detection = std::make_shared<simplaylist::GroupDetectionResult>();
+    auto state = std::make_shared<simplaylist::GroupDetectionState>();
+    t_size sampleEnd = MIN(itemCount, kEstimateSampleItems);
+    simplaylist::detectGroupsSequential(handles, 0, sampleEnd, params, *state, *detection, nullptr);
 
-            // Check for subgroup change using shared detector
-            if (hasSubgroups) {
-                (*handlesPtr)[i]->format_title(nullptr, formattedSubgroup, subgroupScript, nullptr);
-                subgroupDetector.shouldAddSubgroup(formattedSubgroup, isNewGroup,
-                                                    subgroupStarts, subgroupHeaders, i);
+    _playlistView.itemCount = itemCount;
+    [self applyGroupArrays:makePartialViewArrays(*detection, 0, sampleEnd, itemCount)
+              lastGroupEnd:(NSInteger)itemCount];
+    [_playlistView setNeedsDisplay:YES];
+
+    // PROGRESSIVE: Detect the rest in background slices. Each slice refines the
+    // estimate for what is left and is published keeping the visible item fixed.
+    _deferredInserts.reset();
+    _deferredInserts.open = true;
+    auto handlesPtr = std::make_shared<metadb_handle_list>(std::move(handles));
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        if (_groupDetectionGeneration != currentGeneration) return;
+        auto stale = [currentGeneration]() { return _groupDetectionGeneration != currentGeneration; };
+
+        t_size count = handlesPtr->get_count();
+        t_size detectedEnd = sampleEnd;
+        t_size slice = kProgressiveSliceItems;
+        while (detectedEnd < count) {
+            // Chunks are formatted in parallel, then stitched in order
+            t_size sliceEnd = MIN(count, detectedEnd + slice);
+            if (!simplaylist::detectGroupsParallel(*handlesPtr, detectedEnd, sliceEnd, params, *state, *detection, stale)) {
+                return;
             }
+            detectedEnd = sliceEnd;
+            slice *= 2;
+            if (detectedEnd == count || stale()) break;
+
+            GroupViewArrays partialArrays = makePartialViewArrays(*detection, 0, detectedEnd, count);
+            dispatch_async(dispatch_get_main_queue(), ^{
+                __strong typeof(weakSelf) strongSelf = weakSelf;
+                if (!strongSelf) return;
+                if (_groupDetectionGeneration != currentGeneration) return;
+                [strongSelf applyGroupArraysKeepingAnchor:partialArrays];
+            });
         }
+        if (stale()) return;
 
-        if (_groupDetectionGeneration != currentGeneration) return;
+        GroupViewArrays arrays = makeGroupViewArrays(*detection);
 
         // Update UI on main thread
         dispatch_async(dispatch_get_main_queue(), ^{
@@ -1136,64 +1113,19 @@ static NSInteger _groupDetectionGeneration = 0;
             if (!strongSelf) return;
             if (_groupDetectionGeneration != currentGeneration) return;
 
-            strongSelf.playlistView.groupStarts = groupStarts;
-            strongSelf.playlistView.groupHeaders = groupHeaders;
-            strongSelf.playlistView.groupArtKeys = groupArtKeys;
-            strongSelf.playlistView.subgroupStarts = subgroupStarts;
-            strongSelf.playlistView.subgroupHeaders = subgroupHeaders;
-            [strongSelf updateSubgroupCountPerGroup];
-            [strongSelf filterSingleSubgroupsIfNeeded];  // Filter out single subgroups if setting enabled
-            // NOTE: rebuildSubgroupRowCache must be called AFTER padding is set (below)
-
-            // Calculate padding rows for each group based on minimum height for album art
-            CGFloat rowHeight = strongSelf.playlistView.rowHeight;
-            CGFloat albumArtSize = strongSelf.playlistView.albumArtSize;
-            CGFloat padding = 6.0;  // Same as in drawSparseGroupColumnInRect
-
-            // Minimum rows needed below header to fit album art with padding
-            NSInteger minContentRows = (NSInteger)ceil((albumArtSize + padding * 2) / rowHeight);
-
-            // Style 2 has header rows but album art starts at header row Y (extra row of space)
-            // Style 3 needs extra rows for header text below album art + visual separation
-            NSInteger headerStyle = strongSelf.playlistView.headerDisplayStyle;
-            NSInteger minPadding = (headerStyle == 3) ? 1 : 0;  // Style 3: 1 row for separation
-            // For style 2, album art starts at header row (not below), so we have 1 extra row of space
-            NSInteger extraHeaderSpace = (headerStyle == 2) ? 1 : 0;
-            // For style 3, add 1 extra row for header text below album art
-            NSInteger extraTextSpace = (headerStyle == 3) ? 1 : 0;
-
-            NSMutableArray<NSNumber *> *paddingRows = [NSMutableArray arrayWithCapacity:groupStarts.count];
-            NSInteger totalItems = strongSelf.playlistView.itemCount;
-
-            for (NSUInteger g = 0; g < groupStarts.count; g++) {
-                NSInteger groupStart = [groupStarts[g] integerValue];
-                NSInteger groupEnd = (g + 1 < groupStarts.count) ? [groupStarts[g + 1] integerValue] : totalItems;
-                NSInteger trackCount = groupEnd - groupStart;
-
-                // Subgroup headers also take vertical space, subtract them from needed padding
-                NSInteger subgroupsInGroup = (g < strongSelf.playlistView.subgroupCountPerGroup.count)
-                    ? [strongSelf.playlistView.subgroupCountPerGroup[g] integerValue] : 0;
-                NSInteger neededPadding = MAX(minPadding, minContentRows - trackCount - subgroupsInGroup - extraHeaderSpace + extraTextSpace);
-                [paddingRows addObject:@(neededPadding)];
-            }
-
-            strongSelf.playlistView.groupPaddingRows = paddingRows;
-            [strongSelf.playlistView rebuildPaddingCache];
-            [strongSelf.playlistView rebuildSubgroupRowCache];  // MUST be after padding cache is built
-
-            // Recalculate height with group headers, subgroups, and padding
-            CGFloat newHeight = [strongSelf.playlistView totalContentHeightCached];
-            [strongSelf.playlistView setFrameSize:NSMakeSize(strongSelf.playlistView.frame.size.width, newHeight)];
+            [strongSelf applyGroupArraysKeepingAnchor:arrays];
+            strongSelf->_groupModel = std::move(*detection);
+            strongSelf->_groupArrays = arrays;
+            strongSelf->_groupModelItemCount = (NSInteger)count;
 
             // Full detection complete - safe to save scroll positions now
             strongSelf->_currentPlaylistInitialized = YES;
+            [strongSelf replayDeferredInserts];
 
             // Schedule scroll restore after frame size change settles
             if (strongSelf->_scrollRestorePlaylistIndex >= 0) {
                 [strongSelf scheduleDeferredScrollRestore];
             }
-
-            [strongSelf.playlistView setNeedsDisplay:YES];
         });
     });
 }
@@ -1204,81 +1136,382 @@ static NSInteger _groupDetectionGeneration = 0;
     if (activePlaylist == SIZE_MAX) return;
 
     t_size itemCount = pm->playlist_get_item_count(activePlaylist);
-    [_playlistView.selectedIndices removeAllIndexes];
 
     // Use batch selection query - ONE SDK call instead of N
     pfc::bit_array_bittable selectionMask(itemCount);
     pm->playlist_get_selection_mask(activePlaylist, selectionMask);
 
-    // Efficiently iterate only set bits
-    for (t_size i = selectionMask.find_first(true, 0, itemCount);
-         i < itemCount;
-         i = selectionMask.find_first(true, i + 1, itemCount)) {
-        [_playlistView.selectedIndices addIndex:i];
+    if (_filterActive) {
+        simplaylist::SelectionModel selection;
+        for (size_t i = 0; i < _filterRows.size(); i++) {
+            if (_filterRows[i] < itemCount && selectionMask.get(_filterRows[i])) {
+                selection.appendRun((int64_t)i, (int64_t)i + 1);
+            }
+        }
+        [_playlistView setSelection:selection];
+        return;
     }
+
+    // Collapse into runs; the view redraws only rows whose state changed
+    [_playlistView setSelection:simplaylist::selectionFromMask(selectionMask, itemCount)];
 }
 
 - (void)updatePlayingIndicator {
     auto pm = playlist_manager::get();
     t_size playingPlaylist, playingItem;
 
-    _playlistView.playingIndex = -1;
+    // Set once - the view redraws only the old and new playing rows
+    NSInteger playingIndex = -1;
     if (pm->get_playing_item_location(&playingPlaylist, &playingItem)) {
         if (playingPlaylist == (t_size)_currentPlaylistIndex) {
             // In both flat and sparse group mode, we can use playlist index directly
             // The view will handle the row mapping
-            _playlistView.playingIndex = (NSInteger)playingItem;
+            playingIndex = [self itemIndexForPlaylistIndex:(NSInteger)playingItem];
         }
     }
+    _playlistView.playingIndex = playingIndex;
 }
 
 #pragma mark - Playlist Event Handlers
 
+// Above this share of modified items a full rebuild beats windowed re-detection
+static const double kIncrementalModifyMaxFraction = 0.25;
+
 - (void)handlePlaylistSwitched {
     [self rebuildFromPlaylist];
 }
 
-- (void)handleItemsAdded:(NSInteger)base count:(NSInteger)count {
-    // For Phase 1, just rebuild everything
-    // Later phases can do incremental updates
-    [self rebuildFromPlaylist];
+- (void)handleItemsAdded:(NSInteger)base
+                   count:(NSInteger)count
+               selection:(const simplaylist::SelectionModel &)insertedSelection
+                  serial:(uint64_t)serial {
+    [self searchIndexItemsAdded:base count:count serial:serial];
+    if (_filterActive) {
+        [self applySearchResettingScroll:NO];
+        return;
+    }
+    if (serial <= _rebuildEventSerial) return;  // Already reflected by a full rebuild
+
+    // Background detection is still building the model (import batches landing
+    // on a freshly opened playlist) - splice them in once it is complete
+    if (_deferredInserts.add((t_size)base, (t_size)count, serial)) {
+        if (_groupModelItemCount >= 0) [self replayDeferredInserts];
+        return;
+    }
+
+    NSInteger newCount = _groupModelItemCount + count;
+    if (![self groupModelAcceptsEventWithSerial:serial oldItemCount:_groupModelItemCount newItemCount:newCount]) {
+        [self rebuildFromPlaylist];
+        return;
+    }
+
+    CGFloat anchorOffset = 0;
+    NSInteger anchorIndex = [self scrollAnchorWithOffset:&anchorOffset];
+    if (anchorIndex >= base) anchorIndex += count;
+
+    // Shift the selection instead of re-reading the whole playlist mask
+    simplaylist::SelectionModel selection = [_playlistView selection];
+    selection.shiftForInsert(base, count);
+    for (const simplaylist::SelectionModel::Run &run : insertedSelection.runs()) {
+        selection.selectRange(base + run.start, base + run.end);
+    }
+    [_playlistView setSelection:selection];
+
+    simplaylist::IndexRuns dirty;
+    simplaylist::GroupSpliceLog log;
+    if (_groupModelGrouped) {
+        simplaylist::remapModelForInsert(_groupModel, base, count, dirty);
+    }
+    _columnEngine.invalidate();  // Rows after base moved
+    [self applyIncrementalEdit:dirty log:log itemCount:newCount firstChanged:base
+                   anchorIndex:anchorIndex anchorOffset:anchorOffset];
 }
 
-- (void)handleItemsRemoved {
-    // Disable implicit animations during rebuild to prevent visual flicker
+- (void)handleItemsRemoved:(const simplaylist::IndexRuns &)removed
+                  oldCount:(NSInteger)oldCount
+                  newCount:(NSInteger)newCount
+                    serial:(uint64_t)serial {
+    [self searchIndexItemsRemoved:removed serial:serial];
+    if (_filterActive) {
+        [self applySearchResettingScroll:NO];
+        return;
+    }
+    if (serial <= _rebuildEventSerial) return;  // Already reflected by a full rebuild
+
+    // Disable implicit animations during the update to prevent visual flicker
     [CATransaction begin];
     [CATransaction setDisableActions:YES];
-    [self rebuildFromPlaylist];
+
+    if (![self groupModelAcceptsEventWithSerial:serial oldItemCount:oldCount newItemCount:newCount]) {
+        [self rebuildFromPlaylist];
+    } else {
+        CGFloat anchorOffset = 0;
+        NSInteger anchorIndex = [self scrollAnchorWithOffset:&anchorOffset];
+        if (anchorIndex >= 0) {
+            anchorIndex = simplaylist::remapIndexForRemove(removed, anchorIndex);
+            if (anchorIndex >= newCount) anchorIndex = newCount - 1;
+        }
+
+        std::vector<simplaylist::SelectionModel::Run> removedRuns;
+        removedRuns.reserve(removed.size());
+        for (const simplaylist::IndexRun &run : removed) {
+            removedRuns.push_back({(int64_t)run.start, (int64_t)(run.start + run.count)});
+        }
+        simplaylist::SelectionModel selection = [_playlistView selection];
+        selection.shiftForRemove(removedRuns);
+        [_playlistView setSelection:selection];
+
+        simplaylist::IndexRuns dirty;
+        simplaylist::GroupSpliceLog log;
+        if (_groupModelGrouped) {
+            simplaylist::remapModelForRemove(_groupModel, removed, dirty, log);
+        }
+        _columnEngine.invalidate();  // Rows after the first removal moved
+        NSInteger firstChanged = removed.empty() ? 0 : (NSInteger)removed.front().start;
+        [self applyIncrementalEdit:dirty log:log itemCount:newCount firstChanged:firstChanged
+                       anchorIndex:anchorIndex anchorOffset:anchorOffset];
+    }
+
     [CATransaction commit];
 }
 
-- (void)handleItemsReordered {
-    [self rebuildFromPlaylist];
+- (void)handleItemsReordered:(const std::vector<t_size> &)order serial:(uint64_t)serial {
+    simplaylist::MovePlan plan = std::move(_pendingMove);
+    _pendingMove = simplaylist::MovePlan();
+    // Any reorder but our own sort leaves the playlist unsorted
+    BOOL ownSort = !_pendingSortOrder.empty() && _pendingSortOrder == order;
+    _pendingSortOrder.clear();
+    if (!ownSort) [self clearSortState];
+    [self searchIndexItemsReordered:order serial:serial];
+    if (_filterActive) {
+        [self applySearchResettingScroll:NO];
+        return;
+    }
+    if (serial <= _rebuildEventSerial) return;  // Already reflected by a full rebuild
+
+    // Only our own block moves are applied incrementally - any other order
+    // (sort, shuffle, another component) rebuilds
+    NSInteger count = (NSInteger)order.size();
+    if (plan.empty() || plan.order != order ||
+        ![self groupModelAcceptsEventWithSerial:serial oldItemCount:count newItemCount:count]) {
+        [self rebuildFromPlaylist];
+        return;
+    }
+
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+
+    CGFloat anchorOffset = 0;
+    NSInteger anchorIndex = [self scrollAnchorWithOffset:&anchorOffset];
+    if (anchorIndex >= 0) anchorIndex = (NSInteger)simplaylist::remapIndexForMove(plan, (t_size)anchorIndex);
+
+    [_playlistView setSelection:simplaylist::remapSelectionForMove(plan, [_playlistView selection])];
+
+    simplaylist::IndexRuns dirty;
+    simplaylist::GroupSpliceLog log;
+    if (_groupModelGrouped) {
+        simplaylist::remapModelForMove(_groupModel, plan, dirty, log);
+    }
+    _columnEngine.invalidate();  // Rows between the moved runs and the block changed
+    NSInteger firstChanged = (NSInteger)MIN(plan.moved.front().start, plan.insertAt);
+    [self applyIncrementalEdit:dirty log:log itemCount:count firstChanged:firstChanged
+                   anchorIndex:anchorIndex anchorOffset:anchorOffset];
+
+    [CATransaction commit];
 }
 
 - (void)handleSelectionChanged {
     // Skip if we recently set the selection ourselves (avoid expensive round-trip)
     // Use generation counter because the callback is async
+    // The view already shows our own selection
     if (_selectionGeneration > _lastSyncedGeneration) {
         _lastSyncedGeneration = _selectionGeneration;
+        return;
+    }
+
+    // External selection change - sync from SDK; the view redraws only rows whose state changed
+    [self syncSelectionFromPlaylist];
+}
+
+- (void)handleFocusChanged:(NSInteger)fromPlaylistIndex to:(NSInteger)toPlaylistIndex {
+    // Redraws only the previous and new focus rows
+    _playlistView.focusIndex = [self itemIndexForPlaylistIndex:toPlaylistIndex];
+}
+
+- (void)handleItemsModified:(const simplaylist::IndexRuns &)modified serial:(uint64_t)serial {
+    [self searchIndexItemsModified:modified serial:serial];
+    if (_filterActive) {
+        // Retagged items can enter or leave the result
+        [self applySearchResettingScroll:NO];
+        return;
+    }
+    if (serial <= _rebuildEventSerial) return;  // Already reflected by a full rebuild
+
+    t_size modifiedCount = 0;
+    for (const simplaylist::IndexRun& run : modified) modifiedCount += run.count;
+
+    // Mass retagging touches most groups anyway - a full rebuild is cheaper
+    if ((double)modifiedCount > _groupModelItemCount * kIncrementalModifyMaxFraction ||
+        ![self groupModelAcceptsEventWithSerial:serial oldItemCount:_groupModelItemCount
+                                   newItemCount:_groupModelItemCount]) {
+        [self rebuildFromPlaylist];
+        return;
+    }
+
+    // Metadata changed - drop only the affected formatted rows
+    for (const simplaylist::IndexRun& run : modified) {
+        for (t_size i = run.start; i < run.start + run.count; i++) {
+            _columnEngine.invalidateRow((int64_t)i);
+        }
+    }
+
+    if (!_groupModelGrouped) {
         [_playlistView setNeedsDisplay:YES];
         return;
     }
 
-    // External selection change - sync from SDK
-    [self syncSelectionFromPlaylist];
-    [_playlistView setNeedsDisplay:YES];
-}
+    CGFloat anchorOffset = 0;
+    NSInteger anchorIndex = [self scrollAnchorWithOffset:&anchorOffset];
+    simplaylist::GroupSpliceLog log;
+    NSInteger firstChanged = modified.empty() ? 0 : (NSInteger)modified.front().start;
+    [self applyIncrementalEdit:modified log:log itemCount:_groupModelItemCount
+                  firstChanged:firstChanged
+                   anchorIndex:anchorIndex anchorOffset:anchorOffset];
+}
+
+#pragma mark - Incremental Group Updates
+
+// An edit can be applied in place when the model is complete for the current
+// playlist at its pre-edit size and no later edit is queued behind this one
+// (handles are read from the live playlist, which must match this edit exactly).
+// Apply the inserts collected during background detection to the completed
+// model as one incremental insert. Waits while more events are still queued.
+- (void)replayDeferredInserts {
+    if (_deferredInserts.count == 0) {
+        _deferredInserts.reset();
+        return;
+    }
+    if (_deferredInserts.lastSerial != SimPlaylistCallbackManager_eventSerial()) return;
+
+    simplaylist::DeferredInserts inserts = _deferredInserts;
+    _deferredInserts.reset();
+    NSInteger base = (NSInteger)inserts.base;
+    NSInteger newCount = _groupModelItemCount + (NSInteger)inserts.count;
+    if (![self groupModelAcceptsEventWithSerial:inserts.lastSerial
+                                   oldItemCount:_groupModelItemCount
+                                   newItemCount:newCount]) {
+        [self rebuildFromPlaylist];
+        return;
+    }
+
+    CGFloat anchorOffset = 0;
+    NSInteger anchorIndex = [self scrollAnchorWithOffset:&anchorOffset];
+    if (anchorIndex >= base) anchorIndex += (NSInteger)inserts.count;
+
+    simplaylist::IndexRuns dirty;
+    simplaylist::GroupSpliceLog log;
+    if (_groupModelGrouped) {
+        simplaylist::remapModelForInsert(_groupModel, inserts.base, inserts.count, dirty);
+    }
+    _columnEngine.invalidate();  // Rows after base moved
+    [self applyIncrementalEdit:dirty log:log itemCount:newCount firstChanged:base
+                   anchorIndex:anchorIndex anchorOffset:anchorOffset];
+    // The inserted items' selection wasn't tracked while they were deferred
+    [self syncSelectionFromPlaylist];
+}
+
+- (BOOL)groupModelAcceptsEventWithSerial:(uint64_t)serial
+                            oldItemCount:(NSInteger)oldCount
+                            newItemCount:(NSInteger)newCount {
+    if (_groupModelItemCount < 0 || _groupModelItemCount != oldCount) return NO;
+    if (serial != SimPlaylistCallbackManager_eventSerial()) return NO;
+
+    auto pm = playlist_manager::get();
+    t_size activePlaylist = pm->get_active_playlist();
+    if (activePlaylist == SIZE_MAX || (NSInteger)activePlaylist != _currentPlaylistIndex) return NO;
+    return (NSInteger)pm->playlist_get_item_count(activePlaylist) == newCount;
+}
+
+// First visible playlist item and its distance from the top of the visible area
+- (NSInteger)scrollAnchorWithOffset:(CGFloat *)outOffset {
+    *outOffset = 0;
+    if (!_currentPlaylistInitialized) return -1;
+    return [self visibleScrollAnchorWithOffset:outOffset];
+}
+
+// Same, also while groups are still partial (used when they are completed)
+- (NSInteger)visibleScrollAnchorWithOffset:(CGFloat *)outOffset {
+    *outOffset = 0;
+    NSInteger anchorIndex = [self firstVisiblePlaylistIndex];
+    if (anchorIndex < 0) return -1;
+
+    NSInteger row = [_playlistView rowForPlaylistIndex:anchorIndex];
+    if (row < 0) return -1;
+    *outOffset = NSMinY(_scrollView.contentView.bounds) - [_playlistView yOffsetForRow:row];
+    return anchorIndex;
+}
+
+// Re-detect groups around the dirty ranges, publish the spliced arrays and
+// keep the anchor item at the same on-screen position.
+- (void)applyIncrementalEdit:(const simplaylist::IndexRuns &)dirty
+                         log:(simplaylist::GroupSpliceLog &)log
+                   itemCount:(NSInteger)itemCount
+                firstChanged:(NSInteger)firstChanged
+                 anchorIndex:(NSInteger)anchorIndex
+                anchorOffset:(CGFloat)anchorOffset {
+    auto pm = playlist_manager::get();
+    t_size activePlaylist = pm->get_active_playlist();
+
+    // Supersedes any background detection/validation of the pre-edit playlist
+    ++_groupDetectionGeneration;
+
+    _groupModelItemCount = itemCount;
+    _playlistView.itemCount = itemCount;
+
+    if (_groupModelGrouped) {
+        simplaylist::redetectDirtyRanges(
+            _groupModel, (t_size)itemCount, dirty, _groupParams,
+            [&pm, activePlaylist](t_size index) {
+                metadb_handle_ptr handle;
+                pm->playlist_get_item_handle(handle, activePlaylist, index);
+                return handle;
+            },
+            log);
+
+        GroupViewArrays arrays;
+        arrays.groupStarts = startsFromVector(_groupModel.groupStarts);
+        arrays.groupHeaders = spliceStringArray(_groupArrays.groupHeaders, log.groups, _groupModel.groupHeaders);
+        arrays.groupArtKeys = spliceStringArray(_groupArrays.groupArtKeys, log.groups, _groupModel.groupArtKeys);
+        arrays.subgroupStarts = startsFromVector(_groupModel.subgroupStarts);
+        arrays.subgroupHeaders = spliceStringArray(_groupArrays.subgroupHeaders, log.subgroups, _groupModel.subgroupHeaders);
+        _groupArrays = arrays;
+        [self applyGroupArrays:arrays lastGroupEnd:itemCount];
+    } else {
+        CGFloat totalHeight = [_playlistView totalContentHeightCached];
+        [_playlistView setFrameSize:NSMakeSize(_playlistView.frame.size.width, totalHeight)];
+    }
+
+    // Selection was shifted by the caller - no full mask read needed
+    t_size focusItem = pm->playlist_get_focus_item(activePlaylist);
+    _playlistView.focusIndex = (focusItem != SIZE_MAX) ? (NSInteger)focusItem : -1;
+    [self updatePlayingIndicator];
+    [_playlistView reloadDataFromPlaylistIndex:firstChanged];
 
-- (void)handleFocusChanged:(NSInteger)fromPlaylistIndex to:(NSInteger)toPlaylistIndex {
-    // In flat mode, focus index = playlist index
-    _playlistView.focusIndex = toPlaylistIndex;
-    [_playlistView setNeedsDisplay:YES];
+    [self restoreScrollAnchor:anchorIndex offset:anchorOffset];
 }
 
-- (void)handleItemsModified {
-    // Metadata changed - rebuild to update formatted values
-    [self rebuildFromPlaylist];
+// Scroll so the anchor item sits anchorOffset below the top of the visible area
+- (void)restoreScrollAnchor:(NSInteger)anchorIndex offset:(CGFloat)anchorOffset {
+    if (anchorIndex >= 0 && anchorIndex < _playlistView.itemCount) {
+        NSInteger row = [_playlistView rowForPlaylistIndex:anchorIndex];
+        if (row >= 0) {
+            NSClipView *clipView = _scrollView.contentView;
+            CGFloat maxY = MAX(0, NSHeight(_playlistView.frame) - NSHeight(clipView.bounds));
+            CGFloat y = MIN(MAX(0, [_playlistView yOffsetForRow:row] + anchorOffset), maxY);
+            [clipView scrollToPoint:NSMakePoint(NSMinX(clipView.bounds), y)];
+            [_scrollView reflectScrolledClipView:clipView];
+        }
+    }
 }
 
 #pragma mark - Playback Event Handlers
@@ -1293,33 +1526,27 @@ static NSInteger _groupDetectionGeneration = 0;
 
 #pragma mark - SimPlaylistViewDelegate
 
-- (void)playlistView:(SimPlaylistView *)view selectionDidChange:(NSIndexSet *)selectedPlaylistIndices {
+- (void)playlistView:(SimPlaylistView *)view selectionDidChange:(const simplaylist::SelectionModel &)selection {
     // Sync selection back to playlist_manager
     // SDK calls must be on main thread - callbacks trigger UI updates in fb2k core
 
     // Increment generation to skip the async callback
     _selectionGeneration++;
 
-    // Copy indices and capture current playlist for the async block
-    NSIndexSet *indicesCopy = [selectedPlaylistIndices copy];
+    // Copy the runs (O(runs), not O(items)) and capture current playlist for the async block.
+    // Filter view: hidden items end up deselected.
+    simplaylist::SelectionModel newSelection = [self playlistSelectionForItemSelection:selection];
     auto pm = playlist_manager::get();
     t_size activePlaylist = pm->get_active_playlist();
     t_size itemCount = pm->playlist_get_item_count(activePlaylist);
 
     if (activePlaylist == SIZE_MAX || itemCount == 0) return;
+    newSelection.truncate((int64_t)itemCount);
 
     // Async to coalesce rapid selection changes, but must be main thread
     dispatch_async(dispatch_get_main_queue(), ^{
-        // Build new state bit array directly from NSIndexSet - O(selection count)
-        __block bit_array_bittable newState(itemCount);
-
-        // Mark new selections
-        [indicesCopy enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
-            if (idx < itemCount) {
-                newState.set((t_size)idx, true);
-            }
-        }];
-
+        // One bulk call - the SDK reads the runs through the bit_array view
+        simplaylist::SelectionBitArray newState(newSelection);
         pm->playlist_set_selection(activePlaylist, bit_array_true(), newState);
     });
 }
@@ -1330,7 +1557,7 @@ static NSInteger _groupDetectionGeneration = 0;
     if (activePlaylist == SIZE_MAX) return;
 
     // Get playlist index using the view's row mapping
-    NSInteger playlistIndex = [view playlistIndexForRow:row];
+    NSInteger playlistIndex = [self playlistIndexForItemIndex:[view playlistIndexForRow:row]];
     if (playlistIndex < 0) return;  // Header row or invalid
 
     pm->playlist_execute_default_action(activePlaylist, playlistIndex);
@@ -1345,6 +1572,7 @@ static NSInteger _groupDetectionGeneration = 0;
 
     // Collect indices to array first (can't modify C++ objects in blocks)
     NSMutableArray<NSNumber *> *indices = [NSMutableArray array];
+    playlistIndices = [self playlistView:view playlistIndicesForItemIndices:playlistIndices];
     [playlistIndices enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
         if (idx < itemCount) {
             [indices addObject:@(idx)];
@@ -1550,35 +1778,30 @@ static NSInteger _groupDetectionGeneration = 0;
         }
     }
 
-    // Create undo point
-    pm->playlist_undo_backup(activePlaylist);
-
-    // Build removal mask from selected playlist indices
-    // Note: selectedIndices contains playlist indices directly (not row indices)
+    // Removal mask straight from the selection runs
+    // Note: the selection holds playlist indices directly (not row indices)
     t_size itemCount = pm->playlist_get_item_count(activePlaylist);
-    __block bit_array_bittable mask(itemCount);
+    simplaylist::SelectionModel selection = [self playlistSelectionForItemSelection:[view selection]];
+    selection.truncate((int64_t)itemCount);
+    if (selection.empty()) return;
+    simplaylist::SelectionBitArray mask(selection);
 
-    [view.selectedIndices enumerateIndexesUsingBlock:^(NSUInteger playlistIndex, BOOL *stop) {
-        if (playlistIndex < itemCount) {
-            mask.set((t_size)playlistIndex, true);
-        }
-    }];
+    // Create undo point
+    pm->playlist_undo_backup(activePlaylist);
 
     // Calculate new focus position BEFORE removal
     // Focus should move to the next item after the last selected, or previous if at end
-    NSInteger lastSelectedIndex = (NSInteger)[view.selectedIndices lastIndex];
-    NSInteger firstSelectedIndex = (NSInteger)[view.selectedIndices firstIndex];
-    t_size selectionCount = [view.selectedIndices count];
+    NSInteger lastSelectedIndex = (NSInteger)selection.last();
+    NSInteger firstSelectedIndex = (NSInteger)selection.first();
+    t_size selectionCount = (t_size)selection.count();
     t_size newItemCount = itemCount - selectionCount;
 
     t_size newFocusIndex = SIZE_MAX;
     if (newItemCount > 0) {
         // Try to focus the item that will be at the position after the last selected item
         // After removal, items shift down, so next item after lastSelected becomes lastSelected - (items removed before it)
-        t_size itemsRemovedBeforeLast = 0;
-        for (t_size i = 0; i < (t_size)lastSelectedIndex; i++) {
-            if (mask.get(i)) itemsRemovedBeforeLast++;
-        }
+        // Every other selected item lies before the last one
+        t_size itemsRemovedBeforeLast = selectionCount - 1;
         // The item after lastSelectedIndex (if it exists) will be at position: lastSelectedIndex - itemsRemovedBeforeLast
         // But we need to check if there IS an item after lastSelectedIndex
         if ((t_size)(lastSelectedIndex + 1) < itemCount) {
@@ -1631,8 +1854,10 @@ static BOOL isRemotePath(const char *path) {
     auto pm = playlist_manager::get();
     t_size activePlaylist = (t_size)_currentPlaylistIndex;
 
+    // Load priority follows view positions; the handle comes from the playlist
+    NSInteger itemPlaylistIndex = [self playlistIndexForItemIndex:playlistIndex];
     metadb_handle_ptr handle;
-    if (!pm->playlist_get_item_handle(handle, activePlaylist, (t_size)playlistIndex)) {
+    if (itemPlaylistIndex < 0 || !pm->playlist_get_item_handle(handle, activePlaylist, (t_size)itemPlaylistIndex)) {
         return nil;
     }
 
@@ -1653,7 +1878,7 @@ static BOOL isRemotePath(const char *path) {
     // If not loading yet and not already known to have no image, start async load
     if (![cache isLoadingKey:cacheKey] && ![cache hasNoImageForKey:cacheKey]) {
         __weak SimPlaylistController *weakSelf = self;
-        [cache loadImageForKey:cacheKey handle:handle completion:^(NSImage *image) {
+        [cache loadImageForKey:cacheKey handle:handle owner:view position:playlistIndex completion:^(NSImage *image) {
             // Only trigger redraw if we actually got an image
             if (image) {
                 // Coalesce redraws with small delay to batch multiple image loads
@@ -1701,32 +1926,613 @@ static BOOL isRemotePath(const char *path) {
     t_size activePlaylist = pm->get_active_playlist();
     if (activePlaylist == SIZE_MAX) return nil;
 
-    // Check if playlistIndex is within valid range
-    t_size playlistItemCount = pm->playlist_get_item_count(activePlaylist);
-    if (playlistIndex < 0 || (t_size)playlistIndex >= playlistItemCount) {
-        FILE *f = fopen("/tmp/simplaylist_column_debug.log", "a");
-        if (f) {
-            fprintf(f, "INVALID INDEX: playlistIndex=%ld, playlistItemCount=%lu\n",
-                    (long)playlistIndex, (unsigned long)playlistItemCount);
-            fclose(f);
-        }
+    // The view's item count bounds the index (the view mirrors the playlist or the filter rows)
+    if (playlistIndex < 0 || playlistIndex >= _playlistView.itemCount) {
+        SIMPLAYLIST_TRACE("columnValues: invalid index " << (int64_t)playlistIndex
+                          << ", view item count " << (int64_t)_playlistView.itemCount);
         return nil;
     }
+    playlistIndex = [self playlistIndexForItemIndex:playlistIndex];
 
     // Format column values using playlist context (supports %list_index%, etc.)
-    NSMutableArray<NSString *> *columnValues = [NSMutableArray array];
-    for (ColumnDefinition *col in _columns) {
-        auto script = simplaylist::TitleFormatHelper::compileWithCache(
-            std::string([col.pattern UTF8String])
-        );
-        std::string value = simplaylist::TitleFormatHelper::formatWithPlaylistContext(
-            activePlaylist, playlistIndex, script);
-        [columnValues addObject:[NSString stringWithUTF8String:value.c_str()]];
+    const std::vector<titleformat_object::ptr>& scripts = _columnSet.scripts();
+    NSMutableArray<NSString *> *columnValues = [NSMutableArray arrayWithCapacity:scripts.size()];
+    for (const auto& script : scripts) {
+        _legacyFormatBuffer.reset();
+        if (script.is_valid()) {
+            pm->playlist_item_format_title(activePlaylist, (t_size)playlistIndex, nullptr, _legacyFormatBuffer,
+                                           script, nullptr, playback_control::display_level_all);
+        }
+        [columnValues addObject:[NSString stringWithUTF8String:_legacyFormatBuffer.get_ptr()] ?: @""];
     }
 
     return columnValues;
 }
 
+- (void)playlistView:(SimPlaylistView *)view prepareColumnValuesInRange:(NSRange)playlistIndexRange {
+    if (playlistIndexRange.length == 0) return;
+    t_size activePlaylist = playlist_manager::get()->get_active_playlist();
+    _columnEngine.prepareRange(activePlaylist,
+                               (int64_t)playlistIndexRange.location,
+                               (int64_t)NSMaxRange(playlistIndexRange) - 1,
+                               _filterActive ? &_filterRows : nullptr);
+}
+
+- (BOOL)playlistView:(SimPlaylistView *)view
+     columnValueUTF8:(const char **)outValue
+              length:(NSUInteger *)outLength
+    forPlaylistIndex:(NSInteger)playlistIndex
+              column:(NSUInteger)column {
+    const char *data = nullptr;
+    size_t length = 0;
+    if (!_columnEngine.cell(playlistIndex, column, data, length)) return NO;
+    *outValue = data;
+    *outLength = length;
+    return YES;
+}
+
+#pragma mark - Search
+
+// Edits up to this many items are re-formatted into the search index on the
+// main thread; larger ones rebuild it in background
+static const t_size kSearchIndexMaxSyncItems = 4096;
+// Filter results up to this size are grouped synchronously (no flat-list flash per keystroke)
+static const t_size kFilterSyncDetectMaxItems = 4096;
+static const CGFloat kSearchBarHeight = 28;
+
+// View item index <-> playlist index. Identity unless the filter view is shown.
+- (NSInteger)playlistIndexForItemIndex:(NSInteger)itemIndex {
+    if (!_filterActive) return itemIndex;
+    if (itemIndex < 0 || itemIndex >= (NSInteger)_filterRows.size()) return -1;
+    return (NSInteger)_filterRows[itemIndex];
+}
+
+- (NSInteger)itemIndexForPlaylistIndex:(NSInteger)playlistIndex {
+    if (!_filterActive || playlistIndex < 0) return playlistIndex;
+    auto it = std::lower_bound(_filterRows.begin(), _filterRows.end(), (t_size)playlistIndex);
+    if (it == _filterRows.end() || *it != (t_size)playlistIndex) return -1;  // Filtered out
+    return (NSInteger)(it - _filterRows.begin());
+}
+
+- (simplaylist::SelectionModel)playlistSelectionForItemSelection:(const simplaylist::SelectionModel &)selection {
+    if (!_filterActive) return selection;
+    simplaylist::SelectionModel result;
+    for (const simplaylist::SelectionModel::Run &run : selection.runs()) {
+        for (int64_t i = run.start; i < run.end && i < (int64_t)_filterRows.size(); i++) {
+            result.appendRun((int64_t)_filterRows[i], (int64_t)_filterRows[i] + 1);
+        }
+    }
+    return result;
+}
+
+- (NSIndexSet *)playlistView:(SimPlaylistView *)view playlistIndicesForItemIndices:(NSIndexSet *)indices {
+    if (!_filterActive) return indices;
+    NSMutableIndexSet *result = [NSMutableIndexSet indexSet];
+    [indices enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+        NSInteger playlistIndex = [self playlistIndexForItemIndex:(NSInteger)idx];
+        if (playlistIndex >= 0) [result addIndex:(NSUInteger)playlistIndex];
+    }];
+    return result;
+}
+
+- (void)playlistView:(SimPlaylistView *)view didRequestFindWithText:(NSString *)text {
+    [self showSearchBar];
+    if (text.length > 0) {
+        _searchField.stringValue = text;
+        [self searchFieldDidChange:_searchField];
+    }
+    [self.view.window makeFirstResponder:_searchField];
+    // Keep typing after the seeded characters instead of replacing them
+    NSText *editor = [_searchField currentEditor];
+    [editor setSelectedRange:NSMakeRange(editor.string.length, 0)];
+}
+
+- (void)createSearchBar {
+    NSView *container = self.view;
+    NSView *bar = [[NSView alloc] initWithFrame:NSMakeRect(0, NSHeight(container.bounds) - kSearchBarHeight,
+                                                           NSWidth(container.bounds), kSearchBarHeight)];
+    bar.autoresizingMask = NSViewWidthSizable | NSViewMinYMargin;
+    bar.hidden = YES;
+
+    NSButton *filter = [NSButton checkboxWithTitle:@"Filter" target:self action:@selector(filterCheckboxToggled:)];
+    filter.controlSize = NSControlSizeSmall;
+    filter.font = [NSFont systemFontOfSize:[NSFont smallSystemFontSize]];
+    filter.toolTip = @"Show only matching tracks";
+    filter.state = simplaylist_config::getConfigBool(
+        simplaylist_config::kSearchFilterMode,
+        simplaylist_config::kDefaultSearchFilterMode) ? NSControlStateValueOn : NSControlStateValueOff;
+    [filter sizeToFit];
+    NSSize filterSize = filter.frame.size;
+    filter.frame = NSMakeRect(NSWidth(bar.bounds) - filterSize.width - 8,
+                              (kSearchBarHeight - filterSize.height) / 2, filterSize.width, filterSize.height);
+    filter.autoresizingMask = NSViewMinXMargin;
+    [bar addSubview:filter];
+
+    NSTextField *status = [NSTextField labelWithString:@""];
+    status.font = [NSFont systemFontOfSize:[NSFont smallSystemFontSize]];
+    status.textColor = [NSColor secondaryLabelColor];
+    status.alignment = NSTextAlignmentRight;
+    status.frame = NSMakeRect(NSMinX(filter.frame) - 108, 6, 100, 16);
+    status.autoresizingMask = NSViewMinXMargin;
+    [bar addSubview:status];
+
+    NSSearchField *field = [[NSSearchField alloc] initWithFrame:NSMakeRect(6, 4, NSMinX(status.frame) - 12, 20)];
+    field.autoresizingMask = NSViewWidthSizable;
+    field.controlSize = NSControlSizeSmall;
+    field.font = [NSFont systemFontOfSize:[NSFont smallSystemFontSize]];
+    field.placeholderString = @"Find in playlist";
+    field.sendsSearchStringImmediately = YES;  // Index answers per keystroke
+    field.target = self;
+    field.action = @selector(searchFieldDidChange:);
+    field.delegate = self;
+    [bar addSubview:field];
+
+    [container addSubview:bar];
+    _searchBar = bar;
+    _searchField = field;
+    _filterCheckbox = filter;
+    _searchStatusLabel = status;
+}
+
+// Search bar sits above the column header; header and list move down while it is shown
+- (void)layoutSearchBar {
+    NSRect bounds = self.view.bounds;
+    CGFloat top = NSMaxY(bounds);
+    if (_searchBar && !_searchBar.hidden) {
+        _searchBar.frame = NSMakeRect(0, top - kSearchBarHeight, NSWidth(bounds), kSearchBarHeight);
+        top -= kSearchBarHeight;
+    }
+    CGFloat headerHeight = NSHeight(_headerBar.frame);
+    _headerBar.frame = NSMakeRect(0, top - headerHeight, NSWidth(bounds), headerHeight);
+    _scrollView.frame = NSMakeRect(0, 0, NSWidth(bounds), MAX(0, top - headerHeight));
+}
+
+- (void)showSearchBar {
+    if (!_searchBar) [self createSearchBar];
+    if (!_searchBar.hidden) return;
+    _searchBar.hidden = NO;
+    [self layoutSearchBar];
+    [self startSearchIndexBuild];
+}
+
+- (void)hideSearchBar {
+    if (!_searchBar || _searchBar.hidden) return;
+    _searchField.stringValue = @"";
+    [self setSearchQuery:std::string()];
+    _searchBar.hidden = YES;
+    [self layoutSearchBar];
+
+    // The index is only kept while the search bar is open
+    [self cancelSearchIndexBuild];
+    _searchIndex.clear();
+    _searchIndexReady = NO;
+    [self.view.window makeFirstResponder:_playlistView];
+}
+
+- (BOOL)searchBarVisible {
+    return _searchBar && !_searchBar.hidden;
+}
+
+- (void)searchFieldDidChange:(NSSearchField *)sender {
+    const char *text = sender.stringValue.UTF8String ?: "";
+    std::string folded;
+    simplaylist::foldSearchText(text, strlen(text), folded);
+    [self setSearchQuery:folded];
+}
+
+- (void)setSearchQuery:(const std::string &)query {
+    if (query == _searchQuery) return;
+    _searchQuery = query;
+    [self applySearchResettingScroll:YES];
+}
+
+- (void)filterCheckboxToggled:(NSButton *)sender {
+    simplaylist_config::setConfigBool(simplaylist_config::kSearchFilterMode,
+                                      sender.state == NSControlStateValueOn);
+    [self applySearchResettingScroll:YES];
+}
+
+- (BOOL)control:(NSControl *)control textView:(NSTextView *)textView doCommandBySelector:(SEL)commandSelector {
+    if (control != _searchField) return NO;
+
+    if (commandSelector == @selector(insertNewline:)) {
+        // Enter / Shift+Enter step through the matches
+        BOOL backward = ([NSEvent modifierFlags] & NSEventModifierFlagShift) != 0;
+        [self focusSearchMatchForward:!backward];
+        return YES;
+    }
+    if (commandSelector == @selector(cancelOperation:)) {
+        [self hideSearchBar];
+        return YES;
+    }
+    if (commandSelector == @selector(moveDown:)) {
+        [self.view.window makeFirstResponder:_playlistView];
+        return YES;
+    }
+    return NO;
+}
+
+// Run the query and show the result: the filter view, or (filter off) the
+// matches selected with focus on the first one at or after the current focus.
+// Also used to refresh the filter view after playlist edits.
+- (void)applySearchResettingScroll:(BOOL)resetScroll {
+    _searchAwaitingIndex = !_searchIndexReady && !_searchQuery.empty();
+    _searchMatches = (_searchIndexReady && !_searchQuery.empty()) ? _searchIndex.query(_searchQuery)
+                                                                 : std::vector<t_size>();
+
+    BOOL wantFilter = _searchIndexReady && !_searchQuery.empty() && _currentPlaylistIndex >= 0 &&
+                      _filterCheckbox.state == NSControlStateValueOn;
+    if (wantFilter) {
+        _filterActive = YES;
+        _filterRows = _searchMatches;
+        [self showFilterRowsResettingScroll:resetScroll];
+    } else {
+        if (_filterActive) {
+            _filterActive = NO;
+            _filterRows.clear();
+            [self rebuildFromPlaylist];
+        }
+        if (resetScroll && !_searchMatches.empty()) {
+            [self selectSearchMatches];
+        }
+    }
+    [self updateSearchStatus];
+}
+
+- (void)selectSearchMatches {
+    auto pm = playlist_manager::get();
+    t_size playlist = (t_size)_currentPlaylistIndex;
+    if (playlist >= pm->get_playlist_count()) return;
+
+    simplaylist::SelectionModel matches;
+    for (t_size index : _searchMatches) matches.appendRun((int64_t)index, (int64_t)index + 1);
+    pm->playlist_set_selection(playlist, pfc::bit_array_true(), simplaylist::SelectionBitArray(matches));
+    [self focusSearchMatchFrom:pm->playlist_get_focus_item(playlist) forward:YES inclusive:YES];
+}
+
+- (void)focusSearchMatchForward:(BOOL)forward {
+    if (_currentPlaylistIndex < 0) return;
+    t_size focus = playlist_manager::get()->playlist_get_focus_item((t_size)_currentPlaylistIndex);
+    [self focusSearchMatchFrom:focus forward:forward inclusive:NO];
+}
+
+// Focus the next (previous) match after from, wrapping around, and scroll to it
+- (void)focusSearchMatchFrom:(t_size)from forward:(BOOL)forward inclusive:(BOOL)inclusive {
+    if (_searchMatches.empty()) return;
+
+    size_t position;
+    if (from == SIZE_MAX) {
+        position = forward ? 0 : _searchMatches.size() - 1;
+    } else if (forward) {
+        auto it = inclusive ? std::lower_bound(_searchMatches.begin(), _searchMatches.end(), from)
+                            : std::upper_bound(_searchMatches.begin(), _searchMatches.end(), from);
+        position = (it == _searchMatches.end()) ? 0 : (size_t)(it - _searchMatches.begin());
+    } else {
+        auto it = std::lower_bound(_searchMatches.begin(), _searchMatches.end(), from);
+        position = (it == _searchMatches.begin()) ? _searchMatches.size() - 1
+                                                  : (size_t)(it - _searchMatches.begin()) - 1;
+    }
+
+    t_size target = _searchMatches[position];
+    playlist_manager::get()->playlist_set_focus_item((t_size)_currentPlaylistIndex, target);
+    NSInteger row = [_playlistView rowForPlaylistIndex:[self itemIndexForPlaylistIndex:(NSInteger)target]];
+    if (row >= 0) [_playlistView scrollRowToVisible:row];
+}
+
+- (void)updateSearchStatus {
+    if (!_searchStatusLabel) return;
+    NSString *status = @"";
+    if (!_searchIndexReady) {
+        status = @"Indexing...";
+    } else if (!_searchQuery.empty()) {
+        status = _searchMatches.empty() ? @"No matches"
+                                        : [NSString stringWithFormat:@"%zu matches", _searchMatches.size()];
+    }
+    _searchStatusLabel.stringValue = status;
+}
+
+// Show only the filter rows. The group index is detected over the matching
+// handles alone; playlist edits re-run the query rather than patching a model,
+// and the subset's layout never reaches the layout cache.
+- (void)showFilterRowsResettingScroll:(BOOL)resetScroll {
+    auto pm = playlist_manager::get();
+    t_size playlist = (t_size)_currentPlaylistIndex;
+
+    NSInteger currentGeneration = ++_groupDetectionGeneration;
+    _groupModel = simplaylist::GroupDetectionResult();
+    _groupArrays = GroupViewArrays();
+    _groupModelItemCount = -1;
+    _groupModelCacheKey.clear();
+    _currentPlaylistInitialized = NO;
+    _scrollRestorePlaylistIndex = -1;
+    _columnEngine.invalidate();
+
+    simplaylist::SelectionModel rows;
+    for (t_size index : _filterRows) rows.appendRun((int64_t)index, (int64_t)index + 1);
+    auto handles = std::make_shared<metadb_handle_list>();
+    pm->playlist_get_items(playlist, *handles, simplaylist::SelectionBitArray(rows));
+    t_size count = handles->get_count();
+    _playlistView.itemCount = count;
+
+    GroupPreset *activePreset = nil;
+    if (_activePresetIndex >= 0 && _activePresetIndex < (NSInteger)_groupPresets.count) {
+        activePreset = _groupPresets[_activePresetIndex];
+    }
+    BOOL useGrouping = (activePreset && activePreset.headerPattern.length > 0);
+
+    [_playlistView clearGroups];
+    if (useGrouping && count > 0) {
+        simplaylist::GroupDetectionParams params = makeDetectionParams(activePreset);
+        if (count <= kFilterSyncDetectMaxItems) {
+            simplaylist::GroupDetectionState state;
+            simplaylist::GroupDetectionResult detection;
+            simplaylist::detectGroupsSequential(*handles, 0, count, params, state, detection, nullptr);
+            [self applyGroupArrays:makeGroupViewArrays(detection) lastGroupEnd:(NSInteger)count];
+        } else {
+            __weak typeof(self) weakSelf = self;
+            dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+                if (_groupDetectionGeneration != currentGeneration) return;
+
+                simplaylist::GroupDetectionState state;
+                simplaylist::GroupDetectionResult detection;
+                bool completed = simplaylist::detectGroupsParallel(
+                    *handles, 0, count, params, state, detection,
+                    [currentGeneration]() { return _groupDetectionGeneration != currentGeneration; });
+                if (!completed || _groupDetectionGeneration != currentGeneration) return;
+
+                GroupViewArrays arrays = makeGroupViewArrays(detection);
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    __strong typeof(weakSelf) strongSelf = weakSelf;
+                    if (!strongSelf) return;
+                    if (_groupDetectionGeneration != currentGeneration) return;
+
+                    [strongSelf applyGroupArrays:arrays lastGroupEnd:(NSInteger)count];
+                    [strongSelf.playlistView reloadData];
+                });
+            });
+        }
+    }
+
+    CGFloat totalHeight = [_playlistView totalContentHeightCached];
+    [_playlistView setFrameSize:NSMakeSize(_playlistView.frame.size.width, totalHeight)];
+
+    [self syncSelectionFromPlaylist];
+    t_size focusItem = pm->playlist_get_focus_item(playlist);
+    _playlistView.focusIndex = [self itemIndexForPlaylistIndex:(focusItem != SIZE_MAX) ? (NSInteger)focusItem : -1];
+    [self updatePlayingIndicator];
+    [_playlistView reloadData];
+
+    if (resetScroll) {
+        NSClipView *clipView = _scrollView.contentView;
+        [clipView scrollToPoint:NSMakePoint(NSMinX(clipView.bounds), 0)];
+        [_scrollView reflectScrolledClipView:clipView];
+    }
+}
+
+#pragma mark - Search Index
+
+- (void)cancelSearchIndexBuild {
+    if (_searchBuildCancel) {
+        *_searchBuildCancel = true;
+        _searchBuildCancel.reset();
+    }
+}
+
+// Format the whole playlist in background (same chunked formatting as group
+// detection). Only runs while the search bar is open.
+- (void)startSearchIndexBuild {
+    [self cancelSearchIndexBuild];
+    _searchIndexReady = NO;
+    [self updateSearchStatus];
+    if (![self searchBarVisible]) return;
+
+    auto pm = playlist_manager::get();
+    t_size playlist = pm->get_active_playlist();
+    if (playlist == SIZE_MAX) return;
+
+    _searchScripts = _columnSet.scripts();
+
+    auto handles = std::make_shared<metadb_handle_list>();
+    pm->playlist_get_all_items(playlist, *handles);
+    uint64_t serial = SimPlaylistCallbackManager_eventSerial();
+    std::vector<titleformat_object::ptr> scripts = _searchScripts;
+    auto context = std::make_shared<simplaylist::PlaylistFormatContext>(
+        simplaylist::PlaylistFormatContext::capture(playlist));
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    _searchBuildCancel = cancelled;
+
+    __weak SimPlaylistController *weakSelf = self;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        std::vector<std::string> texts;
+        if (!simplaylist::formatSearchTexts(*handles, 0, handles->get_count(), scripts, context.get(), texts,
+                                            cancelled.get())) {
+            return;
+        }
+        auto index = std::make_shared<simplaylist::SearchIndex>();
+        index->build(std::move(texts));
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            SimPlaylistController *strongSelf = weakSelf;
+            if (!strongSelf || *cancelled) return;
+            strongSelf->_searchBuildCancel.reset();
+
+            // Edited while formatting - the snapshot is behind the playlist
+            if (serial != SimPlaylistCallbackManager_eventSerial()) {
+                [strongSelf startSearchIndexBuild];
+                return;
+            }
+            strongSelf->_searchIndex = std::move(*index);
+            strongSelf->_searchIndexSerial = serial;
+            strongSelf->_searchIndexReady = YES;
+            if (strongSelf->_searchAwaitingIndex) {
+                [strongSelf applySearchResettingScroll:YES];
+            }
+            [strongSelf updateSearchStatus];
+        });
+    });
+}
+
+// Playlist edits keep the index current. Returns NO when the index doesn't
+// track this event (not built, or the event predates the snapshot).
+- (BOOL)searchIndexAcceptsEventWithSerial:(uint64_t)serial {
+    if (!_searchIndexReady || serial <= _searchIndexSerial) return NO;
+    _searchIndexSerial = serial;
+    return YES;
+}
+
+// Added/modified items are formatted from the live playlist, which only matches
+// the event when no later edit is queued behind it - otherwise rebuild
+- (BOOL)searchIndexCanFormatItems:(t_size)count serial:(uint64_t)serial {
+    if (count <= kSearchIndexMaxSyncItems && serial == SimPlaylistCallbackManager_eventSerial()) return YES;
+    [self startSearchIndexBuild];
+    return NO;
+}
+
+- (metadb_handle_list)searchHandlesInRange:(t_size)start count:(t_size)count {
+    metadb_handle_list handles;
+    playlist_manager::get()->playlist_get_items((t_size)_currentPlaylistIndex, handles,
+                                                pfc::bit_array_range(start, count));
+    return handles;
+}
+
+- (void)searchIndexItemsAdded:(NSInteger)base count:(NSInteger)count serial:(uint64_t)serial {
+    if (![self searchIndexAcceptsEventWithSerial:serial]) return;
+    if (![self searchIndexCanFormatItems:(t_size)count serial:serial]) return;
+
+    metadb_handle_list handles = [self searchHandlesInRange:(t_size)base count:(t_size)count];
+    auto context = simplaylist::PlaylistFormatContext::capture((t_size)_currentPlaylistIndex, (t_size)base);
+    std::vector<std::string> texts;
+    simplaylist::formatSearchTexts(handles, 0, handles.get_count(), _searchScripts, &context, texts, nullptr);
+    _searchIndex.insert((size_t)base, std::move(texts));
+    [self searchIndexDidChange];
+}
+
+- (void)searchIndexItemsRemoved:(const simplaylist::IndexRuns &)removed serial:(uint64_t)serial {
+    if (![self searchIndexAcceptsEventWithSerial:serial]) return;
+    _searchIndex.remove(removed);
+    [self searchIndexDidChange];
+}
+
+- (void)searchIndexItemsReordered:(const std::vector<t_size> &)order serial:(uint64_t)serial {
+    if (![self searchIndexAcceptsEventWithSerial:serial]) return;
+    _searchIndex.reorder(order);
+    [self searchIndexDidChange];
+}
+
+- (void)searchIndexItemsModified:(const simplaylist::IndexRuns &)modified serial:(uint64_t)serial {
+    if (![self searchIndexAcceptsEventWithSerial:serial]) return;
+    t_size modifiedCount = 0;
+    for (const simplaylist::IndexRun &run : modified) modifiedCount += run.count;
+    if (![self searchIndexCanFormatItems:modifiedCount serial:serial]) return;
+
+    for (const simplaylist::IndexRun &run : modified) {
+        metadb_handle_list handles = [self searchHandlesInRange:run.start count:run.count];
+        auto context = simplaylist::PlaylistFormatContext::capture((t_size)_currentPlaylistIndex, run.start);
+        std::vector<std::string> texts;
+        simplaylist::formatSearchTexts(handles, 0, handles.get_count(), _searchScripts, &context, texts, nullptr);
+        for (size_t i = 0; i < texts.size(); i++) {
+            _searchIndex.update(run.start + i, std::move(texts[i]));
+        }
+    }
+    [self searchIndexDidChange];
+}
+
+// Keep match positions current for Enter navigation and the match count
+- (void)searchIndexDidChange {
+    if (!_searchQuery.empty()) _searchMatches = _searchIndex.query(_searchQuery);
+    [self updateSearchStatus];
+}
+
+#pragma mark - Column Sort
+
+- (void)cancelSort {
+    if (_sortCancel) {
+        *_sortCancel = true;
+        _sortCancel.reset();
+    }
+}
+
+- (void)clearSortState {
+    [self cancelSort];
+    if (_sortKeys.empty()) return;
+    _sortKeys.clear();
+    [self updateSortIndicators];
+}
+
+- (void)updateSortIndicators {
+    NSMutableArray<NSNumber *> *columns = [NSMutableArray array];
+    NSMutableIndexSet *descending = [NSMutableIndexSet indexSet];
+    for (const auto& key : _sortKeys) {
+        [columns addObject:@(key.first)];
+        if (key.second) [descending addIndex:(NSUInteger)key.first];
+    }
+    _headerBar.sortColumns = columns;
+    _headerBar.descendingSortColumns = descending;
+}
+
+// Keys are extracted and sorted in background; the result is applied with a
+// single playlist_reorder_items (one undo step, selection and focus follow the items)
+- (void)sortPlaylistBySortKeys {
+    [self cancelSort];
+    if (_currentPlaylistIndex < 0 || _sortKeys.empty()) return;
+
+    auto pm = playlist_manager::get();
+    t_size playlist = (t_size)_currentPlaylistIndex;
+    if (pm->playlist_lock_is_present(playlist) &&
+        (pm->playlist_lock_get_filter_mask(playlist) & playlist_lock::filter_reorder)) {
+        return;
+    }
+
+    std::vector<simplaylist::SortKeySpec> keys;
+    for (const auto& key : _sortKeys) {
+        if ((size_t)key.first >= _columnSet.count()) return;
+        simplaylist::SortKeySpec spec;
+        spec.script = _columnSet.script((size_t)key.first);
+        spec.descending = key.second;
+        keys.push_back(spec);
+    }
+
+    auto handles = std::make_shared<metadb_handle_list>();
+    pm->playlist_get_all_items(playlist, *handles);
+    if (handles->get_count() < 2) return;
+    uint64_t serial = SimPlaylistCallbackManager_eventSerial();
+    auto context = std::make_shared<simplaylist::PlaylistFormatContext>(
+        simplaylist::PlaylistFormatContext::capture(playlist));
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    _sortCancel = cancelled;
+
+    __weak SimPlaylistController *weakSelf = self;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        auto order = std::make_shared<std::vector<t_size>>();
+        if (!simplaylist::computeSortOrder(*handles, keys, context.get(), *order, cancelled.get())) return;
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            SimPlaylistController *strongSelf = weakSelf;
+            if (!strongSelf || *cancelled) return;
+            strongSelf->_sortCancel.reset();
+
+            // Edited while sorting - the order is for a stale snapshot
+            if (serial != SimPlaylistCallbackManager_eventSerial()) {
+                [strongSelf sortPlaylistBySortKeys];
+                return;
+            }
+
+            bool alreadySorted = true;
+            for (t_size i = 0; i < order->size() && alreadySorted; i++) {
+                alreadySorted = (*order)[i] == i;
+            }
+            if (alreadySorted) return;
+
+            auto manager = playlist_manager::get();
+            manager->playlist_undo_backup(playlist);
+            strongSelf->_pendingSortOrder = *order;
+            if (!manager->playlist_reorder_items(playlist, order->data(), order->size())) {
+                strongSelf->_pendingSortOrder.clear();
+            }
+        });
+    });
+}
+
 #pragma mark - SimPlaylistHeaderBarDelegate
 
 - (void)headerBar:(SimPlaylistHeaderBar *)bar didResizeColumn:(NSInteger)columnIndex toWidth:(CGFloat)newWidth {
@@ -1770,7 +2576,7 @@ static BOOL isRemotePath(const char *path) {
     _headerBar.columns = _columns;
     _playlistView.columns = _columns;
     [_headerBar setNeedsDisplay:YES];
-    [_playlistView clearFormattedValuesCache];  // Clear cache - values are in old column order
+    [self columnsDidChange];  // Recompile - formatted values are in old column order
     [_playlistView setNeedsDisplay:YES];
 
     // Persist column order
@@ -1780,8 +2586,25 @@ static BOOL isRemotePath(const char *path) {
     }
 }
 
-- (void)headerBar:(SimPlaylistHeaderBar *)bar didClickColumn:(NSInteger)columnIndex {
-    // Could implement sorting here in the future
+// Click: sort by the column (same single column again: flip direction).
+// Shift-click: add the column as the next key (already a key: flip it).
+- (void)headerBar:(SimPlaylistHeaderBar *)bar didClickColumn:(NSInteger)columnIndex extend:(BOOL)extend {
+    if (columnIndex < 0 || columnIndex >= (NSInteger)_columns.count) return;
+
+    auto existing = std::find_if(_sortKeys.begin(), _sortKeys.end(),
+                                 [columnIndex](const std::pair<NSInteger, bool>& key) { return key.first == columnIndex; });
+    if (extend) {
+        if (existing != _sortKeys.end()) {
+            existing->second = !existing->second;
+        } else {
+            _sortKeys.emplace_back(columnIndex, false);
+        }
+    } else {
+        bool descending = _sortKeys.size() == 1 && existing != _sortKeys.end() && !existing->second;
+        _sortKeys.assign(1, std::make_pair(columnIndex, descending));
+    }
+    [self updateSortIndicators];
+    [self sortPlaylistBySortKeys];
 }
 
 - (void)headerBar:(SimPlaylistHeaderBar *)bar didResizeGroupColumnToWidth:(CGFloat)newWidth {
@@ -1924,7 +2747,7 @@ static BOOL isRemotePath(const char *path) {
     _headerBar.columns = _columns;
     _playlistView.columns = _columns;
     [_headerBar setNeedsDisplay:YES];
-    [_playlistView clearFormattedValuesCache];
+    [self columnsDidChange];
     [_playlistView setNeedsDisplay:YES];
 
     // Save to config
@@ -1965,21 +2788,21 @@ static BOOL isRemotePath(const char *path) {
     t_size itemCount = pm->playlist_get_item_count(activePlaylist);
     if (itemCount == 0) return;
 
-    // sourceRowIndices actually contains playlist indices (from _selectedIndices in view)
-    // They're already playlist indices, no conversion needed
-    NSMutableArray<NSNumber *> *sourcePlaylistIndices = [NSMutableArray array];
-    [sourceRowIndices enumerateIndexesUsingBlock:^(NSUInteger playlistIdx, BOOL *stop) {
-        if (playlistIdx < itemCount) {
-            [sourcePlaylistIndices addObject:@(playlistIdx)];
+    // A drop position between filtered rows has no well-defined playlist position
+    if (_filterActive) return;
+
+    // sourceRowIndices actually contains playlist indices (from the view's selection)
+    // They're already playlist indices, no conversion needed - take them as runs
+    __block simplaylist::IndexRuns sourceRuns;
+    [sourceRowIndices enumerateRangesUsingBlock:^(NSRange range, BOOL *stop) {
+        if (range.location >= itemCount) {
+            *stop = YES;
+            return;
         }
+        sourceRuns.push_back({(t_size)range.location, MIN((t_size)range.length, itemCount - range.location)});
     }];
 
-    if (sourcePlaylistIndices.count == 0) return;
-
-    // Sort source indices
-    [sourcePlaylistIndices sortUsingComparator:^NSComparisonResult(NSNumber *a, NSNumber *b) {
-        return [a compare:b];
-    }];
+    if (sourceRuns.empty()) return;
 
     // Convert destination row to playlist index
     NSInteger totalRows = [view rowCount];
@@ -2003,15 +2826,17 @@ static BOOL isRemotePath(const char *path) {
         }
     }
 
-    pm->playlist_undo_backup(activePlaylist);
-
     if (isDuplicate) {
+        pm->playlist_undo_backup(activePlaylist);
+
         // COPY: Duplicate items at destination (insert copies, keep originals)
         metadb_handle_list items;
-        for (NSNumber *num in sourcePlaylistIndices) {
-            metadb_handle_ptr item;
-            if (pm->playlist_get_item_handle(item, activePlaylist, [num unsignedLongValue])) {
-                items.add_item(item);
+        for (const simplaylist::IndexRun &run : sourceRuns) {
+            for (t_size i = run.start; i < run.start + run.count; i++) {
+                metadb_handle_ptr item;
+                if (pm->playlist_get_item_handle(item, activePlaylist, i)) {
+                    items.add_item(item);
+                }
             }
         }
 
@@ -2020,75 +2845,29 @@ static BOOL isRemotePath(const char *path) {
             pm->playlist_insert_items(activePlaylist, insertPos, items, pfc::bit_array_false());
 
             // Select the duplicated items
-            t_size newItemCount = pm->playlist_get_item_count(activePlaylist);
-            bit_array_bittable selMask(newItemCount);
-            for (t_size i = 0; i < items.get_count(); i++) {
-                selMask.set(insertPos + i, true);
-            }
-            pm->playlist_set_selection(activePlaylist, pfc::bit_array_true(), selMask);
+            simplaylist::SelectionModel duplicated;
+            duplicated.setRange((int64_t)insertPos, (int64_t)(insertPos + items.get_count()));
+            pm->playlist_set_selection(activePlaylist, pfc::bit_array_true(), simplaylist::SelectionBitArray(duplicated));
             pm->playlist_set_focus_item(activePlaylist, insertPos);
         }
     } else {
-        // MOVE: Reorder items (original behavior)
-        // Build reorder array
-        std::vector<t_size> order(itemCount);
-
-        // Create a set of source indices for quick lookup
-        std::set<t_size> sourceSet;
-        for (NSNumber *num in sourcePlaylistIndices) {
-            sourceSet.insert([num unsignedLongValue]);
-        }
-
-        // Calculate where items actually go after removal
-        t_size adjustedDest = destPlaylistIndex;
-        for (NSNumber *num in sourcePlaylistIndices) {
-            if ([num unsignedLongValue] < (t_size)destPlaylistIndex) {
-                adjustedDest--;
-            }
-        }
-
-        // Build the order array
-        // 1. Collect non-moved items in original order
-        // 2. Insert moved items at the adjusted destination
-        std::vector<t_size> nonMovedItems;
-        for (t_size i = 0; i < itemCount; i++) {
-            if (sourceSet.find(i) == sourceSet.end()) {
-                nonMovedItems.push_back(i);
-            }
-        }
-
-        // Build final order: non-moved items with moved items inserted at adjustedDest
-        t_size writePos = 0;
-
-        // Items before destination
-        for (t_size i = 0; i < adjustedDest && i < nonMovedItems.size(); i++) {
-            order[writePos++] = nonMovedItems[i];
-        }
-
-        // Insert moved items at destination
-        for (NSNumber *num in sourcePlaylistIndices) {
-            order[writePos++] = [num unsignedLongValue];
-        }
-
-        // Items after destination
-        for (t_size i = adjustedDest; i < nonMovedItems.size(); i++) {
-            order[writePos++] = nonMovedItems[i];
+        // MOVE: one permutation built in O(n), applied with a single reorder call.
+        // The plan is kept so handleItemsReordered can update groups incrementally.
+        simplaylist::MovePlan plan;
+        if (!simplaylist::planMove(sourceRuns, itemCount, (t_size)destPlaylistIndex, plan)) return;
+
+        pm->playlist_undo_backup(activePlaylist);
+        _pendingMove = plan;
+        if (!pm->playlist_reorder_items(activePlaylist, plan.order.data(), itemCount)) {
+            _pendingMove = simplaylist::MovePlan();
+            return;
         }
 
-        pm->playlist_reorder_items(activePlaylist, order.data(), itemCount);
-
         // Set focus and selection to the moved items at their new position
-        if (sourcePlaylistIndices.count > 0) {
-            t_size newFocusPos = adjustedDest;
-            pm->playlist_set_focus_item(activePlaylist, newFocusPos);
-
-            // Select all moved items
-            bit_array_bittable selMask(itemCount);
-            for (t_size i = 0; i < sourcePlaylistIndices.count; i++) {
-                selMask.set(adjustedDest + i, true);
-            }
-            pm->playlist_set_selection(activePlaylist, pfc::bit_array_true(), selMask);
-        }
+        pm->playlist_set_focus_item(activePlaylist, plan.insertAt);
+        simplaylist::SelectionModel movedBlock;
+        movedBlock.setRange((int64_t)plan.insertAt, (int64_t)(plan.insertAt + plan.movedCount));
+        pm->playlist_set_selection(activePlaylist, pfc::bit_array_true(), simplaylist::SelectionBitArray(movedBlock));
     }
 }
 
@@ -2113,21 +2892,139 @@ static BOOL isRemotePath(const char *path) {
     if (row >= 0 && row < totalRows) {
         NSInteger playlistIdx = [view playlistIndexForRow:row];
         if (playlistIdx >= 0) {
-            insertAt = (t_size)playlistIdx;
+            insertAt = (t_size)[self playlistIndexForItemIndex:playlistIdx];
         } else {
             // Row is header/subgroup/padding - find next valid track
             for (NSInteger r = row; r < totalRows; r++) {
                 NSInteger idx = [view playlistIndexForRow:r];
                 if (idx >= 0) {
-                    insertAt = (t_size)idx;
+                    insertAt = (t_size)[self playlistIndexForItemIndex:idx];
                     break;
                 }
             }
         }
     }
 
-    // Use async import to avoid crash from synchronous process_location
-    importFilesToPlaylistAsync(activePlaylist, insertAt, urls);
+    // Folders are walked here and inserted in batches as they resolve
+    std::vector<std::string> locations;
+    locations.reserve(urls.count);
+    for (NSURL *url in urls) {
+        // Accept file URLs or URLs with file path (media library may use different scheme)
+        const char *path = url.path.length > 0 ? url.path.fileSystemRepresentation : nullptr;
+        if (path) locations.emplace_back(path);
+    }
+    [self startImportOfLocations:std::move(locations) intoPlaylist:activePlaylist
+                         atIndex:insertAt expandFolders:YES];
+}
+
+#pragma mark - Streaming Import
+
+- (void)startImportOfLocations:(std::vector<std::string>)locations
+                  intoPlaylist:(t_size)playlist
+                       atIndex:(t_size)insertAt
+                 expandFolders:(BOOL)expandFolders {
+    if (locations.empty()) return;
+    if (playlist >= playlist_manager::get()->get_playlist_count()) return;
+
+    __weak SimPlaylistController *weakSelf = self;
+    auto import = simplaylist::StreamingImport::start(playlist, insertAt, std::move(locations),
+                                                      expandFolders,
+                                                      [weakSelf](const simplaylist::ImportProgress&) {
+        [weakSelf importProgressDidChange];
+    });
+    if (!import->finished()) _imports.push_back(import);
+    [self importProgressDidChange];
+}
+
+- (void)importProgressDidChange {
+    _imports.erase(std::remove_if(_imports.begin(), _imports.end(),
+                                  [](const auto& import) { return import->finished(); }),
+                   _imports.end());
+    if (_imports.empty()) {
+        _importProgressView.hidden = YES;
+        return;
+    }
+
+    size_t found = 0, resolved = 0, inserted = 0;
+    bool enumerating = false;
+    for (const auto& import : _imports) {
+        const simplaylist::ImportProgress& progress = import->progress();
+        found += progress.locationsFound;
+        resolved += progress.locationsResolved;
+        inserted += progress.itemsInserted;
+        enumerating = enumerating || progress.enumerating;
+    }
+
+    [self ensureImportProgressView];
+    _importProgressView.hidden = NO;
+    // Indeterminate until the folder walk knows the total
+    _importProgressBar.indeterminate = enumerating || found == 0;
+    if (_importProgressBar.indeterminate) {
+        [_importProgressBar startAnimation:nil];
+    } else {
+        [_importProgressBar stopAnimation:nil];
+        _importProgressBar.maxValue = (double)found;
+        _importProgressBar.doubleValue = (double)resolved;
+    }
+    _importProgressLabel.stringValue = enumerating
+        ? [NSString stringWithFormat:@"Scanning folders... %zu files found, %zu added", found, inserted]
+        : [NSString stringWithFormat:@"Adding files... %zu of %zu", resolved, found];
+}
+
+- (void)ensureImportProgressView {
+    if (_importProgressView) return;
+
+    CGFloat height = 26;
+    NSView *container = self.view;
+    NSVisualEffectView *panel = [[NSVisualEffectView alloc] initWithFrame:NSMakeRect(0, 0, container.bounds.size.width, height)];
+    panel.autoresizingMask = NSViewWidthSizable | NSViewMaxYMargin;
+    panel.blendingMode = NSVisualEffectBlendingModeWithinWindow;
+
+    NSButton *stopButton = [NSButton buttonWithImage:[NSImage imageNamed:NSImageNameStopProgressFreestandingTemplate]
+                                              target:self
+                                              action:@selector(cancelImports:)];
+    stopButton.bordered = NO;
+    stopButton.toolTip = @"Stop adding files (Esc)";
+    stopButton.frame = NSMakeRect(panel.bounds.size.width - 24, 5, 16, 16);
+    stopButton.autoresizingMask = NSViewMinXMargin;
+    [panel addSubview:stopButton];
+
+    _importProgressBar = [[NSProgressIndicator alloc] initWithFrame:NSMakeRect(8, 5, 120, 16)];
+    _importProgressBar.style = NSProgressIndicatorStyleBar;
+    _importProgressBar.controlSize = NSControlSizeSmall;
+    _importProgressBar.minValue = 0;
+    [panel addSubview:_importProgressBar];
+
+    _importProgressLabel = [NSTextField labelWithString:@""];
+    _importProgressLabel.font = [NSFont systemFontOfSize:[NSFont smallSystemFontSize]];
+    _importProgressLabel.textColor = [NSColor secondaryLabelColor];
+    _importProgressLabel.lineBreakMode = NSLineBreakByTruncatingTail;
+    _importProgressLabel.frame = NSMakeRect(136, 5, panel.bounds.size.width - 168, 16);
+    _importProgressLabel.autoresizingMask = NSViewWidthSizable;
+    [panel addSubview:_importProgressLabel];
+
+    // Above the scroll view, over the bottom rows
+    [container addSubview:panel positioned:NSWindowAbove relativeTo:_scrollView];
+    _importProgressView = panel;
+}
+
+- (void)cancelImports:(id)sender {
+    // cancel() may finish synchronously and report back into _imports
+    auto imports = _imports;
+    for (auto& import : imports) import->cancel();
+    [self importProgressDidChange];
+}
+
+- (BOOL)playlistViewDidRequestCancel:(SimPlaylistView *)view {
+    if (!_imports.empty()) {
+        [self cancelImports:nil];
+        return YES;
+    }
+    if ([self searchBarVisible]) {
+        [self hideSearchBar];
+        return YES;
+    }
+    return NO;
 }
 
 - (NSArray<NSString *> *)playlistView:(SimPlaylistView *)view filePathsForPlaylistIndices:(NSIndexSet *)indices {
@@ -2187,13 +3084,13 @@ static BOOL isRemotePath(const char *path) {
     if (row >= 0 && row < totalRows) {
         NSInteger playlistIdx = [view playlistIndexForRow:row];
         if (playlistIdx >= 0) {
-            insertAt = (t_size)playlistIdx;
+            insertAt = (t_size)[self playlistIndexForItemIndex:playlistIdx];
         } else {
             // Row is header/subgroup/padding - find next valid track
             for (NSInteger r = row; r < totalRows; r++) {
                 NSInteger idx = [view playlistIndexForRow:r];
                 if (idx >= 0) {
-                    insertAt = (t_size)idx;
+                    insertAt = (t_size)[self playlistIndexForItemIndex:idx];
                     break;
                 }
             }
@@ -2229,7 +3126,13 @@ static BOOL isRemotePath(const char *path) {
     }
 
     // Insert into destination playlist using foobar2000 native paths
-    importFb2kPathsToPlaylistAsync(destPlaylist, insertAt, paths);
+    std::vector<std::string> locations;
+    locations.reserve(paths.count);
+    for (NSString *path in paths) {
+        if (path.length > 0) locations.emplace_back([path UTF8String]);
+    }
+    [self startImportOfLocations:std::move(locations) intoPlaylist:destPlaylist
+                         atIndex:insertAt expandFolders:NO];
 }
 
 @end
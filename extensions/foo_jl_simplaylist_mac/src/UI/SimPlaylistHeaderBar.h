@@ -20,6 +20,10 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong) NSArray<ColumnDefinition *> *columns;
 @property (nonatomic, assign) CGFloat groupColumnWidth;
 
+// Sort indicators - column indices in key priority order, and which of them sort descending
+@property (nonatomic, copy) NSArray<NSNumber *> *sortColumns;
+@property (nonatomic, copy) NSIndexSet *descendingSortColumns;
+
 // Sync horizontal scroll with main view
 - (void)setScrollOffset:(CGFloat)offset;
 
@@ -41,8 +45,8 @@ NS_ASSUME_NONNULL_BEGIN
 // Column reorder
 - (void)headerBar:(SimPlaylistHeaderBar *)bar didReorderColumnFrom:(NSInteger)fromIndex to:(NSInteger)toIndex;
 
-// Column click (for sorting)
-- (void)headerBar:(SimPlaylistHeaderBar *)bar didClickColumn:(NSInteger)columnIndex;
+// Column click (for sorting) - extend is YES for Shift-click (add a secondary key)
+- (void)headerBar:(SimPlaylistHeaderBar *)bar didClickColumn:(NSInteger)columnIndex extend:(BOOL)extend;
 
 // Right-click context menu for column configuration
 - (void)headerBar:(SimPlaylistHeaderBar *)bar showColumnMenuAtPoint:(NSPoint)point;
@@ -41,6 +41,8 @@ static const CGFloat kResizeHandleWidth = 6.0;
 
 - (void)commonInit {
     _columns = @[];
+    _sortColumns = @[];
+    _descendingSortColumns = [NSIndexSet indexSet];
     _groupColumnWidth = 80;
     _scrollOffset = 0;
     _resizingColumn = -1;
@@ -53,6 +55,16 @@ static const CGFloat kResizeHandleWidth = 6.0;
     return YES;
 }
 
+- (void)setSortColumns:(NSArray<NSNumber *> *)sortColumns {
+    _sortColumns = [sortColumns copy];
+    [self setNeedsDisplay:YES];
+}
+
+- (void)setDescendingSortColumns:(NSIndexSet *)descendingSortColumns {
+    _descendingSortColumns = [descendingSortColumns copy];
+    [self setNeedsDisplay:YES];
+}
+
 - (void)setScrollOffset:(CGFloat)offset {
     _scrollOffset = offset;
     [self setNeedsDisplay:YES];
@@ -159,7 +171,8 @@ static const CGFloat kResizeHandleWidth = 6.0;
             BOOL isDragging = (i == _draggingColumn);
 
             if (!isDragging) {
-                [self drawHeaderCell:col.name inRect:colRect highlighted:isHighlighted];
+                [self drawHeaderCell:col.name inRect:colRect highlighted:isHighlighted
+                       sortIndicator:[self sortIndicatorForColumn:i]];
             }
 
             // Draw resize handle visual
@@ -187,7 +200,8 @@ static const CGFloat kResizeHandleWidth = 6.0;
         [[[NSColor controlBackgroundColor] colorWithAlphaComponent:0.9] setFill];
         NSRectFill(dragRect);
 
-        [self drawHeaderCell:dragCol.name inRect:dragRect highlighted:YES];
+        [self drawHeaderCell:dragCol.name inRect:dragRect highlighted:YES
+               sortIndicator:[self sortIndicatorForColumn:_draggingColumn]];
 
         // Border
         [[NSColor selectedContentBackgroundColor] setStroke];
@@ -200,7 +214,17 @@ static const CGFloat kResizeHandleWidth = 6.0;
     NSRectFill(NSMakeRect(0, kHeaderHeight - 1, self.bounds.size.width, 1));
 }
 
-- (void)drawHeaderCell:(NSString *)title inRect:(NSRect)rect highlighted:(BOOL)highlighted {
+// Arrow for a sorted column, with its key number once there are several keys
+- (nullable NSString *)sortIndicatorForColumn:(NSInteger)columnIndex {
+    NSUInteger position = [_sortColumns indexOfObject:@(columnIndex)];
+    if (position == NSNotFound) return nil;
+    NSString *arrow = [_descendingSortColumns containsIndex:(NSUInteger)columnIndex] ? @"\u25BC" : @"\u25B2";
+    if (_sortColumns.count < 2) return arrow;
+    return [NSString stringWithFormat:@"%lu%@", (unsigned long)position + 1, arrow];
+}
+
+- (void)drawHeaderCell:(NSString *)title inRect:(NSRect)rect highlighted:(BOOL)highlighted
+         sortIndicator:(nullable NSString *)sortIndicator {
     if (highlighted) {
         [[[NSColor labelColor] colorWithAlphaComponent:0.1] setFill];
         NSRectFill(rect);
@@ -213,6 +237,19 @@ static const CGFloat kResizeHandleWidth = 6.0;
         NSForegroundColorAttributeName: [NSColor secondaryLabelColor]
     };
 
+    if (sortIndicator) {
+        NSDictionary *indicatorAttrs = @{
+            NSFontAttributeName: [NSFont systemFontOfSize:8],
+            NSForegroundColorAttributeName: [NSColor secondaryLabelColor]
+        };
+        NSSize indicatorSize = [sortIndicator sizeWithAttributes:indicatorAttrs];
+        NSRect indicatorRect = NSMakeRect(NSMaxX(textRect) - indicatorSize.width,
+                                          NSMidY(rect) - indicatorSize.height / 2,
+                                          indicatorSize.width, indicatorSize.height);
+        [sortIndicator drawInRect:indicatorRect withAttributes:indicatorAttrs];
+        textRect.size.width = MAX(0, textRect.size.width - indicatorSize.width - 4);
+    }
+
     NSMutableParagraphStyle *style = [[NSMutableParagraphStyle alloc] init];
     style.lineBreakMode = NSLineBreakByTruncatingTail;
 
@@ -340,8 +377,9 @@ static const CGFloat kResizeHandleWidth = 6.0;
             // Just a click, not a drag
             NSInteger clickedColumn = [self columnAtX:location.x];
             if (clickedColumn >= 0 && clickedColumn == _draggingColumn) {
-                if ([_delegate respondsToSelector:@selector(headerBar:didClickColumn:)]) {
-                    [_delegate headerBar:self didClickColumn:clickedColumn];
+                if ([_delegate respondsToSelector:@selector(headerBar:didClickColumn:extend:)]) {
+                    BOOL extend = (event.modifierFlags & NSEventModifierFlagShift) != 0;
+                    [_delegate headerBar:self didClickColumn:clickedColumn extend:extend];
                 }
             }
         }
@@ -8,6 +8,8 @@
 #pragma once
 
 #import <Cocoa/Cocoa.h>
+#include "../Core/GroupIndex.h"
+#include "../Core/SelectionModel.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -31,23 +33,11 @@ extern NSPasteboardType const SimPlaylistPasteboardType;
 @property (nonatomic, strong) NSArray<ColumnDefinition *> *columns;
 
 // SPARSE GROUP MODEL - O(G) storage for G groups instead of O(N) for N tracks
+// Group/subgroup starts and padding live in a C++ GroupIndex (see setGroupStarts:...)
 @property (nonatomic, assign) NSInteger itemCount;  // Total playlist items
-@property (nonatomic, strong) NSArray<NSNumber *> *groupStarts;  // Playlist indices where groups start
 @property (nonatomic, strong) NSArray<NSString *> *groupHeaders;  // Header text per group
 @property (nonatomic, strong) NSArray<NSString *> *groupArtKeys;  // Album art cache key per group
-@property (nonatomic, strong) NSArray<NSNumber *> *groupPaddingRows;  // Extra padding rows per group for min height
-@property (nonatomic, assign) NSInteger totalPaddingRowsCached;  // Pre-computed sum of all padding rows
-@property (nonatomic, strong) NSArray<NSNumber *> *cumulativePaddingCache;  // Pre-computed cumulative padding before each group
-
-// SUBGROUPS - playlist indices where subgroups start, header text per subgroup
-@property (nonatomic, strong) NSArray<NSNumber *> *subgroupStarts;  // Playlist indices where subgroups start
 @property (nonatomic, strong) NSArray<NSString *> *subgroupHeaders;  // Header text per subgroup
-@property (nonatomic, strong) NSArray<NSNumber *> *subgroupCountPerGroup;  // Pre-computed subgroup count per group
-@property (nonatomic, strong) NSSet<NSNumber *> *subgroupRowSet;  // Pre-computed set of subgroup row numbers for O(1) lookup
-@property (nonatomic, strong) NSDictionary<NSNumber *, NSNumber *> *subgroupRowToIndex;  // Map row -> subgroup index
-
-// Formatted column values cache (lazily populated during draw, auto-evicts under memory pressure)
-@property (nonatomic, strong) NSCache<NSNumber *, NSArray<NSString *> *> *formattedValuesCache;
 
 // Legacy properties (for compatibility)
 @property (nonatomic, strong) NSArray<GroupNode *> *nodes;  // Deprecated
@@ -66,7 +56,7 @@ extern NSPasteboardType const SimPlaylistPasteboardType;
 @property (nonatomic, assign) CGFloat albumArtSize;  // Preferred album art size (actual may be smaller)
 
 // State
-@property (nonatomic, strong) NSMutableIndexSet *selectedIndices;
+@property (nonatomic, readonly) NSIndexSet *selectedIndices;  // Snapshot of the selection runs (playlist indices)
 @property (nonatomic, assign) NSInteger focusIndex;
 @property (nonatomic, assign) NSInteger playingIndex;  // -1 if not playing
 @property (nonatomic, assign) NSInteger sourcePlaylistIndex;  // For drag validation
@@ -79,6 +69,11 @@ extern NSPasteboardType const SimPlaylistPasteboardType;
 
 // Reload data and redraw
 - (void)reloadData;
+// Same after an insert/remove/move: only tiles from playlistIndex's group down are redrawn
+- (void)reloadDataFromPlaylistIndex:(NSInteger)playlistIndex;
+
+// Draw tiles newly exposed by scrolling (content is rendered in row tiles)
+- (void)updateTilesForVisibleRect;
 
 // Selection management
 - (void)selectRowAtIndex:(NSInteger)index;
@@ -88,6 +83,11 @@ extern NSPasteboardType const SimPlaylistPasteboardType;
 - (void)deselectAll;
 - (void)toggleSelectionAtIndex:(NSInteger)index;
 
+// Selection as runs of playlist indices. Setting it (e.g. mirrored from the
+// playlist) redraws only the rows whose state changed and doesn't notify the delegate.
+- (const simplaylist::SelectionModel &)selection;
+- (void)setSelection:(simplaylist::SelectionModel)selection;
+
 // Focus management
 - (void)setFocusIndex:(NSInteger)index;
 - (void)moveFocusBy:(NSInteger)delta extendSelection:(BOOL)extend;
@@ -98,6 +98,14 @@ extern NSPasteboardType const SimPlaylistPasteboardType;
 - (NSRect)rectForRow:(NSInteger)row;
 - (CGFloat)yOffsetForRow:(NSInteger)row;
 
+// Replace group layout: ascending playlist indices where groups / subgroups start,
+// and extra padding rows per group (min height for album art). Header strings are set separately.
+- (void)setGroupStarts:(std::vector<int64_t>)groupStarts
+        subgroupStarts:(std::vector<int64_t>)subgroupStarts
+           paddingRows:(std::vector<int32_t>)paddingRows;
+- (void)clearGroups;  // Flat list
+- (NSInteger)groupCount;
+
 // Row mapping for sparse groups (O(log g) operations)
 - (NSInteger)rowCount;  // Total display rows = itemCount + groupCount
 - (NSInteger)playlistIndexForRow:(NSInteger)row;  // -1 for header rows
@@ -106,11 +114,6 @@ extern NSPasteboardType const SimPlaylistPasteboardType;
 - (NSInteger)rowForGroupHeader:(NSInteger)groupIndex;  // Row number for group header
 - (NSInteger)rowForPlaylistIndex:(NSInteger)playlistIndex;  // Convert playlist index to row
 
-// Clear cached data (call when playlist changes)
-- (void)clearFormattedValuesCache;
-- (void)rebuildSubgroupRowCache;  // Call after subgroups or layout changes
-- (void)rebuildPaddingCache;  // Call after groupPaddingRows changes
-
 // Update playing state
 - (void)setPlayingIndex:(NSInteger)index;
 
@@ -129,7 +132,7 @@ extern NSPasteboardType const SimPlaylistPasteboardType;
 
 @optional
 // Called when selection changes
-- (void)playlistView:(SimPlaylistView *)view selectionDidChange:(NSIndexSet *)selectedIndices;
+- (void)playlistView:(SimPlaylistView *)view selectionDidChange:(const simplaylist::SelectionModel &)selection;
 
 // Called when user double-clicks a row
 - (void)playlistView:(SimPlaylistView *)view didDoubleClickRow:(NSInteger)row;
@@ -140,6 +143,12 @@ extern NSPasteboardType const SimPlaylistPasteboardType;
 // Called when user presses delete key
 - (void)playlistViewDidRequestRemoveSelection:(SimPlaylistView *)view;
 
+// Called when user presses Escape (returns NO if there was nothing to cancel)
+- (BOOL)playlistViewDidRequestCancel:(SimPlaylistView *)view;
+
+// Called on Cmd+F (text = nil) or when user starts typing (text = typed characters)
+- (void)playlistView:(SimPlaylistView *)view didRequestFindWithText:(nullable NSString *)text;
+
 // Called to request album art for a group (returns cached image or nil, triggers async load)
 - (nullable NSImage *)playlistView:(SimPlaylistView *)view albumArtForGroupAtPlaylistIndex:(NSInteger)playlistIndex;
 
@@ -160,9 +169,23 @@ extern NSPasteboardType const SimPlaylistPasteboardType;
 // Get file paths for playlist indices (for drag data capture)
 - (nullable NSArray<NSString *> *)playlistView:(SimPlaylistView *)view filePathsForPlaylistIndices:(NSIndexSet *)indices;
 
-// Lazy column value formatting - called when drawing track rows with nil columnValues
+// Map view item indices to playlist indices when the view shows a filtered subset
+// (drag data always carries playlist indices)
+- (NSIndexSet *)playlistView:(SimPlaylistView *)view playlistIndicesForItemIndices:(NSIndexSet *)indices;
+
+// Lazy column value formatting - legacy per-row path (used when batch methods are not implemented)
 - (nullable NSArray<NSString *> *)playlistView:(SimPlaylistView *)view columnValuesForPlaylistIndex:(NSInteger)playlistIndex;
 
+// Batch column formatting - called once per draw pass with the visible playlist index range plus overscan
+- (void)playlistView:(SimPlaylistView *)view prepareColumnValuesInRange:(NSRange)playlistIndexRange;
+
+// Zero-copy access to a formatted cell prepared above (NUL-terminated UTF-8, valid until next prepare)
+- (BOOL)playlistView:(SimPlaylistView *)view
+     columnValueUTF8:(const char * _Nullable * _Nonnull)outValue
+              length:(NSUInteger *)outLength
+    forPlaylistIndex:(NSInteger)playlistIndex
+              column:(NSUInteger)column;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -11,11 +11,63 @@
 #import "../Core/ColumnDefinition.h"
 #import "../Core/ConfigHelper.h"
 #import "../Core/AlbumArtCache.h"
+#include "../Core/RowLayoutCache.h"
+#include "../Core/SelectionModel.h"
+#include "../Core/TileManager.h"
 
 NSString *const SimPlaylistSettingsChangedNotification = @"SimPlaylistSettingsChanged";
 NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.rows";
 
-@interface SimPlaylistView ()
+// Track rows formatted beyond each edge of the visible range (smooth scrolling without format stalls)
+static const NSInteger kColumnFormatOverscanRows = 32;
+// Groups above/below the viewport whose pending art loads are kept (not cancelled)
+static const NSInteger kAlbumArtOverscanGroups = 8;
+// Rows per render tile, and tiles kept drawn above/below the viewport
+static const NSInteger kRowsPerTile = 16;
+static const int64_t kOverscanTiles = 1;
+
+// Draws tile layers through their view (kept separate so the layers don't retain it)
+@interface SimPlaylistTileDelegate : NSObject <CALayerDelegate>
+@property (nonatomic, weak) SimPlaylistView *view;
+@end
+
+@interface SimPlaylistView (Tiles)
+- (void)drawTileLayer:(CALayer *)layer inContext:(CGContextRef)context;
+@end
+
+@implementation SimPlaylistTileDelegate
+
+- (void)drawLayer:(CALayer *)layer inContext:(CGContextRef)context {
+    [self.view drawTileLayer:layer inContext:context];
+}
+
+- (nullable id<CAAction>)actionForLayer:(CALayer *)layer forKey:(NSString *)event {
+    return (id<CAAction>)[NSNull null];  // Tiles move and redraw without implicit animations
+}
+
+@end
+
+@interface SimPlaylistView () {
+    // Reused per draw pass - track rows draw without per-row object allocations
+    NSMutableString *_cellScratch;
+    NSMutableAttributedString *_cellAttrScratch;
+    NSFont *_trackFont;
+    CGFloat _trackFontSize;  // 0 = text attributes need rebuilding
+    NSDictionary *_cellAttributes[2];  // [selected], CoreText attributes
+    NSColor *_dimmedColors[2];  // [selected]
+    // Shaped cell lines - rows that didn't change redraw without layout
+    simplaylist::RowLayoutCache _rowLayouts;
+    // Tiled rendering: resident tiles and their layers (tile index -> layer)
+    simplaylist::TileManager _tiles;
+    NSMutableDictionary<NSNumber *, CALayer *> *_tileLayers;
+    NSMutableArray<CALayer *> *_spareTileLayers;
+    SimPlaylistTileDelegate *_tileDelegate;
+    BOOL _delegateFormatsInBatch;
+    // Group/subgroup starts, padding and row prefix sums (row <-> playlist index mapping)
+    simplaylist::GroupIndex _groupIndex;
+    // Selected playlist indices as runs
+    simplaylist::SelectionModel _selection;
+}
 @property (nonatomic, assign) NSInteger selectionAnchor;  // For shift-click selection
 @property (nonatomic, strong) NSTrackingArea *trackingArea;
 @property (nonatomic, assign) NSInteger hoveredRow;
@@ -51,7 +103,6 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
 - (void)commonInit {
     _columns = [ColumnDefinition defaultColumns];
-    _selectedIndices = [NSMutableIndexSet indexSet];
     _focusIndex = -1;
     _playingIndex = -1;
     _selectionAnchor = -1;
@@ -62,19 +113,12 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
     // SPARSE GROUP MODEL - efficient O(G) storage
     _itemCount = 0;
-    _groupStarts = @[];
     _groupHeaders = @[];
     _groupArtKeys = @[];
-    _groupPaddingRows = @[];
-    _totalPaddingRowsCached = 0;
-    _cumulativePaddingCache = @[];
-    _subgroupStarts = @[];
     _subgroupHeaders = @[];
-    _subgroupCountPerGroup = @[];
-    _subgroupRowSet = [NSSet set];
-    _subgroupRowToIndex = @{};
-    _formattedValuesCache = [[NSCache alloc] init];
-    _formattedValuesCache.countLimit = 1000;  // Cache ~1000 visible row values, auto-evicts oldest
+    _cellScratch = [NSMutableString string];
+    _cellAttrScratch = [[NSMutableAttributedString alloc] init];
+    _trackFontSize = 0;
 
     // Legacy properties (keep for compatibility)
     _nodes = @[];
@@ -99,6 +143,7 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     _headerDisplayStyle = simplaylist_config::getConfigInt(
         simplaylist_config::kHeaderDisplayStyle,
         simplaylist_config::kDefaultHeaderDisplayStyle);
+    _groupIndex.setHeaderRowsPerGroup(_headerDisplayStyle == 3 ? 0 : 1);
     _dimParentheses = simplaylist_config::getConfigBool(
         simplaylist_config::kDimParentheses,
         simplaylist_config::kDefaultDimParentheses);
@@ -106,10 +151,14 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
         simplaylist_config::kDisplaySize,
         simplaylist_config::kDefaultDisplaySize);
 
-    // PERFORMANCE: Enable layer-backed async drawing
+    // PERFORMANCE: Tiled layer-backed drawing - rows render into fixed-height tile
+    // layers that scroll with the view; only newly exposed or invalidated tiles redraw
     self.wantsLayer = YES;
     self.layerContentsRedrawPolicy = NSViewLayerContentsRedrawOnSetNeedsDisplay;
-    self.layer.drawsAsynchronously = YES;
+    _tileLayers = [NSMutableDictionary dictionary];
+    _spareTileLayers = [NSMutableArray array];
+    _tileDelegate = [[SimPlaylistTileDelegate alloc] init];
+    _tileDelegate.view = self;
 
     // CRITICAL: Set low priorities to allow flexible container resizing.
     // Without this, the view resists shrinking when user expands adjacent columns.
@@ -177,8 +226,12 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     _subgroupHeight = getConfigInt(kSubgroupHeight, kDefaultSubgroupHeight);
     _groupColumnWidth = getConfigInt(kGroupColumnWidth, kDefaultGroupColumnWidth);
     _showNowPlayingShading = getConfigBool(kNowPlayingShading, kDefaultNowPlayingShading);
-    _headerDisplayStyle = getConfigInt(kHeaderDisplayStyle, kDefaultHeaderDisplayStyle);
-    _dimParentheses = getConfigBool(kDimParentheses, kDefaultDimParentheses);
+    self.headerDisplayStyle = getConfigInt(kHeaderDisplayStyle, kDefaultHeaderDisplayStyle);
+    BOOL dimParentheses = getConfigBool(kDimParentheses, kDefaultDimParentheses);
+    if (dimParentheses != _dimParentheses) {
+        _dimParentheses = dimParentheses;
+        _rowLayouts.clear();
+    }
 
     [self invalidateIntrinsicContentSize];
     [self setNeedsDisplay:YES];
@@ -190,17 +243,27 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     return YES;  // Top-left origin for easier layout
 }
 
+- (void)viewDidChangeEffectiveAppearance {
+    [super viewDidChangeEffectiveAppearance];
+    // Text colors are resolved to CGColors when lines are built
+    _trackFontSize = 0;
+    [self setNeedsDisplay:YES];
+}
+
 - (BOOL)acceptsFirstResponder {
     return YES;
 }
 
 - (BOOL)becomeFirstResponder {
-    [self setNeedsDisplay:YES];
+    // Only the focus ring depends on first responder state
+    if (_focusIndex >= 0) [self invalidateRowsForPlaylistIndexes:[NSIndexSet indexSetWithIndex:_focusIndex]];
+    [super setNeedsDisplay:YES];
     return YES;
 }
 
 - (BOOL)resignFirstResponder {
-    [self setNeedsDisplay:YES];
+    if (_focusIndex >= 0) [self invalidateRowsForPlaylistIndexes:[NSIndexSet indexSetWithIndex:_focusIndex]];
+    [super setNeedsDisplay:YES];
     return YES;
 }
 
@@ -224,7 +287,27 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 #pragma mark - Data Management
 
 - (void)reloadData {
-    // Update frame size to match content for proper scrolling
+    [self updateContentFrame];
+    [self setNeedsDisplay:YES];
+}
+
+- (void)reloadDataFromPlaylistIndex:(NSInteger)playlistIndex {
+    [self updateContentFrame];
+
+    // Group column art and padding span the whole group: redraw from its header
+    NSInteger row = [self rowForPlaylistIndex:playlistIndex];
+    NSInteger group = row >= 0 ? [self groupIndexForRow:row] : -1;
+    if (group >= 0) row = [self rowForGroupHeader:group];
+    if (row < 0) {
+        [self setNeedsDisplay:YES];  // Past the end - nothing left to anchor on
+        return;
+    }
+    _tiles.invalidateFrom([self yOffsetForRow:row]);
+    [super setNeedsDisplay:YES];
+}
+
+// Update frame size to match content for proper scrolling
+- (void)updateContentFrame {
     NSSize contentSize = [self calculatedContentSize];
 
     // Ensure minimum size matches scroll view's visible area
@@ -245,7 +328,6 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     self.frame = frame;
 
     [self invalidateIntrinsicContentSize];
-    [self setNeedsDisplay:YES];
 }
 
 - (void)setNodes:(NSArray<GroupNode *> *)nodes {
@@ -256,362 +338,83 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
 #pragma mark - Layout Calculations
 
-// Returns total row count: itemCount + groupCount + subgroupCount (each group/subgroup adds 1 header row)
+- (void)setItemCount:(NSInteger)itemCount {
+    _itemCount = itemCount;
+    _groupIndex.setItemCount(itemCount);
+}
+
 // Only style 3 (under album art) has no header rows - header text is below album art
-- (NSInteger)rowCount {
-    // Total rows = items + group headers + subgroup headers + padding rows
-    // Uses cached totalPaddingRowsCached for O(1) instead of O(G) loop
+- (void)setHeaderDisplayStyle:(NSInteger)headerDisplayStyle {
+    _headerDisplayStyle = headerDisplayStyle;
+    _groupIndex.setHeaderRowsPerGroup(headerDisplayStyle == 3 ? 0 : 1);
+}
 
-    // Only style 3 has no header rows (header is drawn below album art)
-    // Styles 0, 1, 2 all have header rows
-    NSInteger groupHeaderRows = (_headerDisplayStyle == 3) ? 0 : (NSInteger)_groupStarts.count;
+- (void)setGroupStarts:(std::vector<int64_t>)groupStarts
+        subgroupStarts:(std::vector<int64_t>)subgroupStarts
+           paddingRows:(std::vector<int32_t>)paddingRows {
+    _groupIndex.assign(std::move(groupStarts), std::move(subgroupStarts), std::move(paddingRows));
+}
 
-    return _itemCount + groupHeaderRows + (NSInteger)_subgroupStarts.count + _totalPaddingRowsCached;
+- (void)clearGroups {
+    _groupIndex.clear();
+    _groupHeaders = @[];
+    _groupArtKeys = @[];
+    _subgroupHeaders = @[];
 }
 
-// Helper: cumulative padding rows up to (but not including) group g - O(1) using cache
-- (NSInteger)cumulativePaddingBeforeGroup:(NSInteger)groupIndex {
-    if (groupIndex <= 0 || _cumulativePaddingCache.count == 0) return 0;
-    if (groupIndex >= (NSInteger)_cumulativePaddingCache.count) {
-        return [_cumulativePaddingCache.lastObject integerValue];
-    }
-    return [_cumulativePaddingCache[groupIndex] integerValue];
+- (NSInteger)groupCount {
+    return (NSInteger)_groupIndex.groupCount();
+}
+
+// Returns total row count: items + group headers + subgroup headers + padding rows - O(1)
+- (NSInteger)rowCount {
+    return (NSInteger)_groupIndex.rowCount();
 }
 
 // Helper: total rows in group g (header + subgroups + tracks + padding)
-// Only style 3 has no header row (header is drawn below album art)
 - (NSInteger)totalRowsInGroup:(NSInteger)groupIndex {
-    if (groupIndex < 0 || groupIndex >= (NSInteger)_groupStarts.count) return 0;
-    NSInteger groupStart = [_groupStarts[groupIndex] integerValue];
-    NSInteger groupEnd = (groupIndex + 1 < (NSInteger)_groupStarts.count)
-        ? [_groupStarts[groupIndex + 1] integerValue]
-        : _itemCount;
-    NSInteger trackCount = groupEnd - groupStart;
-    NSInteger padding = (groupIndex < (NSInteger)_groupPaddingRows.count)
-        ? [_groupPaddingRows[groupIndex] integerValue] : 0;
-    // Only style 3 has no header row
-    NSInteger headerRows = (_headerDisplayStyle == 3) ? 0 : 1;
-
-    // Use pre-computed subgroup count (O(1) instead of O(S))
-    NSInteger subgroupCount = (groupIndex < (NSInteger)_subgroupCountPerGroup.count)
-        ? [_subgroupCountPerGroup[groupIndex] integerValue] : 0;
-
-    return headerRows + subgroupCount + trackCount + padding;
+    if (groupIndex < 0 || groupIndex >= (NSInteger)_groupIndex.groupCount()) return 0;
+    return (NSInteger)_groupIndex.totalRowsInGroup(groupIndex);
 }
 
 #pragma mark - Row Mapping (O(log g) using binary search)
 
-// Find which group a row belongs to using binary search
+// Find which group a row belongs to
 - (NSInteger)groupIndexForRow:(NSInteger)row {
-    if (_groupStarts.count == 0 || row < 0) return -1;
-
-    // Binary search: find the largest group index g where rowForGroupHeader(g) <= row
-    NSInteger low = 0;
-    NSInteger high = (NSInteger)_groupStarts.count - 1;
-    NSInteger result = 0;
-
-    while (low <= high) {
-        NSInteger mid = (low + high) / 2;
-        NSInteger headerRow = [self rowForGroupHeader:mid];
-        if (headerRow <= row) {
-            result = mid;
-            low = mid + 1;
-        } else {
-            high = mid - 1;
-        }
-    }
-    return result;
+    return (NSInteger)_groupIndex.groupForRow(row);
 }
 
 // Row number where group header appears (or first track row for style 3)
 - (NSInteger)rowForGroupHeader:(NSInteger)groupIndex {
-    if (groupIndex < 0 || groupIndex >= (NSInteger)_groupStarts.count) return -1;
-    NSInteger cumulativePadding = [self cumulativePaddingBeforeGroup:groupIndex];
-    NSInteger groupStart = [_groupStarts[groupIndex] integerValue];
-
-    // Count all subgroups that appear before this group - O(log S) using binary search
-    NSInteger subgroupsBeforeGroup = [self subgroupCountBeforePlaylistIndex:groupStart];
-
-    // Only style 3 has no header rows
-    if (_headerDisplayStyle == 3) {
-        // Style 3: no header rows, return position of first track
-        return groupStart + subgroupsBeforeGroup + cumulativePadding;
-    } else {
-        // Styles 0, 1, 2: Header row = groupStart[g] + g (group headers) + subgroups before + cumulative padding
-        return groupStart + groupIndex + subgroupsBeforeGroup + cumulativePadding;
-    }
+    if (groupIndex < 0 || groupIndex >= (NSInteger)_groupIndex.groupCount()) return -1;
+    return (NSInteger)_groupIndex.firstRowOfGroup(groupIndex);
 }
 
 // Check if row is a group header
 - (BOOL)isRowGroupHeader:(NSInteger)row {
-    if (_groupStarts.count == 0) return NO;
-    // Only style 3 has no header rows (header is drawn below album art)
-    if (_headerDisplayStyle == 3) return NO;
-
-    NSInteger groupIndex = [self groupIndexForRow:row];
-    return row == [self rowForGroupHeader:groupIndex];
-}
-
-// Check if row is a padding row (empty space for minimum group height)
-- (BOOL)isRowPaddingRow:(NSInteger)row {
-    if (_groupStarts.count == 0 || _groupPaddingRows.count == 0) return NO;
-    NSInteger groupIndex = [self groupIndexForRow:row];
-    if (groupIndex < 0) return NO;
-
-    NSInteger headerRow = [self rowForGroupHeader:groupIndex];
-    NSInteger rowWithinGroup = row - headerRow;
-
-    // Get track count for this group
-    NSInteger groupStart = [_groupStarts[groupIndex] integerValue];
-    NSInteger groupEnd = (groupIndex + 1 < (NSInteger)_groupStarts.count)
-        ? [_groupStarts[groupIndex + 1] integerValue]
-        : _itemCount;
-    NSInteger trackCount = groupEnd - groupStart;
-
-    // Get subgroup count for this group (subgroup headers add to row count)
-    NSInteger subgroupsInGroup = (groupIndex < (NSInteger)_subgroupCountPerGroup.count)
-        ? [_subgroupCountPerGroup[groupIndex] integerValue] : 0;
-
-    // Total content rows = tracks + subgroup headers (header row already excluded by rowWithinGroup)
-    NSInteger contentRows = trackCount + subgroupsInGroup;
-
-    // Row is padding if it's after all content (tracks + subgroups) in the group
-    return (rowWithinGroup > contentRows);
+    return _groupIndex.kindOfRow(row) == simplaylist::GroupIndex::RowKind::GroupHeader;
 }
 
 // Convert row to playlist index (-1 for header rows, subgroup rows, and padding rows)
 - (NSInteger)playlistIndexForRow:(NSInteger)row {
-    if (row < 0 || row >= [self rowCount]) return -1;
-    if (_groupStarts.count == 0) return row;  // No groups = flat mode
-
-    // Check if this is a subgroup header row
-    if ([self isRowSubgroupHeader:row]) {
-        return -1;
-    }
-
-    NSInteger groupIndex = [self groupIndexForRow:row];
-    NSInteger groupStartRow = [self rowForGroupHeader:groupIndex];
-
-    // Styles 0, 1, 2 have header rows; only style 3 doesn't
-    if (_headerDisplayStyle != 3 && row == groupStartRow) {
-        return -1;  // This is a header row
-    }
-
-    // Count subgroups in this group before this row to get correct playlist index
-    NSInteger groupStart = [_groupStarts[groupIndex] integerValue];
-    NSInteger groupEnd = (groupIndex + 1 < (NSInteger)_groupStarts.count)
-        ? [_groupStarts[groupIndex + 1] integerValue]
-        : _itemCount;
-
-    // Count subgroup rows between groupStartRow and this row using cached set - O(subgroups in group)
-    NSInteger subgroupsInGroup = 0;
-    for (NSNumber *sgRowNum in _subgroupRowSet) {
-        NSInteger sgRow = [sgRowNum integerValue];
-        if (sgRow > groupStartRow && sgRow < row) {
-            subgroupsInGroup++;
-        }
-    }
-
-    // Calculate position within group accounting for subgroups
-    NSInteger rowWithinGroup = row - groupStartRow - subgroupsInGroup;
-
-    // Styles 0, 1, 2 have header rows; only style 3 doesn't
-    if (_headerDisplayStyle != 3) {
-        rowWithinGroup -= 1;
-    }
-
-    NSInteger trackCount = groupEnd - groupStart;
-
-    // If row is beyond tracks, it's a padding row
-    if (rowWithinGroup >= trackCount) {
-        return -1;  // Padding row
-    }
-
-    // Track row: playlist index = groupStart + rowWithinGroup
-    return groupStart + rowWithinGroup;
+    return (NSInteger)_groupIndex.playlistIndexForRow(row);
 }
 
 // Convert playlist index to row
 - (NSInteger)rowForPlaylistIndex:(NSInteger)playlistIndex {
-    if (playlistIndex < 0 || playlistIndex >= _itemCount) return -1;
-    if (_groupStarts.count == 0) return playlistIndex;  // No groups
-
-    // Find which group this playlist index belongs to - O(log G) using binary search
-    NSInteger groupIndex = 0;
-    NSInteger low = 0;
-    NSInteger high = (NSInteger)_groupStarts.count - 1;
-    while (low <= high) {
-        NSInteger mid = (low + high) / 2;
-        if ([_groupStarts[mid] integerValue] <= playlistIndex) {
-            groupIndex = mid;
-            low = mid + 1;
-        } else {
-            high = mid - 1;
-        }
-    }
-
-    // Count subgroups before this playlist index - O(log S)
-    // subgroupCountBeforePlaylistIndex counts subgroups with start < playlistIndex
-    // But if a subgroup starts at exactly playlistIndex, its header row is BEFORE this track
-    NSInteger subgroupsBefore = [self subgroupCountBeforePlaylistIndex:playlistIndex];
-    if ([self hasSubgroupAtPlaylistIndex:playlistIndex]) {
-        subgroupsBefore++;
-    }
-
-    // Only style 3 has no header rows
-    NSInteger headerRowsOffset = (_headerDisplayStyle == 3) ? 0 : (groupIndex + 1);
-
-    // Row = playlist index + group headers (if not style 3) + subgroup headers + cumulative padding
-    NSInteger cumulativePadding = [self cumulativePaddingBeforeGroup:groupIndex];
-    return playlistIndex + headerRowsOffset + subgroupsBefore + cumulativePadding;
-}
-
-// Clear formatted values cache (call when playlist changes)
-- (void)clearFormattedValuesCache {
-    [_formattedValuesCache removeAllObjects];
-}
-
-// Rebuild subgroup row cache for O(1) lookup (call when subgroups or layout changes)
-- (void)rebuildSubgroupRowCache {
-    if (_subgroupStarts.count == 0) {
-        _subgroupRowSet = [NSSet set];
-        _subgroupRowToIndex = @{};
-        return;
-    }
-
-    NSMutableSet<NSNumber *> *rowSet = [NSMutableSet setWithCapacity:_subgroupStarts.count];
-    NSMutableDictionary<NSNumber *, NSNumber *> *rowToIndex = [NSMutableDictionary dictionaryWithCapacity:_subgroupStarts.count];
-
-    for (NSUInteger i = 0; i < _subgroupStarts.count; i++) {
-        NSInteger subgroupPlaylistIndex = [_subgroupStarts[i] integerValue];
-        NSInteger subgroupRow = [self rowForSubgroupAtPlaylistIndex:subgroupPlaylistIndex];
-        NSNumber *rowNum = @(subgroupRow);
-        [rowSet addObject:rowNum];
-        rowToIndex[rowNum] = @(i);
-    }
-
-    _subgroupRowSet = [rowSet copy];
-    _subgroupRowToIndex = [rowToIndex copy];
-}
-
-// Rebuild padding cache for O(1) lookup (call when groupPaddingRows changes)
-- (void)rebuildPaddingCache {
-    if (_groupPaddingRows.count == 0) {
-        _totalPaddingRowsCached = 0;
-        _cumulativePaddingCache = @[];
-        return;
-    }
-
-    NSMutableArray<NSNumber *> *cumulative = [NSMutableArray arrayWithCapacity:_groupPaddingRows.count];
-    NSInteger runningTotal = 0;
-
-    for (NSNumber *padding in _groupPaddingRows) {
-        [cumulative addObject:@(runningTotal)];  // Cumulative BEFORE this group
-        runningTotal += [padding integerValue];
-    }
-
-    _totalPaddingRowsCached = runningTotal;
-    _cumulativePaddingCache = [cumulative copy];
+    return (NSInteger)_groupIndex.rowForPlaylistIndex(playlistIndex);
 }
 
 // Get playlist index range for a group
 - (NSRange)playlistIndexRangeForGroup:(NSInteger)groupIndex {
-    if (groupIndex < 0 || groupIndex >= (NSInteger)_groupStarts.count) {
+    if (groupIndex < 0 || groupIndex >= (NSInteger)_groupIndex.groupCount()) {
         return NSMakeRange(NSNotFound, 0);
     }
-    NSInteger groupStart = [_groupStarts[groupIndex] integerValue];
-    NSInteger groupEnd = (groupIndex + 1 < (NSInteger)_groupStarts.count)
-        ? [_groupStarts[groupIndex + 1] integerValue]
-        : _itemCount;
+    NSInteger groupStart = (NSInteger)_groupIndex.groupStart(groupIndex);
+    NSInteger groupEnd = (NSInteger)_groupIndex.groupEnd(groupIndex);
     return NSMakeRange(groupStart, groupEnd - groupStart);
 }
 
-// Count subgroups strictly before a given playlist index - O(log S) using binary search
-- (NSInteger)subgroupCountBeforePlaylistIndex:(NSInteger)playlistIndex {
-    if (_subgroupStarts.count == 0) return 0;
-
-    // Binary search for the first subgroup >= playlistIndex
-    NSInteger low = 0;
-    NSInteger high = (NSInteger)_subgroupStarts.count;
-
-    while (low < high) {
-        NSInteger mid = (low + high) / 2;
-        if ([_subgroupStarts[mid] integerValue] < playlistIndex) {
-            low = mid + 1;
-        } else {
-            high = mid;
-        }
-    }
-
-    return low;  // Number of subgroups with start < playlistIndex
-}
-
-// Check if a subgroup starts at exactly this playlist index - O(log S)
-- (BOOL)hasSubgroupAtPlaylistIndex:(NSInteger)playlistIndex {
-    if (_subgroupStarts.count == 0) return NO;
-
-    NSInteger low = 0;
-    NSInteger high = (NSInteger)_subgroupStarts.count - 1;
-
-    while (low <= high) {
-        NSInteger mid = (low + high) / 2;
-        NSInteger midVal = [_subgroupStarts[mid] integerValue];
-        if (midVal == playlistIndex) {
-            return YES;
-        } else if (midVal < playlistIndex) {
-            low = mid + 1;
-        } else {
-            high = mid - 1;
-        }
-    }
-    return NO;
-}
-
-// Check if a row is a subgroup header - O(1) using pre-computed cache
-- (BOOL)isRowSubgroupHeader:(NSInteger)row {
-    return [_subgroupRowSet containsObject:@(row)];
-}
-
-// Get subgroup header text for a row (returns nil if not a subgroup header) - O(1) using cache
-- (NSString *)subgroupHeaderForRow:(NSInteger)row {
-    NSNumber *indexNum = _subgroupRowToIndex[@(row)];
-    if (!indexNum) return nil;
-
-    NSUInteger i = [indexNum unsignedIntegerValue];
-    if (i < _subgroupHeaders.count) {
-        return _subgroupHeaders[i];
-    }
-    return nil;
-}
-
-// Calculate row for a subgroup that starts at given playlist index
-- (NSInteger)rowForSubgroupAtPlaylistIndex:(NSInteger)subgroupPlaylistIndex {
-    if (_groupStarts.count == 0) return subgroupPlaylistIndex;
-
-    // Find which group this subgroup belongs to - O(log G) using binary search
-    NSInteger groupIndex = 0;
-    NSInteger low = 0;
-    NSInteger high = (NSInteger)_groupStarts.count - 1;
-    while (low <= high) {
-        NSInteger mid = (low + high) / 2;
-        if ([_groupStarts[mid] integerValue] <= subgroupPlaylistIndex) {
-            groupIndex = mid;
-            low = mid + 1;
-        } else {
-            high = mid - 1;
-        }
-    }
-
-    // Row = subgroupPlaylistIndex + (group headers if not inline) + (subgroups before this index) + padding
-    NSInteger cumulativePadding = [self cumulativePaddingBeforeGroup:groupIndex];
-    NSInteger subgroupsBefore = [self subgroupCountBeforePlaylistIndex:subgroupPlaylistIndex];
-
-    // Only style 3 has no group header rows
-    NSInteger headerRowsOffset = (_headerDisplayStyle == 3) ? 0 : (groupIndex + 1);
-
-    return subgroupPlaylistIndex + headerRowsOffset + subgroupsBefore + cumulativePadding;
-}
-
 // Find group boundary for a display row (unused in flat mode)
 - (GroupBoundary *)groupBoundaryForRow:(NSInteger)row {
     return nil;  // No groups in flat mode
@@ -696,18 +499,209 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     return [self rowCount] * _rowHeight;
 }
 
-#pragma mark - Drawing (Virtual Scrolling - SPARSE MODEL)
+#pragma mark - Tiled Rendering
+
+- (BOOL)wantsUpdateLayer {
+    return YES;  // Content is drawn by tile sublayers, not drawRect:
+}
+
+- (void)updateLayer {
+    self.layer.backgroundColor = [self backgroundColor].CGColor;
+    // Backing layer was replaced - tiles have to be attached and drawn again
+    CALayer *anyTile = _tileLayers.allValues.firstObject;
+    if (anyTile && anyTile.superlayer != self.layer) {
+        _tiles.invalidateAll();
+    }
+    [self updateTilesForVisibleRect];
+}
+
+- (void)setNeedsDisplay:(BOOL)needsDisplay {
+    if (needsDisplay) _tiles.invalidateAll();
+    [super setNeedsDisplay:needsDisplay];
+}
+
+- (void)setNeedsDisplayInRect:(NSRect)invalidRect {
+    _tiles.invalidateSpan(NSMinY(invalidRect), NSMaxY(invalidRect));
+    [super setNeedsDisplayInRect:invalidRect];
+}
+
+- (void)setFrameSize:(NSSize)newSize {
+    BOOL widthChanged = newSize.width != self.frame.size.width;
+    [super setFrameSize:newSize];
+    if (widthChanged) {
+        _tiles.invalidateAll();  // Every tile spans the full width
+        [super setNeedsDisplay:YES];
+    }
+}
+
+- (void)viewDidChangeBackingProperties {
+    [super viewDidChangeBackingProperties];
+    [self setNeedsDisplay:YES];  // Redraw tiles at the new scale
+}
+
+// Make tiles around the viewport resident; draw only new and invalidated ones
+- (void)updateTilesForVisibleRect {
+    _tiles.setTileHeight(MAX(_rowHeight, 1) * kRowsPerTile);
+    _tiles.setContentHeight(NSHeight(self.bounds));
+
+    NSRect visibleRect = [self visibleRect];
+    simplaylist::TileManager::Update update =
+        _tiles.update(NSMinY(visibleRect), NSMaxY(visibleRect), kOverscanTiles);
+    if (update.released.empty() && update.toDraw.empty()) return;
+
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+
+    // Released tiles go back to the pool
+    for (int64_t tile : update.released) {
+        CALayer *layer = _tileLayers[@(tile)];
+        if (!layer) continue;
+        [_tileLayers removeObjectForKey:@(tile)];
+        layer.hidden = YES;
+        [_spareTileLayers addObject:layer];
+    }
+
+    CGFloat width = NSWidth(self.bounds);
+    CGFloat scale = self.window ? self.window.backingScaleFactor : 2.0;
+    for (int64_t tile : update.toDraw) {
+        CALayer *layer = _tileLayers[@(tile)];
+        if (!layer) {
+            layer = [self dequeueTileLayer];
+            _tileLayers[@(tile)] = layer;
+        }
+        if (layer.superlayer != self.layer) {
+            [self.layer addSublayer:layer];
+        }
+        layer.frame = CGRectMake(0, _tiles.tileTop(tile), width, _tiles.tileHeightAt(tile));
+        layer.contentsScale = scale;
+        layer.hidden = NO;
+        [layer setNeedsDisplay];
+    }
+
+    [CATransaction commit];
+}
+
+- (CALayer *)dequeueTileLayer {
+    CALayer *layer = _spareTileLayers.lastObject;
+    if (layer) {
+        [_spareTileLayers removeLastObject];
+        return layer;
+    }
+    layer = [CALayer layer];
+    layer.delegate = _tileDelegate;
+    layer.opaque = YES;
+    layer.drawsAsynchronously = YES;
+    layer.needsDisplayOnBoundsChange = YES;
+    return layer;
+}
+
+- (void)drawTileLayer:(CALayer *)layer inContext:(CGContextRef)context {
+    NSRect tileRect = NSRectFromCGRect(layer.frame);
+
+    CGContextSaveGState(context);
+    // Draw in the view's flipped coordinates, offset to the tile
+    if (!layer.contentsAreFlipped) {
+        CGContextTranslateCTM(context, 0, tileRect.size.height);
+        CGContextScaleCTM(context, 1.0, -1.0);
+    }
+    CGContextTranslateCTM(context, -tileRect.origin.x, -tileRect.origin.y);
+
+    [NSGraphicsContext saveGraphicsState];
+    [NSGraphicsContext setCurrentContext:[NSGraphicsContext graphicsContextWithCGContext:context flipped:YES]];
+    [self.effectiveAppearance performAsCurrentDrawingAppearance:^{
+        [self drawContentInRect:tileRect];
+    }];
+    [NSGraphicsContext restoreGraphicsState];
+
+    CGContextRestoreGState(context);
+}
 
-- (void)drawRect:(NSRect)dirtyRect {
-    [super drawRect:dirtyRect];
+// Invalidate the rows of these playlist items that are on resident tiles.
+// Each item is mapped to its row through the group index, so the cost follows
+// the number of changed items rather than the number of rows on screen.
+- (void)invalidateRowsForPlaylistIndexes:(NSIndexSet *)playlistIndexes {
+    simplaylist::TileManager::Range resident = _tiles.residentRange();
+    if (resident.empty() || playlistIndexes.count == 0) return;
+
+    double residentTop = _tiles.tileTop(resident.first);
+    double residentBottom = _tiles.tileTop(resident.last) + _tiles.tileHeightAt(resident.last);
+    NSInteger itemCount = _itemCount;
+    [playlistIndexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        if ((NSInteger)index >= itemCount) {
+            *stop = YES;
+            return;
+        }
+        [self invalidateRowForPlaylistIndex:(NSInteger)index residentTop:residentTop bottom:residentBottom];
+    }];
+}
+
+- (void)invalidateRowForPlaylistIndex:(NSInteger)playlistIndex residentTop:(double)top bottom:(double)bottom {
+    NSInteger row = [self rowForPlaylistIndex:playlistIndex];
+    if (row < 0) return;
+    NSRect rowRect = [self rectForRow:row];
+    if (NSMaxY(rowRect) > top && NSMinY(rowRect) < bottom) {
+        [self setNeedsDisplayInRect:rowRect];
+    }
+
+    // Inline headers (style 2) sit directly on their group's first track,
+    // next to the art - redraw the header row together with that track
+    if (_headerDisplayStyle == 2 && _groupIndex.groupCount() > 0) {
+        NSInteger group = [self groupIndexForRow:row];
+        if (group >= 0 && (NSInteger)_groupIndex.groupStart(group) == playlistIndex) {
+            NSInteger headerRow = [self rowForGroupHeader:group];
+            if (headerRow >= 0 && headerRow != row) {
+                NSRect headerRect = [self rectForRow:headerRow];
+                if (NSMaxY(headerRect) > top && NSMinY(headerRect) < bottom) {
+                    [self setNeedsDisplayInRect:headerRect];
+                }
+            }
+        }
+    }
+}
 
+// Redraw only rows whose selection or focus state differs from before
+- (void)selectionDidChangeFrom:(const simplaylist::SelectionModel &)previousSelection focus:(NSInteger)previousFocus {
+    NSMutableIndexSet *changed = [NSMutableIndexSet indexSet];
+    simplaylist::TileManager::Range resident = _tiles.residentRange();
+    if (!resident.empty()) {
+        // Symmetric difference (O(runs)), limited to the playlist items on resident tiles
+        NSInteger firstRow = [self rowAtPoint:NSMakePoint(0, _tiles.tileTop(resident.first))];
+        double residentBottom = _tiles.tileTop(resident.last) + _tiles.tileHeightAt(resident.last);
+        NSInteger lastRow = [self rowAtPoint:NSMakePoint(0, residentBottom - 1)];
+        NSInteger firstIndex = -1, lastIndex = -1;
+        for (NSInteger row = MAX(firstRow, 0); row <= lastRow && firstIndex < 0; row++) {
+            firstIndex = [self playlistIndexForRow:row];
+        }
+        for (NSInteger row = lastRow; row >= MAX(firstRow, 0) && lastIndex < 0; row--) {
+            lastIndex = [self playlistIndexForRow:row];
+        }
+        if (firstIndex >= 0 && lastIndex >= firstIndex) {
+            simplaylist::SelectionModel diff = simplaylist::SelectionModel::difference(previousSelection, _selection);
+            for (const simplaylist::SelectionModel::Run &run : diff.runs()) {
+                int64_t start = MAX(run.start, (int64_t)firstIndex);
+                int64_t end = MIN(run.end, (int64_t)lastIndex + 1);
+                if (start < end) [changed addIndexesInRange:NSMakeRange((NSUInteger)start, (NSUInteger)(end - start))];
+            }
+        }
+    }
+    if (previousFocus != _focusIndex) {
+        if (previousFocus >= 0) [changed addIndex:previousFocus];
+        if (_focusIndex >= 0) [changed addIndex:_focusIndex];
+    }
+    [self invalidateRowsForPlaylistIndexes:changed];
+}
+
+#pragma mark - Drawing (Virtual Scrolling - SPARSE MODEL)
+
+// Draw everything inside rect (one tile) in view coordinates
+- (void)drawContentInRect:(NSRect)dirtyRect {
     // Background
     [[self backgroundColor] setFill];
     NSRectFill(dirtyRect);
 
     NSInteger totalRows = [self rowCount];
     if (totalRows == 0) {
-        [self drawEmptyStateInRect:dirtyRect];
+        [self drawEmptyStateInRect:self.bounds];
         return;
     }
 
@@ -718,22 +712,31 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 #pragma mark - Sparse Model Drawing
 
 - (void)drawSparseModelInRect:(NSRect)dirtyRect {
-    // Find visible row range (O(1) calculation)
-    NSRect visibleRect = [self visibleRect];
-    NSInteger firstRow = [self rowAtPoint:NSMakePoint(0, NSMinY(visibleRect))];
-    NSInteger lastRow = [self rowAtPoint:NSMakePoint(0, NSMaxY(visibleRect))];
+    // Find row range of the area being drawn (O(1) calculation)
+    NSInteger firstRow = [self rowAtPoint:NSMakePoint(0, NSMinY(dirtyRect))];
+    NSInteger lastRow = [self rowAtPoint:NSMakePoint(0, NSMaxY(dirtyRect))];
 
     NSInteger totalRows = [self rowCount];
-    if (firstRow < 0) firstRow = 0;
+    if (firstRow < 0) {
+        // Tile below the last row (view is taller than its content)
+        if (NSMinY(dirtyRect) > 0) {
+            if (_dropTargetRow >= 0) [self drawDropIndicatorAtRow:_dropTargetRow];
+            return;
+        }
+        firstRow = 0;
+    }
     if (lastRow < 0 || lastRow >= totalRows) lastRow = totalRows - 1;
 
-    // Add small buffer for smooth scrolling
+    // Add small buffer for rows straddling the edges
     firstRow = MAX(0, firstRow - 1);
     lastRow = MIN(totalRows - 1, lastRow + 1);
 
+    // Format all visible track rows (plus overscan) in one batch before drawing
+    [self prepareColumnValuesForRowsFrom:firstRow to:lastRow];
+
     // STEP 1: Fill group column background FIRST (before any content)
     // This ensures header text drawn later won't be covered
-    if (_groupColumnWidth > 0 && _groupStarts.count > 0) {
+    if (_groupColumnWidth > 0 && _groupIndex.groupCount() > 0) {
         [self fillGroupColumnBackgroundInRect:dirtyRect];
     }
 
@@ -746,7 +749,7 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     }
 
     // STEP 3: Draw album art on top (after all row content)
-    if (_groupColumnWidth > 0 && _groupStarts.count > 0) {
+    if (_groupColumnWidth > 0 && _groupIndex.groupCount() > 0) {
         [self drawAlbumArtInRect:dirtyRect firstRow:firstRow lastRow:lastRow];
     }
 
@@ -772,18 +775,20 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
 // Draw a single row using sparse model
 - (void)drawSparseRow:(NSInteger)row inRect:(NSRect)rect {
-    BOOL isHeader = [self isRowGroupHeader:row];
-    BOOL isSubgroupHeader = [self isRowSubgroupHeader:row];
-    BOOL isPadding = [self isRowPaddingRow:row];
-    NSInteger playlistIndex = (isHeader || isSubgroupHeader || isPadding) ? -1 : [self playlistIndexForRow:row];
+    // One index lookup classifies the row
+    int64_t rowIndex = -1;
+    simplaylist::GroupIndex::RowKind kind = _groupIndex.kindOfRow(row, &rowIndex);
+    BOOL isHeader = (kind == simplaylist::GroupIndex::RowKind::GroupHeader);
+    BOOL isSubgroupHeader = (kind == simplaylist::GroupIndex::RowKind::SubgroupHeader);
+    NSInteger playlistIndex = (kind == simplaylist::GroupIndex::RowKind::Track) ? (NSInteger)rowIndex : -1;
 
     // Padding rows are empty - just return (background already drawn)
-    if (isPadding) {
+    if (kind == simplaylist::GroupIndex::RowKind::Padding || kind == simplaylist::GroupIndex::RowKind::Invalid) {
         return;
     }
 
     // Check selection and playing state
-    BOOL isSelected = (playlistIndex >= 0 && [_selectedIndices containsIndex:playlistIndex]);
+    BOOL isSelected = (playlistIndex >= 0 && _selection.contains(playlistIndex));
     BOOL isPlaying = (playlistIndex >= 0 && playlistIndex == _playingIndex);
 
     // Selection/playing background - only in columns area, not album art column
@@ -800,10 +805,9 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     }
 
     if (isHeader) {
-        NSInteger groupIndex = [self groupIndexForRow:row];
-        [self drawSparseHeaderRow:groupIndex inRect:rect];
+        [self drawSparseHeaderRow:(NSInteger)rowIndex inRect:rect];
     } else if (isSubgroupHeader) {
-        NSString *subgroupText = [self subgroupHeaderForRow:row];
+        NSString *subgroupText = (rowIndex < (int64_t)_subgroupHeaders.count) ? _subgroupHeaders[(NSUInteger)rowIndex] : nil;
         [self drawSparseSubgroupRow:subgroupText inRect:rect];
     } else {
         [self drawSparseTrackRow:playlistIndex inRect:rect selected:isSelected playing:isPlaying];
@@ -936,132 +940,227 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     }
 }
 
-// Helper: Create attributed string with dimmed parentheses
-- (NSAttributedString *)attributedString:(NSString *)text
-                                    font:(NSFont *)font
-                               textColor:(NSColor *)textColor
-                              dimmedColor:(NSColor *)dimmedColor
-                          paragraphStyle:(NSParagraphStyle *)style {
-    NSMutableAttributedString *result = [[NSMutableAttributedString alloc] initWithString:text attributes:@{
-        NSFontAttributeName: font,
-        NSForegroundColorAttributeName: textColor,
-        NSParagraphStyleAttributeName: style
-    }];
+- (void)setDelegate:(id<SimPlaylistViewDelegate>)delegate {
+    _delegate = delegate;
+    _delegateFormatsInBatch =
+        [delegate respondsToSelector:@selector(playlistView:prepareColumnValuesInRange:)] &&
+        [delegate respondsToSelector:@selector(playlistView:columnValueUTF8:length:forPlaylistIndex:column:)];
+}
+
+// Ask the delegate to format the track rows covered by [firstRow, lastRow] plus overscan
+- (void)prepareColumnValuesForRowsFrom:(NSInteger)firstRow to:(NSInteger)lastRow {
+    if (!_delegateFormatsInBatch || _itemCount == 0) return;
+
+    // Edge rows may be headers/subgroups/padding - walk inwards to the first and last track
+    NSInteger firstIndex = -1;
+    NSInteger lastIndex = -1;
+    for (NSInteger row = firstRow; row <= lastRow && firstIndex < 0; row++) {
+        firstIndex = [self playlistIndexForRow:row];
+    }
+    for (NSInteger row = lastRow; row >= firstRow && lastIndex < 0; row--) {
+        lastIndex = [self playlistIndexForRow:row];
+    }
+    if (firstIndex < 0 || lastIndex < firstIndex) return;
 
-    // Find and dim text inside () and []
+    firstIndex = MAX(0, firstIndex - kColumnFormatOverscanRows);
+    lastIndex = MIN(_itemCount - 1, lastIndex + kColumnFormatOverscanRows);
+    [_delegate playlistView:self prepareColumnValuesInRange:NSMakeRange(firstIndex, lastIndex - firstIndex + 1)];
+}
+
+// Cell text as UTF-8 (NUL-terminated) - batch cells are read in place without copying
+- (BOOL)cellTextForPlaylistIndex:(NSInteger)playlistIndex
+                          column:(NSUInteger)column
+                    legacyValues:(NSArray<NSString *> *)legacyValues
+                            utf8:(const char **)outText
+                          length:(NSUInteger *)outLength {
+    if (_delegateFormatsInBatch) {
+        const char *utf8 = nullptr;
+        NSUInteger length = 0;
+        if (![_delegate playlistView:self columnValueUTF8:&utf8 length:&length
+                    forPlaylistIndex:playlistIndex column:column] || !utf8) {
+            return NO;
+        }
+        *outText = utf8;
+        *outLength = length;
+        return YES;
+    }
+    if (column < legacyValues.count) {
+        const char *utf8 = legacyValues[column].UTF8String ?: "";
+        *outText = utf8;
+        *outLength = strlen(utf8);
+        return YES;
+    }
+    *outText = "";
+    *outLength = 0;
+    return legacyValues != nil;
+}
+
+// Apply dim color to text inside () and [] - one attribute run per bracketed span
+- (void)applyDimmedRangesTo:(NSMutableAttributedString *)attrStr color:(NSColor *)dimmedColor {
+    NSString *text = attrStr.string;
     NSUInteger length = text.length;
-    NSInteger parenDepth = 0;  // () depth
-    NSInteger bracketDepth = 0;  // [] depth
+    NSInteger depth = 0;
+    NSUInteger runStart = NSNotFound;
+    NSString *colorAttribute = (__bridge NSString *)kCTForegroundColorAttributeName;
+    id colorValue = (__bridge id)dimmedColor.CGColor;
 
     for (NSUInteger i = 0; i < length; i++) {
         unichar c = [text characterAtIndex:i];
-
         if (c == '(' || c == '[') {
-            // Start of parentheses/bracket - dim from this character
-            if (c == '(') parenDepth++;
-            else bracketDepth++;
-
-            [result addAttribute:NSForegroundColorAttributeName
-                           value:dimmedColor
-                           range:NSMakeRange(i, 1)];
+            if (depth == 0) runStart = i;
+            depth++;
         } else if (c == ')' || c == ']') {
-            // End of parentheses/bracket - dim this character too
-            [result addAttribute:NSForegroundColorAttributeName
-                           value:dimmedColor
-                           range:NSMakeRange(i, 1)];
-
-            if (c == ')' && parenDepth > 0) parenDepth--;
-            else if (c == ']' && bracketDepth > 0) bracketDepth--;
-        } else if (parenDepth > 0 || bracketDepth > 0) {
-            // Inside parentheses/brackets - dim
-            [result addAttribute:NSForegroundColorAttributeName
-                           value:dimmedColor
-                           range:NSMakeRange(i, 1)];
+            if (depth == 0) {
+                // Stray closing bracket - dim just this character
+                [attrStr addAttribute:colorAttribute value:colorValue range:NSMakeRange(i, 1)];
+            } else if (--depth == 0) {
+                [attrStr addAttribute:colorAttribute value:colorValue
+                                range:NSMakeRange(runStart, i - runStart + 1)];
+                runStart = NSNotFound;
+            }
         }
     }
-
-    return result;
+    // Unclosed bracket dims to end of string
+    if (runStart != NSNotFound) {
+        [attrStr addAttribute:colorAttribute value:colorValue
+                        range:NSMakeRange(runStart, length - runStart)];
+    }
 }
 
-// Draw track row with lazy column formatting
-- (void)drawSparseTrackRow:(NSInteger)playlistIndex inRect:(NSRect)rect selected:(BOOL)selected playing:(BOOL)playing {
-    if (playlistIndex < 0) return;
+// Track text attributes are shared by every cell - rebuilt when the font size or
+// appearance changes (colors are resolved for the current appearance)
+- (void)rebuildTrackTextAttributesForFontSize:(CGFloat)fontSize {
+    _trackFont = [NSFont systemFontOfSize:fontSize];
+    _trackFontSize = fontSize;
 
-    // Get cached column values or request from delegate
-    NSNumber *indexKey = @(playlistIndex);
-    NSArray<NSString *> *columnValues = [_formattedValuesCache objectForKey:indexKey];
-    if (!columnValues && [_delegate respondsToSelector:@selector(playlistView:columnValuesForPlaylistIndex:)]) {
-        columnValues = [_delegate playlistView:self columnValuesForPlaylistIndex:playlistIndex];
-        if (columnValues) {
-            [_formattedValuesCache setObject:columnValues forKey:indexKey];
+    NSColor *textColors[2] = { [NSColor labelColor], [NSColor selectedMenuItemTextColor] };
+    _dimmedColors[0] = [NSColor secondaryLabelColor];
+    _dimmedColors[1] = [[NSColor selectedMenuItemTextColor] colorWithAlphaComponent:0.5];
+
+    for (NSInteger sel = 0; sel < 2; sel++) {
+        _cellAttributes[sel] = @{
+            (__bridge NSString *)kCTFontAttributeName: _trackFont,
+            (__bridge NSString *)kCTForegroundColorAttributeName: (__bridge id)textColors[sel].CGColor
+        };
+    }
+    _rowLayouts.clear();
+}
+
+// Shape a cell's text, truncated with an ellipsis to width, and cache the line
+- (const simplaylist::RowLayoutCache::Line *)layoutCellForPlaylistIndex:(NSInteger)playlistIndex
+                                                                  column:(NSUInteger)column
+                                                                    utf8:(const char *)utf8
+                                                                  length:(NSUInteger)length
+                                                                   width:(CGFloat)width
+                                                               alignment:(NSInteger)alignment
+                                                                selected:(BOOL)selected
+                                                                 playing:(BOOL)playing
+                                                                styleKey:(uint32_t)styleKey {
+    [_cellScratch setString:playing ? @"\u25B6 " : @""];  // Play triangle
+    if (length > 0) {
+        CFStringAppendCString((__bridge CFMutableStringRef)_cellScratch, utf8, kCFStringEncodingUTF8);
+    }
+
+    NSDictionary *attrs = _cellAttributes[selected ? 1 : 0];
+    [_cellAttrScratch replaceCharactersInRange:NSMakeRange(0, _cellAttrScratch.length) withString:_cellScratch];
+    [_cellAttrScratch setAttributes:attrs range:NSMakeRange(0, _cellAttrScratch.length)];
+    if (_dimParentheses) {
+        [self applyDimmedRangesTo:_cellAttrScratch color:_dimmedColors[selected ? 1 : 0]];
+    }
+
+    CTLineRef line = CTLineCreateWithAttributedString((__bridge CFAttributedStringRef)_cellAttrScratch);
+    CGFloat lineWidth = line ? CTLineGetTypographicBounds(line, NULL, NULL, NULL) : 0;
+    if (line && lineWidth > width) {
+        NSAttributedString *ellipsis = [[NSAttributedString alloc] initWithString:@"\u2026" attributes:attrs];
+        CTLineRef token = CTLineCreateWithAttributedString((__bridge CFAttributedStringRef)ellipsis);
+        CTLineRef truncated = CTLineCreateTruncatedLine(line, width, kCTLineTruncationEnd, token);
+        if (token) CFRelease(token);
+        if (truncated) {
+            CFRelease(line);
+            line = truncated;
+            lineWidth = CTLineGetTypographicBounds(line, NULL, NULL, NULL);
         }
     }
 
-    if (!columnValues) {
-        return;  // Nothing to draw
+    CGFloat penOffset = 0;
+    if (alignment == ColumnAlignmentRight) {
+        penOffset = MAX(0, width - lineWidth);
+    } else if (alignment == ColumnAlignmentCenter) {
+        penOffset = MAX(0, floor((width - lineWidth) / 2.0));
+    }
+    return _rowLayouts.store(playlistIndex, column, utf8, length, width, styleKey, line, penOffset);
+}
+
+// Draw track row from batch-formatted column values
+- (void)drawSparseTrackRow:(NSInteger)playlistIndex inRect:(NSRect)rect selected:(BOOL)selected playing:(BOOL)playing {
+    if (playlistIndex < 0) return;
+
+    // Legacy delegates without batch formatting still get the per-row call
+    NSArray<NSString *> *legacyValues = nil;
+    if (!_delegateFormatsInBatch) {
+        if (![_delegate respondsToSelector:@selector(playlistView:columnValuesForPlaylistIndex:)]) return;
+        legacyValues = [_delegate playlistView:self columnValuesForPlaylistIndex:playlistIndex];
+        if (!legacyValues) return;
     }
 
     // Draw columns
     CGFloat x = _groupColumnWidth;
-    NSColor *textColor = selected ? [NSColor selectedMenuItemTextColor] : [NSColor labelColor];
-    NSColor *dimmedColor = selected ? [[NSColor selectedMenuItemTextColor] colorWithAlphaComponent:0.5]
-                                    : [NSColor secondaryLabelColor];
     // Font size based on display size: compact=12, normal=13, large=14
     CGFloat fontSize = (_displaySize == 0) ? 12 : (_displaySize == 2) ? 14 : 13;
-    NSFont *font = [NSFont systemFontOfSize:fontSize];
+    if (fontSize != _trackFontSize) {
+        [self rebuildTrackTextAttributesForFontSize:fontSize];
+    }
+    NSFont *font = _trackFont;
 
     // Calculate vertical centering with equal top/bottom padding
     CGFloat textHeight = font.ascender - font.descender;
     CGFloat verticalPadding = floor((rect.size.height - textHeight) / 2.0);
+    CGFloat baseline = rect.origin.y + verticalPadding + font.ascender;
+
+    CGContextRef context = [NSGraphicsContext currentContext].CGContext;
+    CGContextSetTextMatrix(context, CGAffineTransformMakeScale(1.0, -1.0));  // Flipped view
 
     for (NSUInteger colIndex = 0; colIndex < _columns.count; colIndex++) {
         ColumnDefinition *col = _columns[colIndex];
+        CGFloat textWidth = col.width - 8;
 
-        // Center text vertically within row
-        NSRect colRect = NSMakeRect(x + 4, rect.origin.y + verticalPadding,
-                                    col.width - 8, textHeight);
-
-        NSString *value = (colIndex < columnValues.count) ? columnValues[colIndex] : @"";
-
-        // For first column, prepend play indicator if this is the playing track
-        if (colIndex == 0 && playing) {
-            value = [NSString stringWithFormat:@"\u25B6 %@", value];  // Play triangle
-        }
-
-        NSMutableParagraphStyle *style = [[NSMutableParagraphStyle alloc] init];
-        style.lineBreakMode = NSLineBreakByTruncatingTail;
-        switch (col.alignment) {
-            case ColumnAlignmentCenter: style.alignment = NSTextAlignmentCenter; break;
-            case ColumnAlignmentRight: style.alignment = NSTextAlignmentRight; break;
-            default: style.alignment = NSTextAlignmentLeft; break;
+        const char *utf8 = nullptr;
+        NSUInteger length = 0;
+        if (![self cellTextForPlaylistIndex:playlistIndex column:colIndex legacyValues:legacyValues
+                                       utf8:&utf8 length:&length]) {
+            // Row not prepared (e.g. drawn outside the batch range) - nothing to draw
+            break;
         }
 
-        if (_dimParentheses) {
-            // Draw with dimmed parentheses
-            NSAttributedString *attrStr = [self attributedString:value
-                                                            font:font
-                                                       textColor:textColor
-                                                      dimmedColor:dimmedColor
-                                                  paragraphStyle:style];
-            [attrStr drawInRect:colRect];
-        } else {
-            // Draw normally
-            NSDictionary *attrs = @{
-                NSFontAttributeName: font,
-                NSForegroundColorAttributeName: textColor,
-                NSParagraphStyleAttributeName: style
-            };
-            [value drawInRect:colRect withAttributes:attrs];
+        if (textWidth > 0) {
+            NSInteger alignment = col.alignment;
+            if (alignment < 0 || alignment > 2) alignment = ColumnAlignmentLeft;
+            // For first column, prepend play indicator if this is the playing track
+            BOOL showPlaying = (colIndex == 0 && playing);
+            uint32_t styleKey = ((uint32_t)alignment << 2) | (showPlaying ? 2u : 0u) | (selected ? 1u : 0u);
+
+            const simplaylist::RowLayoutCache::Line *line =
+                _rowLayouts.find(playlistIndex, colIndex, utf8, length, textWidth, styleKey);
+            if (!line) {
+                line = [self layoutCellForPlaylistIndex:playlistIndex column:colIndex utf8:utf8 length:length
+                                                  width:textWidth alignment:alignment selected:selected
+                                                playing:showPlaying styleKey:styleKey];
+            }
+            if (line->line) {
+                CGContextSetTextPosition(context, x + 4 + line->penOffset, baseline);
+                CTLineDraw(line->line, context);
+            }
         }
         x += col.width;
     }
+    CGContextSetTextMatrix(context, CGAffineTransformIdentity);
 }
 
 // Fill group column background (called BEFORE drawing row content)
 - (void)fillGroupColumnBackgroundInRect:(NSRect)dirtyRect {
-    if (_groupStarts.count == 0) return;
+    if (_groupIndex.empty()) return;
 
-    NSRect visibleRect = [self visibleRect];
+    NSRect visibleRect = dirtyRect;  // Area being drawn (a tile)
 
     // Style 1: Leave header row area unfilled so header text at x=8 is visible
     // Styles 0, 2, 3: Fill entire column
@@ -1077,7 +1176,7 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
         NSInteger firstGroupIndex = [self groupIndexForRow:firstRow];
         NSInteger lastGroupIndex = [self groupIndexForRow:lastRow];
 
-        for (NSInteger g = firstGroupIndex; g <= lastGroupIndex && g < (NSInteger)_groupStarts.count; g++) {
+        for (NSInteger g = firstGroupIndex; g <= lastGroupIndex && g < (NSInteger)_groupIndex.groupCount(); g++) {
             NSInteger groupStartRow = [self rowForGroupHeader:g];
             CGFloat groupTop = [self yOffsetForRow:groupStartRow];
             CGFloat groupHeight = [self totalRowsInGroup:g] * _rowHeight;
@@ -1102,16 +1201,24 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
 // Draw album art for visible groups (called AFTER drawing row content)
 - (void)drawAlbumArtInRect:(NSRect)dirtyRect firstRow:(NSInteger)firstRow lastRow:(NSInteger)lastRow {
-    if (_groupStarts.count == 0) return;
+    if (_groupIndex.empty()) return;
 
     // Find which groups are visible
     NSInteger firstGroupIndex = [self groupIndexForRow:firstRow];
     NSInteger lastGroupIndex = [self groupIndexForRow:lastRow];
 
+    // Tiles are drawn ahead of the viewport - publish what is actually on screen
+    NSRect visibleRect = [self visibleRect];
+    NSInteger firstVisibleRow = MAX(0, [self rowAtPoint:NSMakePoint(0, NSMinY(visibleRect))]);
+    NSInteger lastVisibleRow = [self rowAtPoint:NSMakePoint(0, NSMaxY(visibleRect) - 1)];
+    if (lastVisibleRow < 0) lastVisibleRow = [self rowCount] - 1;
+    [self publishAlbumArtViewportFromGroup:[self groupIndexForRow:firstVisibleRow]
+                                   toGroup:[self groupIndexForRow:lastVisibleRow]];
+
     CGFloat padding = 6;
 
-    for (NSInteger g = firstGroupIndex; g <= lastGroupIndex && g < (NSInteger)_groupStarts.count; g++) {
-        NSInteger groupStart = [_groupStarts[g] integerValue];
+    for (NSInteger g = firstGroupIndex; g <= lastGroupIndex && g < (NSInteger)_groupIndex.groupCount(); g++) {
+        NSInteger groupStart = (NSInteger)_groupIndex.groupStart(g);
 
         // Calculate group's row range
         NSInteger groupStartRow = [self rowForGroupHeader:g];
@@ -1141,7 +1248,9 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
         // Get album art from cache or delegate
         NSImage *albumArt = nil;
-        if (g < (NSInteger)_groupArtKeys.count && [_delegate respondsToSelector:@selector(playlistView:albumArtForGroupAtPlaylistIndex:)]) {
+        // Placeholder groups (empty art key) stay on the placeholder until detected
+        if (g < (NSInteger)_groupArtKeys.count && _groupArtKeys[g].length > 0 &&
+            [_delegate respondsToSelector:@selector(playlistView:albumArtForGroupAtPlaylistIndex:)]) {
             albumArt = [_delegate playlistView:self albumArtForGroupAtPlaylistIndex:groupStart];
         }
 
@@ -1164,6 +1273,27 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     }
 }
 
+// Tell the art cache which groups are on screen so their loads run first
+// and loads for groups scrolled far past are dropped
+- (void)publishAlbumArtViewportFromGroup:(NSInteger)firstGroup toGroup:(NSInteger)lastGroup {
+    NSInteger groupCount = (NSInteger)_groupIndex.groupCount();
+    if (groupCount == 0 || firstGroup < 0) return;
+    lastGroup = MIN(MAX(lastGroup, firstGroup), groupCount - 1);
+
+    NSInteger keepFirst = MAX(0, firstGroup - kAlbumArtOverscanGroups);
+    NSInteger keepLast = MIN(groupCount - 1, lastGroup + kAlbumArtOverscanGroups);
+
+    // Art loads are positioned by the group's first playlist index
+    NSInteger visibleStart = (NSInteger)_groupIndex.groupStart(firstGroup);
+    NSInteger visibleEnd = (NSInteger)_groupIndex.groupStart(lastGroup);
+    NSInteger keepStart = (NSInteger)_groupIndex.groupStart(keepFirst);
+    NSInteger keepEnd = (NSInteger)_groupIndex.groupStart(keepLast);
+
+    [[AlbumArtCache sharedCache] updateViewportForOwner:self
+                                           visibleRange:NSMakeRange(visibleStart, visibleEnd - visibleStart + 1)
+                                              keepRange:NSMakeRange(keepStart, keepEnd - keepStart + 1)];
+}
+
 - (void)drawDropIndicatorAtRow:(NSInteger)row {
     CGFloat y;
     NSInteger count = [self rowCount];
@@ -1258,7 +1388,7 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 - (void)drawFlatModeRow:(NSInteger)row inRect:(NSRect)rect {
     // In flat mode: row index = playlist index directly
     // Selection stores playlist indices
-    BOOL isSelected = [_selectedIndices containsIndex:row];  // row == playlistIndex in flat mode
+    BOOL isSelected = _selection.contains(row);  // row == playlistIndex in flat mode
     BOOL isPlaying = (row == _playingIndex);  // playingIndex is playlist index
 
     // Background - clean design without alternating stripes
@@ -1345,7 +1475,7 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
     if (!isHeader && playlistIndex >= 0) {
         // Selection uses playlist index (not row index)
-        isSelected = [_selectedIndices containsIndex:playlistIndex];
+        isSelected = _selection.contains(playlistIndex);
         isPlaying = (playlistIndex == _playingIndex);
     }
 
@@ -1481,13 +1611,7 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
         }
 
         // Check if any track in group is selected (using playlist indices)
-        BOOL groupHasSelection = NO;
-        for (NSInteger i = group.startPlaylistIndex; i <= group.endPlaylistIndex; i++) {
-            if ([_selectedIndices containsIndex:i]) {
-                groupHasSelection = YES;
-                break;
-            }
-        }
+        BOOL groupHasSelection = _selection.intersects(group.startPlaylistIndex, group.endPlaylistIndex + 1);
 
         // No selection border on album art - cleaner look
 
@@ -1501,7 +1625,7 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     GroupNode *node = _nodes[row];
     // Selection uses playlist index (not row index)
     NSInteger playlistIndex = (node.type == GroupNodeTypeTrack) ? node.playlistIndex : -1;
-    BOOL isSelected = (playlistIndex >= 0 && [_selectedIndices containsIndex:playlistIndex]);
+    BOOL isSelected = (playlistIndex >= 0 && _selection.contains(playlistIndex));
     BOOL isPlaying = (playlistIndex >= 0 && playlistIndex == _playingIndex);
 
     // Background - only in columns area, not album art column
@@ -1832,42 +1956,46 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     NSInteger playlistIndex = [self playlistIndexForRow:index];
     if (playlistIndex < 0) return;  // Don't select headers
 
+    simplaylist::SelectionModel previousSelection = _selection;
+    NSInteger previousFocus = _focusIndex;
+
     if (extend && _selectionAnchor >= 0) {
         // Range selection from anchor to clicked item
         NSInteger start = MIN(_selectionAnchor, playlistIndex);
         NSInteger end = MAX(_selectionAnchor, playlistIndex);
-        [_selectedIndices removeAllIndexes];
-        [_selectedIndices addIndexesInRange:NSMakeRange(start, end - start + 1)];
+        _selection.setRange(start, end + 1);
     } else {
         // Single selection
-        [_selectedIndices removeAllIndexes];
-        [_selectedIndices addIndex:playlistIndex];
+        _selection.setRange(playlistIndex, playlistIndex + 1);
         _selectionAnchor = playlistIndex;
     }
 
     _focusIndex = playlistIndex;
     [self notifySelectionChanged];
-    [self setNeedsDisplay:YES];
+    [self selectionDidChangeFrom:previousSelection focus:previousFocus];
 }
 
 - (void)selectRowsInRange:(NSRange)range {
-    [_selectedIndices addIndexesInRange:range];
+    simplaylist::SelectionModel previousSelection = _selection;
+    _selection.selectRange(range.location, NSMaxRange(range));
     [self notifySelectionChanged];
-    [self setNeedsDisplay:YES];
+    [self selectionDidChangeFrom:previousSelection focus:_focusIndex];
 }
 
 - (void)selectAll {
     // Select all playlist items (not row indices)
     if (_itemCount == 0) return;
-    [_selectedIndices addIndexesInRange:NSMakeRange(0, _itemCount)];
+    simplaylist::SelectionModel previousSelection = _selection;
+    _selection.setRange(0, _itemCount);
     [self notifySelectionChanged];
-    [self setNeedsDisplay:YES];
+    [self selectionDidChangeFrom:previousSelection focus:_focusIndex];
 }
 
 - (void)deselectAll {
-    [_selectedIndices removeAllIndexes];
+    simplaylist::SelectionModel previousSelection = _selection;
+    _selection.clear();
     [self notifySelectionChanged];
-    [self setNeedsDisplay:YES];
+    [self selectionDidChangeFrom:previousSelection focus:_focusIndex];
 }
 
 - (void)toggleSelectionAtIndex:(NSInteger)index {
@@ -1878,21 +2006,39 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     NSInteger playlistIndex = [self playlistIndexForRow:index];
     if (playlistIndex < 0) return;  // Don't select headers
 
-    if ([_selectedIndices containsIndex:playlistIndex]) {
-        [_selectedIndices removeIndex:playlistIndex];
-    } else {
-        [_selectedIndices addIndex:playlistIndex];
-    }
+    _selection.toggle(playlistIndex);
 
     [self notifySelectionChanged];
-    [self setNeedsDisplay:YES];
+    [self invalidateRowsForPlaylistIndexes:[NSIndexSet indexSetWithIndex:playlistIndex]];
+}
+
+- (const simplaylist::SelectionModel &)selection {
+    return _selection;
+}
+
+- (void)setSelection:(simplaylist::SelectionModel)selection {
+    if (selection == _selection) return;
+    simplaylist::SelectionModel previousSelection = std::move(_selection);
+    _selection = std::move(selection);
+    [self selectionDidChangeFrom:previousSelection focus:_focusIndex];
+}
+
+- (NSIndexSet *)selectedIndices {
+    NSMutableIndexSet *indices = [NSMutableIndexSet indexSet];
+    for (const simplaylist::SelectionModel::Run &run : _selection.runs()) {
+        [indices addIndexesInRange:NSMakeRange((NSUInteger)run.start, (NSUInteger)run.count())];
+    }
+    return indices;
 }
 
 - (void)setFocusIndex:(NSInteger)index {
     // Focus index is a playlist index
-    if (index < -1 || index >= _itemCount) return;
+    if (index < -1 || index >= _itemCount || index == _focusIndex) return;
+    NSMutableIndexSet *changed = [NSMutableIndexSet indexSet];
+    if (_focusIndex >= 0) [changed addIndex:_focusIndex];
+    if (index >= 0) [changed addIndex:index];
     _focusIndex = index;
-    [self setNeedsDisplay:YES];
+    [self invalidateRowsForPlaylistIndexes:changed];
 }
 
 - (void)moveFocusBy:(NSInteger)delta extendSelection:(BOOL)extend {
@@ -1934,6 +2080,9 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
     if (playlistIndex < 0) return;  // Couldn't find a valid track in either direction
 
+    simplaylist::SelectionModel previousSelection = _selection;
+    NSInteger previousFocus = _focusIndex;
+
     if (extend) {
         // Extend selection from anchor to new focus
         if (_selectionAnchor < 0) {
@@ -1941,18 +2090,16 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
         }
         NSInteger start = MIN(_selectionAnchor, playlistIndex);
         NSInteger end = MAX(_selectionAnchor, playlistIndex);
-        [_selectedIndices removeAllIndexes];
-        [_selectedIndices addIndexesInRange:NSMakeRange(start, end - start + 1)];
+        _selection.setRange(start, end + 1);
     } else {
-        [_selectedIndices removeAllIndexes];
-        [_selectedIndices addIndex:playlistIndex];
+        _selection.setRange(playlistIndex, playlistIndex + 1);
         _selectionAnchor = playlistIndex;
     }
 
     _focusIndex = playlistIndex;
     [self scrollRowToVisible:newRow];
     [self notifySelectionChanged];
-    [self setNeedsDisplay:YES];
+    [self selectionDidChangeFrom:previousSelection focus:previousFocus];
 }
 
 - (void)scrollRowToVisible:(NSInteger)row {
@@ -1964,13 +2111,17 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
 - (void)notifySelectionChanged {
     if ([_delegate respondsToSelector:@selector(playlistView:selectionDidChange:)]) {
-        [_delegate playlistView:self selectionDidChange:[_selectedIndices copy]];
+        [_delegate playlistView:self selectionDidChange:_selection];
     }
 }
 
 - (void)setPlayingIndex:(NSInteger)index {
+    if (index == _playingIndex) return;
+    NSMutableIndexSet *changed = [NSMutableIndexSet indexSet];
+    if (_playingIndex >= 0) [changed addIndex:_playingIndex];
+    if (index >= 0) [changed addIndex:index];
     _playingIndex = index;
-    [self setNeedsDisplay:YES];
+    [self invalidateRowsForPlaylistIndexes:changed];
 }
 
 #pragma mark - Mouse Events
@@ -1996,7 +2147,7 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
 
     // Check if clicked on group header or group column (album art area)
     BOOL isGroupHeader = [self isRowGroupHeader:row];
-    BOOL isInGroupColumn = (location.x < _groupColumnWidth && _groupColumnWidth > 0 && _groupStarts.count > 0);
+    BOOL isInGroupColumn = (location.x < _groupColumnWidth && _groupColumnWidth > 0 && _groupIndex.groupCount() > 0);
 
     if (isGroupHeader || isInGroupColumn) {
         // Select all items in the group
@@ -2006,17 +2157,10 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
             if (range.location != NSNotFound && range.length > 0) {
                 if (hasCmd) {
                     // Cmd+click on group: toggle group selection
-                    BOOL allSelected = YES;
-                    for (NSUInteger i = range.location; i < range.location + range.length; i++) {
-                        if (![_selectedIndices containsIndex:i]) {
-                            allSelected = NO;
-                            break;
-                        }
-                    }
-                    if (allSelected) {
-                        [_selectedIndices removeIndexesInRange:range];
+                    if (_selection.containsRange(range.location, NSMaxRange(range))) {
+                        _selection.deselectRange(range.location, NSMaxRange(range));
                     } else {
-                        [_selectedIndices addIndexesInRange:range];
+                        _selection.selectRange(range.location, NSMaxRange(range));
                     }
                 } else if (hasShift && _selectionAnchor >= 0) {
                     // Shift+click: extend selection to include entire group
@@ -2024,12 +2168,10 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
                     NSInteger groupEnd = range.location + range.length - 1;
                     NSInteger start = MIN(_selectionAnchor, groupStart);
                     NSInteger end = MAX(_selectionAnchor, groupEnd);
-                    [_selectedIndices removeAllIndexes];
-                    [_selectedIndices addIndexesInRange:NSMakeRange(start, end - start + 1)];
+                    _selection.setRange(start, end + 1);
                 } else {
                     // Regular click: select all items in group
-                    [_selectedIndices removeAllIndexes];
-                    [_selectedIndices addIndexesInRange:range];
+                    _selection.setRange(range.location, NSMaxRange(range));
                     _selectionAnchor = range.location;
                 }
                 _focusIndex = range.location;
@@ -2056,9 +2198,9 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
         _pendingClickRow = -1;
     } else {
         // Regular click: check if item is already selected
-        BOOL alreadySelected = (playlistIndex >= 0 && [_selectedIndices containsIndex:playlistIndex]);
+        BOOL alreadySelected = (playlistIndex >= 0 && _selection.contains(playlistIndex));
 
-        if (alreadySelected && _selectedIndices.count > 1) {
+        if (alreadySelected && _selection.count() > 1) {
             // Clicked on already-selected item in multi-selection
             // Defer selection change until mouseUp (allows multi-item drag)
             _pendingClickRow = row;
@@ -2084,18 +2226,24 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     _isDragging = YES;
     _pendingClickRow = -1;  // Cancel pending selection change since drag started
 
-    FB2K_console_formatter() << "[SimPlaylist] mouseDragged: starting drag, selection count=" << _selectedIndices.count;
+    FB2K_console_formatter() << "[SimPlaylist] mouseDragged: starting drag, selection count=" << _selection.count();
 
     // Only drag if there's a selection
-    if (_selectedIndices.count == 0) return;
+    if (_selection.empty()) return;
 
     // Create dragging item with selected row indices, source playlist, AND file paths
     // File paths ensure drag works correctly even if active playlist changes mid-drag
     NSMutableDictionary *dragData = [NSMutableDictionary dictionary];
     dragData[@"sourcePlaylist"] = @(_sourcePlaylistIndex);
 
-    NSMutableArray<NSNumber *> *rowNumbers = [NSMutableArray array];
-    [_selectedIndices enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+    // Filter view: items are a subset of the playlist - carry the real indices
+    NSIndexSet *dragIndices = self.selectedIndices;
+    if ([_delegate respondsToSelector:@selector(playlistView:playlistIndicesForItemIndices:)]) {
+        dragIndices = [_delegate playlistView:self playlistIndicesForItemIndices:dragIndices];
+    }
+
+    NSMutableArray<NSNumber *> *rowNumbers = [NSMutableArray arrayWithCapacity:dragIndices.count];
+    [dragIndices enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
         [rowNumbers addObject:@(idx)];
     }];
     dragData[@"indices"] = rowNumbers;
@@ -2105,7 +2253,7 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     FB2K_console_formatter() << "[SimPlaylist] delegate responds to filePathsForPlaylistIndices: " << (hasPathsMethod ? "YES" : "NO");
 
     if (hasPathsMethod) {
-        NSArray<NSString *> *paths = [_delegate playlistView:self filePathsForPlaylistIndices:_selectedIndices];
+        NSArray<NSString *> *paths = [_delegate playlistView:self filePathsForPlaylistIndices:dragIndices];
         FB2K_console_formatter() << "[SimPlaylist] DRAG START: sourcePlaylist=" << _sourcePlaylistIndex
                                  << ", indices=" << rowNumbers.count
                                  << ", paths=" << (paths ? paths.count : 0);
@@ -2125,26 +2273,21 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     NSDraggingItem *dragItem = [[NSDraggingItem alloc] initWithPasteboardWriter:pbItem];
 
     // Use selection bounds as frame
-    // Note: _selectedIndices contains playlist indices, need to convert to row indices
-    __block NSRect selectionBounds = NSZeroRect;
-    [_selectedIndices enumerateIndexesUsingBlock:^(NSUInteger playlistIdx, BOOL *stop) {
-        NSInteger rowIdx = [self rowForPlaylistIndex:playlistIdx];
-        if (rowIdx >= 0) {
-            NSRect rowRect = [self rectForRow:rowIdx];
-            if (NSIsEmptyRect(selectionBounds)) {
-                selectionBounds = rowRect;
-            } else {
-                selectionBounds = NSUnionRect(selectionBounds, rowRect);
-            }
-        }
-    }];
+    // Note: the selection holds playlist indices; rows grow with them, so the
+    // first and last selected items bound the rest
+    NSRect selectionBounds = NSZeroRect;
+    NSInteger firstSelectedRow = [self rowForPlaylistIndex:_selection.first()];
+    NSInteger lastSelectedRow = [self rowForPlaylistIndex:_selection.last()];
+    if (firstSelectedRow >= 0 && lastSelectedRow >= 0) {
+        selectionBounds = NSUnionRect([self rectForRow:firstSelectedRow], [self rectForRow:lastSelectedRow]);
+    }
 
     // Create a simple drag image
     NSImage *dragImage = [NSImage imageWithSize:NSMakeSize(200, 30) flipped:YES drawingHandler:^BOOL(NSRect dstRect) {
         [[NSColor colorWithWhite:0.3 alpha:0.7] setFill];
         [[NSBezierPath bezierPathWithRoundedRect:dstRect xRadius:5 yRadius:5] fill];
 
-        NSString *dragText = [NSString stringWithFormat:@"%lu items", (unsigned long)self->_selectedIndices.count];
+        NSString *dragText = [NSString stringWithFormat:@"%lld items", (long long)self->_selection.count()];
         NSDictionary *attrs = @{
             NSFontAttributeName: [NSFont systemFontOfSize:12],
             NSForegroundColorAttributeName: [NSColor whiteColor]
@@ -2191,16 +2334,16 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
     NSInteger row = [self rowAtPoint:location];
 
     // If clicked row not selected, select it
-    // Note: _selectedIndices contains playlist indices, not row indices
+    // Note: the selection holds playlist indices, not row indices
     if (row >= 0) {
         NSInteger playlistIndex = [self playlistIndexForRow:row];
-        if (playlistIndex >= 0 && ![_selectedIndices containsIndex:playlistIndex]) {
+        if (playlistIndex >= 0 && !_selection.contains(playlistIndex)) {
             [self selectRowAtIndex:row];
         }
     }
 
     if ([_delegate respondsToSelector:@selector(playlistView:requestContextMenuForRows:atPoint:)]) {
-        [_delegate playlistView:self requestContextMenuForRows:[_selectedIndices copy] atPoint:location];
+        [_delegate playlistView:self requestContextMenuForRows:self.selectedIndices atPoint:location];
     }
 }
 
@@ -2308,9 +2451,24 @@ NSPasteboardType const SimPlaylistPasteboardType = @"com.foobar2000.simplaylist.
             }
             break;
 
+        case 0x1B:  // Escape - stop a running import
+            if (![_delegate respondsToSelector:@selector(playlistViewDidRequestCancel:)] ||
+                ![_delegate playlistViewDidRequestCancel:self]) {
+                [super keyDown:event];
+            }
+            break;
+
         default:
             if (hasCmd && (key == 'a' || key == 'A')) {
                 [self selectAll];
+            } else if (hasCmd && (key == 'f' || key == 'F') &&
+                       [_delegate respondsToSelector:@selector(playlistView:didRequestFindWithText:)]) {
+                [_delegate playlistView:self didRequestFindWithText:nil];
+            } else if (!hasCmd && !(modifiers & NSEventModifierFlagControl) &&
+                       key > ' ' && key != NSDeleteCharacter && (key < 0xF700 || key > 0xF8FF) &&
+                       [_delegate respondsToSelector:@selector(playlistView:didRequestFindWithText:)]) {
+                // Type-to-find: the first typed characters open the search field
+                [_delegate playlistView:self didRequestFindWithText:event.characters];
             } else {
                 [super keyDown:event];
             }
@@ -0,0 +1,240 @@
+//
+//  FormattedStringCache.h
+//  Shared formatted-metadata cache for foobar2000 macOS components
+//
+//  One process-wide cache of titleformat output keyed by (track, pattern
+//  hash), so panels showing the same tracks with the same pattern format
+//  them once. Used by:
+//  - foo_jl_queue_manager (queue rows and the queue item text)
+//
+//  Every component that includes this header registers an implementation of
+//  the formatted_string_cache service; all of them use the first one
+//  enumerated, so there is a single cache whichever components are loaded.
+//  Entries are dropped when metadb reports the track changed (tag edits,
+//  playback statistics) and evicted least-recently-used past kMaxTracks
+//  tracks or kMaxBytes of text.
+//
+//  Only output that depends on the track alone belongs here - never output
+//  of playlist_item_format_title / playback_format_title (list index,
+//  playback time, stream titles).
+//
+//  Change the service GUID whenever the interface changes, so components
+//  built against different versions do not share an instance.
+//
+
+#pragma once
+
+#include <foobar2000/SDK/foobar2000.h>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace jl_format {
+
+struct cache_stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t invalidations = 0;  // Tracks dropped on metadb change
+    uint64_t tracks = 0;         // Currently cached
+    uint64_t bytes = 0;
+};
+
+class NOVTABLE formatted_string_cache : public service_base {
+    FB2K_MAKE_SERVICE_INTERFACE_ENTRYPOINT(formatted_string_cache);
+public:
+    // Cached output of script for handle; formats and stores it on a miss.
+    // patternKey identifies the script (patternKey() of its source text).
+    // Thread-safe.
+    virtual void format(const metadb_handle_ptr& handle, uint64_t patternKey,
+                        const titleformat_object::ptr& script, pfc::string_base& out) = 0;
+    virtual void invalidate(metadb_handle_list_cref handles) = 0;
+    virtual void invalidate_all() = 0;
+    virtual void get_stats(cache_stats& out) = 0;
+};
+
+inline const GUID formatted_string_cache::class_guid =
+    { 0x61539601, 0xfc7c, 0x43f0, { 0xa0, 0x96, 0xd0, 0xc8, 0x70, 0xb1, 0x75, 0x75 } };
+
+// FNV-1a of the pattern text
+inline uint64_t patternKey(const char* pattern) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char* p = pattern; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 1099511628211ull;
+    }
+    return hash;
+}
+
+class formatted_string_cache_impl : public formatted_string_cache {
+public:
+    static const size_t kMaxTracks = 4096;
+    static const size_t kMaxBytes = 4 * 1024 * 1024;
+
+    void format(const metadb_handle_ptr& handle, uint64_t key,
+                const titleformat_object::ptr& script, pfc::string_base& out) override {
+        out.reset();
+        if (!handle.is_valid() || script.is_empty()) return;
+
+        uint64_t epoch;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_tracks.find(handle.get_ptr());
+            if (it != m_tracks.end()) {
+                for (const auto& value : it->second.values) {
+                    if (value.first == key) {
+                        m_recency.splice(m_recency.begin(), m_recency, it->second.recency);
+                        m_stats.hits++;
+                        out.set_string(value.second.data(), value.second.size());
+                        return;
+                    }
+                }
+            }
+            m_stats.misses++;
+            epoch = m_epoch;
+        }
+
+        // Format outside the lock - format_title may take a while
+        handle->format_title(nullptr, out, script, nullptr);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Invalidated meanwhile: the output may predate the change, don't keep it
+        if (m_epoch != epoch) return;
+        auto it = m_tracks.find(handle.get_ptr());
+        if (it == m_tracks.end()) {
+            m_recency.push_front(handle.get_ptr());
+            it = m_tracks.emplace(handle.get_ptr(), Track{handle, {}, m_recency.begin()}).first;
+        } else {
+            m_recency.splice(m_recency.begin(), m_recency, it->second.recency);
+            for (const auto& value : it->second.values) {
+                if (value.first == key) return;  // Stored by another thread meanwhile
+            }
+        }
+        it->second.values.emplace_back(key, std::string(out.get_ptr(), out.get_length()));
+        m_stats.bytes += out.get_length();
+        evictIfNeeded();
+    }
+
+    void invalidate(metadb_handle_list_cref handles) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_epoch++;  // Also covers tracks being formatted but not stored yet
+        if (m_tracks.empty()) return;
+        for (size_t i = 0; i < handles.get_count(); i++) {
+            auto it = m_tracks.find(handles[i].get_ptr());
+            if (it == m_tracks.end()) continue;
+            erase(it);
+            m_stats.invalidations++;
+        }
+    }
+
+    void invalidate_all() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_epoch++;
+        m_stats.invalidations += m_tracks.size();
+        m_tracks.clear();
+        m_recency.clear();
+        m_stats.bytes = 0;
+    }
+
+    void get_stats(cache_stats& out) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        out = m_stats;
+        out.tracks = m_tracks.size();
+    }
+
+private:
+    struct Track {
+        metadb_handle_ptr handle;  // Keeps the key pointer from being reused
+        std::vector<std::pair<uint64_t, std::string>> values;
+        std::list<const metadb_handle*>::iterator recency;
+    };
+    using TrackMap = std::unordered_map<const metadb_handle*, Track>;
+
+    void erase(TrackMap::iterator it) {
+        for (const auto& value : it->second.values) m_stats.bytes -= value.second.size();
+        m_recency.erase(it->second.recency);
+        m_tracks.erase(it);
+    }
+
+    void evictIfNeeded() {
+        while (m_recency.size() > 1 && (m_tracks.size() > kMaxTracks || m_stats.bytes > kMaxBytes)) {
+            erase(m_tracks.find(m_recency.back()));
+            m_stats.evictions++;
+        }
+    }
+
+    std::mutex m_mutex;
+    TrackMap m_tracks;
+    std::list<const metadb_handle*> m_recency;  // Most recently used first
+    cache_stats m_stats;
+    uint64_t m_epoch = 0;  // Bumped by every invalidation
+};
+
+// This component's instance - only used if it is the one enumerated first
+inline service_factory_single_t<formatted_string_cache_impl> g_formatCacheFactory;
+
+// The process-wide cache (null only if service enumeration fails)
+inline formatted_string_cache* cache() {
+    static service_ptr_t<formatted_string_cache> s_cache = [] {
+        service_ptr_t<formatted_string_cache> first;
+        service_enum_t<formatted_string_cache> e;
+        e.first(first);
+        return first;
+    }();
+    return s_cache.get_ptr();
+}
+
+// Format with a pattern string: compiled once per component, output shared
+inline void formatWithPattern(const metadb_handle_ptr& handle, const char* pattern, pfc::string_base& out) {
+    static std::mutex s_scriptMutex;
+    static std::unordered_map<std::string, titleformat_object::ptr> s_scripts;
+
+    titleformat_object::ptr script;
+    {
+        std::lock_guard<std::mutex> lock(s_scriptMutex);
+        titleformat_object::ptr& slot = s_scripts[pattern];
+        if (slot.is_empty()) titleformat_compiler::get()->compile_safe(slot, pattern);
+        script = slot;
+    }
+
+    if (formatted_string_cache* shared = cache()) {
+        shared->format(handle, patternKey(pattern), script, out);
+    } else if (handle.is_valid()) {
+        handle->format_title(nullptr, out, script, nullptr);
+    } else {
+        out.reset();
+    }
+}
+
+// Tag / statistics changes reach every component's callback; each clears its
+// own instance (a no-op for the instances nobody uses)
+class formatted_string_cache_invalidator : public metadb_io_callback {
+public:
+    void on_changed_sorted(metadb_handle_list_cref items, bool /*fromHook*/) override {
+        g_formatCacheFactory.get_static_instance().invalidate(items);
+    }
+};
+
+inline service_factory_single_t<formatted_string_cache_invalidator> g_formatCacheInvalidatorFactory;
+
+// Hit-rate summary on quit, from the instance that was used
+class formatted_string_cache_stats : public initquit {
+public:
+    void on_init() override {}
+    void on_quit() override {
+        cache_stats stats;
+        g_formatCacheFactory.get_static_instance().get_stats(stats);
+        uint64_t lookups = stats.hits + stats.misses;
+        if (lookups == 0) return;
+        FB2K_console_formatter() << "[FormatCache] " << stats.hits << " hits / " << lookups << " lookups ("
+                                 << (unsigned)(stats.hits * 100 / lookups) << "%), "
+                                 << stats.evictions << " evictions, " << stats.invalidations << " invalidations";
+    }
+};
+
+inline service_factory_single_t<formatted_string_cache_stats> g_formatCacheStatsFactory;
+
+} // namespace jl_format
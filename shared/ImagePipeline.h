@@ -0,0 +1,139 @@
+//
+//  ImagePipeline.h
+//  Shared image decoding for foobar2000 macOS components
+//
+//  Decodes artwork straight to the size it is displayed at (ImageIO thumbnail
+//  decode - JPEG is subsampled while decoding) instead of decoding full
+//  resolution and redrawing. Used by:
+//  - foo_jl_simplaylist_mac (group album art)
+//  - foo_jl_album_art_mac (artwork panel)
+//  - foo_jl_cloud_streamer_mac (downloaded thumbnails)
+//
+
+#pragma once
+
+#import <Cocoa/Cocoa.h>
+#import <ImageIO/ImageIO.h>
+
+namespace jl_image {
+
+// Decode work is bounded to one operation per active core
+inline NSInteger decodeConcurrency() {
+    return MAX((NSInteger)1, (NSInteger)[NSProcessInfo processInfo].activeProcessorCount);
+}
+
+// Shared bounded queue for decode work (per component)
+inline NSOperationQueue* decodeQueue() {
+    static NSOperationQueue* queue = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = [[NSOperationQueue alloc] init];
+        queue.name = @"jl.image.decode";
+        queue.maxConcurrentOperationCount = decodeConcurrency();
+        queue.qualityOfService = NSQualityOfServiceUserInitiated;
+    });
+    return queue;
+}
+
+// Pixels needed to draw pointSize sharply on the highest-density attached screen
+inline NSInteger pixelSizeForPoints(CGFloat pointSize) {
+    CGFloat scale = 1.0;
+    for (NSScreen* screen in [NSScreen screens]) {
+        scale = MAX(scale, screen.backingScaleFactor);
+    }
+    return (NSInteger)ceil(pointSize * scale);
+}
+
+// Longest side of the source image in pixels (0 if unknown), read from the header only
+inline NSInteger sourcePixelSize(CGImageSourceRef source) {
+    if (!source) return 0;
+    CFDictionaryRef properties = CGImageSourceCopyPropertiesAtIndex(source, 0, NULL);
+    if (!properties) return 0;
+    NSDictionary* props = (__bridge NSDictionary*)properties;
+    NSInteger size = MAX([props[(__bridge NSString*)kCGImagePropertyPixelWidth] integerValue],
+                         [props[(__bridge NSString*)kCGImagePropertyPixelHeight] integerValue]);
+    CFRelease(properties);
+    return size;
+}
+
+// Decode at most maxPixelSize on the longest side (0 = full size), EXIF orientation
+// applied and pixels decoded now rather than on first draw. Returns +1 image or NULL.
+inline CGImageRef createDecodedImage(CGImageSourceRef source, NSInteger maxPixelSize) {
+    if (!source || CGImageSourceGetCount(source) == 0) return NULL;
+
+    NSMutableDictionary* options = [@{
+        (__bridge id)kCGImageSourceCreateThumbnailFromImageAlways: @YES,
+        (__bridge id)kCGImageSourceCreateThumbnailWithTransform: @YES,
+        (__bridge id)kCGImageSourceShouldCacheImmediately: @YES
+    } mutableCopy];
+    if (maxPixelSize > 0) {
+        options[(__bridge id)kCGImageSourceThumbnailMaxPixelSize] = @(maxPixelSize);
+    } else {
+        NSInteger fullSize = sourcePixelSize(source);
+        if (fullSize > 0) options[(__bridge id)kCGImageSourceThumbnailMaxPixelSize] = @(fullSize);
+    }
+    return CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)options);
+}
+
+inline NSImage* imageFromCGImage(CGImageRef cgImage) {
+    if (!cgImage) return nil;
+    return [[NSImage alloc] initWithCGImage:cgImage size:NSZeroSize];  // Size in pixels
+}
+
+inline NSImage* decodeImage(NSData* data, NSInteger maxPixelSize) {
+    if (data.length == 0) return nil;
+    CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)data, NULL);
+    if (!source) return nil;
+    CGImageRef cgImage = createDecodedImage(source, maxPixelSize);
+    CFRelease(source);
+    NSImage* image = imageFromCGImage(cgImage);
+    if (cgImage) CGImageRelease(cgImage);
+    return image;
+}
+
+inline NSImage* decodeImageAtURL(NSURL* url, NSInteger maxPixelSize) {
+    if (!url) return nil;
+    CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)url, NULL);
+    if (!source) return nil;
+    CGImageRef cgImage = createDecodedImage(source, maxPixelSize);
+    CFRelease(source);
+    NSImage* image = imageFromCGImage(cgImage);
+    if (cgImage) CGImageRelease(cgImage);
+    return image;
+}
+
+inline NSData* encodeJPEG(CGImageRef image, CGFloat quality) {
+    if (!image) return nil;
+    NSMutableData* data = [NSMutableData data];
+    CGImageDestinationRef destination = CGImageDestinationCreateWithData(
+        (__bridge CFMutableDataRef)data, CFSTR("public.jpeg"), 1, NULL);
+    if (!destination) return nil;
+
+    NSDictionary* properties = @{(__bridge id)kCGImageDestinationLossyCompressionQuality: @(quality)};
+    CGImageDestinationAddImage(destination, image, (__bridge CFDictionaryRef)properties);
+    bool finalized = CGImageDestinationFinalize(destination);
+    CFRelease(destination);
+    return finalized ? data : nil;
+}
+
+// Re-encode image data larger than maxPixelSize as a JPEG of that size.
+// Returns the original data when it is already small enough or can't be decoded.
+inline NSData* downsampledImageData(NSData* data, NSInteger maxPixelSize, CGFloat quality) {
+    if (data.length == 0 || maxPixelSize <= 0) return data;
+    CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)data, NULL);
+    if (!source) return data;
+
+    NSData* result = data;
+    if (sourcePixelSize(source) > maxPixelSize) {
+        CGImageRef cgImage = createDecodedImage(source, maxPixelSize);
+        if (cgImage) {
+            NSData* encoded = encodeJPEG(cgImage, quality);
+            if (encoded.length > 0) result = encoded;
+            CGImageRelease(cgImage);
+        }
+    }
+    CFRelease(source);
+    return result;
+}
+
+} // namespace jl_image
@@ -0,0 +1,386 @@
+//
+//  QueueModelTests.cpp
+//  fb2k-components tests
+//
+//  QueueModel row diffs (applying them reproduces the new queue, single edits
+//  stay minimal, large changes fall back to a wholesale replace) and its
+//  totals and start offsets, kept current through diffs and through
+//  re-measuring rows whose tracks changed, rows played off the head and
+//  source playlist edits. Batch queue operations against the
+//  fake SDK queue: the model follows them, with one refresh per transaction.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_queue_manager_mac/src/Core/QueueModel.h"
+#include "../../extensions/foo_jl_queue_manager_mac/src/Core/QueueOperations.h"
+#include <random>
+
+using namespace queue_ops;
+using fb2k_test::makeTrack;
+
+namespace {
+
+using Items = std::vector<t_playback_queue_item>;
+
+t_playback_queue_item orphan(const metadb_handle_ptr& track) {
+    return {track, ~(t_size)0, ~(t_size)0};
+}
+
+// Distinct queue entries (same track from different playlist rows differs)
+Items distinctItems(const std::string& prefix, size_t count) {
+    Items items;
+    for (size_t i = 0; i < count; i++) items.push_back({makeTrack({}, prefix + std::to_string(i)), 0, i});
+    return items;
+}
+
+// What the table does with a diff: removals on old rows, then insertions at new rows
+Items applyDiff(Items items, const QueueDiff& diff, const Items& newItems) {
+    for (auto it = diff.removed.rbegin(); it != diff.removed.rend(); ++it) {
+        items.erase(items.begin() + (std::ptrdiff_t)*it);
+    }
+    for (size_t index : diff.inserted) items.insert(items.begin() + (std::ptrdiff_t)index, newItems[index]);
+    return items;
+}
+
+bool sameItems(const Items& a, const Items& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!sameQueueItem(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+bool ascending(const std::vector<size_t>& indices) {
+    return std::is_sorted(indices.begin(), indices.end()) &&
+           std::adjacent_find(indices.begin(), indices.end()) == indices.end();
+}
+
+} // namespace
+
+TEST(QueueModel_DiffReproducesNewContents) {
+    std::mt19937 rng(48);
+    // Few tracks, queued repeatedly - identity collisions are the hard case
+    std::vector<metadb_handle_ptr> tracks;
+    for (int i = 0; i < 6; i++) tracks.push_back(makeTrack({}, "/" + std::to_string(i)));
+    auto randomItem = [&] {
+        const metadb_handle_ptr& track = tracks[rng() % tracks.size()];
+        return rng() % 3 == 0 ? orphan(track) : t_playback_queue_item{track, 0, rng() % 4};
+    };
+
+    for (int round = 0; round < 500; round++) {
+        Items oldItems;
+        for (size_t i = rng() % 40; i > 0; i--) oldItems.push_back(randomItem());
+
+        Items newItems = oldItems;
+        for (int edit = (int)(rng() % 6); edit > 0; edit--) {
+            size_t at = newItems.empty() ? 0 : rng() % (newItems.size() + 1);
+            switch (rng() % 3) {
+                case 0:
+                    newItems.insert(newItems.begin() + (std::ptrdiff_t)at, randomItem());
+                    break;
+                case 1:
+                    if (at < newItems.size()) newItems.erase(newItems.begin() + (std::ptrdiff_t)at);
+                    break;
+                case 2:
+                    if (at < newItems.size()) {
+                        t_playback_queue_item moved = newItems[at];
+                        newItems.erase(newItems.begin() + (std::ptrdiff_t)at);
+                        newItems.insert(newItems.begin() + (std::ptrdiff_t)(rng() % (newItems.size() + 1)), moved);
+                    }
+                    break;
+            }
+        }
+
+        QueueDiff diff = diffQueueContents(oldItems, newItems, QueueModel::kMaxDiffEdits);
+        CHECK(ascending(diff.removed));
+        CHECK(ascending(diff.inserted));
+        CHECK(sameItems(applyDiff(oldItems, diff, newItems), newItems));
+        CHECK(diff.removed.size() + diff.inserted.size() <= 10);  // At most two edits per step
+    }
+}
+
+TEST(QueueModel_SingleEditDiffIsMinimal) {
+    Items items = distinctItems("/q", 20);
+
+    Items inserted = items;
+    inserted.insert(inserted.begin() + 7, orphan(makeTrack({}, "/new")));
+    QueueDiff diff = diffQueueContents(items, inserted, QueueModel::kMaxDiffEdits);
+    CHECK(diff.removed.empty());
+    CHECK(diff.inserted == std::vector<size_t>{7});
+
+    Items removed = items;
+    removed.erase(removed.begin() + 12);
+    diff = diffQueueContents(items, removed, QueueModel::kMaxDiffEdits);
+    CHECK(diff.removed == std::vector<size_t>{12});
+    CHECK(diff.inserted.empty());
+
+    // Row 3 moved to 15: one removal, one insertion - not the 12 rows between
+    Items moved = items;
+    t_playback_queue_item row = moved[3];
+    moved.erase(moved.begin() + 3);
+    moved.insert(moved.begin() + 15, row);
+    diff = diffQueueContents(items, moved, QueueModel::kMaxDiffEdits);
+    CHECK(diff.removed == std::vector<size_t>{3});
+    CHECK(diff.inserted == std::vector<size_t>{15});
+    CHECK(sameItems(applyDiff(items, diff, moved), moved));
+
+    CHECK(diffQueueContents(items, items, QueueModel::kMaxDiffEdits).empty());
+}
+
+TEST(QueueModel_LargeChangeReplacesMiddleWholesale) {
+    // Kept entries between every replaced one: an exact diff would keep them,
+    // but its 1200 edits are past the limit
+    Items common = distinctItems("/c", 601);
+    Items oldOnly = distinctItems("/old", 600);
+    Items newOnly = distinctItems("/new", 600);
+    Items oldItems, newItems;
+    for (size_t i = 0; i < 600; i++) {
+        oldItems.push_back(common[i]);
+        oldItems.push_back(oldOnly[i]);
+        newItems.push_back(common[i]);
+        newItems.push_back(newOnly[i]);
+    }
+    oldItems.push_back(common[600]);
+    newItems.push_back(common[600]);
+
+    QueueDiff diff = diffQueueContents(oldItems, newItems, QueueModel::kMaxDiffEdits);
+    // Head (common[0]) and tail (common[600]) are still skipped; all between is replaced
+    CHECK_EQ(diff.removed.size(), oldItems.size() - 2);
+    CHECK_EQ(diff.inserted.size(), newItems.size() - 2);
+    CHECK_EQ(diff.removed.front(), (size_t)1);
+    CHECK_EQ(diff.inserted.back(), newItems.size() - 2);
+    CHECK(sameItems(applyDiff(oldItems, diff, newItems), newItems));
+
+    // Within the limit the same shape diffs exactly
+    diff = diffQueueContents(oldItems, newItems, 2000);
+    CHECK_EQ(diff.removed.size(), (size_t)600);
+    CHECK_EQ(diff.inserted.size(), (size_t)600);
+}
+
+TEST(QueueModel_DiffKeepsTotalsAndOffsets) {
+    auto a = makeTrack({}, "/a", 100);
+    auto b = makeTrack({}, "/b", 0);  // Unknown length
+    auto c = makeTrack({}, "/c", 30);
+
+    QueueModel model;
+    QueueDiff diff = model.update({orphan(a), orphan(b), orphan(c)});
+    CHECK_EQ(diff.inserted.size(), (size_t)3);
+    CHECK_EQ(model.totals().length, 130.0);
+    CHECK_EQ(model.totals().unknownLength, (size_t)1);
+    CHECK_EQ(model.totals().orphans, (size_t)3);
+    CHECK_EQ(model.startOffset(2), 100.0);
+
+    diff = model.update({orphan(c), orphan(a)});
+    CHECK_EQ(model.totals().length, 130.0);
+    CHECK_EQ(model.totals().unknownLength, (size_t)0);
+    CHECK_EQ(model.startOffset(1), 30.0);
+    CHECK_EQ(model.startOffset(2), 130.0);
+}
+
+TEST(QueueModel_RemeasureChangedTracks) {
+    auto a = makeTrack({}, "/a", 100);
+    auto b = makeTrack({}, "/b", 0);
+    auto c = makeTrack({}, "/c", 30);
+
+    QueueModel model;
+    model.update({orphan(a), orphan(b), orphan(c), orphan(b)});
+    CHECK_EQ(model.totals().unknownLength, (size_t)2);
+
+    // b's length became known (e.g. after a rescan); both of its rows change
+    b->length = 20;
+    model.remeasure({1, 3});
+    CHECK_EQ(model.totals().unknownLength, (size_t)0);
+    CHECK_EQ(model.totals().length, 170.0);
+    CHECK_EQ(model.startOffset(1), 100.0);
+    CHECK_EQ(model.startOffset(2), 120.0);
+    CHECK_EQ(model.startOffset(3), 150.0);
+
+    model.remeasure({7});  // Out of range is ignored
+    CHECK_EQ(model.totals().length, 170.0);
+}
+
+TEST(QueueModel_HeadRemovalsKeepOffsets) {
+    std::vector<t_playback_queue_item> items;
+    for (int i = 0; i < 50; i++) items.push_back(orphan(makeTrack({}, "/h" + std::to_string(i), i % 7 ? 10.0 * i : 0)));
+
+    QueueModel model;
+    model.update(items);
+    // Played off the front one or a few at a time, with one append on the way
+    bool appended = false;
+    while (!items.empty()) {
+        items.erase(items.begin(), items.begin() + (std::ptrdiff_t)std::min<size_t>(items.size() % 3 + 1, items.size()));
+        if (!appended && items.size() <= 20) {
+            items.push_back(orphan(makeTrack({}, "/late", 45)));
+            appended = true;
+        }
+        model.update(items);
+
+        double start = 0;
+        size_t unknown = 0;
+        for (size_t i = 0; i < items.size(); i++) {
+            CHECK_EQ(model.startOffset(i), start);
+            start += items[i].m_handle->length;
+            if (items[i].m_handle->length <= 0) unknown++;
+        }
+        CHECK_EQ(model.totals().length, start);
+        CHECK_EQ(model.totals().unknownLength, unknown);
+    }
+    CHECK_EQ(model.startOffset(0), 0.0);
+
+    model.update({orphan(makeTrack({}, "/again", 30))});
+    CHECK_EQ(model.startOffset(1), 30.0);
+}
+
+TEST(QueueModel_RevalidateAfterPlaylistEdits) {
+    playlist_manager& pm = playlist_manager::instance();
+    pm.reset();
+    pm.playlists.assign(1, {});
+    for (int i = 0; i < 4; i++) pm.playlists[0].push_back(makeTrack({}, "/v" + std::to_string(i), 10));
+
+    QueueModel model;
+    model.update({{pm.playlists[0][1], 0, 1}, {pm.playlists[0][3], 0, 3}, orphan(pm.playlists[0][0])});
+    CHECK_EQ(model.totals().invalid, (size_t)0);
+    CHECK(!model.revalidate());
+
+    // Item 1 removed from the playlist: the queued entries now point past the end / elsewhere
+    pm.playlists[0].erase(pm.playlists[0].begin() + 1);
+    CHECK(model.revalidate());
+    CHECK_EQ(model.totals().invalid, (size_t)2);
+    CHECK_EQ(model.totals().orphans, (size_t)1);
+
+    pm.playlists[0].insert(pm.playlists[0].begin() + 1, model.contents()[0].m_handle);
+    CHECK(model.revalidate());
+    CHECK_EQ(model.totals().invalid, (size_t)0);
+    pm.reset();
+}
+
+namespace {
+
+QueueModel g_model;
+size_t g_refreshes = 0;
+
+// QueueCallbackManager: callbacks inside a transaction wait for its end
+void refresh() {
+    g_model.update(getContentsVector());
+    g_refreshes++;
+}
+
+// One playlist of tracks 10, 20, ... seconds long, an empty queue
+playlist_manager& resetQueue(size_t trackCount) {
+    playlist_manager& pm = playlist_manager::instance();
+    pm.reset();
+    pm.playlists.assign(1, {});
+    for (size_t i = 0; i < trackCount; i++) {
+        pm.playlists[0].push_back(makeTrack({}, "/p/" + std::to_string(i), 10.0 * (double)(i + 1)));
+    }
+    g_model = QueueModel();
+    g_refreshes = 0;
+    QueueTransaction::setCommitHandler(refresh);
+    pm.onQueueChanged = [] {
+        if (QueueTransaction::active()) {
+            QueueTransaction::noteChange();
+        } else {
+            refresh();
+        }
+    };
+    return pm;
+}
+
+// Model shows the SDK queue; totals and every start offset summed from scratch
+void checkModelMatchesQueue() {
+    const std::vector<t_playback_queue_item>& queue = playlist_manager::instance().queue;
+    CHECK(sameItems(g_model.contents(), queue));
+    double start = 0;
+    size_t orphans = 0;
+    for (size_t i = 0; i < queue.size(); i++) {
+        CHECK_EQ(g_model.startOffset(i), start);
+        start += queue[i].m_handle->length;
+        if (isOrphanItem(queue[i])) orphans++;
+    }
+    CHECK_EQ(g_model.startOffset(queue.size()), start);
+    CHECK_EQ(g_model.totals().length, start);
+    CHECK_EQ(g_model.totals().orphans, orphans);
+}
+
+std::vector<size_t> playlistItems(const std::vector<t_playback_queue_item>& queue) {
+    std::vector<size_t> items;
+    for (const auto& item : queue) items.push_back(item.m_item);
+    return items;
+}
+
+} // namespace
+
+TEST(QueueOperations_MoveItemsRefreshesOnce) {
+    playlist_manager& pm = resetQueue(10);
+    addItemsFromPlaylist(0, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    CHECK_EQ(g_refreshes, (size_t)1);
+    checkModelMatchesQueue();
+
+    moveItems({1, 4, 5}, 8);
+    CHECK(playlistItems(pm.queue) == std::vector<size_t>({0, 2, 3, 6, 7, 1, 4, 5, 8, 9}));
+    CHECK_EQ(g_refreshes, (size_t)2);
+    checkModelMatchesQueue();
+
+    moveItems({7, 8}, 0);  // To the front
+    CHECK(playlistItems(pm.queue) == std::vector<size_t>({5, 8, 0, 2, 3, 6, 7, 1, 4, 9}));
+    checkModelMatchesQueue();
+
+    moveItems({3, 4}, 5);  // Dropped onto itself: no rebuild, no refresh
+    moveItems({}, 2);
+    CHECK_EQ(g_refreshes, (size_t)3);
+}
+
+TEST(QueueOperations_ReplaceAllRefreshesOnce) {
+    playlist_manager& pm = resetQueue(6);
+    addItemsFromPlaylist(0, {0, 1, 2});
+    auto stream = makeTrack({}, "/stream", 0);
+    std::vector<t_playback_queue_item> items = {
+        orphan(pm.playlists[0][5]), {pm.playlists[0][2], 0, 2}, orphan(stream), {pm.playlists[0][4], 0, 4}};
+
+    replaceAll(items);
+    CHECK_EQ(g_refreshes, (size_t)2);  // The flush and four adds: one refresh
+    CHECK(sameItems(pm.queue, items));
+    checkModelMatchesQueue();
+    CHECK_EQ(g_model.totals().orphans, (size_t)2);
+    CHECK_EQ(g_model.totals().unknownLength, (size_t)1);
+
+    replaceAll({});
+    CHECK(pm.queue.empty());
+    CHECK_EQ(g_refreshes, (size_t)3);
+    checkModelMatchesQueue();
+}
+
+TEST(QueueOperations_MaskRemoveRefreshesOnce) {
+    playlist_manager& pm = resetQueue(8);
+    addItemsFromPlaylist(0, {0, 1, 2, 3, 4, 5, 6, 7});
+
+    pfc::bit_array_bittable mask(8);
+    for (size_t i : {0, 3, 4, 7}) mask.set(i, true);
+    removeItems(mask);
+    CHECK(playlistItems(pm.queue) == std::vector<size_t>({1, 2, 5, 6}));
+    CHECK_EQ(g_refreshes, (size_t)2);
+    checkModelMatchesQueue();
+
+    removeItems(std::vector<size_t>{0, 1, 9});  // Out of range is ignored
+    CHECK(playlistItems(pm.queue) == std::vector<size_t>({5, 6}));
+    checkModelMatchesQueue();
+}
+
+TEST(QueueOperations_NestedTransactionsRefreshOnce) {
+    playlist_manager& pm = resetQueue(5);
+    {
+        QueueTransaction outer;
+        addItemsFromPlaylist(0, {0, 1, 2, 3, 4});  // Its own transaction nests
+        removeItem(0);
+        addOrphanItem(pm.playlists[0][0]);
+        CHECK_EQ(g_refreshes, (size_t)0);
+    }
+    CHECK_EQ(g_refreshes, (size_t)1);
+    CHECK_EQ(pm.queue.size(), (size_t)5);
+    checkModelMatchesQueue();
+
+    { QueueTransaction unchanged; }
+    CHECK_EQ(g_refreshes, (size_t)1);  // Nothing changed, nothing to refresh
+    QueueTransaction::setCommitHandler(nullptr);
+    pm.reset();
+}
@@ -0,0 +1,122 @@
+//
+//  QueueOperationsBenchmark.cpp
+//  fb2k-components tests
+//
+//  Queue 5,000 tracks from a playlist, then move and remove a selection of
+//  them. Batched: addItemsFromPlaylist / moveItems / mask removeItems inside a
+//  QueueTransaction, one refresh that diffs QueueModel and formats only new
+//  rows. Item by item: one SDK call per track, each callback reloading the
+//  whole queue and formatting every row (how the table was refreshed before).
+//
+//  Usage: queue_operations_benchmark [tracks]
+//
+
+#include "../../extensions/foo_jl_queue_manager_mac/src/Core/QueueModel.h"
+#include "../../extensions/foo_jl_queue_manager_mac/src/Core/QueueOperations.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace queue_ops;
+using Clock = std::chrono::steady_clock;
+using fb2k_test::makeTrack;
+
+namespace {
+
+const char* const kRowPattern = "[%artist% - ]%title%";
+
+struct Refreshes {
+    size_t count = 0;
+    size_t rowsFormatted = 0;
+};
+
+QueueModel g_model;
+Refreshes g_batched;
+Refreshes g_itemByItem;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// QueueManagerController::reloadQueueContents: diff, format inserted rows
+void refreshBatched() {
+    QueueDiff diff = g_model.update(getContentsVector());
+    for (size_t index : diff.inserted) formatItem(g_model.contents()[index], kRowPattern);
+    g_batched.count++;
+    g_batched.rowsFormatted += diff.inserted.size();
+}
+
+// Earlier reload: every row of the whole queue, on every callback
+void refreshItemByItem() {
+    std::vector<t_playback_queue_item> contents = getContentsVector();
+    for (const auto& item : contents) formatItem(item, kRowPattern);
+    g_itemByItem.count++;
+    g_itemByItem.rowsFormatted += contents.size();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t trackCount = argc > 1 ? (size_t)atoll(argv[1]) : 5000;
+
+    playlist_manager& pm = playlist_manager::instance();
+    pm.reset();
+    pm.playlists.assign(1, {});
+    for (size_t i = 0; i < trackCount; i++) {
+        pm.playlists[0].push_back(makeTrack({{"artist", "Artist " + std::to_string(i / 12)},
+                                             {"title", "Title " + std::to_string(i)}},
+                                            "/music/" + std::to_string(i) + ".flac", 180 + i % 120));
+    }
+    std::vector<size_t> items(trackCount);
+    for (size_t i = 0; i < trackCount; i++) items[i] = i;
+    std::vector<size_t> selection;  // Every 10th row
+    for (size_t i = 0; i < trackCount; i += 10) selection.push_back(i);
+
+    // Batched - QueueCallbackManager: callbacks inside a transaction wait for its end
+    QueueTransaction::setCommitHandler(refreshBatched);
+    pm.onQueueChanged = [] {
+        if (QueueTransaction::active()) {
+            QueueTransaction::noteChange();
+        } else {
+            refreshBatched();
+        }
+    };
+
+    auto start = Clock::now();
+    addItemsFromPlaylist(0, items);
+    double batchedAdd = millisecondsSince(start);
+
+    start = Clock::now();
+    moveItems(selection, 0);
+    double batchedMove = millisecondsSince(start);
+
+    start = Clock::now();
+    pfc::bit_array_bittable mask(pm.queue_get_count());
+    for (size_t i = 0; i < selection.size(); i++) mask.set(i, true);  // The moved block
+    removeItems(mask);
+    double batchedRemove = millisecondsSince(start);
+    size_t batchedLeft = pm.queue_get_count();
+
+    // Item by item
+    pm.queue.clear();
+    pm.onQueueChanged = refreshItemByItem;
+
+    start = Clock::now();
+    for (size_t item : items) pm.queue_add_item_playlist(0, item);
+    double naiveAdd = millisecondsSince(start);
+
+    start = Clock::now();
+    for (size_t i = 0; i < selection.size(); i++) removeItem(0);
+    double naiveRemove = millisecondsSince(start);
+    size_t naiveLeft = pm.queue_get_count();
+
+    printf("tracks %zu, selection %zu\n", trackCount, selection.size());
+    printf("                      batched      item by item\n");
+    printf("queue all       %10.1f ms %12.1f ms\n", batchedAdd, naiveAdd);
+    printf("move selection  %10.1f ms\n", batchedMove);
+    printf("remove moved    %10.1f ms %12.1f ms (first row, %zu times)\n", batchedRemove, naiveRemove,
+           selection.size());
+    printf("refreshes       %10zu    %12zu\n", g_batched.count, g_itemByItem.count);
+    printf("rows formatted  %10zu    %12zu\n", g_batched.rowsFormatted, g_itemByItem.rowsFormatted);
+    return batchedLeft == naiveLeft ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+//
+//  FormattedStringCacheTests.cpp
+//  fb2k-components tests
+//
+//  Shared formatted-metadata cache: hits per track and pattern, invalidation
+//  from metadb changes (also while a track is being formatted), and LRU
+//  eviction past the track limit.
+//
+
+#include "TestHarness.h"
+#include "../../shared/FormattedStringCache.h"
+
+using jl_format::formatted_string_cache_impl;
+using jl_format::patternKey;
+using fb2k_test::makeScript;
+using fb2k_test::makeTrack;
+
+namespace {
+
+std::string formatTitle(formatted_string_cache_impl& cache, const metadb_handle_ptr& track) {
+    pfc::string8 out;
+    cache.format(track, patternKey("%title%"), makeScript("title"), out);
+    return out.get_ptr();
+}
+
+metadb_handle_list listOf(const metadb_handle_ptr& track) {
+    metadb_handle_list list;
+    list.add_item(track);
+    return list;
+}
+
+} // namespace
+
+TEST(FormattedStringCache_HitsUntilTrackInvalidated) {
+    formatted_string_cache_impl cache;
+    metadb_handle_ptr track = makeTrack({{"title", "One"}});
+    metadb_handle_ptr other = makeTrack({{"title", "Other"}});
+
+    CHECK_EQ(formatTitle(cache, track), std::string("One"));
+    CHECK_EQ(formatTitle(cache, other), std::string("Other"));
+    track->fields["title"] = "Two";
+    CHECK_EQ(formatTitle(cache, track), std::string("One"));  // Not told yet
+
+    cache.invalidate(listOf(track));
+    CHECK_EQ(formatTitle(cache, track), std::string("Two"));
+    CHECK_EQ(formatTitle(cache, other), std::string("Other"));
+
+    jl_format::cache_stats stats;
+    cache.get_stats(stats);
+    CHECK_EQ(stats.misses, (uint64_t)3);
+    CHECK_EQ(stats.hits, (uint64_t)2);
+    CHECK_EQ(stats.invalidations, (uint64_t)1);
+    CHECK_EQ(stats.tracks, (uint64_t)2);
+}
+
+TEST(FormattedStringCache_InvalidateWhileFormattingIsNotStored) {
+    formatted_string_cache_impl cache;
+    metadb_handle_ptr track = makeTrack({{"title", "Old"}});
+
+    // The change notification lands between formatting and storing
+    track->onFormat = [&] { cache.invalidate(listOf(track)); };
+    CHECK_EQ(formatTitle(cache, track), std::string("Old"));
+    track->onFormat = nullptr;
+    track->fields["title"] = "New";
+
+    CHECK_EQ(formatTitle(cache, track), std::string("New"));
+    jl_format::cache_stats stats;
+    cache.get_stats(stats);
+    CHECK_EQ(stats.hits, (uint64_t)0);
+}
+
+TEST(FormattedStringCache_EvictsLeastRecentlyUsed) {
+    formatted_string_cache_impl cache;
+    std::vector<metadb_handle_ptr> tracks;
+    for (size_t i = 0; i <= formatted_string_cache_impl::kMaxTracks; i++) {
+        tracks.push_back(makeTrack({{"title", "t" + std::to_string(i)}}));
+        formatTitle(cache, tracks.back());
+        if (i == 0) continue;
+        formatTitle(cache, tracks[0]);  // Keep the first track recent
+    }
+
+    jl_format::cache_stats stats;
+    cache.get_stats(stats);
+    CHECK_EQ(stats.tracks, (uint64_t)formatted_string_cache_impl::kMaxTracks);
+    CHECK_EQ(stats.evictions, (uint64_t)1);
+
+    uint64_t hits = stats.hits;
+    formatTitle(cache, tracks[0]);
+    formatTitle(cache, tracks[1]);  // The least recently used one went
+    cache.get_stats(stats);
+    CHECK_EQ(stats.hits, hits + 1);
+}
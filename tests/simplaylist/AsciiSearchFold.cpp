@@ -0,0 +1,21 @@
+//
+//  AsciiSearchFold.cpp
+//  fb2k-components tests
+//
+//  foldSearchText for the host build. SearchIndex.mm folds through
+//  CFStringFold (case, width and diacritics); test and benchmark tags are
+//  ASCII, where that fold is plain lowercasing.
+//
+
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/SearchIndex.h"
+
+namespace simplaylist {
+
+void foldSearchText(const char* text, size_t length, std::string& out) {
+    out.assign(text, length);
+    for (char& c : out) {
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+}
+
+} // namespace simplaylist
@@ -0,0 +1,144 @@
+//
+//  ColumnFormatEngineTests.cpp
+//  fb2k-components tests
+//
+//  The 512-row ring behind the visible rows: scrolling a window down past its
+//  capacity evicts the rows left behind, scrolling back re-formats them, and
+//  every resident row reads back the values of the item it shows.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/ColumnFormatEngine.h"
+
+using namespace simplaylist;
+using fb2k_test::makeTrack;
+
+namespace {
+
+const size_t kCapacity = ColumnFormatEngine::kRingCapacity;
+
+playlist_manager& resetPlaylist(size_t itemCount) {
+    playlist_manager& pm = playlist_manager::instance();
+    pm.reset();
+    pm.playlists.assign(1, {});
+    for (size_t i = 0; i < itemCount; i++) {
+        pm.playlists[0].push_back(makeTrack({{"title", "Title " + std::to_string(i)}}, "/r/" + std::to_string(i)));
+    }
+    return pm;
+}
+
+std::string cellText(const ColumnFormatEngine& engine, int64_t row, size_t column) {
+    const char* data = nullptr;
+    size_t length = 0;
+    if (!engine.cell(row, column, data, length)) return "<missing>";
+    CHECK_EQ(data[length], '\0');
+    return std::string(data, length);
+}
+
+// Cells of row hold what formatting item directly gives
+bool rowMatches(const ColumnFormatEngine& engine, const ColumnSet& columns, int64_t row, t_size item) {
+    playlist_manager& pm = playlist_manager::instance();
+    pfc::string8 expected;
+    for (size_t c = 0; c < columns.count(); c++) {
+        pm.playlist_item_format_title(0, item, nullptr, expected, columns.script(c), nullptr,
+                                      playback_control::display_level_all);
+        if (cellText(engine, row, c) != expected.get_ptr()) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(ColumnFormatEngine_ScrollingPastCapacityEvictsAndReformats) {
+    const size_t itemCount = 3000;
+    const int64_t visible = 40;
+    resetPlaylist(itemCount);
+    ColumnSet columns;
+    columns.setPatterns({"%title%", "%list_index%", "[%artist%]"});
+    ColumnFormatEngine engine;
+    engine.setColumns(columns);
+
+    CHECK_EQ(engine.prepareRange(0, 0, visible - 1), (size_t)visible);
+    CHECK_EQ(engine.prepareRange(0, 0, visible - 1), (size_t)0);  // Redraw: all resident
+
+    // Scroll down 7 rows at a time: only the rows coming into view are formatted
+    int64_t top = 0;
+    while (top + 7 + visible <= (int64_t)itemCount) {
+        top += 7;
+        CHECK_EQ(engine.prepareRange(0, top, top + visible - 1), (size_t)7);
+        for (int64_t row = top; row < top + visible; row++) {
+            if (!rowMatches(engine, columns, row, (t_size)row)) {
+                CHECK_EQ(row, (int64_t)-1);  // Reports the first wrong row
+                break;
+            }
+        }
+    }
+    int64_t bottom = top + visible - 1;
+
+    // The last kCapacity rows formatted are resident; everything above is gone
+    for (int64_t row = 0; row < (int64_t)itemCount; row++) {
+        bool resident = row <= bottom && row > bottom - (int64_t)kCapacity;
+        if (engine.hasRow(row) != resident) {
+            CHECK_EQ(row, (int64_t)-1);
+            break;
+        }
+    }
+
+    // Back to the top: evicted rows are formatted again, with their own values
+    CHECK_EQ(engine.prepareRange(0, 0, visible - 1), (size_t)visible);
+    for (int64_t row = 0; row < visible; row++) CHECK(rowMatches(engine, columns, row, (t_size)row));
+    // ...evicting the rows that shared their slots
+    for (int64_t row = 0; row < visible; row++) {
+        int64_t sharing = row + (int64_t)kCapacity * ((bottom - row) / (int64_t)kCapacity);
+        if (sharing != row) CHECK(!engine.hasRow(sharing));
+    }
+}
+
+TEST(ColumnFormatEngine_RangeClampedToCapacityAndPlaylist) {
+    resetPlaylist(1000);
+    ColumnSet columns;
+    columns.setPatterns({"%title%"});
+    ColumnFormatEngine engine;
+    engine.setColumns(columns);
+
+    // Wider than the ring: the leading rows are kept
+    CHECK_EQ(engine.prepareRange(0, 100, 100 + 2 * (int64_t)kCapacity), kCapacity);
+    CHECK(engine.hasRow(100));
+    CHECK(engine.hasRow(100 + (int64_t)kCapacity - 1));
+    CHECK(!engine.hasRow(100 + (int64_t)kCapacity));
+
+    engine.invalidate();
+    CHECK_EQ(engine.prepareRange(0, 990, 1200), (size_t)10);  // Past the end
+    CHECK_EQ(engine.prepareRange(0, 1000, 1010), (size_t)0);
+    CHECK_EQ(cellText(engine, 999, 0), std::string("Title 999"));
+}
+
+TEST(ColumnFormatEngine_InvalidateRowAndRowMap) {
+    playlist_manager& pm = resetPlaylist(600);
+    ColumnSet columns;
+    columns.setPatterns({"%title%", "%list_index%"});
+    ColumnFormatEngine engine;
+    engine.setColumns(columns);
+    engine.prepareRange(0, 0, 99);
+
+    // Tag edit: only that row is formatted again
+    pm.playlists[0][42]->fields["title"] = "Retitled";
+    engine.invalidateRow(42);
+    CHECK_EQ(engine.prepareRange(0, 0, 99), (size_t)1);
+    CHECK_EQ(cellText(engine, 42, 0), std::string("Retitled"));
+
+    // Filtered view: row r shows item rowMap[r], with that item's list index
+    std::vector<t_size> rowMap;
+    for (t_size item = 5; item < 600; item += 10) rowMap.push_back(item);
+    engine.invalidate();
+    CHECK_EQ(engine.prepareRange(0, 0, 1000, &rowMap), rowMap.size());
+    for (size_t row = 0; row < rowMap.size(); row++) {
+        CHECK(rowMatches(engine, columns, (int64_t)row, rowMap[row]));
+    }
+
+    // New columns drop every row
+    columns.setPatterns({"%title%"});
+    engine.setColumns(columns);
+    CHECK(!engine.hasRow(0));
+    pm.reset();
+}
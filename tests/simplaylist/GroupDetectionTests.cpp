@@ -0,0 +1,321 @@
+//
+//  GroupDetectionTests.cpp
+//  fb2k-components tests
+//
+//  The chunked (parallel) group detector must produce exactly the sequential
+//  detector's output and end state, wherever the chunk edges fall. A model
+//  remapped for an insert or removal and re-detected around the dirty ranges
+//  must equal a full detection of the edited playlist. A streaming import's
+//  insertion point follows edits made to its playlist while it runs.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/GroupDetection.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace simplaylist;
+
+namespace {
+
+struct Playlist {
+    metadb_handle_list handles;
+};
+
+// Groups of random length; headers from a small alphabet so neighbouring
+// groups sometimes share a header (and merge), subgroups with gaps and repeats
+Playlist randomPlaylist(std::mt19937& rng, size_t itemCount, size_t maxGroupLength) {
+    Playlist playlist;
+    std::uniform_int_distribution<size_t> groupLength(1, maxGroupLength);
+    std::uniform_int_distribution<int> album(0, 5);
+    std::uniform_int_distribution<int> disc(0, 3);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    size_t index = 0;
+    while (index < itemCount) {
+        std::string header = "Album " + std::to_string(album(rng));
+        size_t length = std::min(groupLength(rng), itemCount - index);
+        std::string subgroup = "Disc " + std::to_string(disc(rng));
+        for (size_t i = 0; i < length; i++, index++) {
+            if (percent(rng) < 3) subgroup = "Disc " + std::to_string(disc(rng));
+            std::string value = percent(rng) < 10 ? "" : subgroup;  // Missing disc tag
+            playlist.handles.add_item(fb2k_test::makeTrack({{"album", header}, {"disc", value}},
+                                                           "/music/" + std::to_string(index) + ".flac"));
+        }
+    }
+    return playlist;
+}
+
+GroupDetectionParams makeParams(bool subgroups, bool showFirst) {
+    GroupDetectionParams params;
+    params.headerScript = fb2k_test::makeScript("album");
+    if (subgroups) params.subgroupScript = fb2k_test::makeScript("disc");
+    params.showFirstSubgroup = showFirst;
+    return params;
+}
+
+// Detect [0, split) sequentially, then [split, end) both ways from the same state
+void checkEquivalent(const Playlist& playlist, const GroupDetectionParams& params, t_size split,
+                     t_size chunkCount) {
+    t_size count = playlist.handles.get_count();
+
+    GroupDetectionState prefixState;
+    GroupDetectionResult prefix;
+    REQUIRE(detectGroupsSequential(playlist.handles, 0, split, params, prefixState, prefix, nullptr));
+
+    GroupDetectionState sequentialState = prefixState;
+    GroupDetectionResult sequential = prefix;
+    REQUIRE(detectGroupsSequential(playlist.handles, split, count, params, sequentialState, sequential, nullptr));
+
+    GroupDetectionState chunkedState = prefixState;
+    GroupDetectionResult chunked = prefix;
+    REQUIRE(detectGroupsChunked(playlist.handles, split, count, params, chunkedState, chunked, nullptr,
+                                chunkCount));
+
+    CHECK(chunked == sequential);
+    CHECK_EQ(chunked.groupStarts.size(), sequential.groupStarts.size());
+    CHECK_EQ(chunked.subgroupStarts.size(), sequential.subgroupStarts.size());
+    CHECK_EQ(chunkedState.currentHeader, sequentialState.currentHeader);
+    CHECK_EQ(chunkedState.currentSubgroup, sequentialState.currentSubgroup);
+    CHECK_EQ(chunkedState.atPlaylistStart, sequentialState.atPlaylistStart);
+}
+
+} // namespace
+
+TEST(GroupDetection_ChunkedMatchesSequentialOnRandomPlaylists) {
+    std::mt19937 rng(27);
+    const t_size chunkCounts[] = {1, 2, 3, 7, 16, 64};
+    for (int round = 0; round < 60; round++) {
+        size_t itemCount = 1 + rng() % 3000;
+        size_t maxGroupLength = 1 + rng() % (round % 2 ? 40 : 400);
+        Playlist playlist = randomPlaylist(rng, itemCount, maxGroupLength);
+        GroupDetectionParams params = makeParams(round % 3 != 0, round % 4 < 2);
+        t_size split = (round % 5 == 0) ? 0 : rng() % itemCount;
+        for (t_size chunkCount : chunkCounts) {
+            checkEquivalent(playlist, params, split, chunkCount);
+        }
+    }
+}
+
+TEST(GroupDetection_ChunkEdgesInsideOneGroup) {
+    // One header for everything: every chunk edge splits the same group, and
+    // the disc changes straddle edges at every offset in some chunk layout
+    metadb_handle_list handles;
+    for (size_t i = 0; i < 997; i++) {
+        std::string disc = (i % 13 == 0) ? "" : "Disc " + std::to_string(i / 50);
+        handles.add_item(fb2k_test::makeTrack({{"album", "Only"}, {"disc", disc}}, "/a/" + std::to_string(i)));
+    }
+    Playlist playlist{handles};
+    for (bool showFirst : {true, false}) {
+        GroupDetectionParams params = makeParams(true, showFirst);
+        for (t_size chunkCount = 1; chunkCount <= 40; chunkCount++) {
+            checkEquivalent(playlist, params, 0, chunkCount);
+        }
+    }
+
+    GroupDetectionState state;
+    GroupDetectionResult out;
+    REQUIRE(detectGroupsChunked(handles, 0, handles.get_count(), makeParams(true, true), state, out, nullptr, 9));
+    CHECK_EQ(out.groupStarts.size(), (size_t)1);
+}
+
+TEST(GroupDetection_ChunkEdgeOnGroupAndSubgroupBoundaries) {
+    // Groups and discs of exactly the chunk size: every edge is also a boundary
+    const size_t chunkSize = 64;
+    const size_t chunkCount = 12;
+    metadb_handle_list handles;
+    for (size_t i = 0; i < chunkSize * chunkCount; i++) {
+        size_t block = i / chunkSize;
+        handles.add_item(fb2k_test::makeTrack({{"album", "Album " + std::to_string(block / 2)},
+                                               {"disc", "Disc " + std::to_string(block % 2)}},
+                                              "/b/" + std::to_string(i)));
+    }
+    Playlist playlist{handles};
+    checkEquivalent(playlist, makeParams(true, true), 0, chunkCount);
+    checkEquivalent(playlist, makeParams(true, false), 0, chunkCount);
+    checkEquivalent(playlist, makeParams(true, true), chunkSize / 2, chunkCount);
+}
+
+TEST(GroupDetection_ChunkedHonoursCancel) {
+    std::mt19937 rng(3);
+    Playlist playlist = randomPlaylist(rng, 5000, 50);
+    GroupDetectionState state;
+    GroupDetectionResult out;
+    DetectionCancelCheck cancelled = [] { return true; };
+    CHECK(!detectGroupsChunked(playlist.handles, 0, 5000, makeParams(true, true), state, out, cancelled, 8));
+}
+
+TEST(GroupDetection_DeferredImportBatchesReplayAsOneInsert) {
+    std::mt19937 rng(39);
+    GroupDetectionParams params = makeParams(true, true);
+    for (int round = 0; round < 80; round++) {
+        // Model detected from a snapshot; import batches land after it was taken
+        Playlist snapshot = randomPlaylist(rng, 1 + rng() % 600, 30);
+        Playlist imported = randomPlaylist(rng, 1 + rng() % 900, 30);
+        t_size snapshotCount = snapshot.handles.get_count();
+        t_size insertAt = (round % 3 == 0) ? snapshotCount : rng() % (snapshotCount + 1);
+
+        GroupDetectionState state;
+        GroupDetectionResult model;
+        REQUIRE(detectGroupsSequential(snapshot.handles, 0, snapshotCount, params, state, model, nullptr));
+
+        // Batches in order, each right after the previous one, now and then
+        // one landing inside the block instead
+        std::vector<metadb_handle_ptr> final;
+        for (t_size i = 0; i < snapshotCount; i++) final.push_back(snapshot.handles[i]);
+        DeferredInserts deferred;
+        deferred.open = true;
+        t_size next = insertAt, done = 0, importCount = imported.handles.get_count();
+        uint64_t serial = 10;
+        while (done < importCount) {
+            t_size batch = std::min<t_size>(1 + rng() % 64, importCount - done);
+            t_size at = (done > 0 && rng() % 4 == 0) ? insertAt + rng() % (next - insertAt + 1) : next;
+            for (t_size i = 0; i < batch; i++) {
+                final.insert(final.begin() + (std::ptrdiff_t)(at + i), imported.handles[done + i]);
+            }
+            REQUIRE(deferred.add(at, batch, ++serial));
+            done += batch;
+            next = std::max(next, at) + batch;
+        }
+        CHECK_EQ(deferred.base, insertAt);
+        CHECK_EQ(deferred.count, importCount);
+        CHECK_EQ(deferred.lastSerial, serial);
+
+        IndexRuns dirty;
+        GroupSpliceLog log;
+        remapModelForInsert(model, deferred.base, deferred.count, dirty);
+        redetectDirtyRanges(model, (t_size)final.size(), dirty, params,
+                            [&final](t_size index) { return final[index]; }, log);
+
+        metadb_handle_list finalHandles;
+        for (const metadb_handle_ptr& handle : final) finalHandles.add_item(handle);
+        GroupDetectionState fullState;
+        GroupDetectionResult full;
+        REQUIRE(detectGroupsSequential(finalHandles, 0, finalHandles.get_count(), params, fullState, full, nullptr));
+        CHECK(model == full);
+    }
+}
+
+namespace {
+
+GroupDetectionResult detectAll(const metadb_handle_list& handles, const GroupDetectionParams& params) {
+    GroupDetectionState state;
+    GroupDetectionResult out;
+    REQUIRE(detectGroupsSequential(handles, 0, handles.get_count(), params, state, out, nullptr));
+    return out;
+}
+
+} // namespace
+
+TEST(GroupDetection_RemapAndRedetectMatchesSequentialOnRandomEdits) {
+    std::mt19937 rng(28);
+    for (int round = 0; round < 120; round++) {
+        size_t maxGroupLength = 1 + rng() % (round % 2 ? 10 : 80);
+        Playlist playlist = randomPlaylist(rng, 1 + rng() % 1500, maxGroupLength);
+        GroupDetectionParams params = makeParams(round % 3 != 0, round % 4 < 2);
+        GroupDetectionResult model = detectAll(playlist.handles, params);
+
+        // A few edits in a row on the same model, like a session of drops and deletes
+        for (int edit = 0; edit < 4; edit++) {
+            t_size count = playlist.handles.get_count();
+            IndexRuns dirty;
+            GroupSpliceLog log;
+            metadb_handle_list edited;
+            if (count < 2 || rng() % 2 == 0) {
+                // Insert: tracks that may continue the group at the insertion
+                // point, start a new one, or split an existing one
+                Playlist inserted = randomPlaylist(rng, 1 + rng() % 200, maxGroupLength);
+                t_size base = rng() % (count + 1);
+                for (t_size i = 0; i < base; i++) edited.add_item(playlist.handles[i]);
+                for (t_size i = 0; i < inserted.handles.get_count(); i++) edited.add_item(inserted.handles[i]);
+                for (t_size i = base; i < count; i++) edited.add_item(playlist.handles[i]);
+                remapModelForInsert(model, base, inserted.handles.get_count(), dirty);
+            } else {
+                // Remove: scattered items or a few whole runs (may take group starts)
+                pfc::bit_array_bittable mask(count);
+                if (rng() % 2 == 0) {
+                    for (t_size i = 0; i < count; i++) mask.set(i, rng() % 10 == 0);
+                } else {
+                    for (int run = 1 + rng() % 3; run > 0; run--) {
+                        t_size start = rng() % count;
+                        t_size length = std::min<t_size>(1 + rng() % 100, count - start);
+                        for (t_size i = start; i < start + length; i++) mask.set(i, true);
+                    }
+                }
+                mask.set(rng() % count, false);  // Keep at least one item
+                for (t_size i = 0; i < count; i++) {
+                    if (!mask.get(i)) edited.add_item(playlist.handles[i]);
+                }
+                remapModelForRemove(model, indexRunsFromMask(mask, count), dirty, log);
+            }
+
+            redetectDirtyRanges(model, edited.get_count(), dirty, params,
+                                [&edited](t_size index) { return edited[index]; }, log);
+            CHECK(model == detectAll(edited, params));
+            playlist.handles = edited;
+        }
+    }
+}
+
+TEST(GroupDetection_ImportInsertPointFollowsOutsideEdits) {
+    std::mt19937 rng(139);
+    for (int round = 0; round < 200; round++) {
+        // Shadow playlist with a marker (-1) where the next batch goes
+        std::vector<int> shadow(rng() % 50);
+        std::iota(shadow.begin(), shadow.end(), 0);
+        ImportInsertPoint point;
+        point.index = rng() % (shadow.size() + 1);
+        shadow.insert(shadow.begin() + (std::ptrdiff_t)point.index, -1);
+        int next = 1000;
+
+        for (int edit = 0; edit < 30; edit++) {
+            auto marker = std::find(shadow.begin(), shadow.end(), -1);
+            t_size markerAt = (t_size)(marker - shadow.begin());
+            t_size itemCount = shadow.size() - 1;
+            if (rng() % 2 == 0) {
+                // Insert elsewhere; at the point itself it lands after our batches
+                t_size base = rng() % (itemCount + 1);
+                t_size count = 1 + rng() % 5;
+                t_size at = base < markerAt ? base : base + 1;
+                for (t_size i = 0; i < count; i++) shadow.insert(shadow.begin() + (std::ptrdiff_t)at, next++);
+                point.itemsInserted(base, count);
+            } else if (itemCount > 0) {
+                pfc::bit_array_bittable mask(itemCount);
+                for (t_size i = 0; i < itemCount; i++) mask.set(i, rng() % 4 == 0);
+                std::vector<int> kept;
+                t_size item = 0;
+                for (int value : shadow) {
+                    if (value == -1 || !mask.get(item++)) kept.push_back(value);
+                }
+                shadow = kept;
+                point.itemsRemoved(indexRunsFromMask(mask, itemCount));
+            }
+            CHECK_EQ(point.index, (t_size)(std::find(shadow.begin(), shadow.end(), -1) - shadow.begin()));
+        }
+
+        point.itemsReordered();
+        CHECK_EQ(point.index, SIZE_MAX);  // No "after our batches" any more: append
+        point.itemsInserted(0, 3);
+        point.itemsRemoved({{0, 1}});
+        CHECK_EQ(point.index, SIZE_MAX);
+    }
+}
+
+TEST(GroupDetection_DeferredInsertsRejectOutsideBlockAndWhenClosed) {
+    DeferredInserts deferred;
+    CHECK(!deferred.add(0, 5, 1));  // Not collecting
+
+    deferred.open = true;
+    CHECK(deferred.add(100, 10, 2));
+    CHECK(deferred.add(110, 10, 3));  // Right after
+    CHECK(deferred.add(105, 1, 4));   // Inside
+    CHECK(!deferred.add(99, 1, 5));   // Before the block - earlier items moved
+    CHECK(!deferred.add(122, 1, 6));  // Gap after the block
+    CHECK_EQ(deferred.count, (t_size)21);
+    CHECK_EQ(deferred.lastSerial, (uint64_t)4);
+
+    deferred.reset();
+    CHECK(!deferred.open);
+    CHECK_EQ(deferred.count, (t_size)0);
+}
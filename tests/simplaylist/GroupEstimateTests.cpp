@@ -0,0 +1,150 @@
+//
+//  GroupEstimateTests.cpp
+//  fb2k-components tests
+//
+//  Placeholder groups around a partly detected playlist: measureGroups
+//  counts only complete groups, and the estimated row total approaches the
+//  detected one as detection widens, matching it once nothing is estimated.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/GroupEstimate.h"
+#include <cstdlib>
+#include <random>
+
+using namespace simplaylist;
+
+namespace {
+
+GroupDetectionParams makeParams() {
+    GroupDetectionParams params;
+    params.headerScript = fb2k_test::makeScript("album");
+    params.subgroupScript = fb2k_test::makeScript("disc");
+    params.showFirstSubgroup = true;
+    return params;
+}
+
+// Items + a header row per group and per subgroup (GroupIndex without padding)
+int64_t rowCount(const GroupDetectionResult& layout, t_size itemCount) {
+    return (int64_t)(itemCount + layout.groupStarts.size() + layout.subgroupStarts.size());
+}
+
+// SimPlaylistController's partial layout: detect the groups of [begin, end)
+// (from the start of the group holding begin), estimate the rest
+GroupDetectionResult partialLayout(const metadb_handle_list& handles, t_size begin, t_size end,
+                                   const GroupDetectionParams& params) {
+    begin = findGroupStart(handles, begin, params);
+    GroupDetectionState state;
+    GroupDetectionResult detected;
+    REQUIRE(detectGroupsSequential(handles, begin, end, params, state, detected, nullptr));
+
+    GroupEstimate estimate = measureGroups(detected, begin, end);
+    GroupDetectionResult partial;
+    appendEstimatedGroups(partial, 0, begin, estimate);
+    partial.groupStarts.insert(partial.groupStarts.end(), detected.groupStarts.begin(), detected.groupStarts.end());
+    partial.subgroupStarts.insert(partial.subgroupStarts.end(), detected.subgroupStarts.begin(),
+                                  detected.subgroupStarts.end());
+    appendEstimatedGroups(partial, end, handles.get_count(), estimate);
+    return partial;
+}
+
+GroupDetectionResult detectAll(const metadb_handle_list& handles, const GroupDetectionParams& params) {
+    GroupDetectionState state;
+    GroupDetectionResult out;
+    REQUIRE(detectGroupsSequential(handles, 0, handles.get_count(), params, state, out, nullptr));
+    return out;
+}
+
+// Albums of 8-16 tracks, one to three discs
+metadb_handle_list randomAlbums(std::mt19937& rng, size_t itemCount) {
+    metadb_handle_list handles;
+    size_t album = 0;
+    while (handles.get_count() < itemCount) {
+        size_t tracks = 8 + rng() % 9;
+        size_t discs = 1 + rng() % 3;
+        for (size_t t = 0; t < tracks && handles.get_count() < itemCount; t++) {
+            handles.add_item(fb2k_test::makeTrack({{"album", "Album " + std::to_string(album)},
+                                                   {"disc", "Disc " + std::to_string(1 + t * discs / tracks)}},
+                                                  "/e/" + std::to_string(handles.get_count())));
+        }
+        album++;
+    }
+    return handles;
+}
+
+} // namespace
+
+TEST(GroupEstimate_MeasuresCompleteGroupsOnly) {
+    GroupDetectionResult detected;
+    detected.groupStarts = {0, 10, 25, 40};
+    detected.subgroupStarts = {0, 5, 10, 12, 25, 30, 40};
+
+    // Several groups: the last one may run past end, so it is left out
+    GroupEstimate estimate = measureGroups(detected, 0, 45);
+    CHECK_EQ(estimate.itemsPerGroup, 40.0 / 3);
+    CHECK_EQ(estimate.subgroupsPerGroup, 2.0);  // 0, 5, 10, 12, 25, 30
+
+    estimate = measureGroups(detected, 5, 30);  // Groups at 10 and 25: only [10, 25) is complete
+    CHECK_EQ(estimate.itemsPerGroup, 15.0);
+    CHECK_EQ(estimate.subgroupsPerGroup, 2.0);
+
+    // One group: measured up to end, the best there is
+    estimate = measureGroups(detected, 10, 20);
+    CHECK_EQ(estimate.itemsPerGroup, 10.0);
+    CHECK_EQ(estimate.subgroupsPerGroup, 2.0);
+
+    estimate = measureGroups(detected, 41, 45);  // No group starts here
+    CHECK_EQ(estimate.itemsPerGroup, 0.0);
+    CHECK_EQ(estimate.subgroupsPerGroup, 0.0);
+}
+
+TEST(GroupEstimate_PlaceholdersCoverRangeEvenly) {
+    GroupEstimate estimate;
+    estimate.itemsPerGroup = 10;
+    estimate.subgroupsPerGroup = 2;
+    GroupDetectionResult out;
+    appendEstimatedGroups(out, 100, 195, estimate);
+    CHECK_EQ(out.groupStarts.size(), (size_t)10);  // round(95 / 10)
+    CHECK_EQ(out.groupStarts.front(), (t_size)100);
+    CHECK_EQ(out.subgroupStarts.size(), (size_t)20);
+    CHECK_EQ(out.groupHeaders.size(), out.groupStarts.size());
+    CHECK_EQ(out.subgroupHeaders.size(), out.subgroupStarts.size());
+    for (size_t i = 1; i < out.groupStarts.size(); i++) CHECK(out.groupStarts[i - 1] < out.groupStarts[i]);
+    CHECK(out.groupStarts.back() < 195);
+
+    // Nothing measured: one group for the whole range
+    GroupDetectionResult single;
+    appendEstimatedGroups(single, 0, 50, GroupEstimate());
+    CHECK_EQ(single.groupStarts.size(), (size_t)1);
+    CHECK(single.subgroupStarts.empty());
+}
+
+TEST(GroupEstimate_RowTotalConvergesAsDetectionWidens) {
+    std::mt19937 rng(45);
+    GroupDetectionParams params = makeParams();
+    for (int round = 0; round < 20; round++) {
+        metadb_handle_list handles = randomAlbums(rng, 2000 + rng() % 3000);
+        t_size itemCount = handles.get_count();
+        int64_t rows = rowCount(detectAll(handles, params), itemCount);
+
+        // Detection grows outward from a visible window, like background detection
+        t_size center = rng() % itemCount;
+        for (t_size radius = 100;; radius *= 2) {
+            t_size begin = center > radius ? center - radius : 0;
+            t_size end = std::min(itemCount, center + radius);
+            GroupDetectionResult partial = partialLayout(handles, begin, end, params);
+            int64_t error = std::llabs(rowCount(partial, itemCount) - rows);
+
+            // Placeholders are the size of the real groups on average: off by
+            // a few percent of the rows they stand in for, none once all is detected
+            t_size estimatedItems = itemCount - (end - begin);
+            CHECK(error <= 8 + (int64_t)estimatedItems / 20);
+
+            if (begin == 0 && end == itemCount) {
+                CHECK_EQ(error, (int64_t)0);
+                CHECK(partial.groupStarts == detectAll(handles, params).groupStarts);
+                break;
+            }
+        }
+    }
+}
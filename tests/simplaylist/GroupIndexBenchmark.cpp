@@ -0,0 +1,102 @@
+//
+//  GroupIndexBenchmark.cpp
+//  fb2k-components tests
+//
+//  Row <-> playlist index mapping on a large grouped playlist: build time and
+//  cost per lookup, against a linear walk over the group list (how the
+//  earlier per-group NSArray scans found a row).
+//
+//  Usage: group_index_benchmark [items]
+//
+
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/GroupIndex.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace simplaylist;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double nanosecondsPer(Clock::time_point start, size_t operations) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (double)operations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int64_t itemCount = argc > 1 ? atoll(argv[1]) : 1000000;
+    std::mt19937 rng(1);
+
+    // ~12 tracks per album, one in five albums with several discs
+    std::vector<int64_t> groupStarts, subgroupStarts;
+    std::vector<int32_t> padding;
+    for (int64_t i = 0; i < itemCount;) {
+        groupStarts.push_back(i);
+        padding.push_back((int32_t)(rng() % 4));
+        int64_t length = 4 + rng() % 17;
+        if (rng() % 5 == 0) {
+            for (int64_t d = i; d < i + length; d += 6) subgroupStarts.push_back(d);
+        }
+        i += length;
+    }
+    while (!subgroupStarts.empty() && subgroupStarts.back() >= itemCount) subgroupStarts.pop_back();
+
+    auto buildStart = Clock::now();
+    GroupIndex index;
+    index.assign(groupStarts, subgroupStarts, padding);
+    index.setItemCount(itemCount);
+    double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+
+    const size_t lookups = 2000000;
+    std::vector<int64_t> rows(lookups), items(lookups);
+    std::uniform_int_distribution<int64_t> rowDist(0, index.rowCount() - 1), itemDist(0, itemCount - 1);
+    for (size_t i = 0; i < lookups; i++) {
+        rows[i] = rowDist(rng);
+        items[i] = itemDist(rng);
+    }
+
+    int64_t sink = 0;
+    auto start = Clock::now();
+    for (int64_t row : rows) sink += index.playlistIndexForRow(row);
+    double rowToItem = nanosecondsPer(start, lookups);
+
+    start = Clock::now();
+    for (int64_t item : items) sink += index.rowForPlaylistIndex(item);
+    double itemToRow = nanosecondsPer(start, lookups);
+
+    start = Clock::now();
+    for (int64_t row : rows) sink += (int64_t)index.kindOfRow(row);
+    double kind = nanosecondsPer(start, lookups);
+
+    // Linear reference: walk groups accumulating rows until the item's group
+    const size_t linearLookups = 2000;
+    start = Clock::now();
+    for (size_t i = 0; i < linearLookups; i++) {
+        int64_t item = items[i];
+        int64_t row = 0;
+        size_t s = 0;
+        for (size_t g = 0; g < groupStarts.size(); g++) {
+            int64_t end = g + 1 < groupStarts.size() ? groupStarts[g + 1] : itemCount;
+            if (item < end) {
+                while (s < subgroupStarts.size() && subgroupStarts[s] <= item) s++;
+                row += 1 + (item - groupStarts[g]);
+                break;
+            }
+            row += 1 + (end - groupStarts[g]) + padding[g];
+        }
+        sink += row + (int64_t)s;
+    }
+    double linear = nanosecondsPer(start, linearLookups);
+
+    printf("items %lld, groups %zu, subgroups %zu, rows %lld\n", (long long)itemCount, index.groupCount(),
+           index.subgroupCount(), (long long)index.rowCount());
+    printf("assign + prefix sums     %10.2f ms\n", buildMs);
+    printf("playlistIndexForRow      %10.1f ns/lookup\n", rowToItem);
+    printf("rowForPlaylistIndex      %10.1f ns/lookup\n", itemToRow);
+    printf("kindOfRow                %10.1f ns/lookup\n", kind);
+    printf("linear group walk        %10.1f ns/lookup\n", linear);
+    return sink == 42 ? 1 : 0;  // Keep the lookups from being optimized away
+}
@@ -0,0 +1,154 @@
+//
+//  GroupIndexTests.cpp
+//  fb2k-components tests
+//
+//  GroupIndex lookups against a naive reference that lays out every row.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/GroupIndex.h"
+#include <random>
+
+using namespace simplaylist;
+using Kind = GroupIndex::RowKind;
+
+namespace {
+
+struct Layout {
+    std::vector<int64_t> groupStarts;
+    std::vector<int64_t> subgroupStarts;
+    std::vector<int32_t> paddingRows;
+    int64_t itemCount = 0;
+};
+
+struct ReferenceRow {
+    Kind kind;
+    int64_t index;
+    int64_t group;  // -1 when ungrouped
+};
+
+// Row list built the obvious way: header rows, tracks with their subgroup
+// header directly above, then padding - group by group
+std::vector<ReferenceRow> referenceRows(const Layout& layout, int32_t headerRows) {
+    std::vector<ReferenceRow> rows;
+    if (layout.groupStarts.empty()) {
+        for (int64_t i = 0; i < layout.itemCount; i++) rows.push_back({Kind::Track, i, -1});
+        return rows;
+    }
+    size_t subgroup = 0;
+    for (size_t g = 0; g < layout.groupStarts.size(); g++) {
+        int64_t end = g + 1 < layout.groupStarts.size() ? layout.groupStarts[g + 1] : layout.itemCount;
+        int64_t group = (int64_t)g;
+        for (int32_t h = 0; h < headerRows; h++) rows.push_back({Kind::GroupHeader, group, group});
+        for (int64_t i = layout.groupStarts[g]; i < end; i++) {
+            if (subgroup < layout.subgroupStarts.size() && layout.subgroupStarts[subgroup] == i) {
+                rows.push_back({Kind::SubgroupHeader, (int64_t)subgroup, group});
+                subgroup++;
+            }
+            rows.push_back({Kind::Track, i, group});
+        }
+        int32_t padding = g < layout.paddingRows.size() ? layout.paddingRows[g] : 0;
+        for (int32_t p = 0; p < padding; p++) rows.push_back({Kind::Padding, group, group});
+    }
+    return rows;
+}
+
+Layout randomLayout(std::mt19937& rng) {
+    Layout layout;
+    layout.itemCount = rng() % 400;
+    if (layout.itemCount == 0 || rng() % 8 == 0) return layout;  // Ungrouped
+
+    for (int64_t i = 0; i < layout.itemCount; i++) {
+        bool groupStart = i == 0 || rng() % 12 == 0;
+        if (groupStart) {
+            layout.groupStarts.push_back(i);
+            layout.paddingRows.push_back(rng() % 3 == 0 ? (int32_t)(rng() % 6) : 0);
+        }
+        // Subgroups at group starts and inside groups
+        if (rng() % (groupStart ? 2 : 7) == 0) layout.subgroupStarts.push_back(i);
+    }
+    if (rng() % 5 == 0) layout.paddingRows.clear();  // No padding at all
+    return layout;
+}
+
+void checkAgainstReference(const Layout& layout, int32_t headerRows) {
+    GroupIndex index;
+    index.setHeaderRowsPerGroup(headerRows);
+    index.assign(layout.groupStarts, layout.subgroupStarts, layout.paddingRows);
+    index.setItemCount(layout.itemCount);
+
+    std::vector<ReferenceRow> rows = referenceRows(layout, headerRows);
+    REQUIRE(index.rowCount() == (int64_t)rows.size());
+
+    std::vector<int64_t> rowOfItem(layout.itemCount, -1);
+    for (size_t row = 0; row < rows.size(); row++) {
+        const ReferenceRow& expected = rows[row];
+        CHECK_EQ(index.groupForRow((int64_t)row), expected.group);
+
+        int64_t kindIndex = -2;
+        Kind kind = index.kindOfRow((int64_t)row, &kindIndex);
+        CHECK(kind == expected.kind);
+        CHECK_EQ(kindIndex, expected.index);
+        CHECK_EQ(index.playlistIndexForRow((int64_t)row), expected.kind == Kind::Track ? expected.index : -1);
+        CHECK_EQ(index.subgroupForRow((int64_t)row), expected.kind == Kind::SubgroupHeader ? expected.index : -1);
+        if (expected.kind == Kind::Track) rowOfItem[expected.index] = (int64_t)row;
+        if (expected.kind == Kind::SubgroupHeader) CHECK_EQ(index.subgroupRow(expected.index), (int64_t)row);
+    }
+
+    for (int64_t item = 0; item < layout.itemCount; item++) {
+        CHECK_EQ(index.rowForPlaylistIndex(item), rowOfItem[item]);
+        CHECK_EQ(index.groupForRow(rowOfItem[item]), index.groupForPlaylistIndex(item));
+    }
+    for (size_t g = 0; g < layout.groupStarts.size(); g++) {
+        int64_t first = index.firstRowOfGroup(g);
+        int64_t last = first + index.totalRowsInGroup(g) - 1;
+        CHECK_EQ(index.groupForRow(first), (int64_t)g);
+        CHECK_EQ(index.groupForRow(last), (int64_t)g);
+        CHECK(first == 0 || rows[first - 1].group == (int64_t)g - 1);
+    }
+
+    CHECK(index.kindOfRow(-1) == Kind::Invalid);
+    CHECK(index.kindOfRow((int64_t)rows.size()) == Kind::Invalid);
+    CHECK_EQ(index.rowForPlaylistIndex(layout.itemCount), (int64_t)-1);
+    CHECK_EQ(index.rowForPlaylistIndex(-1), (int64_t)-1);
+}
+
+} // namespace
+
+TEST(GroupIndex_MatchesReferenceWithHeaderRows) {
+    std::mt19937 rng(29);
+    for (int round = 0; round < 400; round++) {
+        checkAgainstReference(randomLayout(rng), 1);
+    }
+}
+
+TEST(GroupIndex_MatchesReferenceWithoutHeaderRows) {
+    std::mt19937 rng(290);
+    for (int round = 0; round < 400; round++) {
+        checkAgainstReference(randomLayout(rng), 0);
+    }
+}
+
+TEST(GroupIndex_ItemCountOnlyMovesLastGroupEnd) {
+    Layout layout;
+    layout.groupStarts = {0, 5, 9};
+    layout.subgroupStarts = {0, 6};
+    layout.paddingRows = {2, 0, 1};
+    for (int64_t itemCount : {10, 14, 30}) {
+        layout.itemCount = itemCount;
+        checkAgainstReference(layout, 1);
+    }
+}
+
+TEST(GroupIndex_HeaderRowChangeRebuildsRows) {
+    GroupIndex index;
+    index.assign({0, 4}, {2}, {1, 0});
+    index.setItemCount(8);
+    CHECK_EQ(index.rowCount(), (int64_t)(8 + 2 + 1 + 1));
+    index.setHeaderRowsPerGroup(0);
+    CHECK_EQ(index.rowCount(), (int64_t)(8 + 1 + 1));
+    CHECK_EQ(index.rowForPlaylistIndex(4), (int64_t)(4 + 1 + 1));
+    index.clear();
+    CHECK(index.empty());
+    CHECK_EQ(index.rowForPlaylistIndex(5), (int64_t)5);
+}
@@ -0,0 +1,131 @@
+//
+//  ImportQueueTests.cpp
+//  fb2k-components tests
+//
+//  Streaming import ordering: walk units finishing out of order still come
+//  out in drop order, cut into full batches while the walk is running.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/ImportQueue.h"
+#include <algorithm>
+#include <random>
+
+using namespace simplaylist;
+
+namespace {
+
+std::vector<std::string> locations(const std::string& prefix, size_t count) {
+    std::vector<std::string> out;
+    for (size_t i = 0; i < count; i++) out.push_back(prefix + std::to_string(i));
+    return out;
+}
+
+// Every batch the queue hands out right now
+std::vector<std::vector<std::string>> drainBatches(ImportQueue& queue) {
+    std::vector<std::vector<std::string>> batches;
+    for (auto batch = queue.nextBatch(); !batch.empty(); batch = queue.nextBatch()) {
+        batches.push_back(std::move(batch));
+    }
+    return batches;
+}
+
+} // namespace
+
+TEST(ImportQueue_UpFrontLocationsComeOutInBatches) {
+    ImportQueue queue(4);
+    queue.add(locations("/a/", 10));
+    CHECK(!queue.enumerating());
+    CHECK_EQ(queue.locationsFound(), (size_t)10);
+
+    auto batches = drainBatches(queue);
+    REQUIRE(batches.size() == 3);
+    CHECK_EQ(batches[0].front(), std::string("/a/0"));
+    CHECK_EQ(batches[1].front(), std::string("/a/4"));
+    CHECK_EQ(batches[2].size(), (size_t)2);  // Short tail goes out once nothing is walked
+    CHECK(queue.drained());
+}
+
+TEST(ImportQueue_OnlyFullBatchesWhileWalking) {
+    ImportQueue queue(4);
+    queue.beginUnits();
+    CHECK(!queue.drained());  // Unit count not known yet
+    CHECK(queue.nextBatch().empty());
+
+    queue.setUnitCount(2);
+    queue.unitFinished(0, locations("/a/", 6));
+    auto batches = drainBatches(queue);
+    REQUIRE(batches.size() == 1);
+    CHECK_EQ(batches[0].size(), (size_t)4);
+    CHECK_EQ(queue.pendingCount(), (size_t)2);  // Held back for a full batch
+
+    queue.unitFinished(1, locations("/b/", 1));
+    CHECK(!queue.enumerating());
+    batches = drainBatches(queue);
+    REQUIRE(batches.size() == 1);
+    CHECK(batches[0] == (std::vector<std::string>{"/a/4", "/a/5", "/b/0"}));
+    CHECK(queue.drained());
+}
+
+TEST(ImportQueue_UnitsReleasedInDropOrder) {
+    std::mt19937 rng(39);
+    for (int round = 0; round < 200; round++) {
+        size_t unitCount = 1 + rng() % 20;
+        size_t batchSize = 1 + rng() % 16;
+        std::vector<std::vector<std::string>> units;
+        std::vector<std::string> expected;
+        for (size_t u = 0; u < unitCount; u++) {
+            units.push_back(locations("/" + std::to_string(u) + "/", rng() % 30));  // Some units are empty
+            expected.insert(expected.end(), units.back().begin(), units.back().end());
+        }
+
+        std::vector<size_t> finishOrder(unitCount);
+        for (size_t u = 0; u < unitCount; u++) finishOrder[u] = u;
+        std::shuffle(finishOrder.begin(), finishOrder.end(), rng);
+
+        ImportQueue queue(batchSize);
+        queue.beginUnits();
+        queue.setUnitCount(unitCount);
+        std::vector<bool> finished(unitCount, false);
+        std::vector<std::string> sent;
+        for (size_t i = 0; i < unitCount; i++) {
+            queue.unitFinished(finishOrder[i], units[finishOrder[i]]);
+            queue.unitFinished(finishOrder[i], locations("/dup/", 3));  // Repeats are ignored
+            finished[finishOrder[i]] = true;
+            for (auto& batch : drainBatches(queue)) {
+                // Full batches only until the last unit is in
+                if (i + 1 < unitCount) CHECK_EQ(batch.size(), batchSize);
+                sent.insert(sent.end(), batch.begin(), batch.end());
+            }
+
+            // Sent so far is a prefix of drop order, within the finished leading units
+            size_t releasable = 0;
+            for (size_t u = 0; u < unitCount && finished[u]; u++) releasable += units[u].size();
+            REQUIRE(sent.size() <= releasable);
+            CHECK(std::equal(sent.begin(), sent.end(), expected.begin()));
+        }
+        CHECK(sent == expected);
+        CHECK_EQ(queue.locationsFound(), expected.size());
+        CHECK(queue.drained());
+    }
+}
+
+TEST(ImportQueue_NoUnitsDrainsImmediately) {
+    ImportQueue queue(8);
+    queue.beginUnits();
+    queue.setUnitCount(0);
+    CHECK(queue.drained());
+    CHECK(queue.nextBatch().empty());
+}
+
+TEST(ImportQueue_ClearDropsPendingAndUnits) {
+    ImportQueue queue(4);
+    queue.beginUnits();
+    queue.setUnitCount(3);
+    queue.unitFinished(0, locations("/a/", 2));
+    queue.clear();
+    CHECK(queue.drained());
+    queue.unitFinished(1, locations("/b/", 9));  // Late walker after cancel
+    CHECK(queue.drained());
+    CHECK(queue.nextBatch().empty());
+}
@@ -0,0 +1,100 @@
+//
+//  PlaylistFormatContextTests.cpp
+//  fb2k-components tests
+//
+//  Playlist fields captured for background formatting: list position
+//  (zero-padded like the rows), playlist name, queue positions and the
+//  playing item, with track fields still reaching format_title.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/PlaylistFormatContext.h"
+
+using namespace simplaylist;
+using fb2k_test::makeScript;
+using fb2k_test::makeTrack;
+
+namespace {
+
+// Playlist 1 ("Albums") with count tracks titled t0..; playlist 0 is empty
+playlist_manager& setUpPlaylists(size_t count) {
+    playlist_manager& pm = playlist_manager::instance();
+    pm.reset();
+    playback_control::get()->paused = false;
+    pm.playlists.resize(2);
+    pm.playlistNames = {"Other", "Albums"};
+    for (size_t i = 0; i < count; i++) {
+        pm.playlists[1].push_back(makeTrack({{"title", "t" + std::to_string(i)}}));
+    }
+    return pm;
+}
+
+std::string formatField(const PlaylistFormatContext& context, t_size index, const char* field) {
+    pfc::string8 out;
+    context.format(playlist_manager::instance().playlists[1][index], index, out, makeScript(field));
+    return out.get_ptr();
+}
+
+} // namespace
+
+TEST(PlaylistFormatContext_ListFieldsAndName) {
+    setUpPlaylists(120);
+    PlaylistFormatContext context = PlaylistFormatContext::capture(1);
+
+    CHECK_EQ(formatField(context, 4, "list_index"), std::string("005"));
+    CHECK_EQ(formatField(context, 119, "list_index"), std::string("120"));
+    CHECK_EQ(formatField(context, 4, "list_total"), std::string("120"));
+    CHECK_EQ(formatField(context, 4, "Playlist_Name"), std::string("Albums"));  // Field names ignore case
+    CHECK_EQ(formatField(context, 4, "title"), std::string("t4"));  // Track fields pass through
+}
+
+TEST(PlaylistFormatContext_FirstItemOffsetsIndex) {
+    playlist_manager& pm = setUpPlaylists(30);
+    PlaylistFormatContext context = PlaylistFormatContext::capture(1, 20);
+
+    // Handle 0 of the range is playlist item 20
+    pfc::string8 out;
+    context.format(pm.playlists[1][20], 0, out, makeScript("list_index"));
+    CHECK_EQ(std::string(out.get_ptr()), std::string("21"));
+}
+
+TEST(PlaylistFormatContext_QueueFieldsOnlyForQueuedItems) {
+    playlist_manager& pm = setUpPlaylists(10);
+    pm.playlists[0].push_back(makeTrack({{"title", "other"}}));
+    pm.queue_add_item_playlist(1, 3);
+    pm.queue_add_item_playlist(0, 0);  // Another playlist's item with the same index space
+    pm.queue_add_item_playlist(1, 7);
+    pm.queue_add_item_playlist(1, 3);
+    PlaylistFormatContext context = PlaylistFormatContext::capture(1);
+
+    CHECK_EQ(formatField(context, 3, "queue_index"), std::string("1"));
+    CHECK_EQ(formatField(context, 3, "queue_indexes"), std::string("1,4"));
+    CHECK_EQ(formatField(context, 3, "queue_total"), std::string("4"));
+    CHECK_EQ(formatField(context, 7, "queue_index"), std::string("3"));
+    CHECK_EQ(formatField(context, 0, "queue_index"), std::string(""));
+    CHECK_EQ(formatField(context, 0, "queue_total"), std::string(""));
+
+    // Snapshot: later queue changes don't show until the next capture
+    pm.queue_flush();
+    CHECK_EQ(formatField(context, 7, "queue_index"), std::string("3"));
+}
+
+TEST(PlaylistFormatContext_PlayingAndPaused) {
+    playlist_manager& pm = setUpPlaylists(5);
+    pm.playingPlaylist = 1;
+    pm.playingItem = 2;
+    PlaylistFormatContext playing = PlaylistFormatContext::capture(1);
+    CHECK_EQ(formatField(playing, 2, "isplaying"), std::string("1"));
+    CHECK_EQ(formatField(playing, 2, "ispaused"), std::string(""));
+    CHECK_EQ(formatField(playing, 1, "isplaying"), std::string(""));
+
+    playback_control::get()->paused = true;
+    PlaylistFormatContext paused = PlaylistFormatContext::capture(1);
+    CHECK_EQ(formatField(paused, 2, "ispaused"), std::string("1"));
+
+    // Playing from another playlist
+    pm.playingPlaylist = 0;
+    PlaylistFormatContext elsewhere = PlaylistFormatContext::capture(1);
+    CHECK_EQ(formatField(elsewhere, 2, "isplaying"), std::string(""));
+    playback_control::get()->paused = false;
+}
@@ -0,0 +1,151 @@
+//
+//  ReorderEngineTests.cpp
+//  fb2k-components tests
+//
+//  Drag-reorder block moves against a naive move on a vector: the planned
+//  permutation, focus and selection following the moved rows, and the group
+//  model after remapModelForMove plus re-detection against a full detection.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/ReorderEngine.h"
+#include <random>
+
+using namespace simplaylist;
+
+namespace {
+
+// Random drag source: scattered rows or a few blocks, as maximal runs
+IndexRuns randomMovedRuns(std::mt19937& rng, t_size itemCount) {
+    pfc::bit_array_bittable mask(itemCount);
+    if (rng() % 2 == 0) {
+        for (t_size i = 0; i < itemCount; i++) mask.set(i, rng() % 8 == 0);
+    } else {
+        for (int run = 1 + rng() % 3; run > 0; run--) {
+            t_size start = rng() % itemCount;
+            t_size length = std::min<t_size>(1 + rng() % 40, itemCount - start);
+            for (t_size i = start; i < start + length; i++) mask.set(i, true);
+        }
+    }
+    return indexRunsFromMask(mask, itemCount);
+}
+
+// Pull the moved rows out, drop them before `destination` among the rest
+std::vector<t_size> naiveMove(const IndexRuns& moved, t_size itemCount, t_size destination) {
+    std::vector<bool> isMoved(itemCount);
+    for (const IndexRun& run : moved) {
+        for (t_size i = run.start; i < run.start + run.count; i++) isMoved[i] = true;
+    }
+    std::vector<t_size> kept, block;
+    t_size insertAt = 0;
+    for (t_size i = 0; i < itemCount; i++) {
+        if (isMoved[i]) {
+            block.push_back(i);
+        } else {
+            if (i < destination) insertAt++;
+            kept.push_back(i);
+        }
+    }
+    kept.insert(kept.begin() + (std::ptrdiff_t)insertAt, block.begin(), block.end());
+    return kept;
+}
+
+metadb_handle_list randomPlaylist(std::mt19937& rng, size_t itemCount) {
+    metadb_handle_list handles;
+    size_t index = 0;
+    while (index < itemCount) {
+        std::string album = "Album " + std::to_string(rng() % 5);
+        std::string disc = "Disc " + std::to_string(rng() % 3);
+        for (size_t length = 1 + rng() % 30; length > 0 && index < itemCount; length--, index++) {
+            if (rng() % 20 == 0) disc = "Disc " + std::to_string(rng() % 3);
+            handles.add_item(fb2k_test::makeTrack({{"album", album}, {"disc", disc}},
+                                                  "/music/" + std::to_string(index) + ".flac"));
+        }
+    }
+    return handles;
+}
+
+GroupDetectionResult detectAll(const metadb_handle_list& handles, const GroupDetectionParams& params) {
+    GroupDetectionState state;
+    GroupDetectionResult out;
+    REQUIRE(detectGroupsSequential(handles, 0, handles.get_count(), params, state, out, nullptr));
+    return out;
+}
+
+} // namespace
+
+TEST(ReorderEngine_PlanMatchesNaiveMoveAndRemapsIndices) {
+    std::mt19937 rng(38);
+    for (int round = 0; round < 400; round++) {
+        t_size itemCount = 1 + rng() % 300;
+        IndexRuns moved = randomMovedRuns(rng, itemCount);
+        t_size destination = rng() % (itemCount + 1);
+        std::vector<t_size> expected = naiveMove(moved, itemCount, destination);
+
+        MovePlan plan;
+        if (!planMove(moved, itemCount, destination, plan)) {
+            // Nothing selected, or one run dropped where it already is
+            std::vector<t_size> identity(itemCount);
+            for (t_size i = 0; i < itemCount; i++) identity[i] = i;
+            CHECK(expected == identity);
+            CHECK(plan.empty());
+            continue;
+        }
+        CHECK(plan.order == expected);
+
+        // Focus (any single row) lands where its item went
+        for (t_size newIndex = 0; newIndex < itemCount; newIndex++) {
+            CHECK_EQ(remapIndexForMove(plan, plan.order[newIndex]), newIndex);
+        }
+
+        // Selection follows its items, moved or not
+        SelectionModel selection;
+        std::vector<bool> selectedBefore(itemCount);
+        for (t_size i = 0; i < itemCount; i++) {
+            selectedBefore[i] = rng() % 3 == 0;
+            if (selectedBefore[i]) selection.appendRun((int64_t)i, (int64_t)i + 1);
+        }
+        SelectionModel remapped = remapSelectionForMove(plan, selection);
+        CHECK_EQ(remapped.count(), selection.count());
+        for (t_size newIndex = 0; newIndex < itemCount; newIndex++) {
+            CHECK_EQ(remapped.contains((int64_t)newIndex), (bool)selectedBefore[plan.order[newIndex]]);
+        }
+    }
+}
+
+TEST(ReorderEngine_DropOntoItselfIsNoOp) {
+    MovePlan plan;
+    CHECK(!planMove({{10, 5}}, 100, 10, plan));
+    CHECK(!planMove({{10, 5}}, 100, 15, plan));  // Right after the run: same place
+    CHECK(!planMove({}, 100, 0, plan));
+    CHECK(planMove({{10, 5}}, 100, 16, plan));
+    CHECK_EQ(plan.insertAt, (t_size)11);
+    CHECK(planMove({{10, 5}, {20, 1}}, 100, 10, plan));  // Two runs close up
+    CHECK_EQ(plan.insertAt, (t_size)10);
+}
+
+TEST(ReorderEngine_ModelRemapMatchesFullDetection) {
+    std::mt19937 rng(138);
+    GroupDetectionParams params;
+    params.headerScript = fb2k_test::makeScript("album");
+    params.subgroupScript = fb2k_test::makeScript("disc");
+    for (int round = 0; round < 150; round++) {
+        params.showFirstSubgroup = round % 2 == 0;
+        metadb_handle_list handles = randomPlaylist(rng, 1 + rng() % 800);
+        t_size itemCount = handles.get_count();
+        GroupDetectionResult model = detectAll(handles, params);
+
+        MovePlan plan;
+        if (!planMove(randomMovedRuns(rng, itemCount), itemCount, rng() % (itemCount + 1), plan)) continue;
+        metadb_handle_list moved;
+        for (t_size oldIndex : plan.order) moved.add_item(handles[oldIndex]);
+
+        IndexRuns dirty;
+        GroupSpliceLog log;
+        remapModelForMove(model, plan, dirty, log);
+        for (size_t i = 1; i < dirty.size(); i++) CHECK(dirty[i - 1].start <= dirty[i].start);
+        redetectDirtyRanges(model, itemCount, dirty, params,
+                            [&moved](t_size index) { return moved[index]; }, log);
+        CHECK(model == detectAll(moved, params));
+    }
+}
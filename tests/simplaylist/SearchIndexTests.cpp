@@ -0,0 +1,165 @@
+//
+//  SearchIndexTests.cpp
+//  fb2k-components tests
+//
+//  SearchIndex queries against a brute-force substring scan of the same
+//  texts, through random inserts, removes, retags and reorders: reused slots,
+//  stale postings and their compaction, overlapping remove runs, and queries
+//  of only short terms (no trigram to narrow by).
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/SearchIndex.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace simplaylist;
+
+namespace {
+
+// Small alphabet: trigrams repeat across items, so posting lists overlap
+std::string randomText(std::mt19937& rng) {
+    static const char kAlphabet[] = "abcde \n";
+    std::string text;
+    for (size_t length = rng() % 24; length > 0; length--) text.push_back(kAlphabet[rng() % 7]);
+    return text;
+}
+
+std::string randomQuery(std::mt19937& rng) {
+    std::string query;
+    for (int terms = 1 + rng() % 2; terms > 0; terms--) {
+        if (!query.empty()) query.push_back(' ');
+        for (size_t length = 1 + rng() % 4; length > 0; length--) query.push_back("abcde"[rng() % 5]);
+    }
+    return query;
+}
+
+// Every item whose text holds all terms
+std::vector<t_size> scan(const std::vector<std::string>& texts, const std::string& query) {
+    std::vector<std::string> terms;
+    size_t i = 0;
+    while (i < query.size()) {
+        while (i < query.size() && query[i] == ' ') i++;
+        size_t start = i;
+        while (i < query.size() && query[i] != ' ') i++;
+        if (i > start) terms.push_back(query.substr(start, i - start));
+    }
+    std::vector<t_size> result;
+    if (terms.empty()) return result;
+    for (size_t item = 0; item < texts.size(); item++) {
+        bool all = true;
+        for (const std::string& term : terms) all = all && texts[item].find(term) != std::string::npos;
+        if (all) result.push_back(item);
+    }
+    return result;
+}
+
+void checkQueries(std::mt19937& rng, const SearchIndex& index, const std::vector<std::string>& texts) {
+    CHECK_EQ(index.itemCount(), texts.size());
+    for (int q = 0; q < 6; q++) {
+        std::string query = randomQuery(rng);
+        if (index.query(query) != scan(texts, query)) {
+            CHECK_EQ(query, std::string());  // Reports the first failing query
+            return;
+        }
+    }
+}
+
+} // namespace
+
+TEST(SearchIndex_MatchesScanThroughRandomEdits) {
+    std::mt19937 rng(40);
+    for (int round = 0; round < 40; round++) {
+        std::vector<std::string> texts;
+        for (size_t i = rng() % 200; i > 0; i--) texts.push_back(randomText(rng));
+        SearchIndex index;
+        index.build(texts);
+        checkQueries(rng, index, texts);
+
+        for (int edit = 0; edit < 150; edit++) {
+            switch (rng() % 4) {
+                case 0: {  // Insert a batch (reuses freed slots first)
+                    size_t base = rng() % (texts.size() + 1);
+                    std::vector<std::string> batch;
+                    for (size_t i = 1 + rng() % 6; i > 0; i--) batch.push_back(randomText(rng));
+                    texts.insert(texts.begin() + (std::ptrdiff_t)base, batch.begin(), batch.end());
+                    index.insert(base, batch);
+                    break;
+                }
+                case 1: {  // Remove runs - ascending starts, possibly overlapping or past the end
+                    if (texts.empty()) break;
+                    IndexRuns runs;
+                    std::vector<bool> removed(texts.size());
+                    t_size start = 0;
+                    for (int r = 1 + rng() % 3; r > 0 && start < texts.size(); r--) {
+                        start += rng() % 10;
+                        t_size count = 1 + rng() % 8;
+                        runs.push_back({start, count});
+                        for (t_size i = start; i < std::min<t_size>(start + count, texts.size()); i++) removed[i] = true;
+                    }
+                    std::vector<std::string> kept;
+                    for (size_t i = 0; i < texts.size(); i++) {
+                        if (!removed[i]) kept.push_back(texts[i]);
+                    }
+                    texts = kept;
+                    index.remove(runs);
+                    break;
+                }
+                case 2: {  // Retag (now and then to the same text)
+                    if (texts.empty()) break;
+                    size_t item = rng() % texts.size();
+                    if (rng() % 5) texts[item] = randomText(rng);
+                    index.update(item, texts[item]);
+                    break;
+                }
+                case 3: {  // Reorder
+                    std::vector<t_size> order(texts.size());
+                    std::iota(order.begin(), order.end(), (t_size)0);
+                    std::shuffle(order.begin(), order.end(), rng);
+                    std::vector<std::string> reordered;
+                    for (t_size old : order) reordered.push_back(texts[old]);
+                    texts = reordered;
+                    index.reorder(order);
+                    break;
+                }
+            }
+            checkQueries(rng, index, texts);
+        }
+    }
+}
+
+TEST(SearchIndex_ChurnCompactsWithoutLosingItems) {
+    // Retag one item over and over: its stale postings pile up past the live
+    // ones and get swept, and the answer never changes
+    SearchIndex index;
+    std::vector<std::string> texts = {"alpha beta", "gamma", "delta alpha"};
+    index.build(texts);
+    for (int i = 0; i < 500; i++) {
+        texts[1] = (i % 2) ? "gamma alphabet " + std::to_string(i) : "epsilon";
+        index.update(1, texts[1]);
+        CHECK(index.query("alpha") == scan(texts, "alpha"));
+        CHECK(index.query("eps") == scan(texts, "eps"));
+    }
+
+    // Remove and re-insert the same items: freed slots are reused
+    for (int i = 0; i < 200; i++) {
+        index.remove({{0, 1}});
+        index.insert(2, {"alpha " + std::to_string(i)});
+        std::rotate(texts.begin(), texts.begin() + 1, texts.end());
+        texts[2] = "alpha " + std::to_string(i);
+        CHECK(index.query("alpha") == scan(texts, "alpha"));
+    }
+}
+
+TEST(SearchIndex_ShortTermsAndMisses) {
+    SearchIndex index;
+    index.build({"ab", "abc", "", "b a"});
+    CHECK(index.query("") == std::vector<t_size>{});
+    CHECK(index.query("   ") == std::vector<t_size>{});
+    CHECK(index.query("ab") == (std::vector<t_size>{0, 1}));  // Scanned, no trigram
+    CHECK(index.query("a b") == (std::vector<t_size>{0, 1, 3}));
+    CHECK(index.query("abc") == std::vector<t_size>{1});
+    CHECK(index.query("abd").empty());  // Trigram nowhere
+    CHECK(index.query("abc zz").empty());
+}
@@ -0,0 +1,105 @@
+//
+//  SelectionModelBenchmark.cpp
+//  fb2k-components tests
+//
+//  Select all, invert, shift for an insert and a removal, then push the
+//  result to the SDK through a bit_array - on a large playlist, against the
+//  same steps item by item (how the NSMutableIndexSet mirror was synced).
+//
+//  Usage: selection_model_benchmark [items]
+//
+
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/SelectionBitArray.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace simplaylist;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// What playlist_set_selection does with the mask: visit the set bits
+size_t countSetBits(const bit_array& mask, t_size count) {
+    size_t selected = 0;
+    for (t_size i = mask.find_first(true, 0, count); i < count; i = mask.find_first(true, i + 1, count)) {
+        selected++;
+    }
+    return selected;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int64_t itemCount = argc > 1 ? atoll(argv[1]) : 1000000;
+    const int64_t insertAt = itemCount / 3, insertCount = 500;
+    std::vector<SelectionModel::Run> removed;
+    for (int64_t i = itemCount / 2; i < itemCount / 2 + 5000; i += 10) removed.push_back({i, i + 4});
+
+    // Runs
+    auto start = Clock::now();
+    SelectionModel selection;
+    selection.setRange(0, itemCount);
+    double selectAll = millisecondsSince(start);
+
+    start = Clock::now();
+    selection.deselectRange(itemCount / 4, itemCount / 4 + 1000);  // A hole to invert around
+    selection.invert(itemCount);
+    selection.invert(itemCount);
+    double invert = millisecondsSince(start);
+
+    start = Clock::now();
+    selection.shiftForInsert(insertAt, insertCount);
+    selection.shiftForRemove(removed);
+    double shift = millisecondsSince(start);
+
+    int64_t finalCount = itemCount + insertCount - (int64_t)removed.size() * 4;
+    start = Clock::now();
+    SelectionBitArray mask(selection);
+    size_t pushed = countSetBits(mask, (t_size)finalCount);
+    double push = millisecondsSince(start);
+
+    // Item by item
+    start = Clock::now();
+    std::vector<bool> bits((size_t)itemCount);
+    for (int64_t i = 0; i < itemCount; i++) bits[i] = true;
+    double naiveSelectAll = millisecondsSince(start);
+
+    start = Clock::now();
+    for (int64_t i = itemCount / 4; i < itemCount / 4 + 1000; i++) bits[i] = false;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int64_t i = 0; i < itemCount; i++) bits[i] = !bits[i];
+    }
+    double naiveInvert = millisecondsSince(start);
+
+    start = Clock::now();
+    bits.insert(bits.begin() + insertAt, (size_t)insertCount, false);
+    std::vector<bool> kept;
+    kept.reserve(bits.size());
+    size_t r = 0;
+    for (int64_t i = 0; i < (int64_t)bits.size(); i++) {
+        while (r < removed.size() && removed[r].end <= i) r++;
+        if (r < removed.size() && removed[r].start <= i) continue;
+        kept.push_back(bits[i]);
+    }
+    double naiveShift = millisecondsSince(start);
+
+    start = Clock::now();
+    bit_array_bittable table((t_size)kept.size());
+    for (size_t i = 0; i < kept.size(); i++) table.set(i, kept[i]);
+    size_t naivePushed = countSetBits(table, (t_size)kept.size());
+    double naivePush = millisecondsSince(start);
+
+    printf("items %lld, runs %zu, selected %lld\n", (long long)itemCount, selection.runCount(),
+           (long long)selection.count());
+    printf("                       runs        item by item\n");
+    printf("select all       %10.3f ms %12.3f ms\n", selectAll, naiveSelectAll);
+    printf("invert x2        %10.3f ms %12.3f ms\n", invert, naiveInvert);
+    printf("insert + remove  %10.3f ms %12.3f ms\n", shift, naiveShift);
+    printf("push to mask     %10.3f ms %12.3f ms\n", push, naivePush);
+    return pushed == naivePushed ? 0 : 1;
+}
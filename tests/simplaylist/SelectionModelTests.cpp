@@ -0,0 +1,214 @@
+//
+//  SelectionModelTests.cpp
+//  fb2k-components tests
+//
+//  SelectionModel against a plain vector<bool> selection: random edits,
+//  insert/remove shifts and the bit_array view the SDK calls go through.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/SelectionBitArray.h"
+#include <random>
+
+using namespace simplaylist;
+using Run = SelectionModel::Run;
+
+namespace {
+
+using Bits = std::vector<bool>;
+
+// Runs sorted, non-empty, never touching; count matches; same bits as expected
+void checkMatches(const SelectionModel& selection, const Bits& expected) {
+    int64_t count = 0;
+    int64_t previousEnd = -1;
+    for (const Run& run : selection.runs()) {
+        CHECK(run.start < run.end);
+        CHECK(run.start > previousEnd);
+        previousEnd = run.end;
+        count += run.count();
+    }
+    CHECK_EQ(selection.count(), count);
+    REQUIRE(previousEnd <= (int64_t)expected.size());
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (selection.contains((int64_t)i) != expected[i]) {
+            CHECK_EQ(i, (size_t)-1);  // Reports the first mismatching index
+            return;
+        }
+    }
+}
+
+SelectionModel fromBits(const Bits& bits) {
+    SelectionModel selection;
+    for (size_t i = 0; i < bits.size(); i++) {
+        if (bits[i]) selection.appendRun((int64_t)i, (int64_t)i + 1);
+    }
+    return selection;
+}
+
+Bits randomBits(std::mt19937& rng, size_t count) {
+    // Clustered, like real selections: flip state every few items
+    Bits bits(count);
+    bool state = rng() % 2 == 0;
+    for (size_t i = 0; i < count; i++) {
+        if (rng() % 6 == 0) state = !state;
+        bits[i] = state;
+    }
+    return bits;
+}
+
+// Ascending, non-touching removed runs within [0, count)
+std::vector<Run> randomRemoval(std::mt19937& rng, int64_t count) {
+    std::vector<Run> removed;
+    int64_t i = (int64_t)(rng() % 5);
+    while (i < count) {
+        int64_t length = std::min<int64_t>(1 + rng() % 8, count - i);
+        removed.push_back({i, i + length});
+        i += length + 1 + (int64_t)(rng() % 12);
+    }
+    return removed;
+}
+
+} // namespace
+
+TEST(SelectionModel_RandomEditsMatchReference) {
+    std::mt19937 rng(37);
+    for (int round = 0; round < 200; round++) {
+        size_t count = 1 + rng() % 300;
+        Bits bits(count);
+        SelectionModel selection;
+        for (int step = 0; step < 40; step++) {
+            int64_t a = (int64_t)(rng() % count), b = (int64_t)(rng() % (count + 1));
+            int64_t start = std::min(a, b), end = std::max(a, b);
+            switch (rng() % 5) {
+                case 0:
+                    selection.selectRange(start, end);
+                    for (int64_t i = start; i < end; i++) bits[i] = true;
+                    break;
+                case 1:
+                    selection.deselectRange(start, end);
+                    for (int64_t i = start; i < end; i++) bits[i] = false;
+                    break;
+                case 2:
+                    selection.setRange(start, end);
+                    for (int64_t i = 0; i < (int64_t)count; i++) bits[i] = i >= start && i < end;
+                    break;
+                case 3:
+                    selection.toggle(a);
+                    bits[a] = !bits[a];
+                    break;
+                case 4:
+                    selection.invert((int64_t)count);
+                    bits.flip();
+                    break;
+            }
+            checkMatches(selection, bits);
+        }
+    }
+}
+
+TEST(SelectionModel_SetOperationsMatchReference) {
+    std::mt19937 rng(370);
+    for (int round = 0; round < 300; round++) {
+        size_t count = 1 + rng() % 500;
+        Bits a = randomBits(rng, count), b = randomBits(rng, count);
+        Bits unionBits(count), subtractBits(count), differenceBits(count);
+        for (size_t i = 0; i < count; i++) {
+            unionBits[i] = a[i] || b[i];
+            subtractBits[i] = a[i] && !b[i];
+            differenceBits[i] = a[i] != b[i];
+        }
+
+        SelectionModel joined = fromBits(a);
+        joined.unionWith(fromBits(b));
+        checkMatches(joined, unionBits);
+
+        SelectionModel subtracted = fromBits(a);
+        subtracted.subtract(fromBits(b));
+        checkMatches(subtracted, subtractBits);
+
+        checkMatches(SelectionModel::difference(fromBits(a), fromBits(b)), differenceBits);
+    }
+}
+
+TEST(SelectionModel_ShiftForInsertMatchesReference) {
+    std::mt19937 rng(3700);
+    for (int round = 0; round < 400; round++) {
+        size_t count = rng() % 300;
+        Bits bits = randomBits(rng, count);
+        int64_t base = (int64_t)(rng() % (count + 1));
+        int64_t inserted = (int64_t)(rng() % 20);
+
+        SelectionModel selection = fromBits(bits);
+        selection.shiftForInsert(base, inserted);
+        bits.insert(bits.begin() + base, (size_t)inserted, false);
+        checkMatches(selection, bits);
+    }
+}
+
+TEST(SelectionModel_ShiftForInsertSplitsRun) {
+    SelectionModel selection;
+    selection.selectRange(10, 20);
+    selection.shiftForInsert(15, 3);
+    CHECK(selection.runs() == (std::vector<Run>{{10, 15}, {18, 23}}));
+    CHECK_EQ(selection.count(), (int64_t)10);
+
+    // At a run's start or end the run moves or stays whole
+    selection.shiftForInsert(18, 2);
+    CHECK(selection.runs() == (std::vector<Run>{{10, 15}, {20, 25}}));
+    selection.shiftForInsert(15, 1);
+    CHECK(selection.runs() == (std::vector<Run>{{10, 15}, {21, 26}}));
+}
+
+TEST(SelectionModel_ShiftForRemoveMatchesReference) {
+    std::mt19937 rng(37000);
+    for (int round = 0; round < 400; round++) {
+        size_t count = 1 + rng() % 300;
+        Bits bits = randomBits(rng, count);
+        std::vector<Run> removed = randomRemoval(rng, (int64_t)count);
+
+        SelectionModel selection = fromBits(bits);
+        selection.shiftForRemove(removed);
+        Bits kept;
+        size_t r = 0;
+        for (int64_t i = 0; i < (int64_t)count; i++) {
+            while (r < removed.size() && removed[r].end <= i) r++;
+            if (r < removed.size() && removed[r].start <= i) continue;
+            kept.push_back(bits[i]);
+        }
+        checkMatches(selection, kept);
+    }
+}
+
+TEST(SelectionModel_ShiftForRemoveMergesRunsAcrossRemovedGap) {
+    SelectionModel selection;
+    selection.selectRange(0, 5);
+    selection.selectRange(8, 12);
+    selection.shiftForRemove({{5, 8}});
+    CHECK(selection.runs() == (std::vector<Run>{{0, 9}}));
+    CHECK_EQ(selection.count(), (int64_t)9);
+
+    // Removing every selected item leaves nothing
+    selection.shiftForRemove({{0, 9}});
+    CHECK(selection.empty());
+    CHECK_EQ(selection.count(), (int64_t)0);
+}
+
+TEST(SelectionModel_BitArrayFindJumpsBetweenRuns) {
+    std::mt19937 rng(7);
+    for (int round = 0; round < 100; round++) {
+        size_t count = 1 + rng() % 400;
+        Bits bits = randomBits(rng, count);
+        SelectionModel selection = fromBits(bits);
+        SelectionBitArray mask(selection);
+
+        for (t_size start = 0; start <= count; start += 1 + rng() % 7) {
+            for (bool val : {true, false}) {
+                t_size expected = start;
+                while (expected < count && bits[expected] != val) expected++;
+                CHECK_EQ(mask.find_first(val, start, count), expected);
+            }
+        }
+        checkMatches(selectionFromMask(mask, count), bits);
+    }
+}
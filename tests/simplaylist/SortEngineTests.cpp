@@ -0,0 +1,220 @@
+//
+//  SortEngineTests.cpp
+//  fb2k-components tests
+//
+//  Column-header sort against std::stable_sort over the same keys: chunked
+//  key extraction, chunk sorts and merge passes at any chunk count, digit runs
+//  in collation keys, the numeric/collation choice per column (agreed across
+//  chunks), and ties keeping playlist order under descending keys.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/SortEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+
+using namespace simplaylist;
+using fb2k_test::makeScript;
+using fb2k_test::makeTrack;
+
+namespace {
+
+std::string collationKey(const std::string& text) {
+    std::string folded = text;
+    for (char& c : folded) {
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    std::string key;
+    makeCollationKey(folded, key);
+    return key;
+}
+
+bool isNumber(const std::string& text) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    strtod(text.c_str(), &end);
+    return *end == '\0' && text.find_first_of("eExXnN") == std::string::npos;
+}
+
+// What computeSortOrder should give: each column compared as numbers if all
+// its non-empty values are numbers, else by collation key; ties keep order
+std::vector<t_size> referenceOrder(const metadb_handle_list& handles, const std::vector<SortKeySpec>& keys) {
+    t_size count = handles.get_count();
+    std::vector<bool> numeric(keys.size(), true);
+    std::vector<std::vector<double>> numbers(keys.size(), std::vector<double>(count, -HUGE_VAL));
+    std::vector<std::vector<std::string>> collation(keys.size(), std::vector<std::string>(count));
+    pfc::string8 value;
+    for (size_t k = 0; k < keys.size(); k++) {
+        for (t_size i = 0; i < count; i++) {
+            handles[i]->format_title(nullptr, value, keys[k].script, nullptr);
+            std::string text = value.get_ptr();
+            if (isNumber(text)) {
+                numbers[k][i] = strtod(text.c_str(), nullptr);
+            } else if (!text.empty()) {
+                numeric[k] = false;
+            }
+            collation[k][i] = collationKey(text);
+        }
+    }
+
+    std::vector<t_size> order(count);
+    std::iota(order.begin(), order.end(), (t_size)0);
+    std::stable_sort(order.begin(), order.end(), [&](t_size a, t_size b) {
+        for (size_t k = 0; k < keys.size(); k++) {
+            int cmp;
+            if (numeric[k]) {
+                cmp = numbers[k][a] < numbers[k][b] ? -1 : (numbers[k][b] < numbers[k][a] ? 1 : 0);
+            } else {
+                cmp = collation[k][a].compare(collation[k][b]);
+            }
+            if (cmp != 0) return keys[k].descending ? cmp > 0 : cmp < 0;
+        }
+        return false;
+    });
+    return order;
+}
+
+// Few distinct values per column, so most comparisons reach a later key or tie
+metadb_handle_list randomTracks(std::mt19937& rng, size_t itemCount, bool ratingHasText) {
+    static const char* const kArtists[] = {"Artist 2", "artist 10", "ARTIST 9", "The Band", "band", "", "Artist 02"};
+    metadb_handle_list handles;
+    for (size_t i = 0; i < itemCount; i++) {
+        std::string track = rng() % 10 ? std::to_string(1 + rng() % 15) : "";
+        std::string rating = std::to_string(rng() % 5) + "." + std::to_string(rng() % 10);
+        handles.add_item(makeTrack({{"artist", kArtists[rng() % 7]}, {"tracknumber", track}, {"rating", rating}},
+                                   "/s/" + std::to_string(i)));
+    }
+    // One text value late in the playlist: only the last chunk sees it
+    if (ratingHasText) handles[itemCount - 1 - rng() % 10]->fields["rating"] = "unrated";
+    return handles;
+}
+
+std::vector<SortKeySpec> makeKeys(std::initializer_list<std::pair<const char*, bool>> fields) {
+    std::vector<SortKeySpec> keys;
+    for (const auto& field : fields) {
+        SortKeySpec key;
+        key.script = makeScript(field.first);
+        key.descending = field.second;
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+std::vector<t_size> sortOrder(const metadb_handle_list& handles, const std::vector<SortKeySpec>& keys,
+                              t_size chunkCount) {
+    std::vector<t_size> order;
+    REQUIRE(computeSortOrderChunked(handles, keys, nullptr, order, nullptr, chunkCount));
+    return order;
+}
+
+} // namespace
+
+TEST(SortEngine_ChunkedSortMatchesStableSort) {
+    std::mt19937 rng(41);
+    static const char* const kFields[] = {"artist", "tracknumber", "rating"};
+    for (int round = 0; round < 6; round++) {
+        metadb_handle_list handles = randomTracks(rng, 4096 + rng() % 8000, round % 2 == 1);
+        std::vector<SortKeySpec> keys;
+        for (size_t k = 1 + rng() % 3; k > 0; k--) {
+            SortKeySpec key;
+            key.script = makeScript(kFields[rng() % 3]);
+            key.descending = rng() % 2 == 0;
+            keys.push_back(key);
+        }
+        std::vector<t_size> expected = referenceOrder(handles, keys);
+
+        // Chunk edges anywhere, odd run counts left over by the merge passes
+        for (t_size chunkCount : {1, 2, 3, 5, 7, 16}) {
+            if (sortOrder(handles, keys, chunkCount) != expected) {
+                CHECK_EQ(chunkCount, (t_size)0);  // Reports the first failing chunk count
+                break;
+            }
+        }
+        std::vector<t_size> order;
+        CHECK(computeSortOrder(handles, keys, nullptr, order, nullptr));
+        CHECK(order == expected);
+    }
+}
+
+TEST(SortEngine_CollationKeyOrdersDigitRuns) {
+    CHECK(collationKey("2") < collationKey("10"));
+    CHECK(collationKey("Track 9") < collationKey("track 10"));
+    CHECK(collationKey("a2b") < collationKey("a10b"));
+    CHECK(collationKey("1.5") < collationKey("1.10"));  // Each run on its own
+    CHECK(collationKey("9") < collationKey("a"));
+    CHECK(collationKey(" 9") < collationKey("9"));
+
+    // Leading zeros don't count
+    CHECK_EQ(collationKey("02"), collationKey("2"));
+    CHECK_EQ(collationKey("000"), collationKey("0"));
+    CHECK(collationKey("007") < collationKey("10"));
+    CHECK(collationKey("disc 01 track 010") < collationKey("disc 1 track 11"));
+
+    // Run lengths above 127 (the length byte compares unsigned) and past 255
+    std::string digits200(200, '9');
+    std::string digits254 = "1" + std::string(253, '0');
+    std::string digits300 = "1" + std::string(299, '0');
+    CHECK(collationKey(digits200) < collationKey(digits254));
+    CHECK(collationKey(digits254) < collationKey(digits300));
+    CHECK(collationKey("9") < collationKey(digits200));
+    // Past 255 digits only the first 255 count; the text after still does
+    CHECK_EQ(collationKey(digits300), collationKey(digits300 + "5"));
+    CHECK(collationKey(digits300 + "a") < collationKey(digits300 + "b"));
+    CHECK_EQ(collationKey(std::string(100, '0') + digits200), collationKey(digits200));
+}
+
+TEST(SortEngine_MixedColumnFallsBackToCollation) {
+    // All numbers: 1.10 < 1.5. One text value: digit runs compare, 1.5 < 1.10
+    metadb_handle_list handles;
+    for (const char* value : {"1.5", "1.10", "-3", "", "20"}) handles.add_item(makeTrack({{"value", value}}));
+    std::vector<SortKeySpec> keys = makeKeys({{"value", false}});
+    CHECK(sortOrder(handles, keys, 1) == (std::vector<t_size>{3, 2, 1, 0, 4}));
+
+    handles.add_item(makeTrack({{"value", "n/a"}}));
+    CHECK(sortOrder(handles, keys, 1) == (std::vector<t_size>{3, 2, 0, 1, 4, 5}));
+
+    // Text only in the last chunk: every chunk switches to collation
+    metadb_handle_list large;
+    for (t_size i = 0; i < 6000; i++) large.add_item(makeTrack({{"value", i % 2 ? "1.5" : "1.10"}}));
+    large.add_item(makeTrack({{"value", "x"}}));
+    for (t_size chunkCount : {1, 4}) {
+        std::vector<t_size> order = sortOrder(large, keys, chunkCount);
+        CHECK(order == referenceOrder(large, keys));
+        CHECK_EQ(order.front(), (t_size)1);
+        CHECK_EQ(order[3000], (t_size)0);
+        CHECK_EQ(order.back(), (t_size)6000);
+    }
+}
+
+TEST(SortEngine_DescendingMultiKeyStaysStable) {
+    std::mt19937 rng(141);
+    metadb_handle_list handles;
+    for (t_size i = 0; i < 9000; i++) {
+        handles.add_item(makeTrack({{"album", "Album " + std::to_string(rng() % 4)},
+                                    {"disc", std::to_string(1 + rng() % 3)}}));
+    }
+    std::vector<SortKeySpec> keys = makeKeys({{"album", true}, {"disc", true}});
+    for (t_size chunkCount : {1, 3, 8}) {
+        std::vector<t_size> order = sortOrder(handles, keys, chunkCount);
+        CHECK(order == referenceOrder(handles, keys));
+        // Descending keys, yet equal items stay ascending - not a reversed sort
+        for (t_size i = 1; i < order.size(); i++) {
+            const metadb_handle_ptr& a = handles[order[i - 1]];
+            const metadb_handle_ptr& b = handles[order[i]];
+            bool tie = a->fields["album"] == b->fields["album"] && a->fields["disc"] == b->fields["disc"];
+            if (tie && order[i - 1] > order[i]) {
+                CHECK_EQ(i, (t_size)0);  // Reports the first unstable position
+                break;
+            }
+        }
+        CHECK_EQ(handles[order.front()]->fields["album"], std::string("Album 3"));
+        CHECK_EQ(handles[order.front()]->fields["disc"], std::string("3"));
+    }
+
+    // Mixed directions: album ascending, disc descending
+    keys = makeKeys({{"album", false}, {"disc", true}});
+    CHECK(sortOrder(handles, keys, 5) == referenceOrder(handles, keys));
+}
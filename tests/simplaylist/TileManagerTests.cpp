@@ -0,0 +1,163 @@
+//
+//  TileManagerTests.cpp
+//  fb2k-components tests
+//
+//  Tile residency while scrolling and which tiles an edit sends back for
+//  drawing.
+//
+
+#include "TestHarness.h"
+#include "../../extensions/foo_jl_simplaylist_mac/src/Core/TileManager.h"
+#include <algorithm>
+#include <set>
+
+using namespace simplaylist;
+
+namespace {
+
+const double kTile = 100;
+
+std::set<int64_t> asSet(const std::vector<int64_t>& tiles) {
+    return std::set<int64_t>(tiles.begin(), tiles.end());
+}
+
+// Tile manager scrolled so the viewport covers [top, top + height)
+TileManager makeScrolled(double contentHeight, double top, double height, int64_t overscan) {
+    TileManager tiles;
+    tiles.setTileHeight(kTile);
+    tiles.setContentHeight(contentHeight);
+    tiles.update(top, top + height, overscan);
+    return tiles;
+}
+
+} // namespace
+
+TEST(TileManager_SpanMapping) {
+    TileManager tiles;
+    tiles.setTileHeight(kTile);
+    tiles.setContentHeight(950);
+    CHECK_EQ(tiles.tileCount(), (int64_t)10);
+    CHECK_EQ(tiles.tileHeightAt(9), 50.0);
+    CHECK(tiles.tilesForSpan(0, 100) == (TileManager::Range{0, 0}));
+    CHECK(tiles.tilesForSpan(99, 101) == (TileManager::Range{0, 1}));
+    CHECK(tiles.tilesForSpan(900, 5000) == (TileManager::Range{9, 9}));
+    CHECK(tiles.tilesForSpan(2000, 3000).empty());
+    CHECK(tiles.tilesForSpan(300, 300).empty());
+}
+
+TEST(TileManager_ScrollingStaysWithinOverscanBudget) {
+    const int64_t overscan = 2;
+    const double viewport = 350;  // Spans 4-5 tiles depending on offset
+    TileManager tiles;
+    tiles.setTileHeight(kTile);
+    tiles.setContentHeight(100000);
+
+    std::set<int64_t> resident;
+    for (double top = 0; top < 100000; top += 37) {
+        TileManager::Update update = tiles.update(top, top + viewport, overscan);
+        TileManager::Range visible = tiles.tilesForSpan(top, top + viewport);
+        TileManager::Range range = tiles.residentRange();
+
+        // Budget: the visible tiles plus overscan on each side, clamped to the content
+        CHECK_EQ(range.first, std::max<int64_t>(0, visible.first - overscan));
+        CHECK_EQ(range.last, std::min(tiles.tileCount() - 1, visible.last + overscan));
+        CHECK(range.last - range.first + 1 <= visible.last - visible.first + 1 + 2 * overscan);
+
+        // Released tiles are exactly those that left; only newcomers are drawn
+        for (int64_t tile : update.released) {
+            CHECK(resident.count(tile) == 1);
+            CHECK(!range.contains(tile));
+            resident.erase(tile);
+        }
+        for (int64_t tile : update.toDraw) {
+            CHECK(resident.count(tile) == 0);
+            resident.insert(tile);
+        }
+        REQUIRE(resident.size() == (size_t)(range.last - range.first + 1));
+        CHECK_EQ(*resident.begin(), range.first);
+    }
+}
+
+TEST(TileManager_VisibleTilesAreDrawnFirst) {
+    TileManager tiles = makeScrolled(10000, 0, 0, 0);
+    TileManager::Update update = tiles.update(1000, 1300, 2);
+    REQUIRE(update.toDraw.size() == 7);
+    CHECK(asSet({update.toDraw[0], update.toDraw[1], update.toDraw[2]}) == asSet({10, 11, 12}));
+    CHECK(asSet({update.toDraw[3], update.toDraw[4]}) == asSet({9, 13}));
+}
+
+TEST(TileManager_SpanInvalidationTouchesOnlyResidentOverlap) {
+    TileManager tiles = makeScrolled(10000, 1000, 300, 1);  // Tiles 9-13 resident
+    tiles.invalidateSpan(1150, 1160);
+    tiles.invalidateSpan(5000, 6000);  // Not resident
+    CHECK(tiles.isDirty(11));
+    CHECK(!tiles.isDirty(50));
+
+    TileManager::Update update = tiles.update(1000, 1300, 1);
+    CHECK(update.released.empty());
+    CHECK(asSet(update.toDraw) == asSet({11}));
+
+    // Nothing left to draw once the dirty set is consumed
+    CHECK(tiles.update(1000, 1300, 1).toDraw.empty());
+}
+
+TEST(TileManager_InsertRedrawsFromInsertionDown) {
+    TileManager tiles = makeScrolled(10000, 1000, 300, 1);  // Tiles 9-13 resident
+
+    // Rows inserted at y = 1150: tiles 9 and 10 keep their content
+    tiles.setContentHeight(10000 + 22 * 5);
+    tiles.invalidateFrom(1150);
+
+    TileManager::Update update = tiles.update(1000, 1300, 1);
+    CHECK(update.released.empty());
+    CHECK(asSet(update.toDraw) == asSet({11, 12, 13}));
+}
+
+TEST(TileManager_InsertAboveViewportRedrawsEveryResidentTile) {
+    TileManager tiles = makeScrolled(10000, 1000, 300, 1);
+    tiles.invalidateFrom(0);
+    CHECK(asSet(tiles.update(1000, 1300, 1).toDraw) == asSet({9, 10, 11, 12, 13}));
+
+    // Below the resident range: nothing on screen moved
+    tiles.invalidateFrom(4000);
+    CHECK(tiles.update(1000, 1300, 1).toDraw.empty());
+}
+
+TEST(TileManager_RemoveReleasesTilesPastTheNewEnd) {
+    TileManager tiles = makeScrolled(1000, 600, 400, 1);  // Tiles 5-9 resident
+
+    // Rows removed at y = 720 shrink the content to 780: tiles 8 and 9 are gone
+    tiles.setContentHeight(780);
+    tiles.invalidateFrom(720);
+
+    TileManager::Update update = tiles.update(600, 1000, 1);
+    CHECK(asSet(update.released) == asSet({8, 9}));
+    CHECK(tiles.residentRange() == (TileManager::Range{5, 7}));
+    CHECK(asSet(update.toDraw) == asSet({7}));  // Holds the removal and the new end
+
+    // Clamped viewport moved up to the new end: 2-4 become resident as well
+    tiles = makeScrolled(1000, 600, 400, 1);
+    tiles.setContentHeight(780);
+    tiles.invalidateFrom(720);
+    update = tiles.update(380, 780, 1);
+    CHECK(asSet(update.released) == asSet({8, 9}));
+    CHECK(asSet(update.toDraw) == asSet({2, 3, 4, 7}));
+}
+
+TEST(TileManager_ContentHeightChangeRedrawsBothEnds) {
+    TileManager tiles = makeScrolled(950, 500, 450, 1);  // Tiles 4-9 resident
+    tiles.setContentHeight(1250);
+    TileManager::Update update = tiles.update(500, 950, 1);
+    CHECK(update.released.empty());
+    // Old end redrawn, 10 newly resident; the new end (12) isn't resident
+    CHECK(asSet(update.toDraw) == asSet({9, 10}));
+}
+
+TEST(TileManager_TileHeightChangeReleasesEverything) {
+    TileManager tiles = makeScrolled(10000, 1000, 300, 1);
+    tiles.setTileHeight(200);
+    CHECK(tiles.residentRange().empty());
+    TileManager::Update update = tiles.update(1000, 1300, 1);
+    CHECK(asSet(update.released) == asSet({9, 10, 11, 12, 13}));
+    CHECK(asSet(update.toDraw) == asSet({4, 5, 6, 7}));
+}
@@ -0,0 +1,71 @@
+//
+//  TestHarness.h
+//  fb2k-components tests
+//
+//  Minimal self-registering test cases (no external framework needed).
+//  TEST(name) defines a case; CHECK / CHECK_EQ record a failure and carry on,
+//  REQUIRE stops the case. TestMain.cpp runs every case, or the ones whose
+//  name contains argv[1].
+//
+
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace test {
+
+struct Case {
+    const char* name;
+    std::function<void()> body;
+};
+
+inline std::vector<Case>& cases() {
+    static std::vector<Case> all;
+    return all;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+struct Registrar {
+    Registrar(const char* name, std::function<void()> body) { cases().push_back({name, std::move(body)}); }
+};
+
+struct RequireFailed {};
+
+inline void fail(const char* file, int line, const std::string& message) {
+    failures()++;
+    fprintf(stderr, "%s:%d: FAILED: %s\n", file, line, message.c_str());
+}
+
+template <typename A, typename B>
+std::string describe(const char* expression, const A& a, const B& b) {
+    std::ostringstream stream;
+    stream << expression << " (" << a << " vs " << b << ")";
+    return stream.str();
+}
+
+} // namespace test
+
+#define TEST_CONCAT_(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_(a, b)
+
+#define TEST(name)                                                                 \
+    static void TEST_CONCAT(test_, name)();                                        \
+    static test::Registrar TEST_CONCAT(registrar_, name)(#name, TEST_CONCAT(test_, name)); \
+    static void TEST_CONCAT(test_, name)()
+
+#define CHECK(expr) \
+    do { if (!(expr)) test::fail(__FILE__, __LINE__, #expr); } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { if (!((a) == (b))) test::fail(__FILE__, __LINE__, test::describe(#a " == " #b, (a), (b))); } while (0)
+
+#define REQUIRE(expr) \
+    do { if (!(expr)) { test::fail(__FILE__, __LINE__, #expr); throw test::RequireFailed(); } } while (0)
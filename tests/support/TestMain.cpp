@@ -0,0 +1,24 @@
+//
+//  TestMain.cpp
+//  fb2k-components tests
+//
+
+#include "TestHarness.h"
+#include <cstring>
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    for (const test::Case& testCase : test::cases()) {
+        if (filter && !strstr(testCase.name, filter)) continue;
+        int before = test::failures();
+        try {
+            testCase.body();
+        } catch (const test::RequireFailed&) {
+        }
+        run++;
+        printf("%s %s\n", test::failures() == before ? "[ OK ]" : "[FAIL]", testCase.name);
+    }
+    printf("%d cases, %d failed checks\n", run, test::failures());
+    return test::failures() == 0 ? 0 : 1;
+}
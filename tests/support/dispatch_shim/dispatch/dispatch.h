@@ -0,0 +1,37 @@
+//
+//  dispatch.h (host shim)
+//  fb2k-components tests
+//
+//  The libdispatch calls used by the Core sources, for hosts without
+//  libdispatch. dispatch_apply_f runs the iterations on a few std::threads,
+//  so chunked code paths still execute concurrently.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+typedef void* dispatch_queue_t;
+
+#define QOS_CLASS_USER_INITIATED 0x19
+
+inline dispatch_queue_t dispatch_get_global_queue(long, unsigned long) {
+    return nullptr;
+}
+
+inline void dispatch_apply_f(size_t iterations, dispatch_queue_t, void* context, void (*work)(void*, size_t)) {
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next++; i < iterations; i = next++) work(context, i);
+    };
+    // At least two threads, so interleavings are exercised on one-core hosts too
+    size_t threadCount = std::min<size_t>(iterations, std::max(2u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threadCount; t++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+}
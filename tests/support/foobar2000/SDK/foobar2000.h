@@ -0,0 +1,556 @@
+//
+//  foobar2000.h (test double)
+//  fb2k-components tests
+//
+//  Stand-in for the parts of the foobar2000 SDK used by the portable Core
+//  sources, so they build and run on any host compiler. Tracks are in-memory
+//  field maps and a compiled "script" is a field name: format_title writes
+//  that field's value (a titleformat_hook gets the first chance, as in the
+//  SDK). The playlist manager keeps playlists and the playback queue in
+//  memory and reports queue changes through onQueueChanged.
+//
+//  Only what the tested sources call is here - extend as tests need more.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef size_t t_size;
+typedef ptrdiff_t t_ssize;
+
+#ifndef NOVTABLE
+#define NOVTABLE
+#endif
+
+struct GUID {
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t Data4[8];
+};
+
+// =============================================================================
+// pfc
+// =============================================================================
+
+namespace pfc {
+
+class string_base {
+public:
+    virtual ~string_base() = default;
+
+    const char* get_ptr() const { return m_text.c_str(); }
+    const char* c_str() const { return m_text.c_str(); }
+    size_t get_length() const { return m_text.size(); }
+    size_t length() const { return m_text.size(); }
+    bool is_empty() const { return m_text.empty(); }
+
+    void reset() { m_text.clear(); }
+    void set_string(const char* text, size_t length = SIZE_MAX) {
+        m_text.assign(text, length == SIZE_MAX ? strlen(text) : length);
+    }
+    void add_string(const char* text, size_t length = SIZE_MAX) {
+        m_text.append(text, length == SIZE_MAX ? strlen(text) : length);
+    }
+
+    string_base& operator=(const char* text) { set_string(text); return *this; }
+    string_base& operator<<(const char* text) { add_string(text); return *this; }
+    string_base& operator<<(const std::string& text) { m_text += text; return *this; }
+    template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    string_base& operator<<(T value) { m_text += std::to_string(value); return *this; }
+
+protected:
+    std::string m_text;
+};
+
+class string8 : public string_base {
+public:
+    string8() = default;
+    string8(const char* text) { set_string(text); }
+    string8(const string8& other) : string_base() { m_text = other.m_text; }
+    string8& operator=(const string8& other) { m_text = other.m_text; return *this; }
+    string8& operator=(const char* text) { set_string(text); return *this; }
+};
+
+// Zero-padded integer
+class format_int {
+public:
+    format_int(int64_t value, unsigned width = 0) {
+        m_text = std::to_string(value < 0 ? -value : value);
+        if (m_text.size() < width) m_text.insert(0, width - m_text.size(), '0');
+        if (value < 0) m_text.insert(0, 1, '-');
+    }
+    const char* c_str() const { return m_text.c_str(); }
+    operator const char*() const { return m_text.c_str(); }
+
+private:
+    std::string m_text;
+};
+
+template <typename T>
+class list_base_t {
+public:
+    virtual ~list_base_t() = default;
+    t_size get_count() const { return m_items.size(); }
+    t_size get_size() const { return m_items.size(); }
+    const T& operator[](t_size index) const { return m_items[index]; }
+    T& operator[](t_size index) { return m_items[index]; }
+    const T& get_item(t_size index) const { return m_items[index]; }
+    void add_item(const T& item) { m_items.push_back(item); }
+    void remove_all() { m_items.clear(); }
+    void set_size(t_size count) { m_items.resize(count); }
+
+protected:
+    std::vector<T> m_items;
+};
+
+template <typename T>
+class list_t : public list_base_t<T> {};
+
+class NOVTABLE bit_array {
+public:
+    virtual ~bit_array() = default;
+    virtual bool get(t_size index) const = 0;
+
+    // First index in [start, start + count) whose bit equals val, or the end
+    // (count < 0 scans backward, as in pfc)
+    virtual t_size find(bool val, t_size start, t_ssize count) const {
+        t_ssize step = count < 0 ? -1 : 1;
+        t_ssize index = (t_ssize)start;
+        t_ssize end = index + count;
+        for (; index != end; index += step) {
+            if (get((t_size)index) == val) return (t_size)index;
+        }
+        return (t_size)end;
+    }
+
+    t_size find_first(bool val, t_size start, t_size max) const {
+        return find(val, start, (t_ssize)(max - start));
+    }
+};
+
+class bit_array_bittable : public bit_array {
+public:
+    explicit bit_array_bittable(t_size count = 0) : m_bits(count, false) {}
+    void resize(t_size count) { m_bits.resize(count, false); }
+    void set(t_size index, bool value) {
+        if (index >= m_bits.size()) m_bits.resize(index + 1, false);
+        m_bits[index] = value;
+    }
+    bool get(t_size index) const override { return index < m_bits.size() && m_bits[index]; }
+
+private:
+    std::vector<bool> m_bits;
+};
+
+class bit_array_true : public bit_array {
+public:
+    bool get(t_size) const override { return true; }
+};
+
+} // namespace pfc
+
+using pfc::bit_array;
+using pfc::bit_array_bittable;
+
+// =============================================================================
+// Services
+// =============================================================================
+
+class NOVTABLE service_base {
+public:
+    virtual ~service_base() = default;
+};
+
+// Non-owning unless constructed from a fresh object - enough for tests
+template <typename T>
+class service_ptr_t {
+public:
+    service_ptr_t() = default;
+    service_ptr_t(std::nullptr_t) {}
+    explicit service_ptr_t(std::shared_ptr<T> object) : m_object(std::move(object)) {}
+
+    static service_ptr_t borrow(T* object) {
+        return service_ptr_t(std::shared_ptr<T>(object, [](T*) {}));
+    }
+
+    bool is_valid() const { return m_object != nullptr; }
+    bool is_empty() const { return m_object == nullptr; }
+    T* get_ptr() const { return m_object.get(); }
+    T* operator->() const { return m_object.get(); }
+    void release() { m_object.reset(); }
+
+    bool operator==(const service_ptr_t& other) const { return m_object == other.m_object; }
+    bool operator!=(const service_ptr_t& other) const { return m_object != other.m_object; }
+
+private:
+    std::shared_ptr<T> m_object;
+};
+
+#define FB2K_MAKE_SERVICE_INTERFACE_ENTRYPOINT(name) \
+public:                                              \
+    static const GUID class_guid;                    \
+    typedef service_ptr_t<name> ptr;                 \
+private:
+
+namespace fb2k_test {
+
+// Every service_factory_single_t instance, in registration order
+inline std::vector<service_base*>& serviceRegistry() {
+    static std::vector<service_base*> registry;
+    return registry;
+}
+
+} // namespace fb2k_test
+
+template <typename T>
+class service_factory_single_t {
+public:
+    service_factory_single_t() { fb2k_test::serviceRegistry().push_back(&m_instance); }
+    T& get_static_instance() { return m_instance; }
+
+private:
+    T m_instance;
+};
+
+template <typename T>
+class service_enum_t {
+public:
+    bool first(service_ptr_t<T>& out) {
+        m_next = 0;
+        return next(out);
+    }
+    bool next(service_ptr_t<T>& out) {
+        auto& registry = fb2k_test::serviceRegistry();
+        while (m_next < registry.size()) {
+            if (T* match = dynamic_cast<T*>(registry[m_next++])) {
+                out = service_ptr_t<T>::borrow(match);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    size_t m_next = 0;
+};
+
+class NOVTABLE initquit : public service_base {
+public:
+    virtual void on_init() {}
+    virtual void on_quit() {}
+};
+
+class console_formatter {
+public:
+    ~console_formatter() { fprintf(stderr, "%s\n", m_stream.str().c_str()); }
+    template <typename T>
+    console_formatter& operator<<(const T& value) {
+        m_stream << value;
+        return *this;
+    }
+
+private:
+    std::ostringstream m_stream;
+};
+
+inline console_formatter FB2K_console_formatter() { return console_formatter(); }
+
+// =============================================================================
+// Titleformat
+// =============================================================================
+
+namespace titleformat_inputtypes {
+inline const GUID unknown = {0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0}};
+}
+
+class NOVTABLE titleformat_text_out {
+public:
+    virtual ~titleformat_text_out() = default;
+    virtual void write(const GUID& inputType, const char* data, t_size length = SIZE_MAX) = 0;
+};
+
+class titleformat_hook_function_params;
+
+class NOVTABLE titleformat_hook {
+public:
+    virtual ~titleformat_hook() = default;
+    virtual bool process_field(titleformat_text_out* out, const char* name, t_size nameLength,
+                               bool& foundFlag) = 0;
+    virtual bool process_function(titleformat_text_out* out, const char* name, t_size nameLength,
+                                  titleformat_hook_function_params* params, bool& foundFlag) = 0;
+};
+
+// %list_index% / %list_total% (index is zero-based, shown one-based and
+// zero-padded to the width of the total, as in the SDK)
+class titleformat_hook_impl_list : public titleformat_hook {
+public:
+    titleformat_hook_impl_list(t_size index, t_size total) : m_index(index), m_total(total) {}
+    bool process_field(titleformat_text_out* out, const char* name, t_size nameLength, bool& foundFlag) override {
+        std::string field(name, nameLength);
+        foundFlag = false;
+        if (field == "list_index") {
+            std::string value = std::to_string(m_index + 1);
+            size_t width = std::to_string(m_total).size();
+            if (value.size() < width) value.insert(0, width - value.size(), '0');
+            out->write(titleformat_inputtypes::unknown, value.c_str(), value.size());
+            foundFlag = true;
+            return true;
+        }
+        if (field == "list_total") {
+            std::string value = std::to_string(m_total);
+            out->write(titleformat_inputtypes::unknown, value.c_str(), value.size());
+            foundFlag = true;
+            return true;
+        }
+        return false;
+    }
+    bool process_function(titleformat_text_out*, const char*, t_size, titleformat_hook_function_params*,
+                          bool& foundFlag) override {
+        foundFlag = false;
+        return false;
+    }
+
+private:
+    t_size m_index;
+    t_size m_total;
+};
+
+// A compiled script is the name of the field it prints
+class titleformat_object : public service_base {
+public:
+    typedef service_ptr_t<titleformat_object> ptr;
+
+    explicit titleformat_object(std::string field) : m_field(std::move(field)) {}
+    const std::string& field() const { return m_field; }
+
+private:
+    std::string m_field;
+};
+
+class titleformat_compiler {
+public:
+    static titleformat_compiler* get() {
+        static titleformat_compiler compiler;
+        return &compiler;
+    }
+
+    // "%name%" compiles to field "name"; any other pattern is its own field name
+    bool compile_safe(titleformat_object::ptr& out, const char* pattern) {
+        std::string text(pattern ? pattern : "");
+        if (text.size() >= 2 && text.front() == '%' && text.back() == '%' &&
+            text.find('%', 1) == text.size() - 1) {
+            text = text.substr(1, text.size() - 2);
+        }
+        out = titleformat_object::ptr(std::make_shared<titleformat_object>(text));
+        return true;
+    }
+    bool compile_safe_ex(titleformat_object::ptr& out, const char* pattern, const char* = nullptr) {
+        return compile_safe(out, pattern);
+    }
+};
+
+// =============================================================================
+// Tracks
+// =============================================================================
+
+class metadb_handle : public service_base {
+public:
+    std::map<std::string, std::string> fields;
+    std::string path;
+    double length = 0;
+
+    // Runs at the start of every format_title (tests use it to interleave work)
+    std::function<void()> onFormat;
+
+    void format_title(titleformat_hook* hook, pfc::string_base& out, const titleformat_object::ptr& script,
+                      void* /*filter*/) const {
+        out.reset();
+        if (onFormat) onFormat();
+        if (script.is_empty()) return;
+
+        const std::string& field = script->field();
+        if (hook) {
+            struct Writer : titleformat_text_out {
+                std::string text;
+                void write(const GUID&, const char* data, t_size length) override {
+                    text.append(data, length == SIZE_MAX ? strlen(data) : length);
+                }
+            } writer;
+            bool found = false;
+            if (hook->process_field(&writer, field.c_str(), field.size(), found)) {
+                out.set_string(writer.text.c_str(), writer.text.size());
+                return;
+            }
+        }
+        auto it = fields.find(field);
+        if (it != fields.end()) out.set_string(it->second.c_str(), it->second.size());
+    }
+
+    const char* get_path() const { return path.c_str(); }
+    double get_length() const { return length; }
+};
+
+typedef service_ptr_t<metadb_handle> metadb_handle_ptr;
+typedef pfc::list_t<metadb_handle_ptr> metadb_handle_list;
+typedef const pfc::list_base_t<metadb_handle_ptr>& metadb_handle_list_cref;
+
+class NOVTABLE metadb_io_callback : public service_base {
+public:
+    virtual void on_changed_sorted(metadb_handle_list_cref items, bool fromHook) = 0;
+};
+
+namespace fb2k_test {
+
+inline metadb_handle_ptr makeTrack(std::map<std::string, std::string> fields, std::string path = "",
+                                   double length = 0) {
+    auto handle = std::make_shared<metadb_handle>();
+    handle->fields = std::move(fields);
+    handle->path = std::move(path);
+    handle->length = length;
+    return metadb_handle_ptr(handle);
+}
+
+inline titleformat_object::ptr makeScript(const char* field) {
+    return titleformat_object::ptr(std::make_shared<titleformat_object>(field));
+}
+
+} // namespace fb2k_test
+
+// =============================================================================
+// Playlists and playback queue
+// =============================================================================
+
+struct t_playback_queue_item {
+    metadb_handle_ptr m_handle;
+    t_size m_playlist;
+    t_size m_item;
+
+    bool operator==(const t_playback_queue_item& other) const {
+        return m_handle == other.m_handle && m_playlist == other.m_playlist && m_item == other.m_item;
+    }
+};
+
+class playback_control {
+public:
+    enum t_track_command { track_command_default = 0, track_command_settrack = 8 };
+    enum t_display_level { display_level_none, display_level_basic, display_level_titles, display_level_all };
+
+    typedef service_ptr_t<playback_control> ptr;
+    static ptr get() {
+        static playback_control instance;
+        return ptr::borrow(&instance);
+    }
+
+    void play_start(t_track_command = track_command_default, bool = false) { started++; }
+    bool is_paused() { return paused; }
+
+    int started = 0;
+    bool paused = false;
+};
+
+class playlist_manager : public service_base {
+public:
+    typedef service_ptr_t<playlist_manager> ptr;
+    static ptr get() { return ptr::borrow(&instance()); }
+    static playlist_manager& instance() {
+        static playlist_manager manager;
+        return manager;
+    }
+
+    // Test state
+    std::vector<std::vector<metadb_handle_ptr>> playlists;
+    std::vector<std::string> playlistNames;  // Missing entries read as ""
+    std::vector<t_playback_queue_item> queue;
+    t_size playingPlaylist = SIZE_MAX;
+    t_size playingItem = SIZE_MAX;
+    std::function<void()> onQueueChanged;  // playback_queue_callback stand-in
+
+    void reset() {
+        playlists.clear();
+        playlistNames.clear();
+        queue.clear();
+        playingPlaylist = playingItem = SIZE_MAX;
+        onQueueChanged = nullptr;
+    }
+
+    // Playlists
+    t_size get_playlist_count() { return playlists.size(); }
+    t_size playlist_get_item_count(t_size playlist) {
+        return playlist < playlists.size() ? playlists[playlist].size() : 0;
+    }
+    bool playlist_get_item_handle(metadb_handle_ptr& out, t_size playlist, t_size item) {
+        if (item >= playlist_get_item_count(playlist)) return false;
+        out = playlists[playlist][item];
+        return true;
+    }
+    // Track fields plus %list_index% / %list_total%
+    void playlist_item_format_title(t_size playlist, t_size item, titleformat_hook*, pfc::string_base& out,
+                                    const titleformat_object::ptr& script, void*,
+                                    playback_control::t_display_level) {
+        out.reset();
+        if (item >= playlist_get_item_count(playlist)) return;
+        titleformat_hook_impl_list hook(item, playlists[playlist].size());
+        playlists[playlist][item]->format_title(&hook, out, script, nullptr);
+    }
+    bool playlist_get_name(t_size playlist, pfc::string_base& out) {
+        if (playlist >= playlists.size()) return false;
+        out.set_string(playlist < playlistNames.size() ? playlistNames[playlist].c_str() : "");
+        return true;
+    }
+    bool get_playing_item_location(t_size* playlist, t_size* item) {
+        if (playingPlaylist == SIZE_MAX) return false;
+        *playlist = playingPlaylist;
+        *item = playingItem;
+        return true;
+    }
+    void set_active_playlist(t_size) {}
+    void playlist_set_focus_item(t_size, t_size) {}
+
+    // Queue
+    t_size queue_get_count() { return queue.size(); }
+    void queue_get_contents(pfc::list_base_t<t_playback_queue_item>& out) {
+        out.remove_all();
+        for (const auto& item : queue) out.add_item(item);
+    }
+    void queue_add_item(metadb_handle_ptr handle) {
+        queue.push_back({handle, ~(t_size)0, ~(t_size)0});
+        changed();
+    }
+    void queue_add_item_playlist(t_size playlist, t_size item) {
+        metadb_handle_ptr handle;
+        if (!playlist_get_item_handle(handle, playlist, item)) return;
+        queue.push_back({handle, playlist, item});
+        changed();
+    }
+    void queue_remove_mask(const bit_array& mask) {
+        std::vector<t_playback_queue_item> kept;
+        for (t_size i = 0; i < queue.size(); i++) {
+            if (!mask.get(i)) kept.push_back(queue[i]);
+        }
+        if (kept.size() == queue.size()) return;
+        queue.swap(kept);
+        changed();
+    }
+    void queue_flush() {
+        if (queue.empty()) return;
+        queue.clear();
+        changed();
+    }
+
+private:
+    void changed() {
+        if (onQueueChanged) onQueueChanged();
+    }
+};